@@ -42,6 +42,8 @@ void assets_init(int force_reload, color_t **main_images, int *main_image_widths
 
     asset_image_load_all(main_images, main_image_widths);
 
+    group_build_lookup();
+
     group_set_for_external_files();
 
     // By default, if the requested image is not found, the roadblock image will be shown.
@@ -70,7 +72,11 @@ int assets_load_single_group(const char *file_name, color_t **main_images, int *
     }
     xml_init();
     graphics_renderer()->free_image_atlas(ATLAS_EXTRA_ASSET);
-    return xml_process_assetlist_file(file_name) && asset_image_load_all(main_images, main_image_widths);
+    if (!xml_process_assetlist_file(file_name) || !asset_image_load_all(main_images, main_image_widths)) {
+        return 0;
+    }
+    group_build_lookup();
+    return 1;
 }
 
 int assets_get_group_id(const char *assetlist_name)
@@ -93,12 +99,9 @@ int assets_get_image_id(const char *assetlist_name, const char *image_name)
         log_info("Asset group not found: ", assetlist_name, 0);
         return data.roadblock_image_id;
     }
-    const asset_image *img = asset_image_get_from_id(group->first_image_index);
-    while (img && img->index <= group->last_image_index) {
-        if (img->id && strcmp(img->id, image_name) == 0) {
-            return img->index + IMAGE_MAIN_ENTRIES;
-        }
-        img = asset_image_get_from_id(img->index + 1);
+    int index = group_get_image_index(group, image_name);
+    if (index >= 0) {
+        return index + IMAGE_MAIN_ENTRIES;
     }
     log_info("Asset image not found: ", image_name, 0);
     log_info("Asset group is: ", assetlist_name, 0);
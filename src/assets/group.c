@@ -6,14 +6,90 @@
 #include <stdlib.h>
 #include <string.h>
 
+typedef struct {
+    uint32_t hash;
+    int group_id;
+    int image_index;
+} image_lookup_entry;
+
 static struct {
     int total_groups;
     int groups_in_memory;
     image_groups *groups;
 } data;
 
+// Open addressing hash tables for name lookups. Groups created after the tables were built,
+// such as the external files group, are searched linearly.
+static struct {
+    int indexed_groups;
+    uint32_t group_mask;
+    int *groups;
+    uint32_t image_mask;
+    image_lookup_entry *images;
+} lookup;
+
+static uint32_t hash_name(const char *name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t) *name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t hash_image_name(int group_id, const char *name)
+{
+    return hash_name(name) ^ ((uint32_t) group_id * 2654435761u);
+}
+
+static uint32_t get_table_size(int entries)
+{
+    uint32_t size = 16;
+    while (size < (uint32_t) entries * 2) {
+        size *= 2;
+    }
+    return size;
+}
+
+static int find_indexed_group(const char *name)
+{
+    uint32_t slot = hash_name(name) & lookup.group_mask;
+    while (lookup.groups[slot] != -1) {
+        if (strcmp(data.groups[lookup.groups[slot]].name, name) == 0) {
+            return lookup.groups[slot];
+        }
+        slot = (slot + 1) & lookup.group_mask;
+    }
+    return -1;
+}
+
+static int find_indexed_image(int group_id, const char *image_name)
+{
+    uint32_t hash = hash_image_name(group_id, image_name);
+    uint32_t slot = hash & lookup.image_mask;
+    while (lookup.images[slot].image_index != -1) {
+        const image_lookup_entry *entry = &lookup.images[slot];
+        if (entry->hash == hash && entry->group_id == group_id &&
+            strcmp(asset_image_get_from_id(entry->image_index)->id, image_name) == 0) {
+            return entry->image_index;
+        }
+        slot = (slot + 1) & lookup.image_mask;
+    }
+    return -1;
+}
+
+void group_free_lookup(void)
+{
+    free(lookup.groups);
+    free(lookup.images);
+    memset(&lookup, 0, sizeof(lookup));
+}
+
 int group_create_all(int total)
 {
+    group_free_lookup();
     total += 1; // Create extra group for external files
     for (int i = 0; i < data.total_groups; i++) {
         free((char *)data.groups[i].name);
@@ -61,6 +137,7 @@ void group_set_for_external_files(void)
 
 void group_unload_current(void)
 {
+    group_free_lookup();
     image_groups *group = group_get_current();
     asset_image *img = asset_image_get_from_id(group->last_image_index);
     while (img && img->index >= group->first_image_index) {
@@ -85,12 +162,83 @@ int group_get_total(void)
     return data.total_groups;
 }
 
+void group_build_lookup(void)
+{
+    group_free_lookup();
+    // The external files group keeps growing while the game runs, so it and anything after it is not indexed
+    int indexed_groups = 0;
+    while (indexed_groups < data.total_groups &&
+        (!data.groups[indexed_groups].name || strcmp(data.groups[indexed_groups].name, ASSET_EXTERNAL_FILE_LIST) != 0)) {
+        indexed_groups++;
+    }
+    int total_images = 0;
+    for (int i = 0; i < indexed_groups; i++) {
+        const image_groups *group = &data.groups[i];
+        if (group->first_image_index >= 0) {
+            total_images += group->last_image_index - group->first_image_index + 1;
+        }
+    }
+    uint32_t group_size = get_table_size(indexed_groups);
+    uint32_t image_size = get_table_size(total_images);
+    lookup.groups = malloc(sizeof(int) * group_size);
+    lookup.images = malloc(sizeof(image_lookup_entry) * image_size);
+    if (!lookup.groups || !lookup.images) {
+        log_error("Not enough memory to create the asset lookup tables. Asset lookups will be slower.", 0, 0);
+        group_free_lookup();
+        return;
+    }
+    memset(lookup.groups, -1, sizeof(int) * group_size);
+    memset(lookup.images, -1, sizeof(image_lookup_entry) * image_size);
+    lookup.group_mask = group_size - 1;
+    lookup.image_mask = image_size - 1;
+
+    // Entries are added in index order and duplicates are skipped, so the first match wins like in a linear search
+    for (int i = 0; i < indexed_groups; i++) {
+        const image_groups *group = &data.groups[i];
+        if (!group->name || find_indexed_group(group->name) != -1) {
+            continue;
+        }
+        uint32_t slot = hash_name(group->name) & lookup.group_mask;
+        while (lookup.groups[slot] != -1) {
+            slot = (slot + 1) & lookup.group_mask;
+        }
+        lookup.groups[slot] = i;
+    }
+    lookup.indexed_groups = indexed_groups;
+
+    for (int i = 0; i < indexed_groups; i++) {
+        const image_groups *group = &data.groups[i];
+        const asset_image *img = asset_image_get_from_id(group->first_image_index);
+        while (img && img->index <= group->last_image_index) {
+            if (img->id && find_indexed_image(i, img->id) == -1) {
+                uint32_t hash = hash_image_name(i, img->id);
+                uint32_t slot = hash & lookup.image_mask;
+                while (lookup.images[slot].image_index != -1) {
+                    slot = (slot + 1) & lookup.image_mask;
+                }
+                lookup.images[slot].hash = hash;
+                lookup.images[slot].group_id = i;
+                lookup.images[slot].image_index = img->index;
+            }
+            img = asset_image_get_from_id(img->index + 1);
+        }
+    }
+}
+
 image_groups *group_get_from_name(const char *name)
 {
     if (!name || !*name) {
         return 0;
     }
-    for (int i = 0; i < data.total_groups; i++) {
+    int first_unindexed = 0;
+    if (lookup.groups) {
+        int group_id = find_indexed_group(name);
+        if (group_id != -1) {
+            return &data.groups[group_id];
+        }
+        first_unindexed = lookup.indexed_groups;
+    }
+    for (int i = first_unindexed; i < data.total_groups; i++) {
         image_groups *current = &data.groups[i];
         if (strcmp(current->name, name) == 0) {
             return current;
@@ -99,6 +247,22 @@ image_groups *group_get_from_name(const char *name)
     return 0;
 }
 
+int group_get_image_index(const image_groups *group, const char *image_name)
+{
+    int group_id = (int) (group - data.groups);
+    if (lookup.images && group_id >= 0 && group_id < lookup.indexed_groups) {
+        return find_indexed_image(group_id, image_name);
+    }
+    const asset_image *img = asset_image_get_from_id(group->first_image_index);
+    while (img && img->index <= group->last_image_index) {
+        if (img->id && strcmp(img->id, image_name) == 0) {
+            return img->index;
+        }
+        img = asset_image_get_from_id(img->index + 1);
+    }
+    return -1;
+}
+
 image_groups *group_get_from_image_index(int index)
 {
     for (int i = 0; i < data.total_groups; i++) {
@@ -27,7 +27,29 @@ void group_set_for_external_files(void);
 int group_get_total(void);
 
 image_groups *group_get_from_id(int id);
+
+/**
+ * Builds hash tables for looking up groups and their images by name.
+ * Called once all asset groups are loaded. Until then, and for groups added afterwards,
+ * lookups fall back to a linear search.
+ */
+void group_build_lookup(void);
+
+/**
+ * Releases the lookup hash tables. Lookups use a linear search until group_build_lookup is called again.
+ */
+void group_free_lookup(void);
+
 image_groups *group_get_from_name(const char *name);
+
+/**
+ * Finds an image of a group by its name
+ * @param group The group to search in
+ * @param image_name The image name
+ * @return The asset image index of the first image with that name, or -1 if the group has no such image
+ */
+int group_get_image_index(const image_groups *group, const char *image_name);
+
 image_groups *group_get_from_image_index(int index);
 
 #endif // ASSETS_GROUP_H
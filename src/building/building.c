@@ -3,6 +3,7 @@
 #include "building/distribution.h"
 #include "building/industry.h"
 #include "building/granary.h"
+#include "building/house_service.h"
 #include "building/menu.h"
 #include "building/model.h"
 #include "building/monument.h"
@@ -10,7 +11,9 @@
 #include "building/rotation.h"
 #include "building/state.h"
 #include "building/storage.h"
+#include "building/storage_index.h"
 #include "building/variant.h"
+#include "building/warehouse.h"
 #include "city/buildings.h"
 #include "city/finance.h"
 #include "city/population.h"
@@ -34,17 +37,28 @@
 #include "map/terrain.h"
 #include "map/tiles.h"
 
-
+#include <stdlib.h>
+#include <string.h>
 
 #define BUILDING_ARRAY_SIZE_STEP 2000
+#define TYPE_INDEX_SIZE_STEP 16
 
 #define WATER_DESIRABILITY_RANGE 3
 #define WATER_DESIRABILITY_BONUS 15
 
+// The ids of the buildings of one type, kept sorted so they are visited in the same order as the type list
+typedef struct {
+    unsigned int *ids;
+    unsigned int total;
+    unsigned int capacity;
+    unsigned int changes;
+} type_index;
+
 static struct {
     array(building) buildings;
     building *first_of_type[BUILDING_TYPE_MAX];
     building *last_of_type[BUILDING_TYPE_MAX];
+    type_index of_type[BUILDING_TYPE_MAX];
 } data;
 
 static struct {
@@ -88,9 +102,10 @@ int building_count(void)
 
 int building_find(building_type type)
 {
-    for (building *b = data.first_of_type[type]; b; b = b->next_of_type) {
-        if (b->state == BUILDING_STATE_IN_USE) {
-            return b->id;
+    const type_index *index = &data.of_type[type];
+    for (unsigned int i = 0; i < index->total; i++) {
+        if (building_get(index->ids[i])->state == BUILDING_STATE_IN_USE) {
+            return index->ids[i];
         }
     }
     return 0;
@@ -117,8 +132,97 @@ building *building_next(building *b)
     return array_item(data.buildings, b->next_part_building_id);
 }
 
+static unsigned int find_in_type_index(const type_index *index, unsigned int id)
+{
+    unsigned int low = 0;
+    unsigned int high = index->total;
+    while (low < high) {
+        unsigned int middle = low + (high - low) / 2;
+        if (index->ids[middle] < id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static void add_to_type_index(const building *b)
+{
+    type_index *index = &data.of_type[b->type];
+    unsigned int position = find_in_type_index(index, b->id);
+    if (position < index->total && index->ids[position] == b->id) {
+        return;
+    }
+    if (index->total == index->capacity) {
+        unsigned int capacity = index->capacity + TYPE_INDEX_SIZE_STEP;
+        unsigned int *ids = realloc(index->ids, capacity * sizeof(unsigned int));
+        if (!ids) {
+            log_error("Unable to allocate memory for the building type index", 0, b->id);
+            return;
+        }
+        index->ids = ids;
+        index->capacity = capacity;
+    }
+    memmove(&index->ids[position + 1], &index->ids[position], (index->total - position) * sizeof(unsigned int));
+    index->ids[position] = b->id;
+    index->total++;
+    index->changes++;
+}
+
+static void remove_from_type_index(const building *b)
+{
+    type_index *index = &data.of_type[b->type];
+    unsigned int position = find_in_type_index(index, b->id);
+    if (position == index->total || index->ids[position] != b->id) {
+        return;
+    }
+    index->total--;
+    index->changes++;
+    memmove(&index->ids[position], &index->ids[position + 1], (index->total - position) * sizeof(unsigned int));
+}
+
+static void clear_type_indexes(void)
+{
+    for (building_type type = BUILDING_NONE; type < BUILDING_TYPE_MAX; type++) {
+        data.of_type[type].total = 0;
+        data.of_type[type].changes++;
+    }
+}
+
+unsigned int building_get_all_of_type(building_type type, const unsigned int **ids)
+{
+    *ids = data.of_type[type].ids;
+    return data.of_type[type].total;
+}
+
+unsigned int building_type_change_count(building_type type)
+{
+    return data.of_type[type].changes;
+}
+
+building *building_next_of_type_after(building_type type, int building_id)
+{
+    const type_index *index = &data.of_type[type];
+    unsigned int position = find_in_type_index(index, building_id + 1);
+    for (unsigned int i = position; i < index->total; i++) {
+        building *b = building_get(index->ids[i]);
+        if (b->state == BUILDING_STATE_IN_USE) {
+            return b;
+        }
+    }
+    for (unsigned int i = 0; i < position; i++) {
+        building *b = building_get(index->ids[i]);
+        if (b->state == BUILDING_STATE_IN_USE) {
+            return b;
+        }
+    }
+    return 0;
+}
+
 static void fill_adjacent_types(building *b)
 {
+    add_to_type_index(b);
     building *first = data.first_of_type[b->type];
     building *last = data.last_of_type[b->type];
     if (!first || !last) {
@@ -155,6 +259,7 @@ static void fill_adjacent_types(building *b)
 
 static void remove_adjacent_types(building *b)
 {
+    remove_from_type_index(b);
     building *first = data.first_of_type[b->type];
     building *last = data.last_of_type[b->type];
     if (b == first && b == last) {
@@ -212,6 +317,7 @@ building *building_create(building_type type, int x, int y)
     // subtype
     if (building_is_house(type)) {
         b->subtype.house_level = type - BUILDING_HOUSE_VACANT_LOT;
+        house_service_set_days_since_offering(b, 0);
     }
 
     b->output_resource_id = resource_get_from_industry(type);
@@ -262,12 +368,14 @@ void building_change_type(building *b, building_type type)
     remove_adjacent_types(b);
     b->type = type;
     fill_adjacent_types(b);
+    map_desirability_building_changed(b->id);
 }
 
 static void building_delete(building *b)
 {
     building_clear_related_data(b);
     remove_adjacent_types(b);
+    map_desirability_building_changed(b->id);
     int id = b->id;
     memset(b, 0, sizeof(building));
     b->id = id;
@@ -284,6 +392,9 @@ void building_clear_related_data(building *b)
     if (b->type == BUILDING_FORT) {
         formation_legion_delete_for_fort(b);
     }
+    if (b->type == BUILDING_WAREHOUSE) {
+        building_storage_index_warehouse_removed(b->id);
+    }
     if (b->type == BUILDING_TRIUMPHAL_ARCH) {
         city_buildings_remove_triumphal_arch();
         building_menu_update();
@@ -320,6 +431,11 @@ void building_update_state(void)
     {
         if (b->state == BUILDING_STATE_CREATED) {
             b->state = BUILDING_STATE_IN_USE;
+            map_desirability_building_changed(b->id);
+            if (b->type == BUILDING_WAREHOUSE) {
+                building_warehouse_update_road_access(b);
+                building_storage_index_warehouse_changed(b->id);
+            }
         }
         if (b->state == BUILDING_STATE_IN_USE && b->house_size) {
             continue;
@@ -498,6 +614,17 @@ int building_is_fort(building_type type)
         type == BUILDING_FORT_ARCHERS;
 }
 
+static void update_mothballed_warehouse(building *b)
+{
+    if (b->type != BUILDING_WAREHOUSE) {
+        return;
+    }
+    if (b->state == BUILDING_STATE_IN_USE) {
+        building_warehouse_update_road_access(b);
+    }
+    building_storage_index_warehouse_changed(b->id);
+}
+
 int building_mothball_toggle(building *b)
 {
     if (b->state == BUILDING_STATE_IN_USE) {
@@ -506,6 +633,8 @@ int building_mothball_toggle(building *b)
     } else if (b->state == BUILDING_STATE_MOTHBALLED) {
         b->state = BUILDING_STATE_IN_USE;
     }
+    update_mothballed_warehouse(b);
+    map_desirability_building_changed(b->id);
     return b->state;
 }
 
@@ -519,6 +648,8 @@ int building_mothball_set(building *b, int mothball)
     } else if (b->state == BUILDING_STATE_MOTHBALLED) {
         b->state = BUILDING_STATE_IN_USE;
     }
+    update_mothballed_warehouse(b);
+    map_desirability_building_changed(b->id);
     return b->state;
 
 }
@@ -610,6 +741,7 @@ void building_clear_all(void)
 {
     memset(data.first_of_type, 0, sizeof(data.first_of_type));
     memset(data.last_of_type, 0, sizeof(data.last_of_type));
+    clear_type_indexes();
 
     if (!array_init(data.buildings, BUILDING_ARRAY_SIZE_STEP, initialize_new_building, building_in_use) ||
         !array_next(data.buildings)) { // Ignore first building
@@ -675,6 +807,7 @@ void building_load_state(buffer *buf, buffer *sequence, buffer *corrupt_houses,
 
     memset(data.first_of_type, 0, sizeof(data.first_of_type));
     memset(data.last_of_type, 0, sizeof(data.last_of_type));
+    clear_type_indexes();
 
     int highest_id_in_use = 0;
 
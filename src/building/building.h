@@ -24,6 +24,34 @@ typedef struct order {
     } condition;
 } order;
 
+typedef enum {
+    HOUSE_SERVICE_THEATER = 0,
+    HOUSE_SERVICE_AMPHITHEATER_ACTOR,
+    HOUSE_SERVICE_AMPHITHEATER_GLADIATOR,
+    HOUSE_SERVICE_COLOSSEUM_GLADIATOR,
+    HOUSE_SERVICE_COLOSSEUM_LION,
+    HOUSE_SERVICE_ARENA_GLADIATOR,
+    HOUSE_SERVICE_ARENA_LION,
+    HOUSE_SERVICE_TAVERN_WINE,
+    HOUSE_SERVICE_TAVERN_FOOD,
+    HOUSE_SERVICE_HIPPODROME,
+    HOUSE_SERVICE_SCHOOL,
+    HOUSE_SERVICE_LIBRARY,
+    HOUSE_SERVICE_ACADEMY,
+    HOUSE_SERVICE_BARBER,
+    HOUSE_SERVICE_CLINIC,
+    HOUSE_SERVICE_BATHHOUSE,
+    HOUSE_SERVICE_HOSPITAL,
+    HOUSE_SERVICE_TEMPLE_CERES,
+    HOUSE_SERVICE_TEMPLE_NEPTUNE,
+    HOUSE_SERVICE_TEMPLE_MERCURY,
+    HOUSE_SERVICE_TEMPLE_MARS,
+    HOUSE_SERVICE_TEMPLE_VENUS,
+    HOUSE_SERVICE_PANTHEON,
+    HOUSE_SERVICE_TAX_COLLECTOR,
+    HOUSE_SERVICE_MAX
+} house_service_type;
+
 typedef struct building {
     unsigned int id;
 
@@ -38,9 +66,9 @@ typedef struct building {
     unsigned char size;
     unsigned char house_is_merged;
     unsigned char house_size;
-    unsigned char x;
-    unsigned char y;
-    short grid_offset;
+    unsigned short x;
+    unsigned short y;
+    int grid_offset;
     building_type type;
     union {
         short house_level;
@@ -50,23 +78,23 @@ typedef struct building {
         short native_meeting_center_id;
         short barracks_priority;
     } subtype;
-    unsigned char road_network_id;
+    unsigned short road_network_id;
     unsigned short created_sequence;
-    short houses_covered;
+    unsigned int houses_covered_expiry; // see house_service_houses_covered()
     short percentage_houses_covered;
     short house_population;
     short house_population_room;
     short distance_from_entry;
     short house_highest_population;
     short house_unreachable_ticks;
-    unsigned char road_access_x;
-    unsigned char road_access_y;
+    unsigned short road_access_x;
+    unsigned short road_access_y;
     short figure_id;
     short figure_id2; // labor seeker or market supplier
     short immigrant_figure_id;
     short figure_id4; // tower ballista, burning ruin prefect, doctor healing plague
     unsigned char figure_spawn_delay;
-    unsigned char days_since_offering;
+    unsigned char days_since_offering; // not used by houses, see house_service_days_since_offering()
     unsigned char figure_roam_direction;
     unsigned char has_water_access;
     short prev_part_building_id;
@@ -83,8 +111,6 @@ typedef struct building {
     short fire_duration;
     unsigned char fire_proof; // cannot catch fire or collapse
     unsigned char house_figure_generation_delay;
-    unsigned char house_tax_coverage;
-    unsigned char house_pantheon_access;
     short formation_id;
     signed char monthly_levy;
     struct {
@@ -123,24 +149,6 @@ typedef struct building {
             unsigned char play;
         } entertainment;
         struct {
-            unsigned char theater;
-            unsigned char amphitheater_actor;
-            unsigned char amphitheater_gladiator;
-            unsigned char colosseum_gladiator;
-            unsigned char colosseum_lion;
-            unsigned char hippodrome;
-            unsigned char school;
-            unsigned char library;
-            unsigned char academy;
-            unsigned char barber;
-            unsigned char clinic;
-            unsigned char bathhouse;
-            unsigned char hospital;
-            unsigned char temple_ceres;
-            unsigned char temple_neptune;
-            unsigned char temple_mercury;
-            unsigned char temple_mars;
-            unsigned char temple_venus;
             unsigned char no_space_to_expand;
             unsigned char num_foods;
             unsigned char entertainment;
@@ -181,10 +189,8 @@ typedef struct building {
         signed char native_anger;
     } sentiment;
     unsigned char show_on_problem_overlay;
-    unsigned char house_tavern_wine_access;
-    unsigned char house_tavern_food_access;
-    unsigned char house_arena_gladiator;
-    unsigned char house_arena_lion;
+    unsigned int house_service_expiry[HOUSE_SERVICE_MAX]; // see house_service_get()
+    unsigned int house_last_offering_day; // see house_service_days_since_offering()
     unsigned char is_tourism_venue;
     unsigned char tourism_disabled;
     unsigned char tourism_income;
@@ -215,6 +221,31 @@ int building_find(building_type type);
 
 building *building_first_of_type(building_type type);
 
+/**
+ * Gets the ids of all buildings of a type, in ascending order.
+ * The buildings are not filtered by state beyond being in use.
+ * @param type Building type
+ * @param ids Set to the list of ids, which is only valid until a building of that type is created or removed
+ * @return The number of ids in the list
+ */
+unsigned int building_get_all_of_type(building_type type, const unsigned int **ids);
+
+/**
+ * Gets a counter that changes every time a building of the type is created or removed
+ * @param type Building type
+ * @return The counter
+ */
+unsigned int building_type_change_count(building_type type);
+
+/**
+ * Gets the first active building of a type with an id higher than the given one,
+ * wrapping around to the lowest id when there is none
+ * @param type Building type
+ * @param building_id Id to start after
+ * @return The building, or 0 if no building of that type is active
+ */
+building *building_next_of_type_after(building_type type, int building_id);
+
 void building_change_type(building *b, building_type type);
 
 building *building_main(building *b);
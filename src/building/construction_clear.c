@@ -2,6 +2,7 @@
 
 #include "building/building.h"
 #include "building/monument.h"
+#include "building/storage_index.h"
 #include "city/warning.h"
 #include "core/config.h"
 #include "figure/roamer_preview.h"
@@ -12,6 +13,7 @@
 #include "map/bridge.h"
 #include "map/building.h"
 #include "map/building_tiles.h"
+#include "map/desirability.h"
 #include "map/grid.h"
 #include "map/property.h"
 #include "map/routing_terrain.h"
@@ -128,6 +130,7 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
                 }
                 b->state = BUILDING_STATE_DELETED_BY_PLAYER;
                 b->is_deleted = 1;
+                map_desirability_building_changed(b->id);
                 building *space = b;
                 for (int i = 0; i < 9; i++) {
                     if (space->prev_part_building_id <= 0) {
@@ -136,6 +139,7 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
                     space = building_get(space->prev_part_building_id);
                     game_undo_add_building(space);
                     space->state = BUILDING_STATE_DELETED_BY_PLAYER;
+                    map_desirability_building_changed(space->id);
                 }
                 space = b;
                 for (int i = 0; i < 9; i++) {
@@ -145,6 +149,10 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
                     }
                     game_undo_add_building(space);
                     space->state = BUILDING_STATE_DELETED_BY_PLAYER;
+                    map_desirability_building_changed(space->id);
+                }
+                if (b->type == BUILDING_WAREHOUSE || b->type == BUILDING_WAREHOUSE_SPACE) {
+                    building_storage_index_warehouse_changed(building_main(b)->id);
                 }
             } else if (map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
                 map_terrain_remove(grid_offset, TERRAIN_CLEARABLE & ~TERRAIN_HIGHWAY);
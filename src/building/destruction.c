@@ -1,6 +1,7 @@
 #include "destruction.h"
 
 #include "building/image.h"
+#include "building/storage_index.h"
 #include "city/message.h"
 #include "city/population.h"
 #include "city/ratings.h"
@@ -10,6 +11,7 @@
 #include "game/undo.h"
 #include "map/building.h"
 #include "map/building_tiles.h"
+#include "map/desirability.h"
 #include "map/grid.h"
 #include "map/property.h"
 #include "map/random.h"
@@ -51,6 +53,7 @@ static void destroy_on_fire(building *b, int plagued)
         num_tiles = 0;
     }
     map_building_tiles_remove(b->id, b->x, b->y);
+    map_desirability_building_changed(b->id);
     if (map_terrain_is(b->grid_offset, TERRAIN_WATER)) {
         b->state = BUILDING_STATE_DELETED_BY_GAME;
     } else {
@@ -104,6 +107,7 @@ static void destroy_linked_parts(building *b, int on_fire, int plagued)
         } else {
             map_building_tiles_set_rubble(part_id, part->x, part->y, part->size);
             part->state = BUILDING_STATE_RUBBLE;
+            map_desirability_building_changed(part_id);
         }
     }
 
@@ -119,11 +123,15 @@ static void destroy_linked_parts(building *b, int on_fire, int plagued)
         } else {
             map_building_tiles_set_rubble(part->id, part->x, part->y, part->size);
             part->state = BUILDING_STATE_RUBBLE;
+            map_desirability_building_changed(part->id);
         }
     }
 
     // Unlink the buildings to prevent corrupting the building table
     part = building_main(b);
+    if (part->type == BUILDING_WAREHOUSE) {
+        building_storage_index_warehouse_removed(part->id);
+    }
     for (int i = 0; i < 9 && part->id > 0; i++) {
         building *next_part = building_next(part);
         part->next_part_building_id = 0;
@@ -135,6 +143,7 @@ static void destroy_linked_parts(building *b, int on_fire, int plagued)
 void building_destroy_by_collapse(building *b)
 {
     b->state = BUILDING_STATE_RUBBLE;
+    map_desirability_building_changed(b->id);
     map_building_tiles_set_rubble(b->id, b->x, b->y, b->size);
     figure_create_explosion_cloud(b->x, b->y, b->size);
     destroy_linked_parts(b, 0, 0);
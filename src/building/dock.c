@@ -24,7 +24,7 @@
 #define MAX_DISTANCE_FOR_REROUTING 50
 
 typedef struct {
-    unsigned char road_network_id;
+    unsigned short road_network_id;
     int goods[RESOURCE_MAX];
 } handled_goods_by_road_network;
 
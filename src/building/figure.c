@@ -5,6 +5,7 @@
 #include "building/barracks.h"
 #include "building/caravanserai.h"
 #include "building/granary.h"
+#include "building/house_service.h"
 #include "building/image.h"
 #include "building/industry.h"
 #include "building/lighthouse.h"
@@ -53,7 +54,7 @@ static int worker_percentage(const building *b)
 
 static void check_labor_problem(building *b)
 {
-    if (b->houses_covered <= 0) {
+    if (house_service_houses_covered(b) <= 0) {
         b->show_on_problem_overlay = 2;
     }
 }
@@ -66,9 +67,9 @@ static void generate_labor_seeker(building *b, int x, int y)
     if (config_get(CONFIG_GP_CH_GLOBAL_LABOUR)) {
         // If it can access Rome
         if (b->distance_from_entry) {
-            b->houses_covered = 100;
+            house_service_set_houses_covered(b, 100);
         } else {
-            b->houses_covered = 0;
+            house_service_set_houses_covered(b, 0);
         }
         return;
     }
@@ -91,11 +92,11 @@ static void spawn_labor_seeker(building *b, int x, int y, int min_houses)
     if (config_get(CONFIG_GP_CH_GLOBAL_LABOUR)) {
         // If it can access Rome
         if (b->distance_from_entry) {
-            b->houses_covered = 2 * min_houses;
+            house_service_set_houses_covered(b, 2 * min_houses);
         } else {
-            b->houses_covered = 0;
+            house_service_set_houses_covered(b, 0);
         }
-    } else if (b->houses_covered <= min_houses) {
+    } else if (house_service_houses_covered(b) <= min_houses) {
         generate_labor_seeker(b, x, y);
     }
 }
@@ -481,7 +482,7 @@ static void spawn_figure_amphitheater(building *b)
     }
     map_point road;
     if (map_has_road_access(b->x, b->y, b->size, &road)) {
-        if (b->houses_covered <= 50) {
+        if (house_service_houses_covered(b) <= 50) {
             generate_labor_seeker(b, road.x, road.y);
         }
         int pct_workers = worker_percentage(b);
@@ -534,7 +535,7 @@ static void spawn_figure_theater(building *b)
     }
     map_point road;
     if (map_has_road_access(b->x, b->y, b->size, &road)) {
-        if (b->houses_covered <= 50) {
+        if (house_service_houses_covered(b) <= 50) {
             generate_labor_seeker(b, road.x, road.y);
         }
         int spawn_delay = default_spawn_delay(b);
@@ -572,7 +573,7 @@ static void spawn_figure_hippodrome(building *b)
     }
     map_point road;
     if (map_has_road_access_hippodrome_rotation(b->x, b->y, &road, b->subtype.orientation)) {
-        if (b->houses_covered <= 50) {
+        if (house_service_houses_covered(b) <= 50) {
             generate_labor_seeker(b, road.x, road.y);
         }
         int pct_workers = worker_percentage(b);
@@ -641,7 +642,7 @@ static void spawn_figure_colosseum(building *b)
     }
     map_point road;
     if (map_has_road_access(b->x, b->y, b->size, &road)) {
-        if (b->houses_covered <= 50) {
+        if (house_service_houses_covered(b) <= 50) {
             generate_labor_seeker(b, road.x, road.y);
         }
         int pct_workers = worker_percentage(b);
@@ -1179,7 +1180,7 @@ static void spawn_figure_tavern(building *b)
     check_labor_problem(b);
     map_point road;
     if (map_has_road_access(b->x, b->y, b->size, &road)) {
-        if (b->houses_covered <= 50) {
+        if (house_service_houses_covered(b) <= 50) {
             generate_labor_seeker(b, road.x, road.y);
         }
         int spawn_delay = default_spawn_delay(b) * 2;
@@ -3,6 +3,7 @@
 #include "building/destruction.h"
 #include "building/model.h"
 #include "building/storage.h"
+#include "building/storage_index.h"
 #include "building/warehouse.h"
 #include "city/finance.h"
 #include "city/map.h"
@@ -147,7 +148,10 @@ int building_granaries_add_resource(int resource, int amount, int respect_settin
         return amount;
     }
 
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
         if (b->state != BUILDING_STATE_IN_USE || b->resources[RESOURCE_NONE] <= 0) {
             continue;
         }
@@ -220,7 +224,10 @@ int building_granary_try_fullload_remove_resource(building *granary, int resourc
 int building_granaries_remove_resource(int resource, int amount)
 {
     // first go for non-getting granaries
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b && amount; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total && amount; i++) {
+        building *b = building_get(ids[i]);
         if (b->state == BUILDING_STATE_IN_USE) {
             if (!building_granary_is_getting(resource, b)) {
                 amount = building_granary_remove_resource(b, resource, amount);
@@ -228,7 +235,9 @@ int building_granaries_remove_resource(int resource, int amount)
         }
     }
     // if that doesn't work, take it anyway
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b && amount; b = b->next_of_type) {
+    total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total && amount; i++) {
+        building *b = building_get(ids[i]);
         if (b->state == BUILDING_STATE_IN_USE) {
             amount = building_granary_remove_resource(b, resource, amount);
         }
@@ -239,7 +248,10 @@ int building_granaries_remove_resource(int resource, int amount)
 int building_granaries_send_resources_to_rome(int resource, int amount)
 {
     // first go for non-getting granaries
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b && amount; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total && amount; i++) {
+        building *b = building_get(ids[i]);
         if (b->state == BUILDING_STATE_IN_USE) {
             if (!building_granary_is_getting(resource, b)) {
                 int remaining = building_granary_remove_resource(b, resource, amount);
@@ -259,7 +271,9 @@ int building_granaries_send_resources_to_rome(int resource, int amount)
         }
     }
     // if that doesn't work, take it anyway
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b && amount; b = b->next_of_type) {
+    total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total && amount; i++) {
+        building *b = building_get(ids[i]);
         if (b->state == BUILDING_STATE_IN_USE) {
             int remaining = building_granary_remove_resource(b, resource, amount);
             if (remaining < amount) {
@@ -383,7 +397,10 @@ void building_granaries_calculate_stocks(void)
         non_getting_granaries.total_storage[i] = 0;     
     }
 
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
         if (b->state != BUILDING_STATE_IN_USE || !b->has_road_access ||
             b->distance_from_entry <= 0 || b->has_plague) {
             continue;
@@ -445,13 +462,22 @@ int building_granary_for_storing(int x, int y, int resource, int road_network_id
     }
     int min_dist = INFINITE;
     int min_building_id = 0;
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
-        if (b->road_network_id != road_network_id ||
-            !building_granary_accepts_storage(b, resource, understaffed)) {
+    unsigned int total = 0;
+    const building_storage_index_entry **granaries = 0;
+    if (road_network_id >= 0) {
+        granaries = building_storage_index_get(BUILDING_GRANARY, road_network_id, &total);
+    }
+    for (unsigned int i = 0; i < total; i++) {
+        int dist = calc_maximum_distance(granaries[i]->x + 1, granaries[i]->y + 1, x, y);
+        // Farther granaries only need to be checked when the understaffed ones are counted
+        if (dist >= min_dist && !understaffed) {
+            continue;
+        }
+        building *b = building_get(granaries[i]->building_id);
+        if (!building_granary_accepts_storage(b, resource, understaffed)) {
             continue;
         }
         // there is room
-        int dist = calc_maximum_distance(b->x + 1, b->y + 1, x, y);
         if (dist < min_dist) {
             min_dist = dist;
             min_building_id = b->id;
@@ -477,7 +503,10 @@ int building_getting_granary_for_storing(int x, int y, int resource, int road_ne
     }
     int min_dist = INFINITE;
     int min_building_id = 0;
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
         if (b->state != BUILDING_STATE_IN_USE || b->has_plague) {
             continue;
         }
@@ -543,12 +572,11 @@ int building_granary_for_getting(building *src, map_point *dst, int min_amount)
                 continue;
             }
         }
-        if (building_granary_amount_can_get_from(b, src) >= min_amount) {
-            int dist = calc_maximum_distance(b->x + 1, b->y + 1, src->x + 1, src->y + 1);
-            if (dist < min_dist) {
-                min_dist = dist;
-                min_building_id = b->id;
-            }
+        int dist = calc_maximum_distance(b->x + 1, b->y + 1, src->x + 1, src->y + 1);
+        // Only granaries closer than the best one so far need their stock checked
+        if (dist < min_dist && building_granary_amount_can_get_from(b, src) >= min_amount) {
+            min_dist = dist;
+            min_building_id = b->id;
         }
     }
     building *min = building_get(min_building_id);
@@ -560,7 +588,10 @@ void building_granary_bless(void)
 {
     int min_stored = INFINITE;
     building *min_building = 0;
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
         if (b->state != BUILDING_STATE_IN_USE || b->has_plague) {
             continue;
         }
@@ -590,7 +621,10 @@ void building_granary_warehouse_curse(int big)
 {
     int max_stored = 0;
     building *max_building = 0;
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
         if (b->state != BUILDING_STATE_IN_USE || b->has_plague) {
             continue;
         }
@@ -604,7 +638,9 @@ void building_granary_warehouse_curse(int big)
             max_building = b;
         }
     }
-    for (building *b = building_first_of_type(BUILDING_WAREHOUSE); b; b = b->next_of_type) {
+    total = building_get_all_of_type(BUILDING_WAREHOUSE, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
         if (b->state != BUILDING_STATE_IN_USE || b->has_plague) {
             continue;
         }
@@ -640,7 +676,10 @@ void building_granary_warehouse_curse(int big)
 
 void building_granary_update_built_granaries_capacity(void)
 {
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
         int total_units = 0;
         for (int resource = RESOURCE_MIN_FOOD; resource < RESOURCE_MAX_FOOD; resource++) {
             total_units += b->resources[resource];
@@ -1,5 +1,6 @@
 #include "house.h"
 
+#include "building/house_service.h"
 #include "building/image.h"
 #include "city/population.h"
 #include "core/config.h"
@@ -9,6 +10,7 @@
 #include "game/undo.h"
 #include "map/building.h"
 #include "map/building_tiles.h"
+#include "map/desirability.h"
 #include "map/grid.h"
 #include "map/image.h"
 #include "map/random.h"
@@ -18,17 +20,19 @@
 
 #define OFFSET(x,y) (x + GRID_SIZE * y)
 
-static const int HOUSE_TILE_OFFSETS[] = {
-    OFFSET(0,0), OFFSET(1,0), OFFSET(0,1), OFFSET(1,1), // 2x2
-    OFFSET(2,0), OFFSET(2,1), OFFSET(2,2), OFFSET(1,2), OFFSET(0,2), // 3x3
-    OFFSET(3,0), OFFSET(3,1), OFFSET(3,2), OFFSET(3,3), OFFSET(2,3), OFFSET(1,3), OFFSET(0,3) // 4x4
+static const struct {
+    int x;
+    int y;
+} HOUSE_TILES[] = {
+    {0, 0}, {1, 0}, {0, 1}, {1, 1}, // 2x2
+    {2, 0}, {2, 1}, {2, 2}, {1, 2}, {0, 2}, // 3x3
+    {3, 0}, {3, 1}, {3, 2}, {3, 3}, {2, 3}, {1, 3}, {0, 3} // 4x4
 };
 
 static const struct {
     int x;
     int y;
-    int offset;
-} EXPAND_DIRECTION_DELTA[MAX_DIR] = { {0, 0, 0}, {-1, -1, -GRID_SIZE - 1}, {-1, 0, -1}, {0, -1, -GRID_SIZE} };
+} EXPAND_DIRECTION_DELTA[MAX_DIR] = { {0, 0}, {-1, -1}, {-1, 0}, {0, -1} };
 
 static struct {
     int x;
@@ -57,6 +61,7 @@ void building_house_change_to_vacant_lot(building *house)
 {
     house->house_population = 0;
     building_change_type(house, BUILDING_HOUSE_VACANT_LOT);
+    map_desirability_building_changed(house->id);
     house->subtype.house_level = house->type - BUILDING_HOUSE_VACANT_LOT;
     if (house->house_is_merged) {
         map_building_tiles_remove(house->id, house->x, house->y);
@@ -81,7 +86,7 @@ static void prepare_for_merge(int building_id, int num_tiles)
     merge_data.sentiment = 0;
     int grid_offset = map_grid_offset(merge_data.x, merge_data.y);
     for (int i = 0; i < num_tiles; i++) {
-        int house_offset = grid_offset + HOUSE_TILE_OFFSETS[i];
+        int house_offset = grid_offset + OFFSET(HOUSE_TILES[i].x, HOUSE_TILES[i].y);
         if (map_terrain_is(house_offset, TERRAIN_BUILDING)) {
             building *house = building_get(map_building_at(house_offset));
             if (house->id != building_id && house->house_size) {
@@ -92,6 +97,7 @@ static void prepare_for_merge(int building_id, int num_tiles)
                 }
                 house->house_population = 0;
                 house->state = BUILDING_STATE_DELETED_BY_GAME;
+                map_desirability_building_changed(house->id);
             }
         }
     }
@@ -116,6 +122,7 @@ static void merge(building *b)
     b->y = merge_data.y;
     b->grid_offset = map_grid_offset(b->x, b->y);
     b->house_is_merged = 1;
+    map_desirability_building_changed(b->id);
     map_building_tiles_add(b->id, b->x, b->y, 2, building_image_get(b), TERRAIN_BUILDING);
 }
 
@@ -131,7 +138,7 @@ void building_house_merge(building *house)
     }
     int num_house_tiles = 0;
     for (int i = 0; i < 4; i++) {
-        int tile_offset = house->grid_offset + HOUSE_TILE_OFFSETS[i];
+        int tile_offset = house->grid_offset + OFFSET(HOUSE_TILES[i].x, HOUSE_TILES[i].y);
         if (map_terrain_is(tile_offset, TERRAIN_BUILDING)) {
             building *other_house = building_get(map_building_at(tile_offset));
             if (other_house->id == house->id) {
@@ -155,10 +162,10 @@ int building_house_can_expand(building *house, int num_tiles)
 {
     // merge with other houses
     for (int dir = 0; dir < MAX_DIR; dir++) {
-        int base_offset = EXPAND_DIRECTION_DELTA[dir].offset + house->grid_offset;
+        int base_offset = OFFSET(EXPAND_DIRECTION_DELTA[dir].x, EXPAND_DIRECTION_DELTA[dir].y) + house->grid_offset;
         int ok_tiles = 0;
         for (int i = 0; i < num_tiles; i++) {
-            int tile_offset = base_offset + HOUSE_TILE_OFFSETS[i];
+            int tile_offset = base_offset + OFFSET(HOUSE_TILES[i].x, HOUSE_TILES[i].y);
             if (map_terrain_is(tile_offset, TERRAIN_BUILDING)) {
                 building *other_house = building_get(map_building_at(tile_offset));
                 if (other_house->id == house->id) {
@@ -178,10 +185,10 @@ int building_house_can_expand(building *house, int num_tiles)
     }
     // merge with houses and empty terrain
     for (int dir = 0; dir < MAX_DIR; dir++) {
-        int base_offset = EXPAND_DIRECTION_DELTA[dir].offset + house->grid_offset;
+        int base_offset = OFFSET(EXPAND_DIRECTION_DELTA[dir].x, EXPAND_DIRECTION_DELTA[dir].y) + house->grid_offset;
         int ok_tiles = 0;
         for (int i = 0; i < num_tiles; i++) {
-            int tile_offset = base_offset + HOUSE_TILE_OFFSETS[i];
+            int tile_offset = base_offset + OFFSET(HOUSE_TILES[i].x, HOUSE_TILES[i].y);
             if (!map_terrain_is(tile_offset, TERRAIN_NOT_CLEAR)) {
                 ok_tiles++;
             } else if (map_terrain_is(tile_offset, TERRAIN_BUILDING)) {
@@ -203,10 +210,10 @@ int building_house_can_expand(building *house, int num_tiles)
     }
     // merge with houses, empty terrain and gardens
     for (int dir = 0; dir < MAX_DIR; dir++) {
-        int base_offset = EXPAND_DIRECTION_DELTA[dir].offset + house->grid_offset;
+        int base_offset = OFFSET(EXPAND_DIRECTION_DELTA[dir].x, EXPAND_DIRECTION_DELTA[dir].y) + house->grid_offset;
         int ok_tiles = 0;
         for (int i = 0; i < num_tiles; i++) {
-            int tile_offset = base_offset + HOUSE_TILE_OFFSETS[i];
+            int tile_offset = base_offset + OFFSET(HOUSE_TILES[i].x, HOUSE_TILES[i].y);
             if (!map_terrain_is(tile_offset, TERRAIN_NOT_CLEAR)) {
                 ok_tiles++;
             } else if (map_terrain_is(tile_offset, TERRAIN_BUILDING)) {
@@ -233,31 +240,31 @@ int building_house_can_expand(building *house, int num_tiles)
     return 0;
 }
 
+static const house_service_type split_house_services[] = {
+    HOUSE_SERVICE_ACADEMY, HOUSE_SERVICE_AMPHITHEATER_ACTOR,
+    HOUSE_SERVICE_AMPHITHEATER_GLADIATOR, HOUSE_SERVICE_BARBER,
+    HOUSE_SERVICE_BATHHOUSE, HOUSE_SERVICE_CLINIC,
+    HOUSE_SERVICE_COLOSSEUM_GLADIATOR, HOUSE_SERVICE_COLOSSEUM_LION,
+    HOUSE_SERVICE_HIPPODROME, HOUSE_SERVICE_HOSPITAL,
+    HOUSE_SERVICE_LIBRARY, HOUSE_SERVICE_SCHOOL,
+    HOUSE_SERVICE_TEMPLE_CERES, HOUSE_SERVICE_TEMPLE_MARS,
+    HOUSE_SERVICE_TEMPLE_MERCURY, HOUSE_SERVICE_TEMPLE_NEPTUNE,
+    HOUSE_SERVICE_TEMPLE_VENUS, HOUSE_SERVICE_THEATER
+};
+
+#define SPLIT_HOUSE_SERVICES (sizeof(split_house_services) / sizeof(house_service_type))
+
 static void copy_house_data(building *house, const building *main_house)
 {
-    house->data.house.academy = main_house->data.house.academy;
-    house->data.house.amphitheater_actor = main_house->data.house.amphitheater_actor;
-    house->data.house.amphitheater_gladiator = main_house->data.house.amphitheater_gladiator;
-    house->data.house.barber = main_house->data.house.barber;
-    house->data.house.bathhouse = main_house->data.house.bathhouse;
-    house->data.house.clinic = main_house->data.house.clinic;
-    house->data.house.colosseum_gladiator = main_house->data.house.colosseum_gladiator;
-    house->data.house.colosseum_lion = main_house->data.house.colosseum_lion;
+    for (unsigned int i = 0; i < SPLIT_HOUSE_SERVICES; i++) {
+        house_service_type service = split_house_services[i];
+        house->house_service_expiry[service] = main_house->house_service_expiry[service];
+    }
     house->data.house.education = main_house->data.house.education;
     house->data.house.entertainment = main_house->data.house.entertainment;
     house->data.house.health = main_house->data.house.health;
-    house->data.house.hippodrome = main_house->data.house.hippodrome;
-    house->data.house.hospital = main_house->data.house.hospital;
-    house->data.house.library = main_house->data.house.library;
     house->data.house.num_foods = main_house->data.house.num_foods;
     house->data.house.num_gods = main_house->data.house.num_gods;
-    house->data.house.school = main_house->data.house.school;
-    house->data.house.temple_ceres = main_house->data.house.temple_ceres;
-    house->data.house.temple_mars = main_house->data.house.temple_mars;
-    house->data.house.temple_mercury = main_house->data.house.temple_mercury;
-    house->data.house.temple_neptune = main_house->data.house.temple_neptune;
-    house->data.house.temple_venus = main_house->data.house.temple_venus;
-    house->data.house.theater = main_house->data.house.theater;
     house->sentiment.house_happiness = main_house->sentiment.house_happiness;
 }
 
@@ -290,6 +297,7 @@ static void split_size2(building *house, building_type new_type)
 
     // main tile
     building_change_type(house, new_type);
+    map_desirability_building_changed(house->id);
     house->subtype.house_level = house->type - BUILDING_HOUSE_VACANT_LOT;
     house->size = house->house_size = 1;
     house->is_close_to_water = building_is_close_to_water(house);
@@ -350,7 +358,7 @@ static void split(building *house, int num_tiles)
 {
     int grid_offset = map_grid_offset(merge_data.x, merge_data.y);
     for (int i = 0; i < num_tiles; i++) {
-        int tile_offset = grid_offset + HOUSE_TILE_OFFSETS[i];
+        int tile_offset = grid_offset + OFFSET(HOUSE_TILES[i].x, HOUSE_TILES[i].y);
         if (map_terrain_is(tile_offset, TERRAIN_BUILDING)) {
             building *other_house = building_get(map_building_at(tile_offset));
             if (other_house->id != house->id && other_house->house_size) {
@@ -538,6 +546,7 @@ void building_house_check_for_corruption(building *house)
                     house->grid_offset = grid_offset;
                     house->x = map_grid_offset_to_x(grid_offset);
                     house->y = map_grid_offset_to_y(grid_offset);
+                    map_desirability_building_changed(house->id);
                     building_totals_add_corrupted_house(0);
                     return;
                 }
@@ -545,6 +554,7 @@ void building_house_check_for_corruption(building *house)
         }
         building_totals_add_corrupted_house(1);
         house->state = BUILDING_STATE_RUBBLE;
+        map_desirability_building_changed(house->id);
     }
 }
 
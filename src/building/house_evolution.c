@@ -1,6 +1,7 @@
 #include "house_evolution.h"
 
 #include "building/house.h"
+#include "building/house_service.h"
 #include "building/model.h"
 #include "building/monument.h"
 #include "city/houses.h"
@@ -128,7 +129,7 @@ static int has_required_goods_and_services(building *house, int for_upgrade, int
     }
     // barber
     int barber = model->barber;
-    if (house->data.house.barber < barber) {
+    if (house_service_get(house, HOUSE_SERVICE_BARBER) < barber) {
         ++demands->missing.barber;
         return 0;
     }
@@ -137,7 +138,7 @@ static int has_required_goods_and_services(building *house, int for_upgrade, int
     }
     // bathhouse
     int bathhouse = model->bathhouse;
-    if (house->data.house.bathhouse < bathhouse) {
+    if (house_service_get(house, HOUSE_SERVICE_BATHHOUSE) < bathhouse) {
         ++demands->missing.bathhouse;
         return 0;
     }
@@ -193,7 +194,8 @@ static int has_required_goods_and_services(building *house, int for_upgrade, int
 static int check_requirements(building *house, house_demands *demands)
 {
     int bonus = 0;
-    if (building_monument_pantheon_module_is_active(PANTHEON_MODULE_2_HOUSING_EVOLUTION) && house->house_pantheon_access) {
+    if (building_monument_pantheon_module_is_active(PANTHEON_MODULE_2_HOUSING_EVOLUTION) &&
+        house_service_get(house, HOUSE_SERVICE_PANTHEON)) {
         bonus++;
     }
     int status = check_evolve_desirability(house, bonus);
@@ -494,7 +496,8 @@ static int evolve_large_palace(building *house, house_demands *demands)
 
 static int evolve_luxury_palace(building *house, house_demands *demands)
 {
-    int bonus = (int) (building_monument_pantheon_module_is_active(PANTHEON_MODULE_2_HOUSING_EVOLUTION) && house->house_pantheon_access);
+    int bonus = (int) (building_monument_pantheon_module_is_active(PANTHEON_MODULE_2_HOUSING_EVOLUTION) &&
+        house_service_get(house, HOUSE_SERVICE_PANTHEON));
     int status = check_evolve_desirability(house, bonus);
     if (!has_required_goods_and_services(house, 0, bonus, demands)) {
         status = DEVOLVE;
@@ -526,12 +529,14 @@ static void consume_resources(building *b)
         consumption_reduction[RESOURCE_FURNITURE] += 20;
     }
     // mercury module 2 - oil and wine reduced by 20%
-    if (b->data.house.temple_mercury && building_monument_gt_module_is_active(MERCURY_MODULE_2_OIL_WINE)) {
+    if (house_service_get(b, HOUSE_SERVICE_TEMPLE_MERCURY) &&
+        building_monument_gt_module_is_active(MERCURY_MODULE_2_OIL_WINE)) {
         consumption_reduction[RESOURCE_WINE] += 20;
         consumption_reduction[RESOURCE_OIL] += 20;
     }
     // mars module 2 - all goods reduced by 10% 
-    if (b->data.house.temple_mars && building_monument_gt_module_is_active(MARS_MODULE_2_ALL_GOODS)) {
+    if (house_service_get(b, HOUSE_SERVICE_TEMPLE_MARS) &&
+        building_monument_gt_module_is_active(MARS_MODULE_2_ALL_GOODS)) {
         consumption_reduction[RESOURCE_WINE] += 10;
         consumption_reduction[RESOURCE_OIL] += 10;
         consumption_reduction[RESOURCE_POTTERY] += 10;
@@ -597,7 +602,8 @@ void building_house_process_evolve_and_consume_goods(void)
 void building_house_determine_evolve_text(building *house, int worst_desirability_building)
 {
     int level = house->subtype.house_level;
-    if (building_monument_pantheon_module_is_active(PANTHEON_MODULE_2_HOUSING_EVOLUTION) && house->house_pantheon_access) {
+    if (building_monument_pantheon_module_is_active(PANTHEON_MODULE_2_HOUSING_EVOLUTION) &&
+        house_service_get(house, HOUSE_SERVICE_PANTHEON)) {
         level--;
     }
     level = calc_bound(level, HOUSE_MIN, HOUSE_MAX);
@@ -677,10 +683,10 @@ void building_house_determine_evolve_text(building *house, int worst_desirabilit
             house->data.house.evolve_text_id = 14;
             return;
         } else if (education == 2) {
-            if (house->data.house.school) {
+            if (house_service_get(house, HOUSE_SERVICE_SCHOOL)) {
                 house->data.house.evolve_text_id = 15;
                 return;
-            } else if (house->data.house.library) {
+            } else if (house_service_get(house, HOUSE_SERVICE_LIBRARY)) {
                 house->data.house.evolve_text_id = 16;
                 return;
             }
@@ -690,7 +696,7 @@ void building_house_determine_evolve_text(building *house, int worst_desirabilit
         }
     }
     // bathhouse
-    if (house->data.house.bathhouse < model->bathhouse) {
+    if (house_service_get(house, HOUSE_SERVICE_BATHHOUSE) < model->bathhouse) {
         house->data.house.evolve_text_id = 18;
         return;
     }
@@ -717,7 +723,7 @@ void building_house_determine_evolve_text(building *house, int worst_desirabilit
         }
     }
     // barber
-    if (house->data.house.barber < model->barber) {
+    if (house_service_get(house, HOUSE_SERVICE_BARBER) < model->barber) {
         house->data.house.evolve_text_id = 23;
         return;
     }
@@ -726,7 +732,7 @@ void building_house_determine_evolve_text(building *house, int worst_desirabilit
     if (house->data.house.health < health) {
         if (health == 1) {
             house->data.house.evolve_text_id = 24;
-        } else if (house->data.house.clinic) {
+        } else if (house_service_get(house, HOUSE_SERVICE_CLINIC)) {
             house->data.house.evolve_text_id = 25;
         } else {
             house->data.house.evolve_text_id = 26;
@@ -829,10 +835,10 @@ void building_house_determine_evolve_text(building *house, int worst_desirabilit
             house->data.house.evolve_text_id = 44;
             return;
         } else if (education == 2) {
-            if (house->data.house.school) {
+            if (house_service_get(house, HOUSE_SERVICE_SCHOOL)) {
                 house->data.house.evolve_text_id = 45;
                 return;
-            } else if (house->data.house.library) {
+            } else if (house_service_get(house, HOUSE_SERVICE_LIBRARY)) {
                 house->data.house.evolve_text_id = 46;
                 return;
             }
@@ -842,7 +848,7 @@ void building_house_determine_evolve_text(building *house, int worst_desirabilit
         }
     }
     // bathhouse
-    if (house->data.house.bathhouse < model->bathhouse) {
+    if (house_service_get(house, HOUSE_SERVICE_BATHHOUSE) < model->bathhouse) {
         house->data.house.evolve_text_id = 48;
         return;
     }
@@ -869,7 +875,7 @@ void building_house_determine_evolve_text(building *house, int worst_desirabilit
         }
     }
     // barber
-    if (house->data.house.barber < model->barber) {
+    if (house_service_get(house, HOUSE_SERVICE_BARBER) < model->barber) {
         house->data.house.evolve_text_id = 53;
         return;
     }
@@ -878,7 +884,7 @@ void building_house_determine_evolve_text(building *house, int worst_desirabilit
     if (house->data.house.health < health) {
         if (health == 1) {
             house->data.house.evolve_text_id = 54;
-        } else if (house->data.house.clinic) {
+        } else if (house_service_get(house, HOUSE_SERVICE_CLINIC)) {
             house->data.house.evolve_text_id = 55;
         } else {
             house->data.house.evolve_text_id = 56;
@@ -1,5 +1,6 @@
 #include "house_population.h"
 
+#include "building/house_service.h"
 #include "building/list.h"
 #include "building/model.h"
 #include "building/monument.h"
@@ -9,6 +10,7 @@
 #include "city/population.h"
 #include "core/calc.h"
 #include "figuretype/migrant.h"
+#include "map/desirability.h"
 
 int house_population_add_to_city(int num_people)
 {
@@ -63,7 +65,7 @@ int house_population_get_capacity(building *house)
 
     // Neptune module 2 bonus
     if (building_monument_gt_module_is_active(NEPTUNE_MODULE_2_CAPACITY_AND_WATER) &&
-        house->data.house.temple_neptune) {
+        house_service_get(house, HOUSE_SERVICE_TEMPLE_NEPTUNE)) {
         max_pop += (max_pop + 1) / 20;
     }
     return max_pop;
@@ -242,6 +244,7 @@ void house_population_evict_overcrowded(void)
             } else {
                 // house has been removed
                 b->state = BUILDING_STATE_UNDO;
+                map_desirability_building_changed(b->id);
             }
         }
     }
@@ -3,75 +3,96 @@
 #include "building/building.h"
 #include "building/monument.h"
 #include "city/culture.h"
+#include "map/desirability.h"
 
-static void decay(unsigned char *value)
+#define MAX_DAYS_SINCE_OFFERING 125
+
+// Each counter goes up by one every day, at the point in the day where the matching coverage wears off
+static struct {
+    unsigned int culture_day;
+    unsigned int tax_collector_day;
+    unsigned int houses_covered_day;
+} data;
+
+void house_service_decay_culture(void)
 {
-    if (*value > 0) {
-        *value = *value - 1;
-    } else {
-        *value = 0;
-    }
+    data.culture_day++;
 }
 
-void house_service_decay_culture(void)
+void house_service_decay_tax_collector(void)
 {
-    for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
-        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state != BUILDING_STATE_IN_USE || !b->house_size) {
-                continue;
-            }
-            decay(&b->data.house.theater);
-            decay(&b->data.house.amphitheater_actor);
-            decay(&b->data.house.amphitheater_gladiator);
-            decay(&b->data.house.colosseum_gladiator);
-            decay(&b->data.house.colosseum_lion);
-            decay(&b->house_arena_gladiator);
-            decay(&b->house_arena_lion);
-            decay(&b->house_tavern_food_access);
-            decay(&b->house_tavern_wine_access);
-            decay(&b->data.house.hippodrome);
-            decay(&b->data.house.school);
-            decay(&b->data.house.library);
-            decay(&b->data.house.academy);
-            decay(&b->data.house.barber);
-            decay(&b->data.house.clinic);
-            decay(&b->data.house.bathhouse);
-            decay(&b->data.house.hospital);
-            decay(&b->data.house.temple_ceres);
-            decay(&b->data.house.temple_neptune);
-            decay(&b->data.house.temple_mercury);
-            decay(&b->data.house.temple_mars);
-            decay(&b->data.house.temple_venus);
-            decay(&b->house_pantheon_access);
-            if (b->days_since_offering < 125) {
-                ++b->days_since_offering;
-            }
-        }
+    data.tax_collector_day++;
+}
+
+void house_service_decay_houses_covered(void)
+{
+    data.houses_covered_day++;
+}
+
+static unsigned int current_day(house_service_type service)
+{
+    return service == HOUSE_SERVICE_TAX_COLLECTOR ? data.tax_collector_day : data.culture_day;
+}
+
+static int days_until(unsigned int expiry, unsigned int day)
+{
+    int remaining = (int) (expiry - day);
+    return remaining > 0 ? remaining : 0;
+}
+
+int house_service_get(const building *b, house_service_type service)
+{
+    return days_until(b->house_service_expiry[service], current_day(service));
+}
+
+unsigned int house_service_current_day(house_service_type service)
+{
+    return current_day(service);
+}
+
+void house_service_set(building *b, house_service_type service, int value)
+{
+    b->house_service_expiry[service] = current_day(service) + (value > 0 ? value : 0);
+    if (service == HOUSE_SERVICE_TEMPLE_VENUS) {
+        // Venus coverage can change the desirability of the house
+        map_desirability_building_changed(b->id);
     }
 }
 
-void house_service_decay_tax_collector(void)
+int house_service_days_since_offering(const building *b)
 {
-    for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
-        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state == BUILDING_STATE_IN_USE && b->house_tax_coverage) {
-                b->house_tax_coverage--;
-            }
-        }
+    unsigned int days = data.culture_day - b->house_last_offering_day;
+    return days < MAX_DAYS_SINCE_OFFERING ? (int) days : MAX_DAYS_SINCE_OFFERING;
+}
+
+void house_service_set_days_since_offering(building *b, int days)
+{
+    b->house_last_offering_day = data.culture_day - days;
+}
+
+static int has_fixed_houses_covered(const building *b)
+{
+    // Towers do not lose coverage over time
+    return b->type == BUILDING_TOWER || b->type == BUILDING_WATCHTOWER;
+}
+
+int house_service_houses_covered(const building *b)
+{
+    if (has_fixed_houses_covered(b)) {
+        return (int) b->houses_covered_expiry;
     }
+    return days_until(b->houses_covered_expiry, data.houses_covered_day);
 }
 
-void house_service_decay_houses_covered(void)
+void house_service_set_houses_covered(building *b, int value)
 {
-    for (int i = 1; i < building_count(); i++) {
-        building *b = building_get(i);
-        if (b->state != BUILDING_STATE_UNUSED && b->type != BUILDING_TOWER && b->type != BUILDING_WATCHTOWER) {
-            if (b->houses_covered <= 1) {
-                b->houses_covered = 0;
-            } else {
-                b->houses_covered--;
-            }
-        }
+    if (value < 0) {
+        value = 0;
+    }
+    if (has_fixed_houses_covered(b)) {
+        b->houses_covered_expiry = value;
+    } else {
+        b->houses_covered_expiry = data.houses_covered_day + value;
     }
 }
 
@@ -92,36 +113,36 @@ void house_service_calculate_culture_aggregates(void)
             // Entertainment
             b->data.house.entertainment = 0;
 
-            if (b->data.house.theater) {
+            if (house_service_get(b, HOUSE_SERVICE_THEATER)) {
                 b->data.house.entertainment += 10;
             }
 
-            if (b->house_tavern_wine_access) {
+            if (house_service_get(b, HOUSE_SERVICE_TAVERN_WINE)) {
                 b->data.house.entertainment += 10;
-                if (b->house_tavern_food_access) {
+                if (house_service_get(b, HOUSE_SERVICE_TAVERN_FOOD)) {
                     b->data.house.entertainment += 5;
                 }
             }
 
-            if (b->data.house.amphitheater_actor) {
-                if (b->data.house.amphitheater_gladiator) {
+            if (house_service_get(b, HOUSE_SERVICE_AMPHITHEATER_ACTOR)) {
+                if (house_service_get(b, HOUSE_SERVICE_AMPHITHEATER_GLADIATOR)) {
                     b->data.house.entertainment += 15;
                 } else {
                     b->data.house.entertainment += 10;
                 }
             }
 
-            if (b->house_arena_gladiator) {
-                arena_total = b->house_arena_lion ? 20 : 10;
+            if (house_service_get(b, HOUSE_SERVICE_ARENA_GLADIATOR)) {
+                arena_total = house_service_get(b, HOUSE_SERVICE_ARENA_LION) ? 20 : 10;
             }
 
-            if (b->data.house.colosseum_gladiator) {
-                colosseum_total = b->data.house.colosseum_lion ? 25 : 15;
+            if (house_service_get(b, HOUSE_SERVICE_COLOSSEUM_GLADIATOR)) {
+                colosseum_total = house_service_get(b, HOUSE_SERVICE_COLOSSEUM_LION) ? 25 : 15;
             }
 
             b->data.house.entertainment += arena_total > colosseum_total ? arena_total : colosseum_total;
 
-            if (b->data.house.hippodrome) {
+            if (house_service_get(b, HOUSE_SERVICE_HIPPODROME)) {
                 b->data.house.entertainment += 30;
             }
 
@@ -134,17 +155,17 @@ void house_service_calculate_culture_aggregates(void)
             }
 
             // Venus Module 2 Entertainment Bonus
-            if (venus_module2 && b->data.house.temple_venus) {
+            if (venus_module2 && house_service_get(b, HOUSE_SERVICE_TEMPLE_VENUS)) {
                 b->data.house.entertainment += 10;
             }
 
             // Education
             b->data.house.education = 0;
-            if (b->data.house.school || b->data.house.library) {
+            if (house_service_get(b, HOUSE_SERVICE_SCHOOL) || house_service_get(b, HOUSE_SERVICE_LIBRARY)) {
                 b->data.house.education = 1;
-                if (b->data.house.school && b->data.house.library) {
+                if (house_service_get(b, HOUSE_SERVICE_SCHOOL) && house_service_get(b, HOUSE_SERVICE_LIBRARY)) {
                     b->data.house.education = 2;
-                    if (b->data.house.academy) {
+                    if (house_service_get(b, HOUSE_SERVICE_ACADEMY)) {
                         b->data.house.education = 3;
                     }
                 }
@@ -152,28 +173,28 @@ void house_service_calculate_culture_aggregates(void)
 
             // religion
             b->data.house.num_gods = 0;
-            if (b->data.house.temple_ceres) {
+            if (house_service_get(b, HOUSE_SERVICE_TEMPLE_CERES)) {
                 ++b->data.house.num_gods;
             }
-            if (b->data.house.temple_neptune) {
+            if (house_service_get(b, HOUSE_SERVICE_TEMPLE_NEPTUNE)) {
                 ++b->data.house.num_gods;
             }
-            if (b->data.house.temple_mercury) {
+            if (house_service_get(b, HOUSE_SERVICE_TEMPLE_MERCURY)) {
                 ++b->data.house.num_gods;
             }
-            if (b->data.house.temple_mars) {
+            if (house_service_get(b, HOUSE_SERVICE_TEMPLE_MARS)) {
                 ++b->data.house.num_gods;
             }
-            if (b->data.house.temple_venus) {
+            if (house_service_get(b, HOUSE_SERVICE_TEMPLE_VENUS)) {
                 ++b->data.house.num_gods;
             }
 
             // health
             b->data.house.health = 0;
-            if (b->data.house.clinic) {
+            if (house_service_get(b, HOUSE_SERVICE_CLINIC)) {
                 ++b->data.house.health;
             }
-            if (b->data.house.hospital) {
+            if (house_service_get(b, HOUSE_SERVICE_HOSPITAL)) {
                 ++b->data.house.health;
             }
         }
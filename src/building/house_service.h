@@ -1,12 +1,80 @@
 #ifndef BUILDING_HOUSE_SERVICE_H
 #define BUILDING_HOUSE_SERVICE_H
 
+#include "building/building.h"
+
+/**
+ * @file
+ * Service coverage of houses and the number of houses covered by each building.
+ * Coverage is stored as the day on which it runs out, so it wears off without visiting every house each day.
+ */
+
+/**
+ * Advances the day used by the culture services and by the days since the last offering
+ */
 void house_service_decay_culture(void);
 
+/**
+ * Advances the day used by the tax collector coverage
+ */
 void house_service_decay_tax_collector(void);
 
+/**
+ * Advances the day used by the number of houses covered
+ */
 void house_service_decay_houses_covered(void);
 
+/**
+ * Gets the remaining coverage of a service for a house
+ * @param b House
+ * @param service Service to get
+ * @return Remaining days of coverage, 0 if the house has no access to the service
+ */
+int house_service_get(const building *b, house_service_type service);
+
+/**
+ * Gets the day that the coverage of a service is counted against
+ * @param service Service
+ * @return The current day, which goes up by one every day
+ */
+unsigned int house_service_current_day(house_service_type service);
+
+/**
+ * Sets the coverage of a service for a house
+ * @param b House
+ * @param service Service to set
+ * @param value Days of coverage
+ */
+void house_service_set(building *b, house_service_type service, int value);
+
+/**
+ * Gets the number of days since the last offering of a house, up to 125
+ * @param b House
+ * @return The number of days
+ */
+int house_service_days_since_offering(const building *b);
+
+/**
+ * Sets the number of days since the last offering of a house
+ * @param b House
+ * @param days Number of days
+ */
+void house_service_set_days_since_offering(building *b, int days);
+
+/**
+ * Gets the number of houses covered by a building's labor seeker, which goes down every day
+ * @param b Building
+ * @return The number of houses covered
+ */
+int house_service_houses_covered(const building *b);
+
+/**
+ * Sets the number of houses covered by a building's labor seeker
+ * @param b Building
+ * @param value Number of houses covered
+ */
+void house_service_set_houses_covered(building *b, int value);
+
 void house_service_calculate_culture_aggregates(void);
 
 #endif // BUILDING_HOUSE_SERVICE_H
@@ -1,6 +1,7 @@
 #include "industry.h"
 
 #include "building/count.h"
+#include "building/house_service.h"
 #include "building/image.h"
 #include "building/list.h"
 #include "building/model.h"
@@ -159,7 +160,7 @@ static void update_city_mint_production(int new_day)
     }
 
     b->data.industry.has_raw_materials = 0;
-    if (b->houses_covered <= 0 || b->num_workers <= 0) {
+    if (house_service_houses_covered(b) <= 0 || b->num_workers <= 0) {
         return;
     }
 
@@ -259,7 +260,7 @@ void building_industry_update_production(int new_day)
             }
 
             b->data.industry.has_raw_materials = 0;
-            if (b->houses_covered <= 0 || b->num_workers <= 0 || b->strike_duration_days > 0) {
+            if (house_service_houses_covered(b) <= 0 || b->num_workers <= 0 || b->strike_duration_days > 0) {
                 continue;
             }
 
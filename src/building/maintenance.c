@@ -4,6 +4,7 @@
 #include "building/destruction.h"
 #include "building/list.h"
 #include "building/monument.h"
+#include "building/storage_index.h"
 #include "city/buildings.h"
 #include "city/map.h"
 #include "city/message.h"
@@ -19,6 +20,7 @@
 #include "game/undo.h"
 #include "map/building.h"
 #include "map/building_tiles.h"
+#include "map/desirability.h"
 #include "map/grid.h"
 #include "map/random.h"
 #include "map/road_access.h"
@@ -58,6 +60,7 @@ void building_maintenance_update_burning_ruins(void)
         if (b->fire_duration > 32) {
             game_undo_disable();
             b->state = BUILDING_STATE_RUBBLE;
+            map_desirability_building_changed(i);
             map_building_tiles_set_rubble(i, b->x, b->y, b->size);
             recalculate_terrain = 1;
             continue;
@@ -258,6 +261,7 @@ void building_maintenance_check_rome_access(void)
                         b->house_unreachable_ticks = 0;
                     }
                     b->state = BUILDING_STATE_UNDO;
+                    map_desirability_building_changed(b->id);
                 }
             } else {
                 int distance = map_routing_distance(map_grid_offset(x_road, y_road));
@@ -278,6 +282,7 @@ void building_maintenance_check_rome_access(void)
                     if (b->house_unreachable_ticks > 8) {
                         b->house_unreachable_ticks = 0;
                         b->state = BUILDING_STATE_UNDO;
+                        map_desirability_building_changed(b->id);
                     }
                 }
                 b->road_access_x = x_road;
@@ -323,6 +328,7 @@ void building_maintenance_check_rome_access(void)
             b->has_road_access = b->distance_from_entry > 0;
         }
     }
+    building_storage_index_invalidate();
     const map_tile *exit_point = city_map_exit_point();
 
     if (!map_routing_distance(exit_point->grid_offset)) {
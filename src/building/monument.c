@@ -12,6 +12,7 @@
 #include "core/log.h"
 #include "empire/city.h"
 #include "map/building_tiles.h"
+#include "map/desirability.h"
 #include "map/grid.h"
 #include "map/orientation.h"
 #include "map/road_access.h"
@@ -347,6 +348,7 @@ void building_monument_set_phase(building *b, int phase)
         return;
     }
     b->monument.phase = phase;
+    map_desirability_building_changed(b->id);
     map_building_tiles_add(b->id, b->x, b->y, b->size, building_image_get(b), TERRAIN_BUILDING);
     if (b->monument.phase != MONUMENT_FINISHED) {
         for (int resource = 0; resource < RESOURCE_MAX; resource++) {
@@ -773,6 +775,7 @@ int building_monument_is_construction_halted(building *b)
 
 int building_monument_toggle_construction_halted(building *b)
 {
+    map_desirability_building_changed(b->id);
     if (b->state == BUILDING_STATE_MOTHBALLED) {
         b->state = BUILDING_STATE_IN_USE;
         return 0;
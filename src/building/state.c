@@ -1,5 +1,6 @@
 #include "state.h"
 
+#include "building/house_service.h"
 #include "building/industry.h"
 #include "building/monument.h"
 #include "building/roadblock.h"
@@ -23,24 +24,24 @@ static void write_type_data(buffer *buf, const building *b)
     size_t buffer_index = buf->index;
 
     if (building_is_house(b->type)) {
-        buffer_write_u8(buf, b->data.house.theater);
-        buffer_write_u8(buf, b->data.house.amphitheater_actor);
-        buffer_write_u8(buf, b->data.house.amphitheater_gladiator);
-        buffer_write_u8(buf, b->data.house.colosseum_gladiator);
-        buffer_write_u8(buf, b->data.house.colosseum_lion);
-        buffer_write_u8(buf, b->data.house.hippodrome);
-        buffer_write_u8(buf, b->data.house.school);
-        buffer_write_u8(buf, b->data.house.library);
-        buffer_write_u8(buf, b->data.house.academy);
-        buffer_write_u8(buf, b->data.house.barber);
-        buffer_write_u8(buf, b->data.house.clinic);
-        buffer_write_u8(buf, b->data.house.bathhouse);
-        buffer_write_u8(buf, b->data.house.hospital);
-        buffer_write_u8(buf, b->data.house.temple_ceres);
-        buffer_write_u8(buf, b->data.house.temple_neptune);
-        buffer_write_u8(buf, b->data.house.temple_mercury);
-        buffer_write_u8(buf, b->data.house.temple_mars);
-        buffer_write_u8(buf, b->data.house.temple_venus);
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_THEATER));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_AMPHITHEATER_ACTOR));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_AMPHITHEATER_GLADIATOR));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_COLOSSEUM_GLADIATOR));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_COLOSSEUM_LION));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_HIPPODROME));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_SCHOOL));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_LIBRARY));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_ACADEMY));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_BARBER));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_CLINIC));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_BATHHOUSE));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_HOSPITAL));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_TEMPLE_CERES));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_TEMPLE_NEPTUNE));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_TEMPLE_MERCURY));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_TEMPLE_MARS));
+        buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_TEMPLE_VENUS));
         buffer_write_u8(buf, b->data.house.no_space_to_expand);
         buffer_write_u8(buf, b->data.house.num_foods);
         buffer_write_u8(buf, b->data.house.entertainment);
@@ -115,10 +116,10 @@ void building_state_save_to_buffer(buffer *buf, const building *b)
     buffer_write_i16(buf, b->grid_offset);
     buffer_write_i16(buf, b->type);
     buffer_write_i16(buf, b->subtype.house_level); // which union field we use does not matter
-    buffer_write_u8(buf, b->road_network_id);
+    buffer_write_u8(buf, b->road_network_id); // only a cache: recalculated after loading
     buffer_write_u8(buf, b->monthly_levy);
     buffer_write_u16(buf, b->created_sequence);
-    buffer_write_i16(buf, b->houses_covered);
+    buffer_write_i16(buf, house_service_houses_covered(b));
     buffer_write_i16(buf, b->percentage_houses_covered);
     buffer_write_i16(buf, b->house_population);
     buffer_write_i16(buf, b->house_population_room);
@@ -132,11 +133,11 @@ void building_state_save_to_buffer(buffer *buf, const building *b)
     buffer_write_i16(buf, b->immigrant_figure_id);
     buffer_write_i16(buf, b->figure_id4);
     buffer_write_u8(buf, b->figure_spawn_delay);
-    buffer_write_u8(buf, b->days_since_offering);
+    buffer_write_u8(buf, building_is_house(b->type) ? house_service_days_since_offering(b) : b->days_since_offering);
     buffer_write_u8(buf, b->figure_roam_direction);
     buffer_write_u8(buf, b->has_water_access);
-    buffer_write_u8(buf, b->house_tavern_wine_access);
-    buffer_write_u8(buf, b->house_tavern_food_access);
+    buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_TAVERN_WINE));
+    buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_TAVERN_FOOD));
     buffer_write_i16(buf, b->prev_part_building_id);
     buffer_write_i16(buf, b->next_part_building_id);
     buffer_write_i16(buf, 0);
@@ -152,8 +153,8 @@ void building_state_save_to_buffer(buffer *buf, const building *b)
     buffer_write_i16(buf, b->fire_duration);
     buffer_write_u8(buf, b->fire_proof);
     buffer_write_u8(buf, b->house_figure_generation_delay);
-    buffer_write_u8(buf, b->house_tax_coverage);
-    buffer_write_u8(buf, b->house_pantheon_access);
+    buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_TAX_COLLECTOR));
+    buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_PANTHEON));
     buffer_write_i16(buf, b->formation_id);
     write_type_data(buf, b);
     buffer_write_i32(buf, b->tax_income_or_storage);
@@ -173,8 +174,8 @@ void building_state_save_to_buffer(buffer *buf, const building *b)
     buffer_write_i16(buf, b->monument.phase);
 
     // Tourism
-    buffer_write_u8(buf, b->house_arena_gladiator);
-    buffer_write_u8(buf, b->house_arena_lion);
+    buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_ARENA_GLADIATOR));
+    buffer_write_u8(buf, house_service_get(b, HOUSE_SERVICE_ARENA_LION));
     buffer_write_u8(buf, b->is_tourism_venue);
     buffer_write_u8(buf, b->tourism_disabled);
     buffer_write_u8(buf, b->tourism_income);
@@ -207,6 +208,13 @@ void building_state_save_to_buffer(buffer *buf, const building *b)
     // latrines
     buffer_write_u8(buf, b->has_latrines_access);
 
+    // map positions, the original fields above only fit maps up to 181 tiles
+    buffer_write_i32(buf, b->grid_offset);
+    buffer_write_u16(buf, b->x);
+    buffer_write_u16(buf, b->y);
+    buffer_write_u16(buf, b->road_access_x);
+    buffer_write_u16(buf, b->road_access_y);
+
     // New building state code should always be added at the end to preserve savegame retrocompatibility
     // Also, don't forget to update BUILDING_STATE_CURRENT_BUFFER_SIZE and if possible, add a new macro like
     // BUILDING_STATE_NEW_FEATURE_BUFFER_SIZE with the full building state buffer size including all added features
@@ -239,24 +247,24 @@ static void read_type_data(buffer *buf, building *b, int version)
                 b->resources[resource_map_legacy_inventory(i)] = buffer_read_i16(buf);
             }
         }
-        b->data.house.theater = buffer_read_u8(buf);
-        b->data.house.amphitheater_actor = buffer_read_u8(buf);
-        b->data.house.amphitheater_gladiator = buffer_read_u8(buf);
-        b->data.house.colosseum_gladiator = buffer_read_u8(buf);
-        b->data.house.colosseum_lion = buffer_read_u8(buf);
-        b->data.house.hippodrome = buffer_read_u8(buf);
-        b->data.house.school = buffer_read_u8(buf);
-        b->data.house.library = buffer_read_u8(buf);
-        b->data.house.academy = buffer_read_u8(buf);
-        b->data.house.barber = buffer_read_u8(buf);
-        b->data.house.clinic = buffer_read_u8(buf);
-        b->data.house.bathhouse = buffer_read_u8(buf);
-        b->data.house.hospital = buffer_read_u8(buf);
-        b->data.house.temple_ceres = buffer_read_u8(buf);
-        b->data.house.temple_neptune = buffer_read_u8(buf);
-        b->data.house.temple_mercury = buffer_read_u8(buf);
-        b->data.house.temple_mars = buffer_read_u8(buf);
-        b->data.house.temple_venus = buffer_read_u8(buf);
+        house_service_set(b, HOUSE_SERVICE_THEATER, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_AMPHITHEATER_ACTOR, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_AMPHITHEATER_GLADIATOR, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_COLOSSEUM_GLADIATOR, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_COLOSSEUM_LION, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_HIPPODROME, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_SCHOOL, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_LIBRARY, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_ACADEMY, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_BARBER, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_CLINIC, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_BATHHOUSE, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_HOSPITAL, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_TEMPLE_CERES, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_TEMPLE_NEPTUNE, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_TEMPLE_MERCURY, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_TEMPLE_MARS, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_TEMPLE_VENUS, buffer_read_u8(buf));
         b->data.house.no_space_to_expand = buffer_read_u8(buf);
         b->data.house.num_foods = buffer_read_u8(buf);
         b->data.house.entertainment = buffer_read_u8(buf);
@@ -445,7 +453,7 @@ void building_state_load_from_buffer(buffer *buf, building *b, int building_buf_
     b->road_network_id = buffer_read_u8(buf);
     b->monthly_levy = buffer_read_u8(buf);
     b->created_sequence = buffer_read_u16(buf);
-    b->houses_covered = buffer_read_i16(buf);
+    house_service_set_houses_covered(b, buffer_read_i16(buf));
     b->percentage_houses_covered = buffer_read_i16(buf);
     b->house_population = buffer_read_i16(buf);
     b->house_population_room = buffer_read_i16(buf);
@@ -459,11 +467,15 @@ void building_state_load_from_buffer(buffer *buf, building *b, int building_buf_
     b->immigrant_figure_id = buffer_read_i16(buf);
     b->figure_id4 = buffer_read_i16(buf);
     b->figure_spawn_delay = buffer_read_u8(buf);
-    b->days_since_offering = buffer_read_u8(buf);
+    if (building_is_house(b->type)) {
+        house_service_set_days_since_offering(b, buffer_read_u8(buf));
+    } else {
+        b->days_since_offering = buffer_read_u8(buf);
+    }
     b->figure_roam_direction = buffer_read_u8(buf);
     b->has_water_access = buffer_read_u8(buf);
-    b->house_tavern_wine_access = buffer_read_u8(buf);
-    b->house_tavern_food_access = buffer_read_u8(buf);
+    house_service_set(b, HOUSE_SERVICE_TAVERN_WINE, buffer_read_u8(buf));
+    house_service_set(b, HOUSE_SERVICE_TAVERN_FOOD, buffer_read_u8(buf));
     b->prev_part_building_id = buffer_read_i16(buf);
     b->next_part_building_id = buffer_read_i16(buf);
     int loads_stored = buffer_read_i16(buf);
@@ -479,8 +491,8 @@ void building_state_load_from_buffer(buffer *buf, building *b, int building_buf_
     b->fire_duration = buffer_read_i16(buf);
     b->fire_proof = buffer_read_u8(buf);
     b->house_figure_generation_delay = buffer_read_u8(buf);
-    b->house_tax_coverage = buffer_read_u8(buf);
-    b->house_pantheon_access = buffer_read_u8(buf);
+    house_service_set(b, HOUSE_SERVICE_TAX_COLLECTOR, buffer_read_u8(buf));
+    house_service_set(b, HOUSE_SERVICE_PANTHEON, buffer_read_u8(buf));
     b->formation_id = buffer_read_i16(buf);
     read_type_data(buf, b, save_version);
     b->tax_income_or_storage = buffer_read_i32(buf);
@@ -569,8 +581,8 @@ void building_state_load_from_buffer(buffer *buf, building *b, int building_buf_
     }
 
     if (building_buf_size >= BUILDING_STATE_TOURISM_BUFFER_SIZE) {
-        b->house_arena_gladiator = buffer_read_u8(buf);
-        b->house_arena_lion = buffer_read_u8(buf);
+        house_service_set(b, HOUSE_SERVICE_ARENA_GLADIATOR, buffer_read_u8(buf));
+        house_service_set(b, HOUSE_SERVICE_ARENA_LION, buffer_read_u8(buf));
         b->is_tourism_venue = buffer_read_u8(buf);
         b->tourism_disabled = buffer_read_u8(buf);
         b->tourism_income = buffer_read_u8(buf);
@@ -607,6 +619,14 @@ void building_state_load_from_buffer(buffer *buf, building *b, int building_buf_
         b->has_latrines_access = buffer_read_u8(buf);
     }
 
+    if (save_version > SAVE_GAME_LAST_NARROW_MAP_POSITIONS) {
+        b->grid_offset = buffer_read_i32(buf);
+        b->x = buffer_read_u16(buf);
+        b->y = buffer_read_u16(buf);
+        b->road_access_x = buffer_read_u16(buf);
+        b->road_access_y = buffer_read_u16(buf);
+    }
+
     // Update resource requirement changes on monuments
     if (building_monument_is_monument(b) && b->monument.phase != MONUMENT_FINISHED) {
         for (resource_type resource = 0; resource < RESOURCE_MAX; resource++) {
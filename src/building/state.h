@@ -15,7 +15,8 @@
 #define BUILDING_STATE_WITHOUT_RESOURCES (BUILDING_STATE_SICKNESS - RESOURCE_MAX_LEGACY) // 126 (plus variable resource size)
 #define BUILDING_STATE_DYNAMIC_RESOURCES (BUILDING_STATE_WITHOUT_RESOURCES + BUILDING_STATE_NONSTATIC_RESOURCE_SIZE)
 #define BUILDING_STATE_LATRINES (BUILDING_STATE_DYNAMIC_RESOURCES + 9)
-#define BUILDING_STATE_CURRENT_BUFFER_SIZE  (BUILDING_STATE_LATRINES)
+#define BUILDING_STATE_WIDE_MAP_POSITIONS (BUILDING_STATE_LATRINES + 12)
+#define BUILDING_STATE_CURRENT_BUFFER_SIZE  (BUILDING_STATE_WIDE_MAP_POSITIONS)
 
 void building_state_save_to_buffer(buffer *buf, const building *b);
 
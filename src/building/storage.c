@@ -38,6 +38,7 @@ void building_storage_clear_all(void)
         !array_next(storages)) { // Ignore first storage
         log_error("Unable to create storages. The game will likely crash.", 0, 0);
     }
+    array_track_free_slots(storages, 1);
 }
 
 int building_storage_get_array_size(void)
@@ -94,6 +95,10 @@ int building_storage_restore(int storage_id)
     }
     array_item(storages, storage_id)->in_use = 1;
     if (storage_id >= storages.size) {
+        // The slots in between were trimmed away and are free again
+        for (unsigned int i = storages.size; i < (unsigned int) storage_id; i++) {
+            array_release_item(storages, i);
+        }
         storages.size = storage_id + 1;
     }
     return storage_id;
@@ -102,6 +107,7 @@ int building_storage_restore(int storage_id)
 void building_storage_delete(int storage_id)
 {
     array_item(storages, storage_id)->in_use = 0;
+    array_release_item(storages, storage_id);
     array_trim(storages);
 }
 
@@ -316,4 +322,5 @@ void building_storage_load_state(buffer *buf, int version)
     }
 
     storages.size = highest_id_in_use + 1;
+    array_track_free_slots(storages, 1);
 }
@@ -0,0 +1,327 @@
+#include "storage_index.h"
+
+#include "building/warehouse.h"
+#include "city/resource.h"
+#include "core/log.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define STORAGE_TYPES 2
+
+typedef struct {
+    building_storage_index_entry entry;
+    int stock_is_valid;
+    building_storage_index_stock stock;
+} storage_item;
+
+typedef struct {
+    building_type type;
+    storage_item *items;
+    const building_storage_index_entry **by_network; // sorted by road network, then by id
+    unsigned int total;
+    unsigned int capacity;
+    unsigned int *position_of_id; // position in items plus one, or 0 if the building is not in the list
+    unsigned int max_id;
+    unsigned int type_changes;
+    int is_valid;
+} storage_list;
+
+typedef struct {
+    short loads[RESOURCE_MAX];
+    short space[RESOURCE_MAX];
+} counted_stock;
+
+static struct {
+    storage_list lists[STORAGE_TYPES];
+    const building_storage_index_entry **results;
+    unsigned int results_capacity;
+    counted_stock *counted; // what each warehouse currently adds to the city totals, by building id
+    unsigned int counted_capacity;
+} data = {
+    .lists = { { .type = BUILDING_WAREHOUSE }, { .type = BUILDING_GRANARY } }
+};
+
+static storage_list *get_list(building_type type)
+{
+    for (int i = 0; i < STORAGE_TYPES; i++) {
+        if (data.lists[i].type == type) {
+            return &data.lists[i];
+        }
+    }
+    return 0;
+}
+
+void building_storage_index_invalidate(void)
+{
+    for (int i = 0; i < STORAGE_TYPES; i++) {
+        data.lists[i].is_valid = 0;
+    }
+}
+
+static int compare_by_network(const void *va, const void *vb)
+{
+    const building_storage_index_entry *a = *(const building_storage_index_entry **) va;
+    const building_storage_index_entry *b = *(const building_storage_index_entry **) vb;
+    if (a->road_network_id != b->road_network_id) {
+        return a->road_network_id < b->road_network_id ? -1 : 1;
+    }
+    return a->building_id < b->building_id ? -1 : a->building_id > b->building_id;
+}
+
+static int ensure_capacity(storage_list *list, unsigned int capacity)
+{
+    if (capacity <= list->capacity) {
+        return 1;
+    }
+    storage_item *items = realloc(list->items, capacity * sizeof(storage_item));
+    if (!items) {
+        return 0;
+    }
+    list->items = items;
+    const building_storage_index_entry **by_network = realloc(list->by_network,
+        capacity * sizeof(building_storage_index_entry *));
+    if (!by_network) {
+        return 0;
+    }
+    list->by_network = by_network;
+    if (capacity > data.results_capacity) {
+        const building_storage_index_entry **results = realloc(data.results,
+            capacity * sizeof(building_storage_index_entry *));
+        if (!results) {
+            return 0;
+        }
+        data.results = results;
+        data.results_capacity = capacity;
+    }
+    list->capacity = capacity;
+    return 1;
+}
+
+static int ensure_id_capacity(storage_list *list, unsigned int max_id)
+{
+    if (max_id <= list->max_id && list->position_of_id) {
+        memset(list->position_of_id, 0, (list->max_id + 1) * sizeof(unsigned int));
+        return 1;
+    }
+    unsigned int *position_of_id = realloc(list->position_of_id, (max_id + 1) * sizeof(unsigned int));
+    if (!position_of_id) {
+        return 0;
+    }
+    list->position_of_id = position_of_id;
+    list->max_id = max_id;
+    memset(list->position_of_id, 0, (max_id + 1) * sizeof(unsigned int));
+    return 1;
+}
+
+static int rebuild(storage_list *list)
+{
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(list->type, &ids);
+    // The ids are sorted, so the last one is the highest
+    unsigned int max_id = total ? ids[total - 1] : 0;
+    if (!ensure_capacity(list, total) || !ensure_id_capacity(list, max_id)) {
+        log_error("Unable to allocate memory for the storage index", 0, total);
+        list->total = 0;
+        list->is_valid = 0;
+        return 0;
+    }
+    for (unsigned int i = 0; i < total; i++) {
+        const building *b = building_get(ids[i]);
+        storage_item *item = &list->items[i];
+        item->entry.building_id = b->id;
+        item->entry.road_network_id = b->road_network_id;
+        item->entry.x = b->x;
+        item->entry.y = b->y;
+        item->stock_is_valid = 0;
+        list->by_network[i] = &item->entry;
+        list->position_of_id[b->id] = i + 1;
+    }
+    list->total = total;
+    qsort(list->by_network, total, sizeof(building_storage_index_entry *), compare_by_network);
+    list->type_changes = building_type_change_count(list->type);
+    list->is_valid = 1;
+    return 1;
+}
+
+static storage_list *get_valid_list(building_type type)
+{
+    storage_list *list = get_list(type);
+    if (!list) {
+        return 0;
+    }
+    if (!list->is_valid || list->type_changes != building_type_change_count(type)) {
+        if (!rebuild(list)) {
+            return 0;
+        }
+    }
+    return list;
+}
+
+const building_storage_index_entry **building_storage_index_get(building_type type, int road_network_id,
+    unsigned int *total)
+{
+    *total = 0;
+    storage_list *list = get_valid_list(type);
+    if (!list) {
+        return data.results;
+    }
+    if (road_network_id == -1) {
+        for (unsigned int i = 0; i < list->total; i++) {
+            data.results[i] = &list->items[i].entry;
+        }
+        *total = list->total;
+        return data.results;
+    }
+    unsigned int low = 0;
+    unsigned int high = list->total;
+    while (low < high) {
+        unsigned int middle = low + (high - low) / 2;
+        if (list->by_network[middle]->road_network_id < road_network_id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    while (low < list->total && list->by_network[low]->road_network_id == road_network_id) {
+        data.results[(*total)++] = list->by_network[low++];
+    }
+    return data.results;
+}
+
+static storage_item *find_warehouse(int warehouse_id)
+{
+    storage_list *list = get_list(BUILDING_WAREHOUSE);
+    if (!list->is_valid || list->type_changes != building_type_change_count(BUILDING_WAREHOUSE) ||
+        warehouse_id <= 0 || (unsigned int) warehouse_id > list->max_id) {
+        return 0;
+    }
+    unsigned int position = list->position_of_id[warehouse_id];
+    return position ? &list->items[position - 1] : 0;
+}
+
+
+static void calculate_stock(building *warehouse, building_storage_index_stock *stock)
+{
+    memset(stock, 0, sizeof(building_storage_index_stock));
+    stock->has_all_spaces = 1;
+    int has_empty_space = 0;
+    building *space = warehouse;
+    for (int i = 0; i < 8; i++) {
+        space = building_next(space);
+        int resource = space->subtype.warehouse_resource_id;
+        if (resource == RESOURCE_NONE) {
+            has_empty_space = 1;
+        } else if (space->resources[resource] < MAX_CARTLOADS_PER_SPACE) {
+            stock->has_room[resource] = 1;
+        }
+        if (space->id <= 0) {
+            stock->has_all_spaces = 0;
+            continue;
+        }
+        stock->loads[resource] += space->resources[resource];
+        if (resource == RESOURCE_NONE) {
+            stock->space[RESOURCE_NONE] += MAX_CARTLOADS_PER_SPACE;
+        } else {
+            stock->space[resource] += MAX_CARTLOADS_PER_SPACE - space->resources[resource];
+        }
+    }
+    if (has_empty_space) {
+        memset(stock->has_room, 1, sizeof(stock->has_room));
+    }
+}
+
+const building_storage_index_stock *building_storage_index_warehouse_stock(int warehouse_id)
+{
+    static storage_item uncached;
+    storage_item *item = find_warehouse(warehouse_id);
+    if (!item) {
+        item = &uncached;
+        item->stock_is_valid = 0;
+    }
+    if (!item->stock_is_valid) {
+        calculate_stock(building_get(warehouse_id), &item->stock);
+        item->stock_is_valid = item != &uncached;
+    }
+    return &item->stock;
+}
+
+static counted_stock *get_counted(int warehouse_id)
+{
+    if (warehouse_id <= 0) {
+        return 0;
+    }
+    if ((unsigned int) warehouse_id >= data.counted_capacity) {
+        unsigned int capacity = warehouse_id + 1 > data.counted_capacity * 2 ?
+            warehouse_id + 1 : data.counted_capacity * 2;
+        counted_stock *counted = realloc(data.counted, capacity * sizeof(counted_stock));
+        if (!counted) {
+            log_error("Unable to allocate memory for the warehouse stock counters", 0, warehouse_id);
+            return 0;
+        }
+        memset(&counted[data.counted_capacity], 0, (capacity - data.counted_capacity) * sizeof(counted_stock));
+        data.counted = counted;
+        data.counted_capacity = capacity;
+    }
+    return &data.counted[warehouse_id];
+}
+
+static void set_counted_stock(int warehouse_id, const building_storage_index_stock *stock)
+{
+    counted_stock *counted = get_counted(warehouse_id);
+    if (!counted) {
+        return;
+    }
+    for (resource_type r = RESOURCE_NONE; r < RESOURCE_MAX; r++) {
+        int loads = stock && r != RESOURCE_NONE ? stock->loads[r] : 0;
+        int space = stock ? stock->space[r] : 0;
+        if (loads != counted->loads[r] || space != counted->space[r]) {
+            city_resource_change_warehouse_stock(r, loads - counted->loads[r], space - counted->space[r]);
+            counted->loads[r] = loads;
+            counted->space[r] = space;
+        }
+    }
+}
+
+void building_storage_index_warehouse_changed(int warehouse_id)
+{
+    storage_item *item = find_warehouse(warehouse_id);
+    if (item) {
+        item->stock_is_valid = 0;
+    }
+    const building *warehouse = building_get(warehouse_id);
+    if (warehouse->type == BUILDING_WAREHOUSE && warehouse->state == BUILDING_STATE_IN_USE &&
+        warehouse->has_road_access) {
+        set_counted_stock(warehouse_id, building_storage_index_warehouse_stock(warehouse_id));
+    } else {
+        set_counted_stock(warehouse_id, 0);
+    }
+}
+
+void building_storage_index_warehouse_removed(int warehouse_id)
+{
+    set_counted_stock(warehouse_id, 0);
+}
+
+void building_storage_index_recount_warehouses(void)
+{
+    if (data.counted) {
+        memset(data.counted, 0, data.counted_capacity * sizeof(counted_stock));
+    }
+    city_resource_clear_warehouse_stocks();
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_WAREHOUSE, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building_storage_index_warehouse_changed(ids[i]);
+    }
+}
+
+int building_storage_index_warehouse_amount(int warehouse_id, resource_type resource)
+{
+    return building_storage_index_warehouse_stock(warehouse_id)->loads[resource];
+}
+
+int building_storage_index_warehouse_has_room(int warehouse_id, resource_type resource)
+{
+    return building_storage_index_warehouse_stock(warehouse_id)->has_room[resource];
+}
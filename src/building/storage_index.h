@@ -0,0 +1,85 @@
+#ifndef BUILDING_STORAGE_INDEX_H
+#define BUILDING_STORAGE_INDEX_H
+
+#include "building/building.h"
+#include "game/resource.h"
+
+/**
+ * @file
+ * Index of the warehouses and granaries by road network, used to find storage buildings
+ * without scanning every one of them. The index is rebuilt when storage buildings are
+ * created or removed and when their road networks change.
+ */
+
+typedef struct {
+    unsigned int building_id;
+    int road_network_id;
+    int x;
+    int y;
+} building_storage_index_entry;
+
+typedef struct {
+    short loads[RESOURCE_MAX]; /**< Loads of each resource in the warehouse */
+    short space[RESOURCE_MAX]; /**< Free loads in the spaces holding each resource, empty spaces count as RESOURCE_NONE */
+    unsigned char has_room[RESOURCE_MAX]; /**< Whether there is an empty space or a space with room for the resource */
+    int has_all_spaces; /**< Whether all eight spaces of the warehouse exist */
+} building_storage_index_stock;
+
+/**
+ * Marks the index as outdated. Must be called whenever the road network of a storage building changes.
+ */
+void building_storage_index_invalidate(void);
+
+/**
+ * Gets the storage buildings of a type, in ascending id order
+ * @param type BUILDING_WAREHOUSE or BUILDING_GRANARY
+ * @param road_network_id Road network the buildings must be on, or -1 for all buildings
+ * @param total Set to the number of entries
+ * @return The list of entries, which is valid until building_storage_index_get is called again
+ */
+const building_storage_index_entry **building_storage_index_get(building_type type, int road_network_id,
+    unsigned int *total);
+
+/**
+ * Marks the cached stock of a warehouse as outdated and applies the change to the city warehouse totals.
+ * Must be called whenever a warehouse space, or the state or road access of a warehouse, changes.
+ * @param warehouse_id Id of the main warehouse building
+ */
+void building_storage_index_warehouse_changed(int warehouse_id);
+
+/**
+ * Removes what a warehouse adds to the city warehouse totals. Must be called when a warehouse is destroyed.
+ * @param warehouse_id Id of the main warehouse building
+ */
+void building_storage_index_warehouse_removed(int warehouse_id);
+
+/**
+ * Counts the city warehouse totals again from all warehouses, after a game is loaded or started
+ */
+void building_storage_index_recount_warehouses(void);
+
+/**
+ * Gets the stock of a warehouse. The stock is kept per warehouse and only counted again
+ * after one of its spaces changes.
+ * @param warehouse_id Id of the main warehouse building
+ * @return The stock, which is valid until the warehouse changes
+ */
+const building_storage_index_stock *building_storage_index_warehouse_stock(int warehouse_id);
+
+/**
+ * Gets the number of loads of a resource in a warehouse, from the cached stock
+ * @param warehouse_id Id of the main warehouse building
+ * @param resource Resource to get
+ * @return The number of loads
+ */
+int building_storage_index_warehouse_amount(int warehouse_id, resource_type resource);
+
+/**
+ * Checks whether a warehouse has an empty space or a space with room for the resource, from the cached stock
+ * @param warehouse_id Id of the main warehouse building
+ * @param resource Resource to check
+ * @return Boolean true if there is room
+ */
+int building_storage_index_warehouse_has_room(int warehouse_id, resource_type resource);
+
+#endif // BUILDING_STORAGE_INDEX_H
@@ -7,6 +7,7 @@
 #include "building/monument.h"
 #include "building/model.h"
 #include "building/storage.h"
+#include "building/storage_index.h"
 #include "city/finance.h"
 #include "city/resource.h"
 #include "core/calc.h"
@@ -15,12 +16,11 @@
 #include "figure/figure.h"
 #include "game/tutorial.h"
 #include "map/image.h"
+#include "map/road_access.h"
 #include "scenario/property.h"
 
 #define INFINITE 10000
 
-#define MAX_CARTLOADS_PER_SPACE 4
-
 int building_warehouse_get_space_info(building *warehouse)
 {
     int total_loads = 0;
@@ -48,18 +48,11 @@ int building_warehouse_get_space_info(building *warehouse)
 
 int building_warehouse_get_amount(building *warehouse, int resource)
 {
-    int loads = 0;
-    building *space = warehouse;
-    for (int i = 0; i < 8; i++) {
-        space = building_next(space);
-        if (space->id <= 0) {
-            return 0;
-        }
-        if (space->subtype.warehouse_resource_id && space->subtype.warehouse_resource_id == resource) {
-            loads += space->resources[resource];
-        }
+    const building_storage_index_stock *stock = building_storage_index_warehouse_stock(warehouse->id);
+    if (!stock->has_all_spaces || resource == RESOURCE_NONE) {
+        return 0;
     }
-    return loads;
+    return stock->loads[resource];
 }
 
 int building_warehouse_add_resource(building *b, int resource, int respect_settings)
@@ -107,7 +100,6 @@ int building_warehouse_add_resource(building *b, int resource, int respect_setti
             return 0;
         }
     }
-    city_resource_add_to_warehouse(resource, 1);
     b->subtype.warehouse_resource_id = resource;
     b->resources[resource]++;
     tutorial_on_add_to_warehouse();
@@ -121,7 +113,10 @@ int building_warehouses_add_resource(int resource, int amount, int respect_setti
         return 0;
     }
 
-    for (building *b = building_first_of_type(BUILDING_WAREHOUSE); b; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_WAREHOUSE, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
         if (b->state != BUILDING_STATE_IN_USE) {
             continue;
         }
@@ -156,6 +151,9 @@ int building_warehouse_try_remove_resource(building *warehouse, int resource, in
     if (warehouse->has_plague) {
         return 0;
     }
+    if (building_storage_index_warehouse_amount(warehouse->id, resource) <= 0) {
+        return 0;
+    }
     int remaining_desired = desired_amount;
     int removed_amount = 0;
     building *space = warehouse;
@@ -172,12 +170,10 @@ int building_warehouse_try_remove_resource(building *warehouse, int resource, in
         }
         if (space->resources[resource] > remaining_desired) {
             removed_amount += remaining_desired;
-            city_resource_remove_from_warehouse(resource, remaining_desired);
             space->resources[resource] -= remaining_desired;
             remaining_desired = 0;
         } else {
             removed_amount += space->resources[resource];
-            city_resource_remove_from_warehouse(resource, space->resources[resource]);
             remaining_desired -= space->resources[resource];
             space->resources[resource] = 0;
             space->subtype.warehouse_resource_id = RESOURCE_NONE;
@@ -201,11 +197,9 @@ void building_warehouse_remove_resource_curse(building *warehouse, int amount)
             continue;
         }
         if (space->resources[resource] > amount) {
-            city_resource_remove_from_warehouse(resource, amount);
             space->resources[resource] -= amount;
             amount = 0;
         } else {
-            city_resource_remove_from_warehouse(resource, space->resources[resource]);
             amount -= space->resources[resource];
             space->resources[resource] = 0;
             space->subtype.warehouse_resource_id = RESOURCE_NONE;
@@ -216,6 +210,7 @@ void building_warehouse_remove_resource_curse(building *warehouse, int amount)
 
 void building_warehouse_space_set_image(building *space, int resource)
 {
+    building_storage_index_warehouse_changed(building_main(space)->id);
     int image_id;
     if (building_loads_stored(space) <= 0) {
         image_id = image_group(GROUP_BUILDING_WAREHOUSE_STORAGE_EMPTY);
@@ -225,9 +220,44 @@ void building_warehouse_space_set_image(building *space, int resource)
     map_image_set(space->grid_offset, image_id);
 }
 
+void building_warehouse_update_road_access(building *warehouse)
+{
+    int has_road_access = 0;
+    if (map_has_road_access_rotation(warehouse->subtype.orientation, warehouse->x, warehouse->y,
+        warehouse->size, 0)) {
+        has_road_access = 1;
+    } else if (map_has_road_access_rotation(warehouse->subtype.orientation, warehouse->x, warehouse->y, 3, 0)) {
+        has_road_access = 2;
+    }
+    if (has_road_access) {
+        building *space = warehouse;
+        for (int i = 0; i < 8; i++) {
+            space = building_next(space);
+            if (space->id > 0 && space->state == BUILDING_STATE_IN_USE) {
+                space->has_road_access = has_road_access;
+            }
+        }
+    }
+    if (warehouse->has_road_access != has_road_access) {
+        warehouse->has_road_access = has_road_access;
+        building_storage_index_warehouse_changed(warehouse->id);
+    }
+}
+
+void building_warehouses_update_road_access(void)
+{
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_WAREHOUSE, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
+        if (b->state == BUILDING_STATE_IN_USE) {
+            building_warehouse_update_road_access(b);
+        }
+    }
+}
+
 void building_warehouse_space_add_import(building *space, int resource, int land_trader)
 {
-    city_resource_add_to_warehouse(resource, 1);
     space->resources[resource]++;
     space->subtype.warehouse_resource_id = resource;
 
@@ -239,7 +269,6 @@ void building_warehouse_space_add_import(building *space, int resource, int land
 
 void building_warehouse_space_remove_export(building *space, int resource, int land_trader)
 {
-    city_resource_remove_from_warehouse(resource, 1);
     space->resources[resource]--;
     if (space->resources[resource] <= 0) {
         space->subtype.warehouse_resource_id = RESOURCE_NONE;
@@ -253,24 +282,7 @@ void building_warehouse_space_remove_export(building *space, int resource, int l
 
 static building *get_next_warehouse(void)
 {
-    int building_id = city_resource_last_used_warehouse();
-    int wrapped_around = 0;
-    building *b = building_first_of_type(BUILDING_WAREHOUSE);
-    while (b) {
-        if (b->state == BUILDING_STATE_IN_USE && (b->id > building_id || wrapped_around)) {
-            return b;
-        }
-        if (!b->next_of_type) {
-            if (wrapped_around) {
-                return 0;
-            }
-            wrapped_around = 1;
-            b = building_first_of_type(BUILDING_WAREHOUSE);
-        } else {
-            b = b->next_of_type;
-        }
-    }
-    return 0;
+    return building_next_of_type_after(BUILDING_WAREHOUSE, city_resource_last_used_warehouse());
 }
 
 int building_warehouse_is_accepting(int resource, building *b)
@@ -487,15 +499,7 @@ int building_warehouse_accepts_storage(building *b, int resource, int *understaf
         }
         return 0;
     }
-    building *space = b;
-    for (int t = 0; t < 8; t++) {
-        space = building_next(space);
-        if (space->subtype.warehouse_resource_id == RESOURCE_NONE || // empty warehouse space
-            (space->subtype.warehouse_resource_id == resource && space->resources[resource] < MAX_CARTLOADS_PER_SPACE)) {
-            return 1;
-        }
-    }
-    return 0;
+    return building_storage_index_warehouse_has_room(b->id, resource);
 }
 
 int building_warehouse_for_storing(int src_building_id, int x, int y, int resource, int road_network_id,
@@ -503,12 +507,22 @@ int building_warehouse_for_storing(int src_building_id, int x, int y, int resour
 {
     int min_dist = INFINITE;
     int min_building_id = 0;
-    for (building *b = building_first_of_type(BUILDING_WAREHOUSE); b; b = b->next_of_type) {
-        if (b->id == src_building_id || (road_network_id != -1 && b->road_network_id != road_network_id) ||
-            !building_warehouse_accepts_storage(b, resource, understaffed)) {
+    unsigned int total;
+    const building_storage_index_entry **warehouses =
+        building_storage_index_get(BUILDING_WAREHOUSE, road_network_id, &total);
+    for (unsigned int i = 0; i < total; i++) {
+        if (warehouses[i]->building_id == src_building_id) {
+            continue;
+        }
+        int dist = calc_maximum_distance(warehouses[i]->x, warehouses[i]->y, x, y);
+        // Farther warehouses only need to be checked when the understaffed ones are counted
+        if (dist >= min_dist && !understaffed) {
+            continue;
+        }
+        building *b = building_get(warehouses[i]->building_id);
+        if (!building_warehouse_accepts_storage(b, resource, understaffed)) {
             continue;
         }
-        int dist = calc_maximum_distance(b->x, b->y, x, y);
         if (dist < min_dist) {
             min_dist = dist;
             min_building_id = b->id;
@@ -525,22 +539,17 @@ int building_warehouse_for_storing(int src_building_id, int x, int y, int resour
 
 int building_warehouse_amount_can_get_from(building *destination, int resource)
 {
-    int loads_stored = 0;
-    building *space = destination;
-    for (int t = 0; t < 8; t++) {
-        space = building_next(space);
-        if (space->id > 0 && space->subtype.warehouse_resource_id == resource) {
-            loads_stored += space->resources[resource];
-        }
-    }
-    return loads_stored;
+    return building_storage_index_warehouse_amount(destination->id, resource);
 }
 
 int building_warehouse_for_getting(building *src, int resource, map_point *dst)
 {
     int min_dist = INFINITE;
     building *min_building = 0;
-    for (building *b = building_first_of_type(BUILDING_WAREHOUSE); b; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_WAREHOUSE, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
         if (b->state != BUILDING_STATE_IN_USE || b->has_plague) {
             continue;
         }
@@ -569,13 +578,24 @@ int building_warehouse_for_getting(building *src, int resource, map_point *dst)
 
 int building_warehouse_with_resource(int x, int y, int resource, int road_network_id, int *understaffed, map_point *dst, building_storage_permission_states p)
 {
+    if (road_network_id < 0) {
+        return 0;
+    }
     int min_dist = INFINITE;
     building *min_building = 0;
-    for (building *b = building_first_of_type(BUILDING_WAREHOUSE); b; b = b->next_of_type) {
+    unsigned int total;
+    const building_storage_index_entry **warehouses =
+        building_storage_index_get(BUILDING_WAREHOUSE, road_network_id, &total);
+    for (unsigned int i = 0; i < total; i++) {
+        int loads_stored = building_storage_index_warehouse_amount(warehouses[i]->building_id, resource);
+        if (loads_stored <= 0 && !understaffed) {
+            continue;
+        }
+        building *b = building_get(warehouses[i]->building_id);
         if (b->state != BUILDING_STATE_IN_USE || b->has_plague) {
             continue;
         }
-        if (!b->has_road_access || b->distance_from_entry <= 0 || b->road_network_id != road_network_id) {
+        if (!b->has_road_access || b->distance_from_entry <= 0) {
             continue;
         }
         if (!building_storage_get_permission(p, b)) {
@@ -589,14 +609,6 @@ int building_warehouse_with_resource(int x, int y, int resource, int road_networ
             }
             continue;
         }
-        int loads_stored = 0;
-        building *space = b;
-        for (int t = 0; t < 8; t++) {
-            space = building_next(space);
-            if (space->id > 0 && space->subtype.warehouse_resource_id == resource) {
-                loads_stored += space->resources[resource];
-            }
-        }
         if (loads_stored > 0) {
             int dist = calc_maximum_distance(b->x, b->y, x, y);
             dist -= 2 * loads_stored;
@@ -625,7 +637,10 @@ static int determine_granary_accept_foods(int resources[RESOURCE_MAX_FOOD], int
         resources[i] = 0;
     }
     int can_accept = 0;
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
         if (b->state != BUILDING_STATE_IN_USE || !b->has_road_access || b->has_plague || road_network != b->road_network_id) {
             continue;
         }
@@ -654,7 +669,10 @@ static int determine_granary_get_foods(int resources[RESOURCE_MAX_FOOD], int roa
         resources[i] = 0;
     }
     int can_get = 0;
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
+    const unsigned int *ids;
+    unsigned int total = building_get_all_of_type(BUILDING_GRANARY, &ids);
+    for (unsigned int i = 0; i < total; i++) {
+        building *b = building_get(ids[i]);
         if (b->state != BUILDING_STATE_IN_USE || !b->has_road_access || b->has_plague || road_network != b->road_network_id) {
             continue;
         }
@@ -10,6 +10,8 @@
 #define HALF_WAREHOUSE 16
 #define QUARTER_WAREHOUSE 8
 
+#define MAX_CARTLOADS_PER_SPACE 4
+
 enum {
     WAREHOUSE_ROOM = 0,
     WAREHOUSE_FULL = 1,
@@ -44,6 +46,17 @@ void building_warehouse_remove_resource_curse(building *warehouse, int amount);
 
 void building_warehouse_space_set_image(building *space, int resource);
 
+/**
+ * Updates whether a warehouse has road access and counts it towards the city totals if so
+ * @param warehouse Main warehouse building
+ */
+void building_warehouse_update_road_access(building *warehouse);
+
+/**
+ * Updates the road access of all warehouses in use. Must be called when the road networks change.
+ */
+void building_warehouses_update_road_access(void);
+
 void building_warehouse_space_add_import(building *space, int resource, int land_trader);
 
 void building_warehouse_space_remove_export(building *space, int resource, int land_trader);
@@ -2,6 +2,7 @@
 
 #include "building/building.h"
 #include "building/count.h"
+#include "building/house_service.h"
 #include "building/monument.h"
 #include "city/constants.h"
 #include "city/data_private.h"
@@ -247,7 +248,7 @@ void city_culture_calculate(void)
                 city_data.culture.average_education += b->data.house.education;
                 city_data.culture.average_health += b->data.house.health;
                 city_data.culture.average_desirability += b->desirability;
-                if (b->data.house.temple_venus) {
+                if (house_service_get(b, HOUSE_SERVICE_TEMPLE_VENUS)) {
                     city_data.culture.population_with_venus_access += b->house_population;
                 }
             }
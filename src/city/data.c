@@ -113,9 +113,11 @@ static void save_main_data(buffer *main)
     buffer_write_u8(main, city_data.map.exit_point.x);
     buffer_write_u8(main, city_data.map.exit_point.y);
     buffer_write_i16(main, city_data.map.exit_point.grid_offset);
-    for (int i = 0; i < 8; i++) {
-        buffer_write_u8(main, 0);
-    }
+    // full entry and exit coordinates, the fields above only fit maps up to 255 tiles
+    buffer_write_u16(main, city_data.map.entry_point.x);
+    buffer_write_u16(main, city_data.map.entry_point.y);
+    buffer_write_u16(main, city_data.map.exit_point.x);
+    buffer_write_u16(main, city_data.map.exit_point.y);
     buffer_write_u8(main, city_data.trade.land_policy);
     buffer_write_u8(main, city_data.trade.sea_policy);
     for (int i = 0; i < RESOURCE_MAX; i++) {
@@ -569,7 +571,15 @@ static void load_main_data(buffer *main, int version)
     city_data.map.exit_point.x = buffer_read_u8(main);
     city_data.map.exit_point.y = buffer_read_u8(main);
     city_data.map.exit_point.grid_offset = buffer_read_i16(main);
-    buffer_skip(main, 8);
+    if (version > SAVE_GAME_LAST_NARROW_MAP_POSITIONS) {
+        // the grid offsets are set again from these once the map is loaded
+        city_data.map.entry_point.x = buffer_read_u16(main);
+        city_data.map.entry_point.y = buffer_read_u16(main);
+        city_data.map.exit_point.x = buffer_read_u16(main);
+        city_data.map.exit_point.y = buffer_read_u16(main);
+    } else {
+        buffer_skip(main, 8);
+    }
     city_data.trade.land_policy = buffer_read_u8(main);
     city_data.trade.sea_policy = buffer_read_u8(main);
     for (int i = 0; i < resource_total_mapped(); i++) {
@@ -2,6 +2,7 @@
 
 #include "building/building.h"
 #include "building/count.h"
+#include "building/house_service.h"
 #include "building/model.h"
 #include "building/monument.h"
 #include "city/data_private.h"
@@ -217,7 +218,8 @@ void city_finance_estimate_taxes(void)
     city_data.taxes.monthly.collected_patricians = 0;
     for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
         for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state == BUILDING_STATE_IN_USE && b->house_size && b->house_tax_coverage) {
+            if (b->state == BUILDING_STATE_IN_USE && b->house_size &&
+                house_service_get(b, HOUSE_SERVICE_TAX_COLLECTOR)) {
                 int is_patrician = b->subtype.house_level >= HOUSE_SMALL_VILLA;
                 int trm = difficulty_adjust_money(model_get_house(b->subtype.house_level)->tax_multiplier);
                 if (is_patrician) {
@@ -267,7 +269,7 @@ static void collect_monthly_taxes(void)
             city_data.population.at_level[b->subtype.house_level] += population;
 
             int tax = population * trm;
-            if (b->house_tax_coverage) {
+            if (house_service_get(b, HOUSE_SERVICE_TAX_COLLECTOR)) {
                 if (is_patrician) {
                     city_data.taxes.taxed_patricians += population;
                     city_data.taxes.monthly.collected_patricians += tax;
@@ -4,6 +4,7 @@
 #include "building/destruction.h"
 #include "building/granary.h"
 #include "building/house.h"
+#include "building/house_service.h"
 #include "building/model.h"
 #include "building/monument.h"
 #include "building/warehouse.h"
@@ -222,7 +223,7 @@ static void cause_plague(int total_people)
         for (building *b = building_first_of_type(type); b; b = next_of_type) {
             next_of_type = b->next_of_type;
             if (b->state == BUILDING_STATE_IN_USE && b->house_size && b->house_population) {
-                if (!b->data.house.clinic) {
+                if (!house_service_get(b, HOUSE_SERVICE_CLINIC)) {
                     people_to_kill -= b->house_population;
                     building_destroy_by_plague(b);
                     if (people_to_kill <= 0) {
@@ -301,27 +302,27 @@ int city_health_get_house_health_level(const building *b, int update_city_data)
 
     if (building_is_house(b->type)) {
         house_health = calc_bound(b->subtype.house_level, 0, 10);
-        if (b->data.house.clinic && b->data.house.hospital) {
+        if (house_service_get(b, HOUSE_SERVICE_CLINIC) && house_service_get(b, HOUSE_SERVICE_HOSPITAL)) {
             house_health += 50;
             if (update_city_data) {
                 city_data.health.population_access.clinic += b->house_population;
             }
-        } else if (b->data.house.hospital) {
+        } else if (house_service_get(b, HOUSE_SERVICE_HOSPITAL)) {
             house_health += 40;
-        } else if (b->data.house.clinic) {
+        } else if (house_service_get(b, HOUSE_SERVICE_CLINIC)) {
             house_health += 30;
             if (update_city_data) {
                 city_data.health.population_access.clinic += b->house_population;
             }
         }
         
-        if (b->data.house.bathhouse) {
+        if (house_service_get(b, HOUSE_SERVICE_BATHHOUSE)) {
             house_health += 15;
             if (update_city_data) {
                 city_data.health.population_access.baths += b->house_population;
             }
         }
-        if (b->data.house.barber) {
+        if (house_service_get(b, HOUSE_SERVICE_BARBER)) {
             house_health += 10;
             if (update_city_data) {
                 city_data.health.population_access.barber += b->house_population;
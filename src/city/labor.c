@@ -1,6 +1,7 @@
 #include "labor.h"
 
 #include "building/building.h"
+#include "building/house_service.h"
 #include "building/model.h"
 #include "building/monument.h"
 #include "core/config.h"
@@ -260,7 +261,7 @@ static int should_have_workers(building *b, int category, int check_access)
     }
 
     if (check_access) {
-        return b->houses_covered > 0 ? 1 : 0;
+        return house_service_houses_covered(b) > 0 ? 1 : 0;
     }
     return 1;
 }
@@ -286,7 +287,7 @@ static void calculate_workers_needed_per_category(void)
 
         city_data.labor.categories[category - 1].workers_needed += building_get_laborers(b->type);
 
-        city_data.labor.categories[category - 1].total_houses_covered += b->houses_covered;
+        city_data.labor.categories[category - 1].total_houses_covered += house_service_houses_covered(b);
         city_data.labor.categories[category - 1].buildings++;
     }
 }
@@ -403,9 +404,9 @@ static void set_building_worker_weight(void)
             } else {
                 b->percentage_houses_covered = 0;
                 
-                if (b->houses_covered) {
+                if (house_service_houses_covered(b)) {
                     b->percentage_houses_covered =
-                        calc_percentage(100 * b->houses_covered,
+                        calc_percentage(100 * house_service_houses_covered(b),
                         city_data.labor.categories[cat - 1].total_houses_covered);
                 }
             }
@@ -4,6 +4,7 @@
 #include "building/caravanserai.h"
 #include "building/count.h"
 #include "building/granary.h"
+#include "building/house_service.h"
 #include "building/industry.h"
 #include "building/model.h"
 #include "building/monument.h"
@@ -15,6 +16,7 @@
 #include "city/trade.h"
 #include "city/trade_policy.h"
 #include "core/calc.h"
+#include "core/log.h"
 #include "empire/city.h"
 #include "figure/figure.h"
 #include "figure/formation.h"
@@ -249,54 +251,50 @@ void city_resource_remove_from_granary(resource_type food, int amount)
     city_data.resource.granary_food_stored[food] -= amount;
 }
 
-void city_resource_add_to_warehouse(resource_type resource, int amount)
+void city_resource_change_warehouse_stock(resource_type resource, int loads, int space)
 {
-    city_data.resource.space_in_warehouses[resource] -= amount;
-    city_data.resource.stored_in_warehouses[resource] += amount;
+    city_data.resource.stored_in_warehouses[resource] += loads;
+    city_data.resource.space_in_warehouses[resource] += space;
 }
 
-void city_resource_remove_from_warehouse(resource_type resource, int amount)
-{
-    city_data.resource.space_in_warehouses[resource] += amount;
-    city_data.resource.stored_in_warehouses[resource] -= amount;
-}
-
-void city_resource_calculate_warehouse_stocks(void)
+void city_resource_clear_warehouse_stocks(void)
 {
     for (int i = 0; i < RESOURCE_MAX; i++) {
         city_data.resource.space_in_warehouses[i] = 0;
         city_data.resource.stored_in_warehouses[i] = 0;
     }
-    for (building *b = building_first_of_type(BUILDING_WAREHOUSE); b; b = b->next_of_type) {
-        if (b->state == BUILDING_STATE_IN_USE) {
-            b->has_road_access = 0;
-            if (map_has_road_access_rotation(b->subtype.orientation, b->x, b->y, b->size, 0)) {
-                b->has_road_access = 1;
-            } else if (map_has_road_access_rotation(b->subtype.orientation, b->x, b->y, 3, 0)) {
-                b->has_road_access = 2;
-            }
-        }
-    }
+}
+
+void city_resource_check_warehouse_stocks(void)
+{
+#ifndef NDEBUG
+    int stored[RESOURCE_MAX] = { 0 };
+    int space[RESOURCE_MAX] = { 0 };
     for (building *b = building_first_of_type(BUILDING_WAREHOUSE_SPACE); b; b = b->next_of_type) {
         if (b->state != BUILDING_STATE_IN_USE) {
             continue;
         }
         building *warehouse = building_main(b);
-        if (warehouse->state != BUILDING_STATE_IN_USE || warehouse->type != BUILDING_WAREHOUSE) {
+        if (warehouse->state != BUILDING_STATE_IN_USE || warehouse->type != BUILDING_WAREHOUSE ||
+            !warehouse->has_road_access) {
             continue;
         }
-        if (warehouse->has_road_access) {
-            b->has_road_access = warehouse->has_road_access;
-            if (b->subtype.warehouse_resource_id) {
-                int resource = b->subtype.warehouse_resource_id;
-                int loads = b->resources[resource];
-                city_data.resource.stored_in_warehouses[resource] += loads;
-                city_data.resource.space_in_warehouses[resource] += 4 - loads;
-            } else {
-                city_data.resource.space_in_warehouses[RESOURCE_NONE] += 4;
-            }
+        if (b->subtype.warehouse_resource_id) {
+            int resource = b->subtype.warehouse_resource_id;
+            int loads = b->resources[resource];
+            stored[resource] += loads;
+            space[resource] += MAX_CARTLOADS_PER_SPACE - loads;
+        } else {
+            space[RESOURCE_NONE] += MAX_CARTLOADS_PER_SPACE;
+        }
+    }
+    for (resource_type r = RESOURCE_NONE; r < RESOURCE_MAX; r++) {
+        if (stored[r] != city_data.resource.stored_in_warehouses[r] ||
+            space[r] != city_data.resource.space_in_warehouses[r]) {
+            log_error("Warehouse stock counters are out of sync for resource", 0, r);
         }
     }
+#endif
 }
 
 void city_resource_determine_available(int storable_only)
@@ -462,7 +460,7 @@ static int house_consume_food(void)
             }
             int num_types = model_get_house(b->subtype.house_level)->food_types;
             int amount_per_type;
-            if (ceres_module && b->data.house.temple_ceres) {
+            if (ceres_module && house_service_get(b, HOUSE_SERVICE_TEMPLE_CERES)) {
                 amount_per_type = calc_adjust_with_percentage(b->house_population, 40);
             } else {
                 amount_per_type = calc_adjust_with_percentage(b->house_population, 50);
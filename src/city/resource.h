@@ -66,9 +66,20 @@ void city_resource_add_produced_to_granary(int amount);
 void city_resource_add_to_granary(resource_type food, int amount);
 void city_resource_remove_from_granary(resource_type food, int amount);
 
-void city_resource_add_to_warehouse(resource_type resource, int amount);
-void city_resource_remove_from_warehouse(resource_type resource, int amount);
-void city_resource_calculate_warehouse_stocks(void);
+/**
+ * Adds the change in the stock of a counted warehouse to the city totals
+ * @param resource Resource that changed
+ * @param loads Change in the loads stored
+ * @param space Change in the free space
+ */
+void city_resource_change_warehouse_stock(resource_type resource, int loads, int space);
+void city_resource_clear_warehouse_stocks(void);
+
+/**
+ * Checks the warehouse totals against a full count of the warehouse spaces.
+ * Only does anything in debug builds, the totals are kept up to date as warehouses change.
+ */
+void city_resource_check_warehouse_stocks(void);
 
 void city_resource_determine_available(int storable_only);
 resource_type city_resource_ceres_temple_food(void);
@@ -1,6 +1,7 @@
 #include "sentiment.h"
 
 #include "building/building.h"
+#include "building/house_service.h"
 #include "building/model.h"
 #include "city/constants.h"
 #include "city/data_private.h"
@@ -289,7 +290,7 @@ void city_sentiment_update(void)
 
             int sentiment = default_sentiment;
 
-            if (b->house_tax_coverage) {
+            if (house_service_get(b, HOUSE_SERVICE_TAX_COLLECTOR)) {
                 sentiment += sentiment_contribution_taxes;
             } else {
                 sentiment += sentiment_contribution_no_tax;
@@ -335,7 +336,7 @@ void city_sentiment_update(void)
             b->house_sentiment_message = LOW_MOOD_CAUSE_NONE;
 
             if (b->sentiment.house_happiness < 80) {
-                if (b->house_tax_coverage) {
+                if (house_service_get(b, HOUSE_SERVICE_TAX_COLLECTOR)) {
                     worst_sentiment = sentiment_contribution_taxes;
                     b->house_sentiment_message = LOW_MOOD_CAUSE_HIGH_TAXES;
                 }
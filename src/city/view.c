@@ -4,6 +4,7 @@
 #include "core/calc.h"
 #include "core/config.h"
 #include "core/direction.h"
+#include "core/log.h"
 #include "editor/editor.h"
 #include "graphics/menu.h"
 #include "graphics/renderer.h"
@@ -11,6 +12,8 @@
 #include "map/image.h"
 #include "widget/minimap.h"
 
+#include <stdlib.h>
+
 #define TILE_WIDTH_PIXELS 60
 #define TILE_HEIGHT_PIXELS 30
 #define HALF_TILE_WIDTH_PIXELS 30
@@ -41,9 +44,20 @@ static struct {
         int x_pixels;
         int y_pixels;
     } selected_tile;
-} data;
+} data, onscreen_data;
+
+static int is_offscreen;
 
-static int view_to_grid_offset_lookup[VIEW_X_MAX][VIEW_Y_MAX];
+// Grid offset for each view tile. The lookup covers the current map grid,
+// or the grid of another file while the minimap preview of that file is drawn.
+static struct {
+    int *offsets;
+    int grid_size;
+} lookup;
+
+#define VIEW_X_MAX (lookup.grid_size + 3)
+#define VIEW_Y_MAX (2 * lookup.grid_size + 1)
+#define VIEW_TO_GRID_OFFSET(x, y) lookup.offsets[(x) * VIEW_Y_MAX + (y)]
 
 static void check_camera_boundaries(void)
 {
@@ -93,18 +107,28 @@ static void check_camera_boundaries(void)
     data.camera.tile.y &= ~1;
 }
 
-static void reset_lookup(void)
+static int reset_lookup(int grid_size)
 {
-    for (int y = 0; y < VIEW_Y_MAX; y++) {
-        for (int x = 0; x < VIEW_X_MAX; x++) {
-            view_to_grid_offset_lookup[x][y] = -1;
+    if (!lookup.offsets || lookup.grid_size != grid_size) {
+        int *offsets = realloc(lookup.offsets, sizeof(int) * (grid_size + 3) * (2 * grid_size + 1));
+        if (!offsets) {
+            log_error("Unable to allocate the view lookup for grid size", 0, grid_size);
+            return 0;
         }
+        lookup.offsets = offsets;
+        lookup.grid_size = grid_size;
+    }
+    for (int i = 0; i < VIEW_X_MAX * VIEW_Y_MAX; i++) {
+        lookup.offsets[i] = -1;
     }
+    return 1;
 }
 
 static void calculate_lookup(void)
 {
-    reset_lookup();
+    if (!reset_lookup(GRID_SIZE)) {
+        return;
+    }
     int y_view_start;
     int y_view_skip;
     int y_view_step;
@@ -153,9 +177,9 @@ static void calculate_lookup(void)
         for (int x = 0; x < GRID_SIZE; x++) {
             int grid_offset = x + GRID_SIZE * y;
             if (map_image_at(grid_offset) < 6) {
-                view_to_grid_offset_lookup[x_view/2][y_view] = -1;
+                VIEW_TO_GRID_OFFSET(x_view/2, y_view) = -1;
             } else {
-                view_to_grid_offset_lookup[x_view/2][y_view] = grid_offset;
+                VIEW_TO_GRID_OFFSET(x_view/2, y_view) = grid_offset;
             }
             x_view += x_view_step;
             y_view += y_view_step;
@@ -167,11 +191,14 @@ static void calculate_lookup(void)
 
 void city_view_set_custom_lookup(int start_offset, int width, int height, int border_size)
 {
-    reset_lookup();
+    int grid_size = width + border_size;
+    if (grid_size < GRID_SIZE_ORIGINAL || grid_size > GRID_SIZE_MAX || !reset_lookup(grid_size)) {
+        return;
+    }
 
     int start_x = border_size / 2;
-    int end_x = GRID_SIZE - start_x;
-    int start_y = (start_offset - start_x) / GRID_SIZE;
+    int end_x = grid_size - start_x;
+    int start_y = (start_offset - start_x) / grid_size;
     int end_y = start_y + height;
 
     int x_view_start = VIEW_X_MAX - 1 - start_y;
@@ -181,7 +208,7 @@ void city_view_set_custom_lookup(int start_offset, int width, int height, int bo
         int x_view = x_view_start + start_x;
         int y_view = y_view_start + start_x;
         for (int x = start_x; x < end_x; x++) {
-            view_to_grid_offset_lookup[x_view / 2][y_view] = x + GRID_SIZE * y;
+            VIEW_TO_GRID_OFFSET(x_view / 2, y_view) = x + grid_size * y;
             x_view++;
             y_view++;
         }
@@ -190,6 +217,12 @@ void city_view_set_custom_lookup(int start_offset, int width, int height, int bo
     }
 }
 
+void city_view_get_lookup_size(int *x_max, int *y_max)
+{
+    *x_max = VIEW_X_MAX;
+    *y_max = VIEW_Y_MAX;
+}
+
 void city_view_restore_lookup(void)
 {
     calculate_lookup();
@@ -458,7 +491,7 @@ void city_view_grid_offset_to_xy_view(int grid_offset, int *x_view, int *y_view)
     *x_view = *y_view = 0;
     for (int y = 0; y < VIEW_Y_MAX; y++) {
         for (int x = 0; x < VIEW_X_MAX; x++) {
-            if (view_to_grid_offset_lookup[x][y] == grid_offset) {
+            if (VIEW_TO_GRID_OFFSET(x, y) == grid_offset) {
                 *x_view = x;
                 *y_view = y;
                 return;
@@ -521,7 +554,7 @@ void city_view_set_selected_view_tile(const view_tile *tile)
 
 int city_view_tile_to_grid_offset(const view_tile *tile)
 {
-    int grid_offset = view_to_grid_offset_lookup[tile->x][tile->y];
+    int grid_offset = VIEW_TO_GRID_OFFSET(tile->x, tile->y);
     return grid_offset < 0 ? 0 : grid_offset;
 }
 
@@ -541,7 +574,7 @@ static int get_center_grid_offset(void)
 {
     int x_center = data.camera.tile.x + data.viewport.width_tiles / 2;
     int y_center = data.camera.tile.y + data.viewport.height_tiles / 2;
-    return view_to_grid_offset_lookup[x_center][y_center];
+    return VIEW_TO_GRID_OFFSET(x_center, y_center);
 }
 
 void city_view_rotate_left(void)
@@ -633,6 +666,57 @@ void city_view_get_viewport(int *x, int *y, int *width, int *height)
     *height = data.viewport.height_pixels;
 }
 
+void city_view_begin_offscreen(int width, int height)
+{
+    if (is_offscreen) {
+        return;
+    }
+    onscreen_data = data;
+    is_offscreen = 1;
+    data.scale = 100;
+    data.viewport.x = 0;
+    data.viewport.y = 0;
+    data.viewport.width_pixels = width;
+    data.viewport.height_pixels = height;
+    data.viewport.width_tiles = width / TILE_WIDTH_PIXELS;
+    data.viewport.height_tiles = height / HALF_TILE_HEIGHT_PIXELS;
+    graphics_renderer()->update_scale(data.scale);
+}
+
+static int divide_rounding_down(int value, int divisor)
+{
+    return value >= 0 ? value / divisor : -((divisor - 1 - value) / divisor);
+}
+
+void city_view_set_offscreen_camera(int x_pixels, int y_pixels)
+{
+    if (!is_offscreen) {
+        return;
+    }
+    // The camera is not kept within the map, so it may start above or to the left of it
+    int tile_x = divide_rounding_down(x_pixels, TILE_WIDTH_PIXELS);
+    int tile_y = divide_rounding_down(y_pixels, TILE_HEIGHT_PIXELS);
+    data.camera.tile.x = tile_x;
+    data.camera.tile.y = tile_y * 2;
+    data.camera.pixel.x = x_pixels - tile_x * TILE_WIDTH_PIXELS;
+    data.camera.pixel.y = y_pixels - tile_y * TILE_HEIGHT_PIXELS;
+}
+
+int city_view_is_offscreen(void)
+{
+    return is_offscreen;
+}
+
+void city_view_end_offscreen(void)
+{
+    if (!is_offscreen) {
+        return;
+    }
+    data = onscreen_data;
+    is_offscreen = 0;
+    graphics_renderer()->update_scale(data.scale);
+}
+
 void city_view_get_viewport_size_tiles(int *width, int *height)
 {
     *width = data.viewport.width_tiles;
@@ -711,7 +795,7 @@ void city_view_foreach_valid_map_tile(map_callback *callback)
             int x_view = data.camera.tile.x - 6;
             for (int x = 0; x < data.viewport.width_tiles + 9; x++) {
                 if (x_view >= 0 && x_view < VIEW_X_MAX) {
-                    int grid_offset = view_to_grid_offset_lookup[x_view][y_view];
+                    int grid_offset = VIEW_TO_GRID_OFFSET(x_view, y_view);
                     if (grid_offset >= 0) {
                         callback(x_graphic, y_graphic, grid_offset);
                     }
@@ -744,7 +828,7 @@ void city_view_foreach_valid_map_tile_row(map_callback *callback1, map_callback
                 x_view = data.camera.tile.x - 6;
                 for (int x = 0; x < data.viewport.width_tiles + 9; x++) {
                     if (x_view >= 0 && x_view < VIEW_X_MAX) {
-                        int grid_offset = view_to_grid_offset_lookup[x_view][y_view];
+                        int grid_offset = VIEW_TO_GRID_OFFSET(x_view, y_view);
                         if (grid_offset >= 0) {
                             callback1(x_graphic, y_graphic, grid_offset);
                         }
@@ -763,7 +847,7 @@ void city_view_foreach_valid_map_tile_row(map_callback *callback1, map_callback
                 x_view = data.camera.tile.x - 6;
                 for (int x = 0; x < data.viewport.width_tiles + 9; x++) {
                     if (x_view >= 0 && x_view < VIEW_X_MAX) {
-                        int grid_offset = view_to_grid_offset_lookup[x_view][y_view];
+                        int grid_offset = VIEW_TO_GRID_OFFSET(x_view, y_view);
                         if (grid_offset >= 0) {
                             callback2(x_graphic, y_graphic, grid_offset);
                         }
@@ -782,7 +866,7 @@ void city_view_foreach_valid_map_tile_row(map_callback *callback1, map_callback
                 x_view = data.camera.tile.x - 6;
                 for (int x = 0; x < data.viewport.width_tiles + 9; x++) {
                     if (x_view >= 0 && x_view < VIEW_X_MAX) {
-                        int grid_offset = view_to_grid_offset_lookup[x_view][y_view];
+                        int grid_offset = VIEW_TO_GRID_OFFSET(x_view, y_view);
                         if (grid_offset >= 0) {
                             callback3(x_graphic, y_graphic, grid_offset);
                         }
@@ -902,7 +986,7 @@ void city_view_foreach_minimap_tile(
         int x_abs = absolute_x - 4;
         for (int x_rel = -4; x_rel < width_tiles; x_rel++, x_abs++, x_view += 2) {
             if (x_abs >= 0 && x_abs < VIEW_X_MAX && y_abs >= 0 && y_abs < VIEW_Y_MAX) {
-                callback(x_view, y_view, view_to_grid_offset_lookup[x_abs][y_abs]);
+                callback(x_view, y_view, VIEW_TO_GRID_OFFSET(x_abs, y_abs));
             }
         }
     }
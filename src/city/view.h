@@ -2,10 +2,7 @@
 #define CITY_VIEW_H
 
 #include "core/buffer.h"
-
-// TODO get rid of these
-#define VIEW_X_MAX 165
-#define VIEW_Y_MAX 325
+#include "map/grid.h"
 
 typedef struct {
     int x;
@@ -26,6 +23,13 @@ void city_view_init(void);
 void city_view_set_custom_lookup(int start_offset, int width, int height, int border_size);
 void city_view_restore_lookup(void);
 
+/**
+ * Gets the size of the view tile lookup, which follows the grid size of the map being viewed
+ * @param x_max Width of the lookup in view tiles
+ * @param y_max Height of the lookup in view tiles
+ */
+void city_view_get_lookup_size(int *x_max, int *y_max);
+
 int city_view_orientation(void);
 
 void city_view_reset_orientation(void);
@@ -69,6 +73,13 @@ void city_view_set_viewport(int screen_width, int screen_height);
 void city_view_get_viewport(int *x, int *y, int *width, int *height);
 void city_view_get_viewport_size_tiles(int *width, int *height);
 
+// Offscreen views are drawn at 100% scale into a render target of the given size, without boundary checks,
+// and leave the on-screen view untouched
+void city_view_begin_offscreen(int width, int height);
+void city_view_set_offscreen_camera(int x_pixels, int y_pixels);
+int city_view_is_offscreen(void);
+void city_view_end_offscreen(void);
+
 int city_view_is_sidebar_collapsed(void);
 
 void city_view_start_sidebar_toggle(void);
@@ -28,3 +28,58 @@ void array_free(void **data, unsigned int blocks)
     }
     free(data);
 }
+
+void array_free_slots_add(array_free_slots *slots, unsigned int index)
+{
+    if (index < slots->first_index) {
+        return;
+    }
+    if (slots->count == slots->capacity) {
+        unsigned int new_capacity = slots->capacity ? slots->capacity * 2 : 64;
+        unsigned int *new_indexes = realloc(slots->indexes, sizeof(unsigned int) * new_capacity);
+        if (!new_indexes) {
+            // Without a complete list the free slots must be searched for again
+            slots->enabled = 0;
+            slots->count = 0;
+            return;
+        }
+        slots->indexes = new_indexes;
+        slots->capacity = new_capacity;
+    }
+    unsigned int position = slots->count++;
+    while (position > 0) {
+        unsigned int parent = (position - 1) / 2;
+        if (slots->indexes[parent] <= index) {
+            break;
+        }
+        slots->indexes[position] = slots->indexes[parent];
+        position = parent;
+    }
+    slots->indexes[position] = index;
+}
+
+void array_free_slots_remove_first(array_free_slots *slots)
+{
+    if (!slots->count) {
+        return;
+    }
+    unsigned int last = slots->indexes[--slots->count];
+    unsigned int position = 0;
+    while (1) {
+        unsigned int child = position * 2 + 1;
+        if (child >= slots->count) {
+            break;
+        }
+        if (child + 1 < slots->count && slots->indexes[child + 1] < slots->indexes[child]) {
+            child++;
+        }
+        if (last <= slots->indexes[child]) {
+            break;
+        }
+        slots->indexes[position] = slots->indexes[child];
+        position = child;
+    }
+    if (slots->count) {
+        slots->indexes[position] = last;
+    }
+}
@@ -4,6 +4,19 @@
 #include <stdlib.h>
 #include <string.h>
 
+/**
+ * This structure is private and should not be used directly
+ * A min-heap of indexes that may be free. Entries are checked against the in_use callback when they
+ * reach the top, so stale entries are simply dropped.
+ */
+typedef struct {
+    unsigned int *indexes;
+    unsigned int count;
+    unsigned int capacity;
+    unsigned int first_index;
+    int enabled;
+} array_free_slots;
+
 /**
  * Creates an array structure
  * @param T The type of item that the array holds
@@ -17,6 +30,7 @@ struct { \
     unsigned int bit_offset; \
     void (*constructor)(T *, unsigned int); \
     int (*in_use)(const T *); \
+    array_free_slots free_slots; \
 }
 
 /**
@@ -26,6 +40,7 @@ struct { \
 #define array_clear(a) \
 ( \
     array_free((void **)(a).items, (a).blocks), \
+    free((a).free_slots.indexes), \
     memset(&(a), 0, sizeof(a)) \
 )
 
@@ -81,6 +96,7 @@ struct { \
 
 /**
  * Creates a new item for the array, either by finding an available empty item or by expanding the array.
+ * The lowest free index that is not smaller than index is always picked, regardless of free slot tracking.
  * @param a The array structure
  * @param index The index upon which to start searching for a free slot. If index is greater than the array size,
  *        the array will be expanded.
@@ -95,9 +111,29 @@ struct { \
             error = 1; \
             break; \
         } \
+        array_release_item(a, (a).size - 1); \
     } \
     if (!error && (a).in_use) { \
-        for (unsigned int array_index = index; array_index < (a).size; array_index++) { \
+        int needs_search = 1; \
+        while ((a).free_slots.enabled && (a).free_slots.count) { \
+            unsigned int array_index = (a).free_slots.indexes[0]; \
+            if (array_index >= (a).size || (a).in_use(array_item(a, array_index))) { \
+                array_free_slots_remove_first(&(a).free_slots); \
+                continue; \
+            } \
+            if (array_index >= (unsigned int) (index)) { \
+                ptr = array_item(a, array_index); \
+                memset(ptr, 0, sizeof(**(a).items)); \
+                if ((a).constructor) { \
+                    (a).constructor(ptr, array_index); \
+                } \
+            } \
+            break; \
+        } \
+        if ((a).free_slots.enabled && (!(a).free_slots.count || ptr)) { \
+            needs_search = 0; \
+        } \
+        for (unsigned int array_index = index; needs_search && array_index < (a).size; array_index++) { \
             if (!(a).in_use(array_item(a, array_index))) { \
                 ptr = array_item(a, array_index); \
                 memset(ptr, 0, sizeof(**(a).items)); \
@@ -110,9 +146,44 @@ struct { \
     } \
     if (!error && !ptr) { \
         ptr = array_advance(a); \
+        if (ptr) { \
+            array_release_item(a, (a).size - 1); \
+        } \
     } \
 }
 
+/**
+ * Starts keeping track of the free slots of an array, so that new items no longer need to search for one.
+ * Every time an item stops being in use, array_release_item must be called for it.
+ * Should be called again whenever items are changed without going through array_new_item_after_index,
+ * for example after loading the array contents.
+ * Does nothing if the array has no in_use callback. Items must not be moved while tracking free slots.
+ * @param a The array structure
+ * @param first_tracked_index The first index that can be handed out as a free slot
+ */
+#define array_track_free_slots(a, first_tracked_index) \
+{ \
+    (a).free_slots.count = 0; \
+    (a).free_slots.first_index = first_tracked_index; \
+    (a).free_slots.enabled = (a).in_use != 0; \
+    for (unsigned int array_index = first_tracked_index; (a).free_slots.enabled && array_index < (a).size; array_index++) { \
+        if (!(a).in_use(array_item(a, array_index))) { \
+            array_release_item(a, array_index); \
+        } \
+    } \
+}
+
+/**
+ * Marks an array item as free for reuse. Only needed when the array is tracking free slots.
+ * Releasing an item more than once, an item that is still in use or an item below the first tracked index is harmless.
+ * @param a The array structure
+ * @param index The index of the item that stopped being in use
+ */
+#define array_release_item(a, index) \
+( \
+    (a).free_slots.enabled ? array_free_slots_add(&(a).free_slots, index) : (void) 0 \
+)
+
 /**
  * Removes an item from an array, moving the other items left and calling their constructors if applicable
  * @param a The array structure
@@ -281,6 +352,16 @@ int array_add_blocks(void ***data, unsigned int *blocks, unsigned int items_per_
  */
 void array_free(void **data, unsigned int blocks);
 
+/**
+ * This function is private and should not be used
+ */
+void array_free_slots_add(array_free_slots *slots, unsigned int index);
+
+/**
+ * This function is private and should not be used
+ */
+void array_free_slots_remove_first(array_free_slots *slots);
+
 /**
  * Private helper compile-time functions for finding the next power of two into which a number fits
  */
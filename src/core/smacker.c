@@ -30,36 +30,48 @@
 // #define BLOCK_VOID 2 - not supported
 #define BLOCK_SOLID 3
 
+// Codes up to this length are decoded with a single table lookup, longer codes continue down the tree
+#define TREE8_TABLE_BITS 8
+#define TREE16_TABLE_BITS 12
+#define MAX_TREE8_NODES 512
+#define NO_NODE -1
+
 typedef struct {
     const uint8_t *data;
     size_t length;
-    size_t index;
-    int bit_index;
+    size_t index; // next byte to load into the reservoir
+    uint64_t reservoir; // loaded bits, the next bit to read is the lowest one
+    int reservoir_bits;
+    size_t bits_read;
+    size_t total_bits;
 } bitstream;
 
-typedef struct huffnode8_t {
-    struct huffnode8_t *b[2];
+typedef struct {
+    int b[2];
     int is_leaf;
-    uint8_t value;
-} huffnode8;
+    uint16_t value;
+} huffnode;
+
+typedef struct {
+    uint32_t node; // leaf for the code, or the node to continue from when the code is longer than the table
+    uint8_t length;
+} huffcode;
 
 typedef struct hufftree8_t {
-    huffnode8 nodes[512];
+    huffnode nodes[MAX_TREE8_NODES];
     int size;
+    huffcode table[1 << TREE8_TABLE_BITS];
 } hufftree8;
 
-typedef struct huffnode16_t {
-    struct huffnode16_t *b[2];
-    int is_leaf;
-    uint16_t value;
-} huffnode16;
-
 typedef struct hufftree16_t {
-    huffnode16 *root;
+    huffnode *nodes;
+    int size;
+    int capacity;
+    huffcode *table;
     hufftree8 *low;
     hufftree8 *high;
     uint16_t escape_codes[3];
-    huffnode16 *escape_nodes[3];
+    int escape_nodes[3];
 } hufftree16;
 
 typedef struct {
@@ -95,18 +107,6 @@ struct smacker_t {
     int32_t current_frame;
 };
 
-static const uint8_t BIT_MASKS[] = {
-    0x00,
-    0x01,
-    0x03,
-    0x07,
-    0x0f,
-    0x1f,
-    0x3f,
-    0x7f,
-    0xff,
-};
-
 static const uint8_t PALETTE_MAP[64] = {
     0x00, 0x04, 0x08, 0x0C, 0x10, 0x14, 0x18, 0x1C,
     0x20, 0x24, 0x28, 0x2C, 0x30, 0x34, 0x38, 0x3C,
@@ -150,56 +150,116 @@ static bitstream *bitstream_init(bitstream *bs, const uint8_t *data, size_t len)
     bs->data = data;
     bs->length = len;
     bs->index = 0;
-    bs->bit_index = 0;
+    bs->reservoir = 0;
+    bs->reservoir_bits = 0;
+    bs->bits_read = 0;
+    bs->total_bits = len * 8;
     return bs;
 }
 
+static inline void refill(bitstream *bs)
+{
+    // Past the end of the data, the reservoir is filled with zero bits
+    while (bs->reservoir_bits <= 56) {
+        uint64_t byte = bs->index < bs->length ? bs->data[bs->index] : 0;
+        bs->reservoir |= byte << bs->reservoir_bits;
+        bs->reservoir_bits += 8;
+        bs->index++;
+    }
+}
+
+static inline unsigned int peek_bits(bitstream *bs, int num_bits)
+{
+    if (bs->reservoir_bits < num_bits) {
+        refill(bs);
+    }
+    return (unsigned int) (bs->reservoir & ((1 << num_bits) - 1));
+}
+
+static inline void skip_bits(bitstream *bs, int num_bits)
+{
+    bs->reservoir >>= num_bits;
+    bs->reservoir_bits -= num_bits;
+    bs->bits_read += num_bits;
+    if (bs->bits_read > bs->total_bits) {
+        bs->bits_read = bs->total_bits;
+    }
+}
+
 static inline int read_bit(bitstream *bs)
 {
-    if (bs->index >= bs->length) {
+    if (bs->bits_read >= bs->total_bits) {
         return 0;
     }
-    int result = bs->data[bs->index] & (1 << bs->bit_index);
-    if (++bs->bit_index >= 8) {
-        bs->index++;
-        bs->bit_index = 0;
-    }
-    return result ? 1 : 0;
+    int result = peek_bits(bs, 1);
+    skip_bits(bs, 1);
+    return result;
 }
 
 static inline uint8_t read_byte(bitstream *bs)
 {
-    if (bs->bit_index == 0) {
-        // special case: on exact byte boundary
-        if (bs->index < bs->length) {
-            return bs->data[bs->index++];
-        } else {
-            return 0;
-        }
-    }
-    if (bs->index + 1 >= bs->length) {
+    if (bs->total_bits - bs->bits_read < 8) {
         return 0;
     }
-    uint8_t value = bs->data[bs->index] >> bs->bit_index;
-    bs->index++;
-    value |= (bs->data[bs->index] & BIT_MASKS[bs->bit_index]) << (8 - bs->bit_index);
+    uint8_t value = peek_bits(bs, 8);
+    skip_bits(bs, 8);
     return value;
 }
 
+// Huffman lookup tables
+
+static void fill_table(huffcode *table, int table_bits, const huffnode *nodes, int node,
+    unsigned int code, int length)
+{
+    if (!nodes[node].is_leaf && length < table_bits) {
+        fill_table(table, table_bits, nodes, nodes[node].b[0], code, length + 1);
+        fill_table(table, table_bits, nodes, nodes[node].b[1], code | (1 << length), length + 1);
+        return;
+    }
+    // Bits are read from the lowest one up, so the code fills every entry ending in it
+    for (unsigned int rest = 0; rest < (1u << (table_bits - length)); rest++) {
+        huffcode *entry = &table[code | (rest << length)];
+        entry->node = node;
+        entry->length = length;
+    }
+}
+
+static inline const huffnode *lookup_code(bitstream *bs, const huffcode *table, int table_bits, const huffnode *nodes)
+{
+    const huffcode *entry = &table[peek_bits(bs, table_bits)];
+    skip_bits(bs, entry->length);
+    const huffnode *node = &nodes[entry->node];
+    while (!node->is_leaf) {
+        node = &nodes[node->b[read_bit(bs)]];
+    }
+    return node;
+}
+
 // 8-bit huffman tree functions
 
-static huffnode8 *build_tree8_nodes(bitstream *bs, hufftree8 *tree)
+static int build_tree8_nodes(bitstream *bs, hufftree8 *tree)
 {
-    huffnode8 *node = &tree->nodes[tree->size++];
+    if (tree->size >= MAX_TREE8_NODES) {
+        log_error("SMK: too many nodes in 8-bit tree", 0, 0);
+        return NO_NODE;
+    }
+    int id = tree->size++;
+    huffnode *node = &tree->nodes[id];
     if (read_bit(bs)) {
         node->is_leaf = 0;
         node->b[0] = build_tree8_nodes(bs, tree);
+        if (node->b[0] == NO_NODE) {
+            return NO_NODE;
+        }
         node->b[1] = build_tree8_nodes(bs, tree);
+        if (node->b[1] == NO_NODE) {
+            return NO_NODE;
+        }
     } else {
         node->is_leaf = 1;
         node->value = read_byte(bs);
     }
-    return node;
+    return id;
 }
 
 static hufftree8 *create_tree8(bitstream *bs)
@@ -210,12 +270,16 @@ static hufftree8 *create_tree8(bitstream *bs)
             log_error("SMK: no memory for 8-bit tree", 0, 0);
             return NULL;
         }
-        build_tree8_nodes(bs, tree);
+        if (build_tree8_nodes(bs, tree) == NO_NODE) {
+            free(tree);
+            return NULL;
+        }
         if (read_bit(bs) != 0) {
             log_error("SMK: 8-bit tree not closed", 0, 0);
             free(tree);
             return NULL;
         }
+        fill_table(tree->table, TREE8_TABLE_BITS, tree->nodes, 0, 0, 0);
         return tree;
     } else {
         log_info("SMK: WARN: no 8-bit tree found", 0, 0);
@@ -228,80 +292,74 @@ static void free_tree8(hufftree8 *tree)
     free(tree);
 }
 
-static uint8_t lookup_tree8(bitstream *bs, hufftree8 *tree)
+static inline uint8_t lookup_tree8(bitstream *bs, const hufftree8 *tree)
 {
-    huffnode8 *node = &tree->nodes[0];
-    while (!node->is_leaf) {
-        node = node->b[read_bit(bs)];
-    }
-    return node->value;
+    return (uint8_t) lookup_code(bs, tree->table, TREE8_TABLE_BITS, tree->nodes)->value;
 }
 
 // 16-bit huffman tree functions
 
-static void free_node16(huffnode16 *node)
-{
-    if (!node) {
-        return;
-    }
-    if (!node->is_leaf) {
-        free_node16(node->b[0]);
-        free_node16(node->b[1]);
-    }
-    free(node);
-}
-
 static void free_tree16(hufftree16 *tree)
 {
     if (!tree) {
         return;
     }
-    for (int i = 0; i < 3; i++) {
-        if (!tree->escape_nodes[i]->is_leaf) {
-            // Free manually allocated node because it's not in the tree
-            free(tree->escape_nodes[i]);
-        }
-    }
-    free_node16(tree->root);
+    free(tree->nodes);
+    free(tree->table);
     free_tree8(tree->low);
     free_tree8(tree->high);
     free(tree);
 }
 
-static huffnode16 *build_tree16_nodes(bitstream *bs, hufftree16 *tree)
+static int add_node16(hufftree16 *tree)
 {
-    huffnode16 *node = (huffnode16 *) clear_malloc(sizeof(huffnode16));
-    if (!node) {
-        log_error("SMK: no memory for 16-bit tree node", 0, 0);
-        return NULL;
+    if (tree->size >= tree->capacity) {
+        int capacity = tree->capacity ? tree->capacity * 2 : 256;
+        huffnode *nodes = (huffnode *) realloc(tree->nodes, sizeof(huffnode) * capacity);
+        if (!nodes) {
+            log_error("SMK: no memory for 16-bit tree node", 0, 0);
+            return NO_NODE;
+        }
+        tree->nodes = nodes;
+        tree->capacity = capacity;
+    }
+    huffnode *node = &tree->nodes[tree->size];
+    memset(node, 0, sizeof(huffnode));
+    return tree->size++;
+}
+
+static int build_tree16_nodes(bitstream *bs, hufftree16 *tree)
+{
+    int id = add_node16(tree);
+    if (id == NO_NODE) {
+        return NO_NODE;
     }
     if (read_bit(bs)) {
-        node->is_leaf = 0;
-        node->b[0] = build_tree16_nodes(bs, tree);
-        if (!node->b[0]) {
-            free(node);
-            return NULL;
+        // The node array may move while the children are added, so only access the node by index
+        int child = build_tree16_nodes(bs, tree);
+        if (child == NO_NODE) {
+            return NO_NODE;
         }
-        node->b[1] = build_tree16_nodes(bs, tree);
-        if (!node->b[1]) {
-            free_node16(node->b[0]);
-            free(node);
-            return NULL;
+        tree->nodes[id].b[0] = child;
+        child = build_tree16_nodes(bs, tree);
+        if (child == NO_NODE) {
+            return NO_NODE;
         }
+        tree->nodes[id].b[1] = child;
     } else {
-        node->is_leaf = 1;
         uint8_t lo_val = lookup_tree8(bs, tree->low);
         uint8_t hi_val = lookup_tree8(bs, tree->high);
         uint16_t leaf_value = lo_val | (hi_val << 8);
-        node->value = leaf_value;
+        tree->nodes[id].is_leaf = 1;
+        tree->nodes[id].value = leaf_value;
 
         for (int i = 0; i < 3; i++) {
             if (leaf_value == tree->escape_codes[i]) {
-                tree->escape_nodes[i] = node;
+                tree->escape_nodes[i] = id;
             }
         }
     }
-    return node;
+    return id;
 }
 
 static hufftree16 *create_tree16(bitstream *bs, hufftree8 *low, hufftree8 *high)
@@ -309,6 +367,8 @@ static hufftree16 *create_tree16(bitstream *bs, hufftree8 *low, hufftree8 *high)
     hufftree16 *tree = (hufftree16 *) clear_malloc(sizeof(hufftree16));
     if (!tree) {
         log_error("SMK: no memory for 16-bit tree", 0, 0);
+        free_tree8(low);
+        free_tree8(high);
         return NULL;
     }
     tree->low = low;
@@ -317,10 +377,10 @@ static hufftree16 *create_tree16(bitstream *bs, hufftree8 *low, hufftree8 *high)
         // Do not join the following two lines as it results in an optimization bug for MSVC. See PR #215
         tree->escape_codes[i] = read_byte(bs);
         tree->escape_codes[i] |= read_byte(bs) << 8;
+        tree->escape_nodes[i] = NO_NODE;
     }
-    tree->root = build_tree16_nodes(bs, tree);
-    if (!tree->root) {
-        free(tree);
+    if (build_tree16_nodes(bs, tree) == NO_NODE) {
+        free_tree16(tree);
         return NULL;
     }
     if (read_bit(bs) != 0) {
@@ -329,13 +389,22 @@ static hufftree16 *create_tree16(bitstream *bs, hufftree8 *low, hufftree8 *high)
         return NULL;
     }
     for (int i = 0; i < 3; i++) {
-        if (!tree->escape_nodes[i]) {
-            // Escape node is not in the tree: create a dummy node
-            tree->escape_nodes[i] = (huffnode16 *) clear_malloc(sizeof(huffnode16));
-            tree->escape_nodes[i]->is_leaf = 0;
-            tree->escape_nodes[i]->value = 0;
+        if (tree->escape_nodes[i] == NO_NODE) {
+            // Escape node is not in the tree: create a dummy node that cannot be reached
+            tree->escape_nodes[i] = add_node16(tree);
+            if (tree->escape_nodes[i] == NO_NODE) {
+                free_tree16(tree);
+                return NULL;
+            }
         }
     }
+    tree->table = (huffcode *) malloc(sizeof(huffcode) * (1 << TREE16_TABLE_BITS));
+    if (!tree->table) {
+        log_error("SMK: no memory for 16-bit tree table", 0, 0);
+        free_tree16(tree);
+        return NULL;
+    }
+    fill_table(tree->table, TREE16_TABLE_BITS, tree->nodes, 0, 0, 0);
     return tree;
 }
 
@@ -343,7 +412,7 @@ static void reset_escape16(hufftree16 *tree)
 {
     if (tree) {
         for (int i = 0; i < 3; i++) {
-            tree->escape_nodes[i]->value = 0;
+            tree->nodes[tree->escape_nodes[i]].value = 0;
         }
     }
 }
@@ -353,16 +422,13 @@ static uint16_t lookup_tree16(bitstream *bs, hufftree16 *tree)
     if (!tree) {
         return 0;
     }
-    huffnode16 *node = tree->root;
-    while (!node->is_leaf) {
-        node = node->b[read_bit(bs)];
-    }
+    uint16_t value = lookup_code(bs, tree->table, TREE16_TABLE_BITS, tree->nodes)->value;
 
-    uint16_t value = node->value;
-    if (value != tree->escape_nodes[0]->value) {
-        tree->escape_nodes[2]->value = tree->escape_nodes[1]->value;
-        tree->escape_nodes[1]->value = tree->escape_nodes[0]->value;
-        tree->escape_nodes[0]->value = value;
+    huffnode *nodes = tree->nodes;
+    if (value != nodes[tree->escape_nodes[0]].value) {
+        nodes[tree->escape_nodes[2]].value = nodes[tree->escape_nodes[1]].value;
+        nodes[tree->escape_nodes[1]].value = nodes[tree->escape_nodes[0]].value;
+        nodes[tree->escape_nodes[0]].value = value;
     }
     return value;
 }
@@ -4,6 +4,7 @@
 
 #include "sxml/sxml.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -18,6 +19,11 @@ typedef struct {
 
 static struct {
     xml_parser_element *elements;
+    int *next_element_with_name; // next element with the same name, in order, or -1
+    struct {
+        uint32_t mask;
+        int *slots; // first element with each name, or -1 for an empty slot
+    } element_lookup;
     const xml_parser_element **parents;
     int depth;
     int error_depth;
@@ -40,6 +46,9 @@ static struct {
     struct {
         const sxmltok_t *first;
         int size;
+        uint32_t mask;
+        int capacity;
+        int *slots; // token index of each attribute name, or -1 for an empty slot
     } attributes;
     element_text *texts;
 } data;
@@ -68,6 +77,52 @@ int xml_parser_compare_multiple(const char *string, const char *match)
     return 0;
 }
 
+static uint32_t hash_name(const char *name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t) *name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t get_table_size(int entries)
+{
+    uint32_t size = 16;
+    while (size < (uint32_t) entries * 2) {
+        size *= 2;
+    }
+    return size;
+}
+
+static int build_element_lookup(void)
+{
+    uint32_t size = get_table_size(data.total_elements);
+    data.element_lookup.slots = malloc(sizeof(int) * size);
+    data.next_element_with_name = malloc(sizeof(int) * data.total_elements);
+    if (!data.element_lookup.slots || !data.next_element_with_name) {
+        return 0;
+    }
+    data.element_lookup.mask = size - 1;
+    for (uint32_t i = 0; i < size; i++) {
+        data.element_lookup.slots[i] = -1;
+    }
+    // Elements are added from the last one, so each name's list ends up in the original order
+    for (int i = data.total_elements - 1; i >= 0; i--) {
+        const char *name = data.elements[i].name;
+        uint32_t slot = hash_name(name) & data.element_lookup.mask;
+        while (data.element_lookup.slots[slot] != -1 &&
+            strcmp(data.elements[data.element_lookup.slots[slot]].name, name) != 0) {
+            slot = (slot + 1) & data.element_lookup.mask;
+        }
+        data.next_element_with_name[i] = data.element_lookup.slots[slot];
+        data.element_lookup.slots[slot] = i;
+    }
+    return 1;
+}
+
 static void append_to_text(element_text *text_data, const char *text, int length)
 {
     if (text_data->current_size + length > text_data->capacity) {
@@ -132,10 +187,18 @@ static const xml_parser_element *get_element_from_name(const char *name)
     if (!name || !*name) {
         return 0;
     }
-    for (int i = 0; i < data.total_elements; i++) {
-        if (strcmp(name, data.elements[i].name) == 0 && is_proper_child(&data.elements[i])) {
-            return &data.elements[i];
+    uint32_t slot = hash_name(name) & data.element_lookup.mask;
+    while (data.element_lookup.slots[slot] != -1) {
+        int index = data.element_lookup.slots[slot];
+        if (strcmp(data.elements[index].name, name) == 0) {
+            for (; index != -1; index = data.next_element_with_name[index]) {
+                if (is_proper_child(&data.elements[index])) {
+                    return &data.elements[index];
+                }
+            }
+            return 0;
         }
+        slot = (slot + 1) & data.element_lookup.mask;
     }
     return 0;
 }
@@ -157,6 +220,45 @@ static int handle_attribute_value(const sxmltok_t *first, int limit)
     return i;
 }
 
+static int find_attribute_slot(const char *key)
+{
+    uint32_t slot = hash_name(key) & data.attributes.mask;
+    while (data.attributes.slots[slot] != -1 &&
+        strcmp(data.buffer.data + data.attributes.first[data.attributes.slots[slot]].startpos, key) != 0) {
+        slot = (slot + 1) & data.attributes.mask;
+    }
+    return slot;
+}
+
+static int build_attribute_lookup(unsigned int size)
+{
+    uint32_t table_size = get_table_size(size);
+    if (table_size > (uint32_t) data.attributes.capacity) {
+        int *slots = realloc(data.attributes.slots, sizeof(int) * table_size);
+        if (!slots) {
+            return 0;
+        }
+        data.attributes.slots = slots;
+        data.attributes.capacity = table_size;
+    }
+    data.attributes.mask = table_size - 1;
+    for (uint32_t i = 0; i < table_size; i++) {
+        data.attributes.slots[i] = -1;
+    }
+    for (unsigned int i = 0; i < size; i++) {
+        const sxmltok_t *current = &data.attributes.first[i];
+        if (current->type != SXML_CDATA) {
+            continue;
+        }
+        int slot = find_attribute_slot(data.buffer.data + current->startpos);
+        // When an attribute is repeated, the first one is used
+        if (data.attributes.slots[slot] == -1) {
+            data.attributes.slots[slot] = i;
+        }
+    }
+    return 1;
+}
+
 static int handle_attributes(const sxmltok_t *first, unsigned int size)
 {
     data.attributes.size = size;
@@ -168,6 +270,10 @@ static int handle_attributes(const sxmltok_t *first, unsigned int size)
         data.buffer.data[first[i].endpos] = 0;
         i += handle_attribute_value(first + i + 1, size - i - 1);
     }
+    if (!build_attribute_lookup(size)) {
+        data.attributes.size = 0;
+        return 0;
+    }
     return 1;
 }
 
@@ -319,6 +425,11 @@ int xml_parser_init(const xml_parser_element *elements, int total_elements, int
             element->on_exit = dummy_element_on_exit;
         }
     }
+    if (!build_element_lookup()) {
+        xml_parser_free();
+        data.error = 1;
+        return 0;
+    }
     return 1;
 }
 
@@ -445,27 +556,21 @@ int xml_parser_parse(const char *buffer, unsigned int buffer_size, int is_final)
 
 static const char *get_attribute_value(const char *key)
 {
-    if (!key || !data.attributes.first) {
+    if (!key || !data.attributes.first || !data.attributes.size) {
         return 0;
     }
-    for (int i = 0; i < data.attributes.size; i++) {
-        const sxmltok_t *current = &data.attributes.first[i];
-        if (current->type != SXML_CDATA) {
-            continue;
-        }
-        if (strcmp(data.buffer.data + current->startpos, key) != 0) {
-            continue;
-        }
-        if (i + 1 == data.attributes.size) {
-            return &EMPTY_STRING;
-        }
-        current = &data.attributes.first[i + 1];
-        if (current->type != SXML_CHARACTER) {
-            return &EMPTY_STRING;
-        }
-        return data.buffer.data + current->startpos;
+    int i = data.attributes.slots[find_attribute_slot(key)];
+    if (i == -1) {
+        return 0;
     }
-    return 0;
+    if (i + 1 == data.attributes.size) {
+        return &EMPTY_STRING;
+    }
+    const sxmltok_t *current = &data.attributes.first[i + 1];
+    if (current->type != SXML_CHARACTER) {
+        return &EMPTY_STRING;
+    }
+    return data.buffer.data + current->startpos;
 }
 
 int xml_parser_has_attribute(const char *key)
@@ -568,9 +673,13 @@ void xml_parser_free(void)
     data.error = 0;
 
     free(data.elements);
+    free(data.next_element_with_name);
+    free(data.element_lookup.slots);
     free(data.parents);
     free(data.texts);
     data.elements = 0;
+    data.next_element_with_name = 0;
+    data.element_lookup.slots = 0;
     data.parents = 0;
     data.texts = 0;
     data.total_elements = 0;
@@ -588,4 +697,7 @@ void xml_parser_free(void)
     data.parser.tokens = 0;
     data.attributes.first = 0;
     data.attributes.size = 0;
+    free(data.attributes.slots);
+    data.attributes.slots = 0;
+    data.attributes.capacity = 0;
 }
@@ -4,22 +4,23 @@
 #include "map/elevation.h"
 #include "map/figure.h"
 #include "map/grid.h"
+#include "map/point.h"
 #include "map/terrain.h"
 
 #define OFFSET(x,y) (x + GRID_SIZE * y)
 
-static const int TILE_GRID_OFFSETS[] = {
-OFFSET(0,0), OFFSET(0,1), OFFSET(1,0), OFFSET(1,1),
-OFFSET(0,2), OFFSET(2,0), OFFSET(1,2), OFFSET(2,1),
-OFFSET(2,2), OFFSET(0,3), OFFSET(3,0), OFFSET(1,3),
-OFFSET(3,1), OFFSET(2,3), OFFSET(3,2), OFFSET(3,3) };
+static const map_point TILE_GRID_OFFSETS[] = {
+{0, 0}, {0, 1}, {1, 0}, {1, 1},
+{0, 2}, {2, 0}, {1, 2}, {2, 1},
+{2, 2}, {0, 3}, {3, 0}, {1, 3},
+{3, 1}, {2, 3}, {3, 2}, {3, 3} };
 
 
-static const int ACCESS_RAMP_TILE_OFFSETS_BY_ORIENTATION[4][6] = {
-    {OFFSET(0,1), OFFSET(1,1), OFFSET(0,2), OFFSET(1,2), OFFSET(0,0), OFFSET(1,0)},
-    {OFFSET(0,0), OFFSET(0,1), OFFSET(-1,0), OFFSET(-1,1), OFFSET(1,0), OFFSET(1,1)},
-    {OFFSET(0,0), OFFSET(1,0), OFFSET(0,-1), OFFSET(1,-1), OFFSET(0,1), OFFSET(1,1)},
-    {OFFSET(1,0), OFFSET(1,1), OFFSET(2,0), OFFSET(2,1), OFFSET(0,0), OFFSET(0,1)},
+static const map_point ACCESS_RAMP_TILE_OFFSETS_BY_ORIENTATION[4][6] = {
+    {{0, 1}, {1, 1}, {0, 2}, {1, 2}, {0, 0}, {1, 0}},
+    {{0, 0}, {0, 1}, {-1, 0}, {-1, 1}, {1, 0}, {1, 1}},
+    {{0, 0}, {1, 0}, {0, -1}, {1, -1}, {0, 1}, {1, 1}},
+    {{1, 0}, {1, 1}, {2, 0}, {2, 1}, {0, 0}, {0, 1}},
 };
 
 static int is_clear_terrain(const map_tile *tile, int *warning)
@@ -93,7 +94,8 @@ int editor_tool_can_place_access_ramp(const map_tile *tile, int *orientation_ind
         int wrong_tiles = 0;
         int top_elevation = 0;
         for (int index = 0; index < 6; index++) {
-            int tile_offset = tile->grid_offset + ACCESS_RAMP_TILE_OFFSETS_BY_ORIENTATION[orientation][index];
+            const map_point *delta = &ACCESS_RAMP_TILE_OFFSETS_BY_ORIENTATION[orientation][index];
+            int tile_offset = tile->grid_offset + OFFSET(delta->x, delta->y);
             int elevation = map_elevation_at(tile_offset);
             if (index < 2) {
                 if (map_terrain_is(tile_offset, TERRAIN_ELEVATION)) {
@@ -138,7 +140,7 @@ int editor_tool_can_place_building(const map_tile *tile, int num_tiles, int *blo
 {
     int blocked = 0;
     for (int i = 0; i < num_tiles; i++) {
-        int tile_offset = tile->grid_offset + TILE_GRID_OFFSETS[i];
+        int tile_offset = tile->grid_offset + OFFSET(TILE_GRID_OFFSETS[i].x, TILE_GRID_OFFSETS[i].y);
         int forbidden_terrain = map_terrain_get(tile_offset) & TERRAIN_NOT_CLEAR;
         if (forbidden_terrain || map_has_figure_at(tile_offset)) {
             blocked = 1;
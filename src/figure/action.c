@@ -2,6 +2,7 @@
 
 #include "city/entertainment.h"
 #include "city/figures.h"
+#include "figure/combat.h"
 #include "figure/figure.h"
 #include "figuretype/animal.h"
 #include "figuretype/cartpusher.h"
@@ -22,6 +23,7 @@
 #include "figuretype/wall.h"
 #include "figuretype/water.h"
 #include "figuretype/workcamp.h"
+#include "game/tick_stats.h"
 
 
 static void figure_nobody_action(figure *f)
@@ -131,22 +133,24 @@ void figure_action_handle(void)
 {
     city_figures_reset();
     city_entertainment_set_hippodrome_has_race(0);
-    for (int i = 1; i < figure_count(); i++) {
+    figure_combat_invalidate_targets();
+    for (int i = figure_next_in_use(0); i; i = figure_next_in_use(i)) {
         figure *f = figure_get(i);
-        if (f->state) {
-            if (f->targeted_by_figure_id) {
-                figure *attacker = figure_get(f->targeted_by_figure_id);
-                if (attacker->state != FIGURE_STATE_ALIVE) {
-                    f->targeted_by_figure_id = 0;
-                }
-                if (attacker->target_figure_id != i) {
-                    f->targeted_by_figure_id = 0;
-                }
+        if (f->targeted_by_figure_id) {
+            figure *attacker = figure_get(f->targeted_by_figure_id);
+            if (attacker->state != FIGURE_STATE_ALIVE) {
+                f->targeted_by_figure_id = 0;
             }
-            figure_action_callbacks[f->type](f);
-            if (f->state == FIGURE_STATE_DEAD) {
-                figure_delete(f);
+            if (attacker->target_figure_id != i) {
+                f->targeted_by_figure_id = 0;
             }
         }
+        uint64_t start = tick_stats_start();
+        figure_type type = f->type;
+        figure_action_callbacks[type](f);
+        tick_stats_record_figure_type(type, start);
+        if (f->state == FIGURE_STATE_DEAD) {
+            figure_delete(f);
+        }
     }
 }
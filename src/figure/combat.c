@@ -9,14 +9,357 @@
 #include "figure/route.h"
 #include "figure/sound.h"
 #include "game/difficulty.h"
+#include "map/data.h"
 #include "map/figure.h"
+#include "map/grid.h"
 #include "sound/effect.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#define REGION_SIZE_SHIFT 3
+#define REGION_SIZE (1 << REGION_SIZE_SHIFT)
+#define REGIONS_PER_SIDE ((GRID_SIZE_MAX + REGION_SIZE - 1) / REGION_SIZE)
+
+typedef enum {
+    TARGETS_ENEMY,
+    TARGETS_LEGION,
+    TARGETS_RIOTER,
+    TARGETS_NATIVE,
+    TARGETS_ANIMAL,
+    TARGETS_WOLF_PREY,
+    TARGETS_MAX
+} target_list_type;
+
+typedef enum {
+    TARGET_SLOT_CATEGORY,
+    TARGET_SLOT_WOLF_PREY,
+    TARGET_SLOT_MAX
+} target_slot;
+
+typedef struct {
+    int *ids;
+    int size;
+    int capacity;
+} target_list;
+
+typedef struct {
+    int region;
+    int prev;
+    int next;
+} region_link;
+
+// A figure is a candidate of at most one category and may also be wolf prey
+typedef struct {
+    target_list_type list[TARGET_SLOT_MAX];
+    region_link links[TARGET_SLOT_MAX];
+} target_node;
+
+typedef struct {
+    int x_min;
+    int x_max;
+    int y_min;
+    int y_max;
+} region_bounds;
+
+// Figures grouped by the categories the target searches look at, and within each category by the
+// region of 8x8 tiles they stand on, so each search only visits candidates of the right type near
+// the searching figure. The lists are rebuilt at most once per tick and follow the figures as they
+// move. They only hold candidates: the searches still check state, position and type of every entry.
+static struct {
+    int needs_rebuild;
+    // Sorted by figure id, for the searches that fall back to the first candidate anywhere on the map
+    target_list lists[TARGETS_MAX];
+    int region_heads[TARGETS_MAX][REGIONS_PER_SIDE * REGIONS_PER_SIDE];
+    target_node *nodes;
+    int nodes_size;
+    int max_x;
+    int max_y;
+} targets = { 1 };
+
 static int is_attacking_native(const figure *f)
 {
     return f->type == FIGURE_INDIGENOUS_NATIVE && f->action_state == FIGURE_ACTION_159_NATIVE_ATTACKING;
 }
 
+static int can_be_attacked_by_wolf(const figure *f)
+{
+    switch (f->type) {
+        case FIGURE_NONE:
+        case FIGURE_EXPLOSION:
+        case FIGURE_FORT_STANDARD:
+        case FIGURE_TRADE_SHIP:
+        case FIGURE_FISHING_BOAT:
+        case FIGURE_MAP_FLAG:
+        case FIGURE_FLOTSAM:
+        case FIGURE_SHIPWRECK:
+        case FIGURE_INDIGENOUS_NATIVE:
+        case FIGURE_TOWER_SENTRY:
+        case FIGURE_NATIVE_TRADER:
+        case FIGURE_ARROW:
+        case FIGURE_JAVELIN:
+        case FIGURE_BOLT:
+        case FIGURE_BALLISTA:
+        case FIGURE_CATAPULT_MISSILE:
+        case FIGURE_FRIENDLY_ARROW:
+        case FIGURE_WATCHTOWER_ARCHER:
+        case FIGURE_CREATURE:
+            return 0;
+        default:
+            return !figure_is_herd(f);
+    }
+}
+
+static target_list_type get_category(const figure *f)
+{
+    if (figure_is_enemy(f)) {
+        return TARGETS_ENEMY;
+    } else if (figure_is_legion(f)) {
+        return TARGETS_LEGION;
+    } else if (f->type == FIGURE_RIOTER) {
+        return TARGETS_RIOTER;
+    } else if (f->type == FIGURE_INDIGENOUS_NATIVE) {
+        return TARGETS_NATIVE;
+    } else if (figure_is_herd(f)) {
+        return TARGETS_ANIMAL;
+    }
+    return TARGETS_MAX;
+}
+
+static target_slot get_slot(target_list_type type)
+{
+    return type == TARGETS_WOLF_PREY ? TARGET_SLOT_WOLF_PREY : TARGET_SLOT_CATEGORY;
+}
+
+// Figures outside the map, such as enemies that have yet to enter it, are kept in the nearest
+// region. Clamping never increases the distance between two figures, so the bounds stay valid.
+static int get_region(int x, int y)
+{
+    x = calc_bound(x, 0, targets.max_x) >> REGION_SIZE_SHIFT;
+    y = calc_bound(y, 0, targets.max_y) >> REGION_SIZE_SHIFT;
+    return y * REGIONS_PER_SIDE + x;
+}
+
+static void get_region_bounds(int x, int y, int distance, region_bounds *bounds)
+{
+    x = calc_bound(x, 0, targets.max_x);
+    y = calc_bound(y, 0, targets.max_y);
+    bounds->x_min = calc_bound(x - distance, 0, targets.max_x) >> REGION_SIZE_SHIFT;
+    bounds->x_max = calc_bound(x + distance, 0, targets.max_x) >> REGION_SIZE_SHIFT;
+    bounds->y_min = calc_bound(y - distance, 0, targets.max_y) >> REGION_SIZE_SHIFT;
+    bounds->y_max = calc_bound(y + distance, 0, targets.max_y) >> REGION_SIZE_SHIFT;
+}
+
+static void link_to_region(target_list_type type, int figure_id, int region)
+{
+    region_link *link = &targets.nodes[figure_id].links[get_slot(type)];
+    int *head = &targets.region_heads[type][region];
+    link->region = region;
+    link->prev = 0;
+    link->next = *head;
+    if (*head) {
+        targets.nodes[*head].links[get_slot(type)].prev = figure_id;
+    }
+    *head = figure_id;
+}
+
+static void unlink_from_region(target_list_type type, int figure_id)
+{
+    target_slot slot = get_slot(type);
+    region_link *link = &targets.nodes[figure_id].links[slot];
+    if (link->prev) {
+        targets.nodes[link->prev].links[slot].next = link->next;
+    } else {
+        targets.region_heads[type][link->region] = link->next;
+    }
+    if (link->next) {
+        targets.nodes[link->next].links[slot].prev = link->prev;
+    }
+}
+
+static int find_in_list(const target_list *list, int figure_id)
+{
+    int low = 0;
+    int high = list->size;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (list->ids[middle] < figure_id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static int insert_into_list(target_list *list, int figure_id)
+{
+    if (list->size >= list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 64;
+        int *ids = realloc(list->ids, capacity * sizeof(int));
+        if (!ids) {
+            return 0;
+        }
+        list->ids = ids;
+        list->capacity = capacity;
+    }
+    // Figures are mostly added in id order, when the lists are rebuilt
+    int index = list->size && list->ids[list->size - 1] > figure_id ? find_in_list(list, figure_id) : list->size;
+    memmove(&list->ids[index + 1], &list->ids[index], (list->size - index) * sizeof(int));
+    list->ids[index] = figure_id;
+    list->size++;
+    return 1;
+}
+
+static void remove_from_list(target_list *list, int figure_id)
+{
+    int index = find_in_list(list, figure_id);
+    if (index < list->size && list->ids[index] == figure_id) {
+        list->size--;
+        memmove(&list->ids[index], &list->ids[index + 1], (list->size - index) * sizeof(int));
+    }
+}
+
+static void reset_node(target_node *node)
+{
+    for (target_slot slot = 0; slot < TARGET_SLOT_MAX; slot++) {
+        node->list[slot] = TARGETS_MAX;
+    }
+}
+
+static int ensure_node_capacity(int size)
+{
+    if (size <= targets.nodes_size) {
+        return 1;
+    }
+    target_node *nodes = realloc(targets.nodes, size * sizeof(target_node));
+    if (!nodes) {
+        return 0;
+    }
+    for (int i = targets.nodes_size; i < size; i++) {
+        reset_node(&nodes[i]);
+    }
+    targets.nodes = nodes;
+    targets.nodes_size = size;
+    return 1;
+}
+
+static void add_to_target_list(target_list_type type, const figure *f)
+{
+    if (!insert_into_list(&targets.lists[type], f->id)) {
+        // Searches fall back to a full rebuild until memory is available
+        targets.needs_rebuild = 1;
+        return;
+    }
+    targets.nodes[f->id].list[get_slot(type)] = type;
+    link_to_region(type, f->id, get_region(f->x, f->y));
+}
+
+static void remove_target(int figure_id)
+{
+    target_node *node = &targets.nodes[figure_id];
+    for (target_slot slot = 0; slot < TARGET_SLOT_MAX; slot++) {
+        if (node->list[slot] != TARGETS_MAX) {
+            remove_from_list(&targets.lists[node->list[slot]], figure_id);
+            unlink_from_region(node->list[slot], figure_id);
+            node->list[slot] = TARGETS_MAX;
+        }
+    }
+}
+
+static void add_target(const figure *f)
+{
+    if (!ensure_node_capacity(f->id + 1)) {
+        targets.needs_rebuild = 1;
+        return;
+    }
+    // A reused figure slot or a figure that changed type may still be listed
+    remove_target(f->id);
+    target_list_type category = get_category(f);
+    if (category != TARGETS_MAX) {
+        add_to_target_list(category, f);
+    }
+    if (can_be_attacked_by_wolf(f)) {
+        add_to_target_list(TARGETS_WOLF_PREY, f);
+    }
+}
+
+static void rebuild_targets(void)
+{
+    for (target_list_type type = 0; type < TARGETS_MAX; type++) {
+        targets.lists[type].size = 0;
+    }
+    memset(targets.region_heads, 0, sizeof(targets.region_heads));
+    targets.max_x = map_data.width > 0 ? map_data.width - 1 : 0;
+    targets.max_y = map_data.height > 0 ? map_data.height - 1 : 0;
+    targets.needs_rebuild = 0;
+    if (!ensure_node_capacity(figure_count())) {
+        targets.needs_rebuild = 1;
+        return;
+    }
+    for (int i = 0; i < targets.nodes_size; i++) {
+        reset_node(&targets.nodes[i]);
+    }
+    for (int i = 1; i < figure_count(); i++) {
+        figure *f = figure_get(i);
+        if (f->state == FIGURE_STATE_ALIVE) {
+            add_target(f);
+        }
+    }
+}
+
+static void update_targets(void)
+{
+    if (targets.needs_rebuild) {
+        rebuild_targets();
+    }
+}
+
+static int first_in_region(target_list_type type, int region_x, int region_y)
+{
+    return targets.region_heads[type][region_y * REGIONS_PER_SIDE + region_x];
+}
+
+static int next_in_region(target_list_type type, int figure_id)
+{
+    return targets.nodes[figure_id].links[get_slot(type)].next;
+}
+
+// Searches visit candidates out of id order, so equal distances are resolved in favour of
+// the lowest id to pick the same figure as a scan over the whole figure array
+static inline int is_closer(int distance, int figure_id, int min_distance, int min_figure_id)
+{
+    return distance < min_distance || (distance == min_distance && figure_id < min_figure_id);
+}
+
+void figure_combat_invalidate_targets(void)
+{
+    targets.needs_rebuild = 1;
+}
+
+void figure_combat_add_target(const figure *f)
+{
+    if (!targets.needs_rebuild && f->id) {
+        add_target(f);
+    }
+}
+
+void figure_combat_move_target(const figure *f)
+{
+    if (targets.needs_rebuild || f->id <= 0 || f->id >= targets.nodes_size) {
+        return;
+    }
+    int region = get_region(f->x, f->y);
+    const target_node *node = &targets.nodes[f->id];
+    for (target_slot slot = 0; slot < TARGET_SLOT_MAX; slot++) {
+        target_list_type type = node->list[slot];
+        if (type != TARGETS_MAX && node->links[slot].region != region) {
+            unlink_from_region(type, f->id);
+            link_to_region(type, f->id, region);
+        }
+    }
+}
+
 void figure_combat_handle_corpse(figure *f)
 {
     if (f->wait_ticks < 0) {
@@ -172,25 +515,38 @@ void figure_combat_handle_attack(figure *f)
     }
 }
 
+static int is_soldier_target(const figure *f)
+{
+    return !figure_is_dead(f) && (figure_is_enemy(f) || f->type == FIGURE_RIOTER || is_attacking_native(f));
+}
+
 int figure_combat_get_target_for_soldier(int x, int y, int max_distance)
 {
+    static const target_list_type LISTS[] = { TARGETS_ENEMY, TARGETS_RIOTER, TARGETS_NATIVE };
     int min_figure_id = 0;
     int min_distance = 10000;
-    for (int i = 1; i < figure_count(); i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f) || f->is_ghost) {
-            // Do not allow to target dead and enemies located outside of the map
-            continue;
-        }
-        if (figure_is_enemy(f) || f->type == FIGURE_RIOTER || is_attacking_native(f)) {
-            int distance = calc_maximum_distance(x, y, f->x, f->y);
-            if (distance <= max_distance) {
-                if (f->targeted_by_figure_id) {
-                    distance *= 2; // penalty
-                }
-                if (distance < min_distance) {
-                    min_distance = distance;
-                    min_figure_id = i;
+    region_bounds bounds;
+    update_targets();
+    get_region_bounds(x, y, max_distance, &bounds);
+    for (int l = 0; l < 3; l++) {
+        for (int region_y = bounds.y_min; region_y <= bounds.y_max; region_y++) {
+            for (int region_x = bounds.x_min; region_x <= bounds.x_max; region_x++) {
+                for (int id = first_in_region(LISTS[l], region_x, region_y); id; id = next_in_region(LISTS[l], id)) {
+                    figure *f = figure_get(id);
+                    if (!is_soldier_target(f) || f->is_ghost) {
+                        // Do not allow to target dead and enemies located outside of the map
+                        continue;
+                    }
+                    int distance = calc_maximum_distance(x, y, f->x, f->y);
+                    if (distance <= max_distance) {
+                        if (f->targeted_by_figure_id) {
+                            distance *= 2; // penalty
+                        }
+                        if (is_closer(distance, f->id, min_distance, min_figure_id)) {
+                            min_distance = distance;
+                            min_figure_id = f->id;
+                        }
+                    }
                 }
             }
         }
@@ -198,61 +554,52 @@ int figure_combat_get_target_for_soldier(int x, int y, int max_distance)
     if (min_figure_id) {
         return min_figure_id;
     }
-    for (int i = 1; i < figure_count(); i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f)) {
-            continue;
-        }
-        if (figure_is_enemy(f) || f->type == FIGURE_RIOTER || is_attacking_native(f)) {
-            return i;
+    // Nothing within reach: take the first target anywhere, including those outside of the map
+    int first_figure_id = 0;
+    for (int l = 0; l < 3; l++) {
+        const target_list *list = &targets.lists[LISTS[l]];
+        for (int i = 0; i < list->size; i++) {
+            if (first_figure_id && list->ids[i] > first_figure_id) {
+                break;
+            }
+            if (is_soldier_target(figure_get(list->ids[i]))) {
+                first_figure_id = list->ids[i];
+                break;
+            }
         }
     }
-    return 0;
+    return first_figure_id;
 }
 
 int figure_combat_get_target_for_wolf(int x, int y, int max_distance)
 {
     int min_figure_id = 0;
     int min_distance = 10000;
-    for (int i = 1; i < figure_count(); i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f) || !f->type) {
-            continue;
-        }
-        switch (f->type) {
-            case FIGURE_EXPLOSION:
-            case FIGURE_FORT_STANDARD:
-            case FIGURE_TRADE_SHIP:
-            case FIGURE_FISHING_BOAT:
-            case FIGURE_MAP_FLAG:
-            case FIGURE_FLOTSAM:
-            case FIGURE_SHIPWRECK:
-            case FIGURE_INDIGENOUS_NATIVE:
-            case FIGURE_TOWER_SENTRY:
-            case FIGURE_NATIVE_TRADER:
-            case FIGURE_ARROW:
-            case FIGURE_JAVELIN:
-            case FIGURE_BOLT:
-            case FIGURE_BALLISTA:
-            case FIGURE_CATAPULT_MISSILE:
-            case FIGURE_FRIENDLY_ARROW:
-            case FIGURE_WATCHTOWER_ARCHER:
-            case FIGURE_CREATURE:
-                continue;
-        }
-        if (figure_is_herd(f)) {
-            continue;
-        }
-        if (figure_is_legion(f) && f->action_state == FIGURE_ACTION_80_SOLDIER_AT_REST) {
-            continue;
-        }
-        int distance = calc_maximum_distance(x, y, f->x, f->y);
-        if (f->targeted_by_figure_id) {
-            distance *= 2;
-        }
-        if (distance < min_distance) {
-            min_distance = distance;
-            min_figure_id = i;
+    region_bounds bounds;
+    update_targets();
+    // The distance penalty only ever increases the distance, so figures further away than
+    // max_distance can never be returned
+    get_region_bounds(x, y, max_distance, &bounds);
+    for (int region_y = bounds.y_min; region_y <= bounds.y_max; region_y++) {
+        for (int region_x = bounds.x_min; region_x <= bounds.x_max; region_x++) {
+            for (int id = first_in_region(TARGETS_WOLF_PREY, region_x, region_y); id;
+                id = next_in_region(TARGETS_WOLF_PREY, id)) {
+                figure *f = figure_get(id);
+                if (figure_is_dead(f) || !can_be_attacked_by_wolf(f)) {
+                    continue;
+                }
+                if (figure_is_legion(f) && f->action_state == FIGURE_ACTION_80_SOLDIER_AT_REST) {
+                    continue;
+                }
+                int distance = calc_maximum_distance(x, y, f->x, f->y);
+                if (f->targeted_by_figure_id) {
+                    distance *= 2;
+                }
+                if (is_closer(distance, f->id, min_distance, min_figure_id)) {
+                    min_distance = distance;
+                    min_figure_id = f->id;
+                }
+            }
         }
     }
     if (min_distance <= max_distance && min_figure_id) {
@@ -265,16 +612,56 @@ int figure_combat_get_target_for_enemy(int x, int y)
 {
     int min_figure_id = 0;
     int min_distance = 10000;
-    for (int i = 1; i < figure_count(); i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f)) {
-            continue;
+    update_targets();
+    const target_list *list = &targets.lists[TARGETS_LEGION];
+    int first_figure_id = 0;
+    for (int i = 0; i < list->size && !first_figure_id; i++) {
+        figure *f = figure_get(list->ids[i]);
+        if (!figure_is_dead(f) && figure_is_legion(f)) {
+            first_figure_id = f->id;
+        }
+    }
+    if (!first_figure_id) {
+        return 0;
+    }
+    // There is no maximum distance, so the regions are visited in rings around the enemy until
+    // no region can hold a closer soldier
+    int center_x = get_region(x, y) % REGIONS_PER_SIDE;
+    int center_y = get_region(x, y) / REGIONS_PER_SIDE;
+    int max_region_x = targets.max_x >> REGION_SIZE_SHIFT;
+    int max_region_y = targets.max_y >> REGION_SIZE_SHIFT;
+    int max_ring = center_x > max_region_x - center_x ? center_x : max_region_x - center_x;
+    if (center_y > max_ring) {
+        max_ring = center_y;
+    }
+    if (max_region_y - center_y > max_ring) {
+        max_ring = max_region_y - center_y;
+    }
+    for (int ring = 0; ring <= max_ring; ring++) {
+        if (min_figure_id && ring > 0 && (ring - 1) * REGION_SIZE + 1 > min_distance) {
+            break;
         }
-        if (!f->targeted_by_figure_id && figure_is_legion(f)) {
-            int distance = calc_maximum_distance(x, y, f->x, f->y);
-            if (distance < min_distance) {
-                min_distance = distance;
-                min_figure_id = i;
+        for (int region_y = center_y - ring; region_y <= center_y + ring; region_y++) {
+            if (region_y < 0 || region_y > max_region_y) {
+                continue;
+            }
+            int step = (region_y == center_y - ring || region_y == center_y + ring) ? 1 : 2 * ring;
+            for (int region_x = center_x - ring; region_x <= center_x + ring; region_x += step) {
+                if (region_x < 0 || region_x > max_region_x) {
+                    continue;
+                }
+                for (int id = first_in_region(TARGETS_LEGION, region_x, region_y); id;
+                    id = next_in_region(TARGETS_LEGION, id)) {
+                    figure *f = figure_get(id);
+                    if (figure_is_dead(f) || !figure_is_legion(f) || f->targeted_by_figure_id) {
+                        continue;
+                    }
+                    int distance = calc_maximum_distance(x, y, f->x, f->y);
+                    if (is_closer(distance, f->id, min_distance, min_figure_id)) {
+                        min_distance = distance;
+                        min_figure_id = f->id;
+                    }
+                }
             }
         }
     }
@@ -282,16 +669,7 @@ int figure_combat_get_target_for_enemy(int x, int y)
         return min_figure_id;
     }
     // no 'free' soldier found, take first one
-    for (int i = 1; i < figure_count(); i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f)) {
-            continue;
-        }
-        if (figure_is_legion(f)) {
-            return i;
-        }
-    }
-    return 0;
+    return first_figure_id;
 }
 
 static int is_valid_missile_target(figure *f, formation *l)
@@ -313,23 +691,35 @@ static int is_valid_missile_target(figure *f, formation *l)
 
 int figure_combat_get_missile_target_for_soldier(figure *shooter, int max_distance, map_point *tile)
 {
+    static const target_list_type LISTS[] = { TARGETS_ENEMY, TARGETS_NATIVE, TARGETS_ANIMAL };
     int x = shooter->x;
     int y = shooter->y;
 
     int min_distance = max_distance;
     figure *min_figure = 0;
     formation *l = formation_get(shooter->formation_id);
-    for (int i = 1; i < figure_count(); i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f) || f->is_ghost) {
-            // Do not allow to target dead and enemies located outside of the map
-            continue;
-        }
-        if (is_valid_missile_target(f, l)) {
-            int distance = calc_maximum_distance(x, y, f->x, f->y);
-            if (distance < min_distance && figure_movement_can_launch_cross_country_missile(x, y, f->x, f->y)) {
-                min_distance = distance;
-                min_figure = f;
+    region_bounds bounds;
+    update_targets();
+    get_region_bounds(x, y, max_distance, &bounds);
+    for (int list_index = 0; list_index < 3; list_index++) {
+        target_list_type type = LISTS[list_index];
+        for (int region_y = bounds.y_min; region_y <= bounds.y_max; region_y++) {
+            for (int region_x = bounds.x_min; region_x <= bounds.x_max; region_x++) {
+                for (int id = first_in_region(type, region_x, region_y); id; id = next_in_region(type, id)) {
+                    figure *f = figure_get(id);
+                    if (figure_is_dead(f) || f->is_ghost) {
+                        // Do not allow to target dead and enemies located outside of the map
+                        continue;
+                    }
+                    if (is_valid_missile_target(f, l)) {
+                        int distance = calc_maximum_distance(x, y, f->x, f->y);
+                        if (is_closer(distance, f->id, min_distance, min_figure ? min_figure->id : 0) &&
+                            figure_movement_can_launch_cross_country_missile(x, y, f->x, f->y)) {
+                            min_distance = distance;
+                            min_figure = f;
+                        }
+                    }
+                }
             }
         }
     }
@@ -4,6 +4,24 @@
 #include "figure/figure.h"
 #include "map/point.h"
 
+/**
+ * Marks the target candidate lists as outdated, they are rebuilt on the next target search.
+ * Called at the start of every figure action pass and whenever the figure array is replaced.
+ */
+void figure_combat_invalidate_targets(void);
+
+/**
+ * Adds a newly created figure, or a figure that changed type, to the target candidate lists
+ * @param f Figure to add
+ */
+void figure_combat_add_target(const figure *f);
+
+/**
+ * Moves a figure to the target candidates of the region it now stands on
+ * @param f Figure that moved
+ */
+void figure_combat_move_target(const figure *f);
+
 void figure_combat_handle_corpse(figure *f);
 void figure_combat_handle_attack(figure *f);
 
@@ -9,6 +9,7 @@
 #include "game/resource.h"
 #include "game/save_version.h"
 #include "empire/city.h"
+#include "figure/combat.h"
 #include "figure/name.h"
 #include "figure/route.h"
 #include "figure/trader.h"
@@ -16,14 +17,23 @@
 #include "map/figure.h"
 #include "map/grid.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #define FIGURE_ARRAY_SIZE_STEP 1000
+#define IN_USE_WORD_BITS 32
 
 #define FIGURE_ORIGINAL_BUFFER_SIZE 128
-#define FIGURE_CURRENT_BUFFER_SIZE 130
+#define FIGURE_CURRENT_BUFFER_SIZE 154
 
 static struct {
     int created_sequence;
     array(figure) figures;
+    // One bit per figure id that is in use, so the figures can be visited without reading every free slot
+    struct {
+        uint32_t *words;
+        unsigned int total_words;
+    } in_use;
 } data;
 
 figure *figure_get(int id)
@@ -36,6 +46,77 @@ int figure_count(void)
     return data.figures.size;
 }
 
+static int expand_in_use(unsigned int id)
+{
+    unsigned int total_words = id / IN_USE_WORD_BITS + 1;
+    if (total_words <= data.in_use.total_words) {
+        return 1;
+    }
+    total_words += FIGURE_ARRAY_SIZE_STEP / IN_USE_WORD_BITS;
+    uint32_t *words = realloc(data.in_use.words, total_words * sizeof(uint32_t));
+    if (!words) {
+        log_error("Unable to allocate memory for the figure list", 0, id);
+        return 0;
+    }
+    memset(&words[data.in_use.total_words], 0, (total_words - data.in_use.total_words) * sizeof(uint32_t));
+    data.in_use.words = words;
+    data.in_use.total_words = total_words;
+    return 1;
+}
+
+static void set_in_use(unsigned int id)
+{
+    if (expand_in_use(id)) {
+        data.in_use.words[id / IN_USE_WORD_BITS] |= 1u << (id % IN_USE_WORD_BITS);
+    }
+}
+
+static void clear_in_use(unsigned int id)
+{
+    if (id / IN_USE_WORD_BITS < data.in_use.total_words) {
+        data.in_use.words[id / IN_USE_WORD_BITS] &= ~(1u << (id % IN_USE_WORD_BITS));
+    }
+}
+
+static void rebuild_in_use(void)
+{
+    if (data.in_use.words) {
+        memset(data.in_use.words, 0, data.in_use.total_words * sizeof(uint32_t));
+    }
+    for (int i = 1; i < figure_count(); i++) {
+        if (figure_get(i)->state) {
+            set_in_use(i);
+        }
+    }
+}
+
+int figure_next_in_use(int id)
+{
+    unsigned int next = id < 0 ? 0 : id + 1;
+    unsigned int max_id = figure_count();
+    while (next < max_id) {
+        unsigned int word_index = next / IN_USE_WORD_BITS;
+        if (word_index >= data.in_use.total_words) {
+            break;
+        }
+        uint32_t word = data.in_use.words[word_index] >> (next % IN_USE_WORD_BITS);
+        if (!word) {
+            next = (word_index + 1) * IN_USE_WORD_BITS;
+            continue;
+        }
+        while (!(word & 0xff)) {
+            word >>= 8;
+            next += 8;
+        }
+        while (!(word & 1)) {
+            word >>= 1;
+            next++;
+        }
+        return next < max_id ? next : 0;
+    }
+    return 0;
+}
+
 figure *figure_create(figure_type type, int x, int y, direction_type dir)
 {
     figure *f = 0;
@@ -45,6 +126,7 @@ figure *figure_create(figure_type type, int x, int y, direction_type dir)
     }
 
     f->state = FIGURE_STATE_ALIVE;
+    set_in_use(f->id);
     f->faction_id = 1;
     f->type = type;
     f->use_cross_country = 0;
@@ -67,6 +149,7 @@ figure *figure_create(figure_type type, int x, int y, direction_type dir)
     f->phrase_sequence_city = f->phrase_sequence_exact = random_byte() & 3;
     f->name = figure_name_get(type, 0);
     map_figure_add(f);
+    figure_combat_add_target(f);
     if (type == FIGURE_TRADE_CARAVAN || type == FIGURE_TRADE_SHIP || type == FIGURE_NATIVE_TRADER) {
         f->trader_id = trader_create();
     }
@@ -203,7 +286,9 @@ void figure_delete(figure *f)
     int figure_id = f->id;
     memset(f, 0, sizeof(figure));
     f->id = figure_id;
+    clear_in_use(figure_id);
 
+    array_release_item(data.figures, figure_id);
     array_trim(data.figures);
 }
 
@@ -243,7 +328,10 @@ void figure_init_scenario(void)
         !array_next(data.figures)) { // Ignore first figure
         log_error("Unable to create figures array. The game will now crash.", 0, 0);
     }
+    array_track_free_slots(data.figures, 1);
     data.created_sequence = 0;
+    rebuild_in_use();
+    figure_combat_invalidate_targets();
 }
 
 void figure_kill_all(void)
@@ -262,6 +350,8 @@ void figure_kill_all(void)
                 continue;
         }  
     }
+    // Free slots are marked as dead as well, so they must be visited too
+    rebuild_in_use();
 }
 
 int figure_target_is_alive(const figure *f)
@@ -375,6 +465,17 @@ static void figure_save(buffer *buf, const figure *f)
     buffer_write_i16(buf, f->attacker_id2);
     buffer_write_i16(buf, f->opponent_id);
     buffer_write_i16(buf, f->last_visited_index);
+    // map positions, the original fields above only fit maps up to 181 tiles
+    buffer_write_i32(buf, f->grid_offset);
+    buffer_write_i32(buf, f->destination_grid_offset);
+    buffer_write_u16(buf, f->x);
+    buffer_write_u16(buf, f->y);
+    buffer_write_u16(buf, f->previous_tile_x);
+    buffer_write_u16(buf, f->previous_tile_y);
+    buffer_write_u16(buf, f->destination_x);
+    buffer_write_u16(buf, f->destination_y);
+    buffer_write_u16(buf, f->source_x);
+    buffer_write_u16(buf, f->source_y);
 }
 
 static int get_resource_id(figure_type type, int resource)
@@ -503,6 +604,18 @@ static void figure_load(buffer *buf, figure *f, int figure_buf_size, int version
     if (version > SAVE_GAME_LAST_GLOBAL_BUILDING_INFO) {
         f->last_visited_index = buffer_read_i16(buf);
     }
+    if (version > SAVE_GAME_LAST_NARROW_MAP_POSITIONS) {
+        f->grid_offset = buffer_read_i32(buf);
+        f->destination_grid_offset = buffer_read_i32(buf);
+        f->x = buffer_read_u16(buf);
+        f->y = buffer_read_u16(buf);
+        f->previous_tile_x = buffer_read_u16(buf);
+        f->previous_tile_y = buffer_read_u16(buf);
+        f->destination_x = buffer_read_u16(buf);
+        f->destination_y = buffer_read_u16(buf);
+        f->source_x = buffer_read_u16(buf);
+        f->source_y = buffer_read_u16(buf);
+    }
 
     // The following code should only be executed if the savegame includes figure information that is not 
     // supported on this specific version of Augustus. The extra bytes in the buffer must be skipped in order
@@ -556,4 +669,7 @@ void figure_load_state(buffer *list, buffer *seq, int version)
         }
     }
     data.figures.size = highest_id_in_use + 1;
+    array_track_free_slots(data.figures, 1);
+    rebuild_in_use();
+    figure_combat_invalidate_targets();
 }
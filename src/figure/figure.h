@@ -29,18 +29,18 @@ typedef struct {
     signed char direction;
     signed char previous_tile_direction;
     signed char attack_direction;
-    unsigned char x;
-    unsigned char y;
-    unsigned char previous_tile_x;
-    unsigned char previous_tile_y;
+    unsigned short x;
+    unsigned short y;
+    unsigned short previous_tile_x;
+    unsigned short previous_tile_y;
     unsigned char missile_height;
     unsigned char damage;
-    short grid_offset;
-    unsigned char destination_x;
-    unsigned char destination_y;
-    short destination_grid_offset; // only used for soldiers
-    unsigned char source_x;
-    unsigned char source_y;
+    int grid_offset;
+    unsigned short destination_x;
+    unsigned short destination_y;
+    int destination_grid_offset; // only used for soldiers
+    unsigned short source_x;
+    unsigned short source_y;
     union {
         unsigned char soldier;
         signed char enemy;
@@ -127,6 +127,15 @@ figure *figure_get(int id);
 
 int figure_count(void);
 
+/**
+ * Gets the next figure that is in use, in ascending id order.
+ * Figures created with a higher id while iterating are returned as well.
+ * Only the in-use state is kept outside the figures, the figure fields are still read through figure_get.
+ * @param id Id to continue after, 0 to start from the first figure
+ * @return Id of the next figure in use, or 0 when there are no more
+ */
+int figure_next_in_use(int id);
+
 /**
  * Creates a figure
  * @param type Figure type
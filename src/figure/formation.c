@@ -23,7 +23,7 @@
 
 #define FORMATION_ARRAY_SIZE_STEP 50
 #define ORIGINAL_BUFFER_SIZE_PER_FORMATION 128
-#define CURRENT_BUFFER_SIZE_PER_FORMATION 128
+#define CURRENT_BUFFER_SIZE_PER_FORMATION 148
 
 static array(formation) formations;
 
@@ -50,6 +50,7 @@ void formations_clear(void)
         !array_next(formations)) { // Ignore first formation
         log_error("Unable to create the formations array. The game will likely crash.", 0, 0);
     }
+    array_track_free_slots(formations, 1);
     data.id_last_in_use = 0;
     data.id_last_legion = 0;
     data.num_legions = 0;
@@ -59,6 +60,7 @@ void formations_clear(void)
 void formation_clear(int formation_id)
 {
     array_item(formations, formation_id)->in_use = 0;
+    array_release_item(formations, formation_id);
     array_trim(formations);
 }
 
@@ -866,6 +868,17 @@ void formations_save_state(buffer *buf, buffer *totals)
         buffer_write_i32(buf, f->target_formation_id);
         buffer_skip(buf, 13);
         buffer_write_i16(buf, f->invasion_sequence);
+        // map positions, the original fields above only fit maps up to 255 tiles
+        buffer_write_u16(buf, f->x_home);
+        buffer_write_u16(buf, f->y_home);
+        buffer_write_u16(buf, f->standard_x);
+        buffer_write_u16(buf, f->standard_y);
+        buffer_write_u16(buf, f->x);
+        buffer_write_u16(buf, f->y);
+        buffer_write_u16(buf, f->destination_x);
+        buffer_write_u16(buf, f->destination_y);
+        buffer_write_u16(buf, f->prev.x_home);
+        buffer_write_u16(buf, f->prev.y_home);
     }
     buffer_write_i32(totals, data.id_last_in_use);
     buffer_write_i32(totals, data.id_last_legion);
@@ -959,6 +972,18 @@ void formations_load_state(buffer *buf, buffer *totals, int version)
         f->target_formation_id = buffer_read_i32(buf);
         buffer_skip(buf, 13);
         f->invasion_sequence = buffer_read_i16(buf);
+        if (version > SAVE_GAME_LAST_NARROW_MAP_POSITIONS) {
+            f->x_home = buffer_read_u16(buf);
+            f->y_home = buffer_read_u16(buf);
+            f->standard_x = buffer_read_u16(buf);
+            f->standard_y = buffer_read_u16(buf);
+            f->x = buffer_read_u16(buf);
+            f->y = buffer_read_u16(buf);
+            f->destination_x = buffer_read_u16(buf);
+            f->destination_y = buffer_read_u16(buf);
+            f->prev.x_home = buffer_read_u16(buf);
+            f->prev.y_home = buffer_read_u16(buf);
+        }
 
         if (formation_buf_size > CURRENT_BUFFER_SIZE_PER_FORMATION) {
             buffer_skip(buf, formation_buf_size - CURRENT_BUFFER_SIZE_PER_FORMATION);
@@ -971,6 +996,7 @@ void formations_load_state(buffer *buf, buffer *totals, int version)
 
     // Reduce number of available formations to improve performance
     formations.size = highest_id_in_use + 1;
+    array_track_free_slots(formations, 1);
 
     // old saves did not write formations to a zeroed out buffer, so check for invalid target_formation_ids
     for (int i = 0; i < formations.size; i++) {
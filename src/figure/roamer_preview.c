@@ -21,8 +21,14 @@ static struct {
     grid_u8 travelled_tiles;
     building_type types[MAX_STORED_BUILDING_TYPES];
     int stored_building_types;
+    unsigned int version;
 } data;
 
+void figure_roamer_preview_init_grids(void)
+{
+    map_grid_register_u8(&data.travelled_tiles);
+}
+
 static figure_type building_type_to_figure_type(building_type type)
 {
     switch (type) {
@@ -224,6 +230,7 @@ void figure_roamer_preview_create(building_type b_type, int x, int y)
     }
 
     data.travelled_tiles.items[grid_offset] = SHOWN_BUILDING_OFFSET;
+    data.version++;
 
     int b_size = building_is_farm(b_type) ? 3 : building_properties_for_type(b_type)->size;
 
@@ -327,7 +334,8 @@ void figure_roamer_preview_create_all_for_building_type(building_type type)
 
 void figure_roamer_preview_reset(building_type type)
 {
-    map_grid_clear_u8(data.travelled_tiles.items);
+    map_grid_clear_map_area_u8(data.travelled_tiles.items);
+    data.version++;
     int show_other_roamers = 0;
     figure_type fig_type = building_type_to_figure_type(type);
     if (fig_type == FIGURE_LABOR_SEEKER && config_get(CONFIG_GP_CH_GLOBAL_LABOUR)) {
@@ -362,3 +370,8 @@ int figure_roamer_preview_get_frequency(int grid_offset)
 {
     return map_grid_is_valid_offset(grid_offset) ? data.travelled_tiles.items[grid_offset] : 0;
 }
+
+unsigned int figure_roamer_preview_get_version(void)
+{
+    return data.version;
+}
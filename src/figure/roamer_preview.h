@@ -9,10 +9,18 @@
 #define FIGURE_ROAMER_PREVIEW_EXIT_TILE 10
 #define FIGURE_ROAMER_PREVIEW_ENTRY_EXIT_TILE 11
 
+void figure_roamer_preview_init_grids(void);
+
 void figure_roamer_preview_create(building_type b_type, int x, int y);
 void figure_roamer_preview_create_all_for_building_type(building_type type);
 void figure_roamer_preview_reset(building_type type);
 void figure_roamer_preview_reset_building_types(void);
 int figure_roamer_preview_get_frequency(int grid_offset);
 
+/**
+ * Returns a number that changes whenever the travelled tiles of the preview change
+ * @return Change counter of the preview
+ */
+unsigned int figure_roamer_preview_get_version(void);
+
 #endif // FIGURE_ROAMER_PREVIEW_H
@@ -2,20 +2,138 @@
 
 #include "core/array.h"
 #include "core/log.h"
+#include "game/save_version.h"
 #include "map/routing.h"
+#include "map/routing_cache.h"
 #include "map/routing_path.h"
 
+#include <string.h>
+
 #define ARRAY_SIZE_STEP 600
 #define MAX_PATH_LENGTH 500
+#define BITS_PER_DIRECTION 3
+#define DIRECTION_MASK 0x7
+#define ARENA_SIZE_STEP 65536
 
 typedef struct {
     unsigned int id;
     int figure_id;
-    uint8_t directions[MAX_PATH_LENGTH];
+    unsigned int offset;
+    unsigned int length;
 } figure_path_data;
 
 static array(figure_path_data) paths;
 
+// Directions of all paths, packed at three bits each. Every path starts at a new byte.
+static struct {
+    uint8_t *data;
+    unsigned int used;
+    unsigned int wasted;
+    unsigned int capacity;
+} arena;
+
+static uint8_t directions_buffer[MAX_PATH_LENGTH];
+
+static unsigned int packed_size(unsigned int length)
+{
+    return (length * BITS_PER_DIRECTION + 7) / 8;
+}
+
+static void pack_directions(uint8_t *dst, const uint8_t *directions, unsigned int length)
+{
+    memset(dst, 0, packed_size(length));
+    for (unsigned int i = 0; i < length; i++) {
+        unsigned int bit = i * BITS_PER_DIRECTION;
+        unsigned int value = (directions[i] & DIRECTION_MASK) << (bit % 8);
+        dst[bit / 8] |= value & 0xff;
+        if (value > 0xff) {
+            dst[bit / 8 + 1] |= value >> 8;
+        }
+    }
+}
+
+static int unpack_direction(const uint8_t *src, unsigned int index)
+{
+    unsigned int bit = index * BITS_PER_DIRECTION;
+    // The arena always has one spare byte at the end, so reading the next byte is safe
+    unsigned int value = src[bit / 8] | (src[bit / 8 + 1] << 8);
+    return (value >> (bit % 8)) & DIRECTION_MASK;
+}
+
+static void release_path(figure_path_data *path)
+{
+    arena.wasted += packed_size(path->length);
+    path->figure_id = 0;
+    path->length = 0;
+    array_release_item(paths, path->id);
+}
+
+static void compact_arena(void)
+{
+    if (!arena.wasted) {
+        return;
+    }
+    uint8_t *data = malloc(arena.capacity);
+    if (!data) {
+        return;
+    }
+    unsigned int used = 0;
+    figure_path_data *path;
+    array_foreach(paths, path) {
+        if (!path->figure_id || !path->length) {
+            continue;
+        }
+        unsigned int size = packed_size(path->length);
+        memcpy(&data[used], &arena.data[path->offset], size);
+        path->offset = used;
+        used += size;
+    }
+    data[used] = 0;
+    free(arena.data);
+    arena.data = data;
+    arena.used = used;
+    arena.wasted = 0;
+}
+
+static int reserve_arena(unsigned int size)
+{
+    if (arena.used + size + 1 <= arena.capacity) {
+        return 1;
+    }
+    if (arena.wasted >= arena.used / 2) {
+        compact_arena();
+        if (arena.used + size + 1 <= arena.capacity) {
+            return 1;
+        }
+    }
+    unsigned int capacity = arena.capacity ? arena.capacity : ARENA_SIZE_STEP;
+    while (arena.used + size + 1 > capacity) {
+        capacity *= 2;
+    }
+    uint8_t *data = realloc(arena.data, capacity);
+    if (!data) {
+        return 0;
+    }
+    arena.data = data;
+    arena.capacity = capacity;
+    return 1;
+}
+
+static int store_directions(figure_path_data *path, const uint8_t *directions, unsigned int length)
+{
+    unsigned int size = packed_size(length);
+    if (!reserve_arena(size)) {
+        log_error("Unable to allocate memory for a figure path.", 0, 0);
+        return 0;
+    }
+    path->offset = arena.used;
+    path->length = length;
+    pack_directions(&arena.data[arena.used], directions, length);
+    arena.used += size;
+    arena.data[arena.used] = 0;
+    return 1;
+}
+
 static void create_new_path(figure_path_data *path, unsigned int position)
 {
     path->id = position;
@@ -30,6 +148,8 @@ void figure_route_clear_all(void)
 {
     paths.size = 0;
     array_trim(paths);
+    arena.used = 0;
+    arena.wasted = 0;
 }
 
 void figure_route_clean(void)
@@ -40,11 +160,78 @@ void figure_route_clean(void)
         if (figure_id > 0 && figure_id < figure_count()) {
             const figure *f = figure_get(figure_id);
             if (f->state != FIGURE_STATE_ALIVE || f->routing_path_id != array_index) {
-                path->figure_id = 0;
+                release_path(path);
             }
         }
     }
     array_trim(paths);
+    compact_arena();
+}
+
+static int calculate_land_path(figure *f, uint8_t *directions, int direction_limit)
+{
+    int can_travel;
+    switch (f->terrain_usage) {
+        case TERRAIN_USAGE_ENEMY:
+            // check to see if we can reach our destination by going around the city walls
+            can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit, f->destination_building_id, 5000);
+            if (!can_travel) {
+                can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
+                    f->destination_x, f->destination_y, direction_limit, 0, 25000);
+                if (!can_travel) {
+                    can_travel = map_routing_noncitizen_can_travel_through_everything(
+                        f->x, f->y, f->destination_x, f->destination_y, direction_limit);
+                }
+            }
+            break;
+        case TERRAIN_USAGE_WALLS:
+            can_travel = map_routing_can_travel_over_walls(f->x, f->y,
+                f->destination_x, f->destination_y, 4);
+            break;
+        case TERRAIN_USAGE_ANIMAL:
+            can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit, -1, 5000);
+            break;
+        case TERRAIN_USAGE_PREFER_ROADS:
+            can_travel = map_routing_citizen_can_travel_over_road_garden(f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit);
+            if (!can_travel) {
+                can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
+                    f->destination_x, f->destination_y, direction_limit);
+            }
+            break;
+        case TERRAIN_USAGE_ROADS:
+            can_travel = map_routing_citizen_can_travel_over_road_garden(f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit);
+            break;
+        case TERRAIN_USAGE_PREFER_ROADS_HIGHWAY:
+            can_travel = map_routing_citizen_can_travel_over_road_garden_highway(f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit);
+            if (!can_travel) {
+                can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
+                    f->destination_x, f->destination_y, direction_limit);
+            }
+            break;
+        case TERRAIN_USAGE_ROADS_HIGHWAY:
+            can_travel = map_routing_citizen_can_travel_over_road_garden_highway(f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit);
+            break;
+        default:
+            can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
+                f->destination_x, f->destination_y, direction_limit);
+            break;
+    }
+    if (!can_travel) {
+        return 0;
+    }
+    if (f->terrain_usage == TERRAIN_USAGE_WALLS) {
+        int path_length = map_routing_get_path(directions, f->destination_x, f->destination_y, 4);
+        if (path_length > 0) {
+            return path_length;
+        }
+    }
+    return map_routing_get_path(directions, f->destination_x, f->destination_y, direction_limit);
 }
 
 void figure_route_add(figure *f)
@@ -56,9 +243,12 @@ void figure_route_add(figure *f)
     if (f->disallow_diagonal) {
         direction_limit = 4;
     }
-    if (!paths.blocks && !array_init(paths, ARRAY_SIZE_STEP, create_new_path, path_is_used)) {
-        log_error("Unable to create paths array. The game will likely crash.", 0, 0);
-        return;
+    if (!paths.blocks) {
+        if (!array_init(paths, ARRAY_SIZE_STEP, create_new_path, path_is_used)) {
+            log_error("Unable to create paths array. The game will likely crash.", 0, 0);
+            return;
+        }
+        array_track_free_slots(paths, 1);
     }
     figure_path_data *path;
     array_new_item_after_index(paths, 1, path);
@@ -69,83 +259,27 @@ void figure_route_add(figure *f)
     if (f->is_boat) {
         if (f->is_boat == 2) { // flotsam
             map_routing_calculate_distances_water_flotsam(f->x, f->y);
-            path_length = map_routing_get_path_on_water(path->directions,
+            path_length = map_routing_get_path_on_water(directions_buffer,
                 f->destination_x, f->destination_y, 1);
         } else {
             map_routing_calculate_distances_water_boat(f->x, f->y);
-            path_length = map_routing_get_path_on_water(path->directions,
+            path_length = map_routing_get_path_on_water(directions_buffer,
                 f->destination_x, f->destination_y, 0);
         }
     } else {
         // land figure
-        int can_travel;
-        switch (f->terrain_usage) {
-            case TERRAIN_USAGE_ENEMY:
-                // check to see if we can reach our destination by going around the city walls
-                can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit, f->destination_building_id, 5000);
-                if (!can_travel) {
-                    can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
-                        f->destination_x, f->destination_y, direction_limit, 0, 25000);
-                    if (!can_travel) {
-                        can_travel = map_routing_noncitizen_can_travel_through_everything(
-                            f->x, f->y, f->destination_x, f->destination_y, direction_limit);
-                    }
-                }
-                break;
-            case TERRAIN_USAGE_WALLS:
-                can_travel = map_routing_can_travel_over_walls(f->x, f->y,
-                    f->destination_x, f->destination_y, 4);
-                break;
-            case TERRAIN_USAGE_ANIMAL:
-                can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit, -1, 5000);
-                break;
-            case TERRAIN_USAGE_PREFER_ROADS:
-                can_travel = map_routing_citizen_can_travel_over_road_garden(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit);
-                if (!can_travel) {
-                    can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
-                        f->destination_x, f->destination_y, direction_limit);
-                }
-                break;
-            case TERRAIN_USAGE_ROADS:
-                can_travel = map_routing_citizen_can_travel_over_road_garden(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit);
-                break;
-            case TERRAIN_USAGE_PREFER_ROADS_HIGHWAY:
-                can_travel = map_routing_citizen_can_travel_over_road_garden_highway(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit);
-                if (!can_travel) {
-                    can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
-                        f->destination_x, f->destination_y, direction_limit);
-                }
-                break;
-            case TERRAIN_USAGE_ROADS_HIGHWAY:
-                can_travel = map_routing_citizen_can_travel_over_road_garden_highway(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit);
-                break;
-            default:
-                can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit);
-                break;
-        }
-        if (can_travel) {
-            if (f->terrain_usage == TERRAIN_USAGE_WALLS) {
-                path_length = map_routing_get_path(path->directions, f->destination_x, f->destination_y, 4);
-                if (path_length <= 0) {
-                    path_length = map_routing_get_path(path->directions,
-                        f->destination_x, f->destination_y, direction_limit);
-                }
-            } else {
-                path_length = map_routing_get_path(path->directions,
-                    f->destination_x, f->destination_y, direction_limit);
-            }
-        } else { // cannot travel
-            path_length = 0;
+        path_length = 0;
+        // Only figures heading to a building reuse their destination often enough to be worth a cached field
+        if (f->destination_building_id > 0 &&
+            (f->terrain_usage == TERRAIN_USAGE_ROADS || f->terrain_usage == TERRAIN_USAGE_PREFER_ROADS)) {
+            path_length = map_routing_cache_get_road_path(directions_buffer, MAX_PATH_LENGTH,
+                f->x, f->y, f->destination_x, f->destination_y, direction_limit);
+        }
+        if (!path_length) {
+            path_length = calculate_land_path(f, directions_buffer, direction_limit);
         }
     }
-    if (path_length) {
+    if (path_length > 0 && store_directions(path, directions_buffer, path_length)) {
         path->figure_id = f->id;
         f->routing_path_id = path->id;
         f->routing_path_length = path_length;
@@ -156,7 +290,7 @@ void figure_route_remove(figure *f)
 {
     if (f->routing_path_id > 0) {
         if (f->routing_path_id < paths.size && array_item(paths, f->routing_path_id)->figure_id == f->id) {
-            array_item(paths, f->routing_path_id)->figure_id = 0;
+            release_path(array_item(paths, f->routing_path_id));
         }
         f->routing_path_id = 0;
     }
@@ -165,45 +299,114 @@ void figure_route_remove(figure *f)
 
 int figure_route_get_direction(int path_id, int index)
 {
-    return array_item(paths, path_id)->directions[index];
+    const figure_path_data *path = array_item(paths, path_id);
+    if (index < 0 || (unsigned int) index >= path->length) {
+        return DIR_FIGURE_AT_DESTINATION;
+    }
+    return unpack_direction(&arena.data[path->offset], index);
 }
 
 void figure_route_save_state(buffer *figures, buffer *buf_paths)
 {
-    int size = paths.size * sizeof(int);
+    int size = paths.size * sizeof(int16_t);
     uint8_t *buf_data = malloc(size);
     buffer_init(figures, buf_data, size);
 
-    size = paths.size * sizeof(uint8_t) * MAX_PATH_LENGTH;
+    size = 0;
+    figure_path_data *path;
+    array_foreach(paths, path) {
+        size += sizeof(uint16_t) + (path->figure_id ? packed_size(path->length) : 0);
+    }
     buf_data = malloc(size);
     buffer_init(buf_paths, buf_data, size);
 
-    figure_path_data *path;
     array_foreach(paths, path) {
         buffer_write_i16(figures, path->figure_id);
-        buffer_write_raw(buf_paths, path->directions, MAX_PATH_LENGTH);
+        if (path->figure_id) {
+            buffer_write_u16(buf_paths, path->length);
+            buffer_write_raw(buf_paths, &arena.data[path->offset], packed_size(path->length));
+        } else {
+            buffer_write_u16(buf_paths, 0);
+        }
+    }
+}
+
+static void load_packed_paths(buffer *figures, buffer *buf_paths, int elements_to_load)
+{
+    for (int i = 0; i < elements_to_load; i++) {
+        figure_path_data *path = array_next(paths);
+        path->figure_id = buffer_read_i16(figures);
+        unsigned int length = buffer_read_u16(buf_paths);
+        if (length > MAX_PATH_LENGTH) {
+            length = MAX_PATH_LENGTH;
+        }
+        unsigned int size = packed_size(length);
+        if (!length || !reserve_arena(size)) {
+            buffer_skip(buf_paths, size);
+            path->figure_id = 0;
+            continue;
+        }
+        path->offset = arena.used;
+        path->length = length;
+        buffer_read_raw(buf_paths, &arena.data[arena.used], size);
+        arena.used += size;
+        arena.data[arena.used] = 0;
     }
 }
 
-void figure_route_load_state(buffer *figures, buffer *buf_paths)
+static void load_unpacked_paths(buffer *figures, buffer *buf_paths, int elements_to_load)
 {
-    int elements_to_load = (int) buf_paths->size / MAX_PATH_LENGTH;
+    for (int i = 0; i < elements_to_load; i++) {
+        figure_path_data *path = array_next(paths);
+        path->figure_id = buffer_read_i16(figures);
+        buffer_read_raw(buf_paths, directions_buffer, MAX_PATH_LENGTH);
+        // Old saves always stored the full buffer, so the length comes from the figure that owns the path
+        int length = 0;
+        if (path->figure_id > 0 && path->figure_id < figure_count()) {
+            const figure *f = figure_get(path->figure_id);
+            if (f->routing_path_id == i) {
+                length = f->routing_path_length;
+            }
+        }
+        if (length > MAX_PATH_LENGTH) {
+            length = MAX_PATH_LENGTH;
+        }
+        if (length <= 0 || !store_directions(path, directions_buffer, length)) {
+            path->figure_id = 0;
+        }
+    }
+}
+
+void figure_route_load_state(buffer *figures, buffer *buf_paths, int version)
+{
+    int elements_to_load;
+    if (version > SAVE_GAME_LAST_UNPACKED_FIGURE_PATHS) {
+        elements_to_load = (int) figures->size / sizeof(int16_t);
+    } else {
+        elements_to_load = (int) buf_paths->size / MAX_PATH_LENGTH;
+    }
 
     if (!array_init(paths, ARRAY_SIZE_STEP, create_new_path, path_is_used) ||
         !array_expand(paths, elements_to_load)) {
         log_error("Unable to create paths array. The game will likely crash.", 0, 0);
         return;
     }
+    arena.used = 0;
+    arena.wasted = 0;
 
-    int highest_id_in_use = 0;
+    if (version > SAVE_GAME_LAST_UNPACKED_FIGURE_PATHS) {
+        load_packed_paths(figures, buf_paths, elements_to_load);
+    } else {
+        load_unpacked_paths(figures, buf_paths, elements_to_load);
+    }
 
-    for (int i = 0; i < elements_to_load; i++) {
-        figure_path_data *path = array_next(paths);
-        path->figure_id = buffer_read_i16(figures);
-        buffer_read_raw(buf_paths, path->directions, MAX_PATH_LENGTH);
+    int highest_id_in_use = 0;
+    figure_path_data *path;
+    array_foreach(paths, path) {
         if (path->figure_id) {
-            highest_id_in_use = i;
+            highest_id_in_use = array_index;
         }
     }
     paths.size = highest_id_in_use + 1;
+    array_track_free_slots(paths, 1);
 }
@@ -16,6 +16,6 @@ int figure_route_get_direction(int path_id, int index);
 
 void figure_route_save_state(buffer *figures, buffer *buf_paths);
 
-void figure_route_load_state(buffer *figures, buffer *buf_paths);
+void figure_route_load_state(buffer *figures, buffer *buf_paths, int version);
 
 #endif // FIGURE_ROUTE_H
@@ -2,6 +2,7 @@
 
 #include "building/building.h"
 #include "building/distribution.h"
+#include "building/house_service.h"
 #include "building/model.h"
 #include "building/monument.h"
 #include "city/buildings.h"
@@ -85,111 +86,111 @@ static void labor_seeker_coverage(building *b)
 
 static void theater_coverage(building *b)
 {
-    b->data.house.theater = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_THEATER, MAX_COVERAGE);
 }
 
 static void amphitheater_coverage(building *b, int shows)
 {
-    b->data.house.amphitheater_actor = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_AMPHITHEATER_ACTOR, MAX_COVERAGE);
     if (shows == 2) {
-        b->data.house.amphitheater_gladiator = MAX_COVERAGE;
+        house_service_set(b, HOUSE_SERVICE_AMPHITHEATER_GLADIATOR, MAX_COVERAGE);
     }
 }
 
 static void colosseum_coverage(building *b, int shows)
 {
-    b->data.house.colosseum_gladiator = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_COLOSSEUM_GLADIATOR, MAX_COVERAGE);
     if (shows == 2) {
-        b->data.house.colosseum_lion = MAX_COVERAGE;
+        house_service_set(b, HOUSE_SERVICE_COLOSSEUM_LION, MAX_COVERAGE);
     }
 }
 
 static void arena_coverage(building *b, int shows)
 {
-    b->house_arena_gladiator = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_ARENA_GLADIATOR, MAX_COVERAGE);
     if (shows == 2) {
-        b->house_arena_lion = MAX_COVERAGE;
+        house_service_set(b, HOUSE_SERVICE_ARENA_LION, MAX_COVERAGE);
     }
 }
 
 static void hippodrome_coverage(building *b)
 {
-    b->data.house.hippodrome = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_HIPPODROME, MAX_COVERAGE);
 }
 
 static void tavern_coverage(building *b, int products)
 {
     if (products) {
-        b->house_tavern_wine_access = MAX_COVERAGE;
+        house_service_set(b, HOUSE_SERVICE_TAVERN_WINE, MAX_COVERAGE);
         if (products > 1) {
-            b->house_tavern_food_access = MAX_COVERAGE;
+            house_service_set(b, HOUSE_SERVICE_TAVERN_FOOD, MAX_COVERAGE);
         }
     }
 }
 
 static void bathhouse_coverage(building *b)
 {
-    b->data.house.bathhouse = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_BATHHOUSE, MAX_COVERAGE);
 }
 
 static void religion_coverage_ceres(building *b)
 {
-    b->data.house.temple_ceres = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_TEMPLE_CERES, MAX_COVERAGE);
 }
 
 static void religion_coverage_neptune(building *b)
 {
-    b->data.house.temple_neptune = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_TEMPLE_NEPTUNE, MAX_COVERAGE);
 }
 
 static void religion_coverage_mercury(building *b)
 {
-    b->data.house.temple_mercury = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_TEMPLE_MERCURY, MAX_COVERAGE);
 }
 
 static void religion_coverage_mars(building *b)
 {
-    b->data.house.temple_mars = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_TEMPLE_MARS, MAX_COVERAGE);
 }
 
 static void religion_coverage_venus(building *b)
 {
-    b->data.house.temple_venus = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_TEMPLE_VENUS, MAX_COVERAGE);
 }
 
 static void religion_coverage_pantheon(building *b)
 {
-    b->house_pantheon_access = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_PANTHEON, MAX_COVERAGE);
 }
 
 static void school_coverage(building *b)
 {
-    b->data.house.school = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_SCHOOL, MAX_COVERAGE);
 }
 
 static void academy_coverage(building *b)
 {
-    b->data.house.academy = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_ACADEMY, MAX_COVERAGE);
 }
 
 static void library_coverage(building *b)
 {
-    b->data.house.library = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_LIBRARY, MAX_COVERAGE);
 }
 
 static void barber_coverage(building *b)
 {
-    b->data.house.barber = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_BARBER, MAX_COVERAGE);
 }
 
 static void clinic_coverage(building *b)
 {
-    b->data.house.clinic = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_CLINIC, MAX_COVERAGE);
 }
 
 static void hospital_coverage(building *b)
 {
-    b->data.house.hospital = MAX_COVERAGE;
+    house_service_set(b, HOUSE_SERVICE_HOSPITAL, MAX_COVERAGE);
 }
 
 static void cart_pusher_sickness(building *b, int sickness_dest)
@@ -320,7 +321,7 @@ static void tax_collector_coverage(building *b, int *max_tax_multiplier)
         if (tax_multiplier > *max_tax_multiplier) {
             *max_tax_multiplier = tax_multiplier;
         }
-        b->house_tax_coverage = 50;
+        house_service_set(b, HOUSE_SERVICE_TAX_COLLECTOR, 50);
     }
 }
 
@@ -344,7 +345,7 @@ static void distribute_good(building *b, building *market, int stock_wanted, res
 static void collect_offerings_from_house(building *house, building *temple)
 {
     // offerings are generated, not removed from house stores    
-    if (house->days_since_offering >= MARS_OFFERING_FREQUENCY) {
+    if (house_service_days_since_offering(house) >= MARS_OFFERING_FREQUENCY) {
         for (resource_type r = RESOURCE_MIN_FOOD; r < RESOURCE_MAX_FOOD; r++) {
             if (!resource_is_inventory(r)) {
                 continue;
@@ -360,7 +361,7 @@ static void collect_offerings_from_house(building *house, building *temple)
                 temple->resources[r] = 400;
             }
         }
-        house->days_since_offering = 0;
+        house_service_set_days_since_offering(house, 0);
     }
 }
 
@@ -709,10 +710,8 @@ int figure_service_provide_coverage(figure *f)
     }
     if (f->building_id) {
         b = building_get(f->building_id);
-        b->houses_covered += houses_serviced;
-        if (b->houses_covered > 300) {
-            b->houses_covered = 300;
-        }
+        int houses_covered = house_service_houses_covered(b) + houses_serviced;
+        house_service_set_houses_covered(b, houses_covered > 300 ? 300 : houses_covered);
     }
     return 0;
 }
@@ -26,6 +26,7 @@ void figure_visited_buildings_init(void)
     if (!array_init(visited_buildings, VISITED_BUILDINGS_ARRAY_SIZE_STEP, visited_building_create, visited_building_in_use)) {
         log_error("Unable to allocate enough memory for the visited docks array. The game will now crash.", 0, 0);
     }
+    array_track_free_slots(visited_buildings, 1);
 }
 
 int figure_visited_building_in_list(int index, int building_id)
@@ -59,6 +60,7 @@ void figure_visited_buildings_remove_list(int index)
         index = visited->prev_index;
         visited->prev_index = 0;
         visited->building_id = 0;
+        array_release_item(visited_buildings, visited->index);
     }
     array_trim(visited_buildings);
 }
@@ -89,6 +91,7 @@ void figure_visited_buildings_load_state(buffer *buf)
         visited->building_id = buffer_read_i32(buf);
         visited->prev_index = buffer_read_i32(buf);
     }
+    array_track_free_slots(visited_buildings, 1);
 }
 
 void figure_visited_buildings_migrate(void)
@@ -96,6 +99,7 @@ void figure_visited_buildings_migrate(void)
     if (!array_init(visited_buildings, VISITED_BUILDINGS_ARRAY_SIZE_STEP, visited_building_create, visited_building_in_use)) {
         log_error("Unable to allocate enough memory for the visited docks array. The game will now crash.", 0, 0);
     }
+    array_track_free_slots(visited_buildings, 1);
     for (int i = 0; i < figure_count(); i++) {
         figure *f = figure_get(i);
         if (f->type != FIGURE_TRADE_SHIP || f->state == FIGURE_STATE_DEAD || !f->building_id) {
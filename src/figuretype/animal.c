@@ -131,7 +131,7 @@ void figure_seagulls_action(figure *f)
     }
 }
 
-static void herd_get_destination(int index, const formation *m, uint8_t *x, uint8_t *y)
+static void herd_get_destination(int index, const formation *m, unsigned short *x, unsigned short *y)
 {
     int offset_x = formation_layout_position_x(FORMATION_HERD, index);
     int offset_y = formation_layout_position_y(FORMATION_HERD, index);
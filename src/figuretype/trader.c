@@ -226,7 +226,6 @@ static int trader_get_buy_resource(int building_id, int city_id)
         int resource = space->subtype.warehouse_resource_id;
         if (space->resources[resource] > 0 && empire_can_export_resource_to_city(city_id, resource)) {
             // update stocks
-            city_resource_remove_from_warehouse(resource, 1);
             space->resources[resource]--;
             if (space->resources[resource] <= 0) {
                 space->subtype.warehouse_resource_id = RESOURCE_NONE;
@@ -10,12 +10,14 @@
 #include "city/sentiment.h"
 #include "city/victory.h"
 #include "city/warning.h"
+#include "core/dir.h"
 #include "core/lang.h"
 #include "core/string.h"
 #include "empire/city.h"
 #include "figure/figure.h"
 #include "figuretype/crime.h"
 #include "game/tick.h"
+#include "game/tick_stats.h"
 #include "graphics/color.h"
 #include "graphics/font.h"
 #include "graphics/text.h"
@@ -31,6 +33,7 @@
 #include "window/editor/scenario_events.h"
 #include "window/plain_message_dialog.h"
 
+#include <stdio.h>
 #include <string.h>
 
 static int map_editor_warning_shown;
@@ -50,6 +53,7 @@ static void game_cheat_show_editor(uint8_t *);
 static void game_cheat_cast_curse(uint8_t *);
 static void game_cheat_make_buildings_invincible(uint8_t *);
 static void game_cheat_change_climate(uint8_t *);
+static void game_cheat_tick_stats(uint8_t *);
 
 static void (*const execute_command[])(uint8_t *args) = {
     game_cheat_add_money,
@@ -66,7 +70,8 @@ static void (*const execute_command[])(uint8_t *args) = {
     game_cheat_show_editor,
     game_cheat_cast_curse,
     game_cheat_make_buildings_invincible,
-    game_cheat_change_climate
+    game_cheat_change_climate,
+    game_cheat_tick_stats
 };
 
 static const char *commands[] = {
@@ -84,7 +89,8 @@ static const char *commands[] = {
     "debug.showeditor",
     "curse",
     "romanconcrete",
-    "globalwarming"
+    "globalwarming",
+    "debug.tickstats"
 };
 
 #define NUMBER_OF_COMMANDS sizeof (commands) / sizeof (commands[0])
@@ -291,6 +297,52 @@ static void game_cheat_show_editor(uint8_t *args)
     }
 }
 
+static void show_worst_tick_slot(void)
+{
+    int worst_slot = -1;
+    uint64_t worst_us = 0;
+    for (int slot = 0; slot < TICK_STATS_SLOTS; slot++) {
+        const tick_stats_entry *entry = tick_stats_get_slot(slot);
+        if (entry->calls && entry->max_us >= worst_us) {
+            worst_slot = slot;
+            worst_us = entry->max_us;
+        }
+    }
+    if (worst_slot < 0) {
+        return;
+    }
+    char text[MAX_COMMAND_SIZE];
+    const tick_stats_entry *entry = tick_stats_get_slot(worst_slot);
+    snprintf(text, MAX_COMMAND_SIZE, "Slot %d %s: max %u us, avg %u us", worst_slot,
+        game_tick_slot_name(worst_slot), (unsigned int) entry->max_us, (unsigned int) (entry->total_us / entry->calls));
+    city_warning_show_custom((const uint8_t *) text, NEW_WARNING_SLOT);
+}
+
+static void game_cheat_tick_stats(uint8_t *args)
+{
+    uint8_t action[MAX_COMMAND_SIZE];
+    parse_word(args, action);
+    if (strcmp((char *) action, "off") == 0) {
+        tick_stats_set_enabled(0);
+        show_warning(TR_CHEAT_TICK_STATS_DISABLED);
+    } else if (strcmp((char *) action, "reset") == 0) {
+        tick_stats_reset();
+        show_warning(TR_CHEAT_TICK_STATS_RESET);
+    } else if (strcmp((char *) action, "dump") == 0) {
+        if (tick_stats_write_csv(dir_append_location("tick_stats.csv", PATH_LOCATION_ROOT))) {
+            show_warning(TR_CHEAT_TICK_STATS_SAVED);
+        } else {
+            show_warning(TR_CHEAT_TICK_STATS_SAVE_FAILED);
+        }
+    } else if (strcmp((char *) action, "show") == 0) {
+        show_worst_tick_slot();
+    } else {
+        tick_stats_reset();
+        tick_stats_set_enabled(1);
+        show_warning(TR_CHEAT_TICK_STATS_ENABLED);
+    }
+}
+
 void game_cheat_parse_command(uint8_t *command)
 {
     uint8_t command_to_call[MAX_COMMAND_SIZE];
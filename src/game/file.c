@@ -6,6 +6,8 @@
 #include "building/menu.h"
 #include "building/monument.h"
 #include "building/storage.h"
+#include "building/storage_index.h"
+#include "building/warehouse.h"
 #include "city/data.h"
 #include "city/emperor.h"
 #include "city/map.h"
@@ -200,6 +202,7 @@ static void initialize_scenario_data(const uint8_t *scenario_name)
     image_load_enemy(scenario_property_enemy());
 
     city_data_init_scenario();
+    building_storage_index_recount_warehouses();
 
     setting_set_default_game_speed();
     game_state_unpause();
@@ -275,16 +278,24 @@ static void initialize_saved_game(void)
 
     scenario_map_init();
 
+    const map_tile *entry = city_map_entry_point();
+    city_map_set_entry_point(entry->x, entry->y);
+    const map_tile *exit = city_map_exit_point();
+    city_map_set_exit_point(exit->x, exit->y);
+
     city_view_init();
 
     map_routing_update_all();
 
     map_orientation_update_buildings();
     figure_route_clean();
+    map_road_network_clear();
     map_road_network_update();
     map_routing_update_land();
     building_maintenance_check_rome_access();
     building_granaries_calculate_stocks();
+    building_storage_index_recount_warehouses();
+    building_warehouses_update_road_access();
     building_menu_update();
     city_message_init_problem_areas();
 
@@ -477,6 +488,7 @@ int game_file_make_yearly_autosave(void)
         platform_file_manager_get_directory_for_location(PATH_LOCATION_SAVEGAME, 0), "autosave-year-bak-",
         next_autosave_slot, ".svx");
 
+    game_file_io_finish_pending_save();
     platform_file_manager_copy_file(current_save_name, backup_save_name);
     game_file_write_saved_game(current_save_name);
 
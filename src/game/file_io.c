@@ -39,6 +39,7 @@
 #include "map/desirability.h"
 #include "map/elevation.h"
 #include "map/figure.h"
+#include "map/grid.h"
 #include "map/image.h"
 #include "map/property.h"
 #include "map/random.h"
@@ -46,6 +47,7 @@
 #include "map/sprite.h"
 #include "map/terrain.h"
 #include "map/tiles.h"
+#include "platform/thread.h"
 #include "scenario/allowed_building.h"
 #include "scenario/criteria.h"
 #include "scenario/custom_media.h"
@@ -66,6 +68,7 @@
 #include "sound/city.h"
 #include "widget/minimap.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -73,6 +76,7 @@
 #define COMPRESS_BUFFER_INITIAL_SIZE 1000000
 #define UNCOMPRESSED 0x80000000
 #define PIECE_SIZE_DYNAMIC 0
+#define MAX_COMPRESS_THREADS 4
 
 typedef struct {
     buffer buf;
@@ -80,8 +84,15 @@ typedef struct {
     int dynamic;
 } file_piece;
 
+typedef enum {
+    CHUNK_NO_MEMORY,
+    CHUNK_COMPRESSED,
+    CHUNK_UNCOMPRESSED
+} chunk_status;
+
 typedef struct {
     buffer *resource_version;
+    buffer *grid_size;
     buffer *graphic_ids;
     buffer *edge;
     buffer *terrain;
@@ -121,6 +132,7 @@ typedef struct {
     buffer *scenario_campaign_mission;
     buffer *file_version;
     buffer *scenario_version;
+    buffer *grid_size;
     buffer *image_grid;
     buffer *edge_grid;
     buffer *building_grid;
@@ -274,6 +286,7 @@ typedef struct {
         int visited_buildings;
         int custom_campaigns;
         int dynamic_scenario_objects;
+        int grid_size;
     } features;
 } savegame_version_data;
 
@@ -283,6 +296,22 @@ static struct {
     savegame_state state;
 } savegame_data;
 
+typedef struct {
+    file_piece piece;
+    int worker;
+    chunk_status status;
+    void *compressed_data;
+    int compressed_size;
+} save_piece;
+
+// Snapshot of the savegame pieces that is compressed and written to disk off the game thread
+static struct {
+    platform_thread *thread;
+    FILE *fp;
+    int num_pieces;
+    save_piece pieces[sizeof(savegame_state) / sizeof(buffer *) + 1];
+} pending_save;
+
 static struct {
     minimap_functions functions;
     savegame_version_t version;
@@ -305,6 +334,18 @@ static void init_file_piece(file_piece *piece, int size, int compressed)
     }
 }
 
+static buffer *init_grid_piece(file_piece *piece, int bytes_per_tile, int compressed, int has_grid_size)
+{
+    if (!has_grid_size) {
+        init_file_piece(piece, GRID_SIZE_ORIGINAL * GRID_SIZE_ORIGINAL * bytes_per_tile, compressed);
+    } else {
+        // Sized for saving the current grid, loading replaces the buffer with the size stored in the file
+        init_file_piece(piece, GRID_SIZE * GRID_SIZE * bytes_per_tile, compressed);
+        piece->dynamic = 1;
+    }
+    return &piece->buf;
+}
+
 static buffer *create_scenario_piece(int size, int compressed)
 {
     file_piece *piece = &scenario_data.pieces[scenario_data.num_pieces++];
@@ -312,6 +353,12 @@ static buffer *create_scenario_piece(int size, int compressed)
     return &piece->buf;
 }
 
+static buffer *create_scenario_grid_piece(int bytes_per_tile)
+{
+    file_piece *piece = &scenario_data.pieces[scenario_data.num_pieces++];
+    return init_grid_piece(piece, bytes_per_tile, 0, scenario_data.version > SCENARIO_LAST_FIXED_GRID_SIZE);
+}
+
 static buffer *create_savegame_piece(int size, int compressed)
 {
     file_piece *piece = &savegame_data.pieces[savegame_data.num_pieces++];
@@ -319,6 +366,12 @@ static buffer *create_savegame_piece(int size, int compressed)
     return &piece->buf;
 }
 
+static buffer *create_savegame_grid_piece(int bytes_per_tile, int compressed, int has_grid_size)
+{
+    file_piece *piece = &savegame_data.pieces[savegame_data.num_pieces++];
+    return init_grid_piece(piece, bytes_per_tile, compressed, has_grid_size);
+}
+
 static void clear_savegame_pieces(void)
 {
     for (int i = 0; i < savegame_data.num_pieces; i++) {
@@ -347,12 +400,15 @@ static void init_scenario_data(scenario_version_t version)
     if (version > SCENARIO_LAST_NO_STATIC_RESOURCES) {
         state->resource_version = create_scenario_piece(4, 0);
     }
-    state->graphic_ids = create_scenario_piece(52488, 0);
-    state->edge = create_scenario_piece(26244, 0);
-    state->terrain = create_scenario_piece(52488, 0);
-    state->bitfields = create_scenario_piece(26244, 0);
-    state->random = create_scenario_piece(26244, 0);
-    state->elevation = create_scenario_piece(26244, 0);
+    if (version > SCENARIO_LAST_FIXED_GRID_SIZE) {
+        state->grid_size = create_scenario_piece(4, 0);
+    }
+    state->graphic_ids = create_scenario_grid_piece(2);
+    state->edge = create_scenario_grid_piece(1);
+    state->terrain = create_scenario_grid_piece(2);
+    state->bitfields = create_scenario_grid_piece(1);
+    state->random = create_scenario_grid_piece(1);
+    state->elevation = create_scenario_grid_piece(1);
     state->random_iv = create_scenario_piece(8, 0);
     state->camera = create_scenario_piece(8, 0);
 
@@ -409,8 +465,8 @@ static void get_version_data(savegame_version_data *version_data, savegame_versi
         count_multiplier = PIECE_SIZE_DYNAMIC;
     }
 
-    version_data->piece_sizes.image_grid = 52488 * (version > SAVE_GAME_LAST_SMALLER_IMAGE_ID_VERSION ? 2 : 1);
-    version_data->piece_sizes.terrain_grid = 52488 * (version > SAVE_GAME_LAST_ORIGINAL_TERRAIN_DATA_SIZE_VERSION ? 2 : 1);
+    version_data->piece_sizes.image_grid = 2 * (version > SAVE_GAME_LAST_SMALLER_IMAGE_ID_VERSION ? 2 : 1);
+    version_data->piece_sizes.terrain_grid = 2 * (version > SAVE_GAME_LAST_ORIGINAL_TERRAIN_DATA_SIZE_VERSION ? 2 : 1);
     version_data->piece_sizes.figures = 128000 * multiplier;
     version_data->piece_sizes.route_figures = 1200 * multiplier;
     version_data->piece_sizes.route_paths = 300000 * multiplier;
@@ -498,6 +554,7 @@ static void get_version_data(savegame_version_data *version_data, savegame_versi
     version_data->features.visited_buildings = version > SAVE_GAME_LAST_GLOBAL_BUILDING_INFO;
     version_data->features.custom_campaigns = version > SAVE_GAME_LAST_NO_CUSTOM_CAMPAIGNS;
     version_data->features.dynamic_scenario_objects = version > SAVE_GAME_LAST_STATIC_SCENARIO_ORIGINAL_DATA;
+    version_data->features.grid_size = version > SAVE_GAME_LAST_FIXED_GRID_SIZE;
 }
 
 static void init_savegame_data(savegame_version_t version)
@@ -516,22 +573,26 @@ static void init_savegame_data(savegame_version_t version)
     if (version_data.features.scenario_version) {
         state->scenario_version = create_savegame_piece(4, 0);
     }
+    int has_grid_size = version_data.features.grid_size;
+    if (has_grid_size) {
+        state->grid_size = create_savegame_piece(4, 0);
+    }
     if (version_data.features.image_grid) {
-        state->image_grid = create_savegame_piece(version_data.piece_sizes.image_grid, 1);
-    }
-    state->edge_grid = create_savegame_piece(26244, 1);
-    state->building_grid = create_savegame_piece(52488, 1);
-    state->terrain_grid = create_savegame_piece(version_data.piece_sizes.terrain_grid, 1);
-    state->aqueduct_grid = create_savegame_piece(26244, 1);
-    state->figure_grid = create_savegame_piece(52488, 1);
-    state->bitfields_grid = create_savegame_piece(26244, 1);
-    state->sprite_grid = create_savegame_piece(26244, 1);
-    state->random_grid = create_savegame_piece(26244, 0);
-    state->desirability_grid = create_savegame_piece(26244, 1);
-    state->elevation_grid = create_savegame_piece(26244, 1);
-    state->building_damage_grid = create_savegame_piece(26244, 1);
-    state->aqueduct_backup_grid = create_savegame_piece(26244, 1);
-    state->sprite_backup_grid = create_savegame_piece(26244, 1);
+        state->image_grid = create_savegame_grid_piece(version_data.piece_sizes.image_grid, 1, has_grid_size);
+    }
+    state->edge_grid = create_savegame_grid_piece(1, 1, has_grid_size);
+    state->building_grid = create_savegame_grid_piece(2, 1, has_grid_size);
+    state->terrain_grid = create_savegame_grid_piece(version_data.piece_sizes.terrain_grid, 1, has_grid_size);
+    state->aqueduct_grid = create_savegame_grid_piece(1, 1, has_grid_size);
+    state->figure_grid = create_savegame_grid_piece(2, 1, has_grid_size);
+    state->bitfields_grid = create_savegame_grid_piece(1, 1, has_grid_size);
+    state->sprite_grid = create_savegame_grid_piece(1, 1, has_grid_size);
+    state->random_grid = create_savegame_grid_piece(1, 0, has_grid_size);
+    state->desirability_grid = create_savegame_grid_piece(1, 1, has_grid_size);
+    state->elevation_grid = create_savegame_grid_piece(1, 1, has_grid_size);
+    state->building_damage_grid = create_savegame_grid_piece(1, 1, has_grid_size);
+    state->aqueduct_backup_grid = create_savegame_grid_piece(1, 1, has_grid_size);
+    state->sprite_backup_grid = create_savegame_grid_piece(1, 1, has_grid_size);
     state->figures = create_savegame_piece(version_data.piece_sizes.figures, 1);
     state->route_figures = create_savegame_piece(version_data.piece_sizes.route_figures, 1);
     state->route_paths = create_savegame_piece(version_data.piece_sizes.route_paths, 1);
@@ -657,8 +718,21 @@ static void init_savegame_data(savegame_version_t version)
     }
 }
 
-static void scenario_load_from_state(scenario_state *file, scenario_version_t version)
+static int allocate_grids_from_state(buffer *grid_size_buf)
+{
+    int grid_size = grid_size_buf ? buffer_read_i32(grid_size_buf) : GRID_SIZE_ORIGINAL;
+    if (!map_grid_allocate(grid_size)) {
+        log_error("Unable to load map, unsupported grid size", 0, grid_size);
+        return 0;
+    }
+    return 1;
+}
+
+static int scenario_load_from_state(scenario_state *file, scenario_version_t version)
 {
+    if (!allocate_grids_from_state(version > SCENARIO_LAST_FIXED_GRID_SIZE ? file->grid_size : 0)) {
+        return 0;
+    }
     resource_version_t resource_version = RESOURCE_ORIGINAL_VERSION;
     if (version > SCENARIO_LAST_NO_STATIC_RESOURCES) {
         resource_version = buffer_read_u32(file->resource_version);
@@ -706,11 +780,13 @@ static void scenario_load_from_state(scenario_state *file, scenario_version_t ve
         empire_load_custom_map(file->empire_map);
     }
     buffer_skip(file->end_marker, 4);
+    return 1;
 }
 
 static void scenario_save_to_state(scenario_state *file)
 {
     buffer_write_u32(file->resource_version, RESOURCE_CURRENT_VERSION);
+    buffer_write_i32(file->grid_size, GRID_SIZE);
 
     map_image_save_state_legacy(file->graphic_ids);
     map_terrain_save_state_legacy(file->terrain);
@@ -749,8 +825,11 @@ static scenario_version_t save_version_to_scenario_version(savegame_version_t sa
     return buffer_read_i32(buf);
 }
 
-static void savegame_load_from_state(savegame_state *state, savegame_version_t version)
+static int savegame_load_from_state(savegame_state *state, savegame_version_t version)
 {
+    if (!allocate_grids_from_state(version > SAVE_GAME_LAST_FIXED_GRID_SIZE ? state->grid_size : 0)) {
+        return 0;
+    }
     scenario_version_t scenario_version = save_version_to_scenario_version(version, state->scenario_version);
     scenario_settings_load_state(state->scenario_campaign_mission,
         state->scenario_settings,
@@ -798,7 +877,7 @@ static void savegame_load_from_state(savegame_state *state, savegame_version_t v
     map_desirability_load_state(state->desirability_grid);
     map_elevation_load_state(state->elevation_grid);
     figure_load_state(state->figures, state->figure_sequence, version);
-    figure_route_load_state(state->route_figures, state->route_paths);
+    figure_route_load_state(state->route_figures, state->route_paths, version);
     formations_load_state(state->formations, state->formation_totals, version);
 
     city_data_load_state(state->city_data, state->city_graph_order, state->city_entry_exit_xy,
@@ -870,7 +949,7 @@ static void savegame_load_from_state(savegame_state *state, savegame_version_t v
     if (version <= SAVE_GAME_LAST_SPRITE_BRIDGES_MIGRATION_FIX) {
         map_terrain_migrate_old_bridges();
     }
-
+    return 1;
 }
 
 static void savegame_save_to_state(savegame_state *state)
@@ -878,6 +957,7 @@ static void savegame_save_to_state(savegame_state *state)
     buffer_write_i32(state->file_version, SAVE_GAME_CURRENT_VERSION);
     buffer_write_u32(state->resource_version, RESOURCE_CURRENT_VERSION);
     buffer_write_i32(state->scenario_version, SCENARIO_CURRENT_VERSION);
+    buffer_write_i32(state->grid_size, GRID_SIZE);
 
     scenario_settings_save_state(state->scenario_campaign_mission,
         state->scenario_settings,
@@ -1058,21 +1138,41 @@ static int read_compressed_savegame_chunk(FILE *fp, void *buf, size_t bytes_to_r
     return read_compressed_chunk(fp, buf, bytes_to_read, read_as_zlib, compress_buffer);
 }
 
-static int write_compressed_chunk(FILE *fp, void *buf, size_t bytes_to_write, memory_block *compress_buffer)
+static chunk_status compress_chunk(void *buf, size_t bytes_to_write, memory_block *compress_buffer, int *output_size)
 {
     if (!core_memory_block_ensure_size(compress_buffer, bytes_to_write)) {
-        return 0;
+        return CHUNK_NO_MEMORY;
     }
-    int output_size = 0;
-    if (zlib_helper_compress(buf, (int) bytes_to_write, compress_buffer->memory, COMPRESS_BUFFER_INITIAL_SIZE, &output_size)) {
-        write_int32(fp, output_size);
-        fwrite(compress_buffer->memory, 1, output_size, fp);
-    } else {
-        // unable to compress: write uncompressed
-        write_int32(fp, UNCOMPRESSED);
-        fwrite(buf, 1, bytes_to_write, fp);
+    *output_size = 0;
+    if (zlib_helper_compress(buf, (int) bytes_to_write, compress_buffer->memory, COMPRESS_BUFFER_INITIAL_SIZE, output_size)) {
+        return CHUNK_COMPRESSED;
     }
-    return 1;
+    return CHUNK_UNCOMPRESSED;
+}
+
+static int write_chunk(FILE *fp, chunk_status status, void *buf, size_t bytes_to_write,
+    const void *compressed, int compressed_size)
+{
+    switch (status) {
+        case CHUNK_COMPRESSED:
+            write_int32(fp, compressed_size);
+            fwrite(compressed, 1, compressed_size, fp);
+            return 1;
+        case CHUNK_UNCOMPRESSED:
+            // unable to compress: write uncompressed
+            write_int32(fp, UNCOMPRESSED);
+            fwrite(buf, 1, bytes_to_write, fp);
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static int write_compressed_chunk(FILE *fp, void *buf, size_t bytes_to_write, memory_block *compress_buffer)
+{
+    int output_size;
+    chunk_status status = compress_chunk(buf, bytes_to_write, compress_buffer, &output_size);
+    return write_chunk(fp, status, buf, bytes_to_write, compress_buffer->memory, output_size);
 }
 
 static int prepare_dynamic_piece_from_file(FILE *fp, file_piece *piece)
@@ -1082,6 +1182,7 @@ static int prepare_dynamic_piece_from_file(FILE *fp, file_piece *piece)
         if (!size) {
             return 0;
         }
+        free(piece->buf.data);
         uint8_t *data = malloc(size);
         memset(data, 0, size);
         buffer_init(&piece->buf, data, size);
@@ -1096,6 +1197,7 @@ static int prepare_dynamic_piece_from_buffer(buffer *buf, file_piece *piece)
         if (!size) {
             return 0;
         }
+        free(piece->buf.data);
         uint8_t *data = malloc(size);
         memset(data, 0, size);
         buffer_init(&piece->buf, data, size);
@@ -1195,8 +1297,7 @@ int game_file_io_read_scenario_from_buffer(buffer *buf)
     if (!load_scenario_from_buffer(buf)) {
         return 0;
     }
-    scenario_load_from_state(&scenario_data.state, scenario_data.version);
-    return 1;
+    return scenario_load_from_state(&scenario_data.state, scenario_data.version);
 }
 
 int game_file_io_read_scenario(const char *filename)
@@ -1205,8 +1306,7 @@ int game_file_io_read_scenario(const char *filename)
     if (!load_scenario_to_buffers(filename)) {
         return 0;
     }
-    scenario_load_from_state(&scenario_data.state, scenario_data.version);
-    return 1;
+    return scenario_load_from_state(&scenario_data.state, scenario_data.version);
 }
 
 static int scenario_terrain_at(int grid_offset)
@@ -1427,22 +1527,110 @@ static int savegame_read_from_file(FILE *fp, savegame_version_t version)
     return 1;
 }
 
-static void savegame_write_to_file(FILE *fp, memory_block *compress_buffer)
+static void savegame_compress_piece(save_piece *piece, memory_block *compress_buffer)
 {
-    for (int i = 0; i < savegame_data.num_pieces; i++) {
-        file_piece *piece = &savegame_data.pieces[i];
-        if (piece->dynamic) {
-            write_int32(fp, (int) piece->buf.size);
-            if (!piece->buf.size) {
-                continue;
+    int output_size;
+    piece->status = compress_chunk(piece->piece.buf.data, piece->piece.buf.size, compress_buffer, &output_size);
+    if (piece->status == CHUNK_COMPRESSED) {
+        piece->compressed_data = malloc(output_size);
+        if (piece->compressed_data) {
+            memcpy(piece->compressed_data, compress_buffer->memory, output_size);
+            piece->compressed_size = output_size;
+        } else {
+            piece->status = CHUNK_NO_MEMORY;
+        }
+    }
+}
+
+static int savegame_compress_pieces(void *data)
+{
+    int worker = (int) (intptr_t) data;
+    memory_block compress_buffer;
+    core_memory_block_init(&compress_buffer, COMPRESS_BUFFER_INITIAL_SIZE);
+    for (int i = 0; i < pending_save.num_pieces; i++) {
+        save_piece *piece = &pending_save.pieces[i];
+        if (piece->worker == worker) {
+            savegame_compress_piece(piece, &compress_buffer);
+        }
+    }
+    core_memory_block_free(&compress_buffer);
+    return 0;
+}
+
+static void savegame_assign_workers(int num_workers)
+{
+    // Largest pieces first, each to the worker with the least work so far
+    size_t work[MAX_COMPRESS_THREADS] = { 0 };
+    for (int assigned = 0; assigned < pending_save.num_pieces; assigned++) {
+        save_piece *largest = 0;
+        for (int i = 0; i < pending_save.num_pieces; i++) {
+            save_piece *piece = &pending_save.pieces[i];
+            if (piece->worker == -1 && piece->piece.compressed && piece->piece.buf.size &&
+                (!largest || piece->piece.buf.size > largest->piece.buf.size)) {
+                largest = piece;
             }
         }
-        if (piece->compressed) {
-            write_compressed_chunk(fp, piece->buf.data, piece->buf.size, compress_buffer);
+        if (!largest) {
+            break;
+        }
+        int least_busy = 0;
+        for (int w = 1; w < num_workers; w++) {
+            if (work[w] < work[least_busy]) {
+                least_busy = w;
+            }
+        }
+        largest->worker = least_busy;
+        work[least_busy] += largest->piece.buf.size;
+    }
+}
+
+static void savegame_write_piece(FILE *fp, save_piece *save)
+{
+    file_piece *piece = &save->piece;
+    if (piece->dynamic) {
+        write_int32(fp, (int) piece->buf.size);
+        if (!piece->buf.size) {
+            return;
+        }
+    }
+    if (piece->compressed) {
+        write_chunk(fp, save->status, piece->buf.data, piece->buf.size, save->compressed_data, save->compressed_size);
+    } else {
+        fwrite(piece->buf.data, 1, piece->buf.size, fp);
+    }
+}
+
+static int savegame_write_pending(void *unused)
+{
+    int num_workers = platform_thread_cpu_count();
+    if (num_workers > MAX_COMPRESS_THREADS) {
+        num_workers = MAX_COMPRESS_THREADS;
+    }
+    savegame_assign_workers(num_workers);
+
+    platform_thread *workers[MAX_COMPRESS_THREADS] = { 0 };
+    for (int w = 1; w < num_workers; w++) {
+        workers[w] = platform_thread_create(savegame_compress_pieces, "save_compress", (void *) (intptr_t) w);
+    }
+    savegame_compress_pieces((void *) (intptr_t) 0);
+    for (int w = 1; w < num_workers; w++) {
+        if (workers[w]) {
+            platform_thread_wait(workers[w]);
         } else {
-            fwrite(piece->buf.data, 1, piece->buf.size, fp);
+            savegame_compress_pieces((void *) (intptr_t) w);
         }
     }
+
+    for (int i = 0; i < pending_save.num_pieces; i++) {
+        save_piece *piece = &pending_save.pieces[i];
+        savegame_write_piece(pending_save.fp, piece);
+        free(piece->compressed_data);
+        free(piece->piece.buf.data);
+    }
+    file_close(pending_save.fp);
+    pending_save.fp = 0;
+    pending_save.num_pieces = 0;
+    return 0;
 }
 
 static int get_savegame_versions_from_buffer(buffer *buf, savegame_version_t *save_version,
@@ -1505,13 +1693,14 @@ int game_file_io_read_save_game_from_buffer(buffer *buf)
         log_error("Unable to load game, incompatible savefile.", 0, 0);
         return FILE_LOAD_WRONG_FILE_FORMAT;
     }
-    savegame_load_from_state(&savegame_data.state, save_version);
+    result = savegame_load_from_state(&savegame_data.state, save_version);
     clear_savegame_pieces();
-    return FILE_LOAD_SUCCESS;
+    return result ? FILE_LOAD_SUCCESS : FILE_LOAD_WRONG_FILE_FORMAT;
 }
 
 int game_file_io_read_saved_game(const char *filename, int offset)
 {
+    game_file_io_finish_pending_save();
     log_info("Loading saved game", filename, 0);
     FILE *fp = file_open(filename, "rb");
     if (!fp) {
@@ -1540,9 +1729,9 @@ int game_file_io_read_saved_game(const char *filename, int offset)
         log_error("Unable to load game, incompatible savefile.", 0, 0);
         return FILE_LOAD_WRONG_FILE_FORMAT;
     }
-    savegame_load_from_state(&savegame_data.state, save_version);
+    result = savegame_load_from_state(&savegame_data.state, save_version);
     clear_savegame_pieces();
-    return 1;
+    return result ? 1 : FILE_LOAD_WRONG_FILE_FORMAT;
 }
 
 static int savegame_terrain_at(int grid_offset)
@@ -1674,6 +1863,7 @@ static savegame_load_status savegame_read_file_info(saved_game_info *info, saveg
 
 int game_file_io_read_saved_game_info(const char *filename, int offset, saved_game_info *info)
 {
+    game_file_io_finish_pending_save();
     memset(info, 0, sizeof(saved_game_info));
 
     if (!info) {
@@ -1737,6 +1927,7 @@ int game_file_io_read_saved_game_info_from_buffer(buffer *buf, saved_game_info *
 
 int game_file_io_write_saved_game(const char *filename)
 {
+    game_file_io_finish_pending_save();
     resource_set_mapping(RESOURCE_CURRENT_VERSION);
     init_savegame_data(SAVE_GAME_CURRENT_VERSION);
 
@@ -1746,19 +1937,41 @@ int game_file_io_write_saved_game(const char *filename)
     FILE *fp = file_open(filename, "wb");
     if (!fp) {
         log_error("Unable to save game", 0, 0);
+        clear_savegame_pieces();
         return 0;
     }
-    memory_block compress_buffer;
-    core_memory_block_init(&compress_buffer, COMPRESS_BUFFER_INITIAL_SIZE);
-    savegame_write_to_file(fp, &compress_buffer);
-    core_memory_block_free(&compress_buffer);
-    clear_savegame_pieces();
-    file_close(fp);
+    // Hand the filled pieces over to the writer, the next load or save creates new ones
+    pending_save.fp = fp;
+    pending_save.num_pieces = savegame_data.num_pieces;
+    for (int i = 0; i < savegame_data.num_pieces; i++) {
+        save_piece *piece = &pending_save.pieces[i];
+        piece->piece = savegame_data.pieces[i];
+        piece->worker = -1;
+        piece->status = CHUNK_NO_MEMORY;
+        piece->compressed_data = 0;
+        piece->compressed_size = 0;
+        savegame_data.pieces[i].buf.data = 0;
+    }
+    savegame_data.num_pieces = 0;
+
+    pending_save.thread = platform_thread_create(savegame_write_pending, "save_game", 0);
+    if (!pending_save.thread) {
+        savegame_write_pending(0);
+    }
     return 1;
 }
 
+void game_file_io_finish_pending_save(void)
+{
+    if (pending_save.thread) {
+        platform_thread_wait(pending_save.thread);
+        pending_save.thread = 0;
+    }
+}
+
 int game_file_io_delete_saved_game(const char *filename)
 {
+    game_file_io_finish_pending_save();
     log_info("Deleting game", filename, 0);
     int result = file_remove(filename);
     if (!result) {
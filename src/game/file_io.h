@@ -51,8 +51,19 @@ int game_file_io_read_saved_game_info(const char *filename, int offset, saved_ga
 
 int game_file_io_read_saved_game_info_from_buffer(buffer *buf, saved_game_info *info);
 
+/**
+ * Saves the game. The state is captured immediately, but compressing and writing the file
+ * happens on background threads when they are available.
+ * @param filename File to write
+ * @return Boolean true if the file could be opened for writing
+ */
 int game_file_io_write_saved_game(const char *filename);
 
+/**
+ * Blocks until a saved game that is still being written in the background is complete
+ */
+void game_file_io_finish_pending_save(void);
+
 int game_file_io_delete_saved_game(const char *filename);
 
 #endif // GAME_FILE_IO_H
@@ -13,20 +13,37 @@
 #include "core/random.h"
 #include "core/string.h"
 #include "editor/editor.h"
+#include "figure/roamer_preview.h"
 #include "figure/type.h"
 #include "game/animation.h"
 #include "game/campaign.h"
 #include "game/file.h"
 #include "game/file_editor.h"
+#include "game/file_io.h"
 #include "game/settings.h"
 #include "game/speed.h"
 #include "game/state.h"
 #include "game/tick.h"
 #include "graphics/font.h"
 #include "graphics/graphics.h"
+#include "graphics/screenshot.h"
 #include "graphics/text.h"
 #include "graphics/video.h"
 #include "graphics/window.h"
+#include "map/aqueduct.h"
+#include "map/building.h"
+#include "map/desirability.h"
+#include "map/elevation.h"
+#include "map/figure.h"
+#include "map/image.h"
+#include "map/property.h"
+#include "map/random.h"
+#include "map/road_network.h"
+#include "map/routing.h"
+#include "map/routing_cache.h"
+#include "map/soldier_strength.h"
+#include "map/sprite.h"
+#include "map/terrain.h"
 #include "platform/file_manager.h"
 #include "platform/prefs.h"
 #include "platform/user_path.h"
@@ -35,6 +52,7 @@
 #include "sound/city.h"
 #include "sound/system.h"
 #include "translation/translation.h"
+#include "widget/city_water_ghost.h"
 #include "window/editor/map.h"
 #include "window/logo.h"
 #include "window/main_menu.h"
@@ -54,6 +72,26 @@ static encoding_type update_encoding(void)
     return encoding;
 }
 
+static void init_map_grids(void)
+{
+    map_aqueduct_init_grids();
+    map_building_init_grids();
+    map_desirability_init_grids();
+    map_elevation_init_grids();
+    map_figure_init_grids();
+    map_image_init_grids();
+    map_property_init_grids();
+    map_random_init_grids();
+    map_road_network_init_grids();
+    map_routing_init_grids();
+    map_routing_cache_init_grids();
+    map_soldier_strength_init_grids();
+    map_sprite_init_grids();
+    map_terrain_init_grids();
+    figure_roamer_preview_init_grids();
+    city_water_ghost_init_grids();
+}
+
 int game_pre_init(void)
 {
     settings_load();
@@ -69,6 +107,7 @@ int game_pre_init(void)
     }
     update_encoding();
     random_init();
+    init_map_grids();
     return 1;
 }
 
@@ -140,6 +179,27 @@ int game_init(void)
     return 1;
 }
 
+int game_init_headless(void)
+{
+    if (!image_load_climate(CLIMATE_CENTRAL, 0, 1, 0)) {
+        errlog("unable to load main graphics");
+        return 0;
+    }
+    if (!image_load_enemy(ENEMY_0_BARBARIAN)) {
+        errlog("unable to load enemy graphics");
+        return 0;
+    }
+    if (!model_load()) {
+        errlog("unable to load c3_model.txt");
+        return 0;
+    }
+    building_properties_init();
+    load_augustus_messages();
+    game_state_init();
+    resource_init();
+    return 1;
+}
+
 static int reload_language(int is_editor, int reload_images)
 {
     if (!lang_load(is_editor)) {
@@ -203,6 +263,7 @@ int game_reload_language(void)
 
 void game_run(void)
 {
+    graphics_check_pending_screenshot();
     game_animation_update();
     int num_ticks = game_speed_get_elapsed_ticks();
     for (int i = 0; i < num_ticks; i++) {
@@ -232,8 +293,30 @@ void game_display_fps(int fps)
     text_draw_number_centered_colored(fps, x_offset, y_offset + 6, width, FONT_SMALL_PLAIN, COLOR_BLACK);
 }
 
+#ifdef DRAW_FPS
+void game_display_render_stats(int fps, int average_frame_ms, int max_frame_ms, int draw_calls, int sprites)
+{
+    int x_offset = 8;
+    int y_offset = 24;
+    int width = 110;
+    int height = 56;
+    graphics_draw_rect(x_offset, y_offset, width + 2, height + 2, COLOR_BLACK);
+    graphics_fill_rect(x_offset + 1, y_offset + 1, width, height, COLOR_WHITE);
+    x_offset += 6;
+    y_offset += 6;
+    text_draw_number(fps, 0, " fps", x_offset, y_offset, FONT_SMALL_PLAIN, COLOR_BLACK);
+    int x = x_offset + text_draw_number(average_frame_ms, 0, " /", x_offset, y_offset + 12, FONT_SMALL_PLAIN,
+        COLOR_BLACK);
+    text_draw_number(max_frame_ms, 0, " ms", x, y_offset + 12, FONT_SMALL_PLAIN, COLOR_BLACK);
+    text_draw_number(draw_calls, 0, " draw calls", x_offset, y_offset + 24, FONT_SMALL_PLAIN, COLOR_BLACK);
+    text_draw_number(sprites, 0, " sprites", x_offset, y_offset + 36, FONT_SMALL_PLAIN, COLOR_BLACK);
+}
+#endif
+
 void game_exit(void)
 {
+    game_file_io_finish_pending_save();
+    graphics_finish_pending_screenshot();
     video_shutdown();
     settings_save();
     config_save();
@@ -5,6 +5,12 @@ int game_pre_init(void);
 
 int game_init(void);
 
+/**
+ * Loads the data needed to run the simulation, without fonts, sound or windows
+ * @return Boolean true on success, false on failure
+ */
+int game_init_headless(void);
+
 int game_init_editor(void);
 
 int game_reload_language(void);
@@ -15,6 +21,18 @@ void game_draw(void);
 
 void game_display_fps(int fps);
 
+#ifdef DRAW_FPS
+/**
+ * Draws the frame rate together with the frame time and renderer statistics of the last frame
+ * @param fps Frames drawn in the last second
+ * @param average_frame_ms Average time needed to run and draw a frame in the last second
+ * @param max_frame_ms Longest time needed to run and draw a frame in the last second
+ * @param draw_calls Draw calls sent to the renderer in the last frame
+ * @param sprites Sprites drawn in the last frame
+ */
+void game_display_render_stats(int fps, int average_frame_ms, int max_frame_ms, int draw_calls, int sprites);
+#endif
+
 void game_exit_editor(void);
 
 void game_exit(void);
@@ -2,7 +2,7 @@
 #define GAME_SAVE_VERSION_H
 
 typedef enum {
-    SAVE_GAME_CURRENT_VERSION = 0xa4,
+    SAVE_GAME_CURRENT_VERSION = 0xa7,
 
     SAVE_GAME_LAST_ORIGINAL_LIMITS_VERSION = 0x66,
     SAVE_GAME_LAST_SMALLER_IMAGE_ID_VERSION = 0x76,
@@ -46,11 +46,14 @@ typedef enum {
     SAVE_GAME_LAST_SPRITE_BRIDGES = 0xa0,
     SAVE_GAME_LAST_SPRITE_BRIDGES_MIGRATION_FIX = 0xa1,
     SAVE_GAME_LAST_NO_ALT_NATIVE_HUTS = 0xa2,
-    SAVE_GAME_LAST_NO_EXTRA_NATIVE_BUILDINGS = 0xa3
+    SAVE_GAME_LAST_NO_EXTRA_NATIVE_BUILDINGS = 0xa3,
+    SAVE_GAME_LAST_UNPACKED_FIGURE_PATHS = 0xa4,
+    SAVE_GAME_LAST_FIXED_GRID_SIZE = 0xa5,
+    SAVE_GAME_LAST_NARROW_MAP_POSITIONS = 0xa6
 } savegame_version_t;
 
 typedef enum {
-    SCENARIO_CURRENT_VERSION = 18,
+    SCENARIO_CURRENT_VERSION = 19,
 
     SCENARIO_VERSION_NONE = 0,
     SCENARIO_LAST_UNVERSIONED = 1,
@@ -69,7 +72,8 @@ typedef enum {
     SCENARIO_LAST_NO_CUSTOM_EMPIRE_MAP_IMAGE = 14,
     SCENARIO_LAST_STATIC_ORIGINAL_DATA = 15,
     SCENARIO_LAST_NO_ALT_NATIVE_HUTS = 16,
-    SCENARIO_LAST_NO_EXTRA_NATIVE_BUILDINGS = 17
+    SCENARIO_LAST_NO_EXTRA_NATIVE_BUILDINGS = 17,
+    SCENARIO_LAST_FIXED_GRID_SIZE = 18
 } scenario_version_t;
 
 typedef enum {
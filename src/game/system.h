@@ -33,6 +33,12 @@ const char *system_OS(void);
  */
 uint64_t system_get_ticks(void);
 
+/**
+ * Gets the current value of the high resolution timer, in microseconds
+ * @return Number of microseconds
+ */
+uint64_t system_get_microseconds(void);
+
 /**
  * Resize window
  * @param width New width
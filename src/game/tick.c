@@ -40,6 +40,7 @@
 #include "figuretype/crime.h"
 #include "game/file.h"
 #include "game/settings.h"
+#include "game/tick_stats.h"
 #include "game/time.h"
 #include "game/tutorial.h"
 #include "game/undo.h"
@@ -64,8 +65,113 @@
 #include "sound/music.h"
 #include "widget/minimap.h"
 
+typedef struct {
+    void (*run)(void);
+    const char *name;
+} tick_slot;
+
+static void update_god_moods(void)
+{
+    city_gods_calculate_moods(1);
+}
+
+static void update_road_networks(void)
+{
+    if (map_road_network_update()) {
+        building_warehouses_update_road_access();
+    }
+}
+
+static void update_music(void)
+{
+    sound_music_update(0);
+}
+
+static void update_formations_first_pass(void)
+{
+    formation_update_all(0);
+}
+
+static void update_formations_second_pass(void)
+{
+    formation_update_all(1);
+}
+
+static void check_native_land(void)
+{
+    map_natives_check_land(1);
+}
+
+static void update_production_new_day(void)
+{
+    building_industry_update_production(1);
+}
+
+static void update_production(void)
+{
+    building_industry_update_production(0);
+}
+
+static void run_shows_and_update_coverage(void)
+{
+    building_entertainment_run_shows();
+    city_culture_update_coverage();
+}
+
+static void spawn_tourist(void)
+{
+    city_finance_spawn_tourist();
+}
+
+// Slots without an entry are noop, max is 49
+static const tick_slot TICK_SLOTS[TICK_STATS_SLOTS] = {
+    [1] = { update_god_moods, "city_gods_calculate_moods" },
+    [2] = { update_music, "sound_music_update" },
+    [3] = { widget_minimap_invalidate, "widget_minimap_invalidate" },
+    [4] = { city_emperor_update, "city_emperor_update" },
+    [5] = { update_formations_first_pass, "formation_update_all(0)" },
+    [6] = { check_native_land, "map_natives_check_land" },
+    [7] = { update_road_networks, "update_road_networks" },
+    [8] = { building_granaries_calculate_stocks, "building_granaries_calculate_stocks" },
+    [9] = { city_buildings_update_plague, "city_buildings_update_plague" },
+    [12] = { house_service_decay_houses_covered, "house_service_decay_houses_covered" },
+    [16] = { city_resource_check_warehouse_stocks, "city_resource_check_warehouse_stocks" },
+    [17] = { city_resource_calculate_food_stocks_and_supply_wheat,
+        "city_resource_calculate_food_stocks_and_supply_wheat" },
+    [19] = { building_dock_update_open_water_access, "building_dock_update_open_water_access" },
+    [20] = { update_production_new_day, "building_industry_update_production(1)" },
+    [21] = { building_maintenance_check_rome_access, "building_maintenance_check_rome_access" },
+    [22] = { house_population_update_room, "house_population_update_room" },
+    [23] = { house_population_update_migration, "house_population_update_migration" },
+    [24] = { house_population_evict_overcrowded, "house_population_evict_overcrowded" },
+    [25] = { city_labor_update, "city_labor_update" },
+    [27] = { map_water_supply_update_reservoir_fountain, "map_water_supply_update_reservoir_fountain" },
+    [28] = { map_water_supply_update_buildings, "map_water_supply_update_buildings" },
+    [29] = { update_formations_second_pass, "formation_update_all(1)" },
+    [30] = { widget_minimap_invalidate, "widget_minimap_invalidate" },
+    [31] = { building_figure_generate, "building_figure_generate" },
+    [32] = { city_trade_update, "city_trade_update" },
+    [33] = { run_shows_and_update_coverage, "building_entertainment_run_shows" },
+    [34] = { building_government_distribute_treasury, "building_government_distribute_treasury" },
+    [35] = { house_service_decay_culture, "house_service_decay_culture" },
+    [36] = { house_service_calculate_culture_aggregates, "house_service_calculate_culture_aggregates" },
+    [37] = { map_desirability_update, "map_desirability_update" },
+    [38] = { building_update_desirability, "building_update_desirability" },
+    [39] = { building_house_process_evolve_and_consume_goods, "building_house_process_evolve_and_consume_goods" },
+    [40] = { building_update_state, "building_update_state" },
+    [42] = { spawn_tourist, "city_finance_spawn_tourist" },
+    [43] = { building_maintenance_update_burning_ruins, "building_maintenance_update_burning_ruins" },
+    [44] = { building_maintenance_check_fire_collapse, "building_maintenance_check_fire_collapse" },
+    [45] = { figure_generate_criminals, "figure_generate_criminals" },
+    [46] = { update_production, "building_industry_update_production(0)" },
+    [47] = { city_games_decrement_duration, "city_games_decrement_duration" },
+    [48] = { house_service_decay_tax_collector, "house_service_decay_tax_collector" },
+    [49] = { city_culture_calculate, "city_culture_calculate" }
+};
+
 static void advance_year(void)
 {
+    uint64_t start = tick_stats_start();
     game_undo_disable();
     game_time_advance_year();
     scenario_empire_process_expansion();
@@ -74,10 +180,12 @@ static void advance_year(void)
     empire_city_reset_yearly_trade_amounts();
     building_maintenance_update_fire_direction();
     city_ratings_update(1, 0);
+    tick_stats_record_handler(TICK_STATS_HANDLER_YEAR, start);
 }
 
 static void advance_month(void)
 {
+    uint64_t start = tick_stats_start();
     int new_year = 0;
     city_migration_reset_newcomers();
     city_health_update();
@@ -97,11 +205,13 @@ static void advance_month(void)
     building_industry_start_strikes();
     building_trim();
 
+    uint64_t map_update_start = tick_stats_start();
     building_connectable_update_connections();
     map_tiles_update_all_roads();
     map_tiles_update_all_highways();
     map_tiles_update_all_water();
     map_routing_update_land_citizen();
+    tick_stats_record_handler(TICK_STATS_HANDLER_MONTH_MAP_UPDATE, map_update_start);
     city_message_sort_and_compact();
 
     if (game_time_advance_month()) {
@@ -116,20 +226,26 @@ static void advance_month(void)
     city_games_decrement_month_counts();
     city_gods_update_blessings();
     tutorial_on_month_tick();
+    uint64_t events_start = tick_stats_start();
     scenario_events_progress_paused(1);
     scenario_events_process_all();
+    tick_stats_record_handler(TICK_STATS_HANDLER_MONTH_SCENARIO_EVENTS, events_start);
+    uint64_t autosave_start = tick_stats_start();
     if (setting_monthly_autosave()) {
         game_file_write_saved_game(dir_append_location("autosave.svx", PATH_LOCATION_SAVEGAME));
     }
     if (new_year && config_get(CONFIG_GP_CH_YEARLY_AUTOSAVE)) {
         game_file_make_yearly_autosave();
     }
+    tick_stats_record_handler(TICK_STATS_HANDLER_MONTH_AUTOSAVE, autosave_start);
 
     city_weather_update(game_time_month());
+    tick_stats_record_handler(TICK_STATS_HANDLER_MONTH, start);
 }
 
 static void advance_day(void)
 {
+    uint64_t start = tick_stats_start();
     if (game_time_advance_day()) {
         advance_month();
     }
@@ -140,56 +256,17 @@ static void advance_day(void)
         building_lighthouse_consume_timber();
     }
     tutorial_on_day_tick();
+    tick_stats_record_handler(TICK_STATS_HANDLER_DAY, start);
 }
 
 static void advance_tick(void)
 {
-    // NB: these ticks are noop:
-    // 0, 10, 11, 13, 14, 15, 18, 26, 41
-    // max is 49
-    switch (game_time_tick()) {
-        case 1: city_gods_calculate_moods(1); break;
-        case 2: sound_music_update(0); break;
-        case 3: widget_minimap_invalidate(); break;
-        case 4: city_emperor_update(); break;
-        case 5: formation_update_all(0); break;
-        case 6: map_natives_check_land(1); break;
-        case 7: map_road_network_update(); break;
-        case 8: building_granaries_calculate_stocks(); break;
-        case 9: city_buildings_update_plague(); break;
-        case 12: house_service_decay_houses_covered(); break;
-        case 16: city_resource_calculate_warehouse_stocks(); break;
-        case 17: city_resource_calculate_food_stocks_and_supply_wheat(); break;
-        case 19: building_dock_update_open_water_access(); break;
-        case 20: building_industry_update_production(1); break;
-        case 21: building_maintenance_check_rome_access(); break;
-        case 22: house_population_update_room(); break;
-        case 23: house_population_update_migration(); break;
-        case 24: house_population_evict_overcrowded(); break;
-        case 25: city_labor_update(); break;
-        case 27: map_water_supply_update_reservoir_fountain(); break;
-        case 28: map_water_supply_update_buildings(); break;
-        case 29: formation_update_all(1); break;
-        case 30: widget_minimap_invalidate(); break;
-        case 31: building_figure_generate(); break;
-        case 32: city_trade_update(); break;
-        case 33: building_entertainment_run_shows(); city_culture_update_coverage(); break;
-        case 34: building_government_distribute_treasury(); break;
-        case 35: house_service_decay_culture(); break;
-        case 36: house_service_calculate_culture_aggregates(); break;
-        case 37: map_desirability_update(); break;
-        case 38: building_update_desirability(); break;
-        case 39: building_house_process_evolve_and_consume_goods(); break;
-        case 40: building_update_state(); break;
-        case 42: city_finance_spawn_tourist(); break;
-        case 43: building_maintenance_update_burning_ruins(); break;
-        case 44: building_maintenance_check_fire_collapse(); break;
-        case 45: figure_generate_criminals(); break;
-        case 46: building_industry_update_production(0); break;
-        case 47: city_games_decrement_duration(); break;
-        case 48: house_service_decay_tax_collector(); break;
-        case 49: city_culture_calculate(); break;
+    int slot = game_time_tick();
+    uint64_t slot_start = tick_stats_start();
+    if (TICK_SLOTS[slot].run) {
+        TICK_SLOTS[slot].run();
     }
+    tick_stats_record_slot(slot, slot_start);
     if (game_time_advance_tick()) {
         advance_day();
     }
@@ -202,17 +279,29 @@ void game_tick_run(void)
         figure_action_handle(); // just update the flag figures
         return;
     }
+    uint64_t tick_start = tick_stats_start();
     random_generate_next();
     game_undo_reduce_time_available();
     advance_tick();
+    uint64_t figures_start = tick_stats_start();
     figure_action_handle();
+    tick_stats_record_figures(figures_start);
     scenario_earthquake_process();
     scenario_gladiator_revolt_process();
     scenario_emperor_change_process();
     city_victory_check();
+    tick_stats_record_tick(tick_start);
 }
 
 void game_tick_cheat_year(void)
 {
     advance_year();
 }
+
+const char *game_tick_slot_name(int slot)
+{
+    if (slot < 0 || slot >= TICK_STATS_SLOTS) {
+        return 0;
+    }
+    return TICK_SLOTS[slot].name;
+}
@@ -5,4 +5,11 @@ void game_tick_run(void);
 
 void game_tick_cheat_year(void);
 
+/**
+ * Gets a descriptive name for what runs on an advance_tick slot
+ * @param slot Tick slot within the day
+ * @return Name of the slot, or 0 if the slot does nothing
+ */
+const char *game_tick_slot_name(int slot);
+
 #endif // GAME_TICK_H
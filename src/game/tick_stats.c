@@ -0,0 +1,169 @@
+#include "tick_stats.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "game/system.h"
+#include "game/tick.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+static const char *HANDLER_NAMES[TICK_STATS_HANDLER_MAX] = {
+    "advance_day",
+    "advance_month",
+    "advance_month: map and routing update",
+    "advance_month: scenario events",
+    "advance_month: autosave",
+    "advance_year"
+};
+
+static struct {
+    int enabled;
+    tick_stats_entry slots[TICK_STATS_SLOTS];
+    tick_stats_entry handlers[TICK_STATS_HANDLER_MAX];
+    tick_stats_entry figure_types[FIGURE_TYPE_MAX];
+    tick_stats_entry figures;
+    tick_stats_entry tick;
+} data;
+
+static void add_time(tick_stats_entry *entry, uint64_t start)
+{
+    uint64_t elapsed = system_get_microseconds() - start;
+    entry->calls++;
+    entry->total_us += elapsed;
+    if (elapsed > entry->max_us) {
+        entry->max_us = elapsed;
+    }
+}
+
+void tick_stats_set_enabled(int enabled)
+{
+    data.enabled = enabled;
+}
+
+int tick_stats_is_enabled(void)
+{
+    return data.enabled;
+}
+
+void tick_stats_reset(void)
+{
+    int enabled = data.enabled;
+    memset(&data, 0, sizeof(data));
+    data.enabled = enabled;
+}
+
+uint64_t tick_stats_start(void)
+{
+    return data.enabled ? system_get_microseconds() : 0;
+}
+
+void tick_stats_record_slot(int slot, uint64_t start)
+{
+    if (data.enabled && slot >= 0 && slot < TICK_STATS_SLOTS) {
+        add_time(&data.slots[slot], start);
+    }
+}
+
+void tick_stats_record_handler(tick_stats_handler handler, uint64_t start)
+{
+    if (data.enabled && handler >= 0 && handler < TICK_STATS_HANDLER_MAX) {
+        add_time(&data.handlers[handler], start);
+    }
+}
+
+void tick_stats_record_figure_type(figure_type type, uint64_t start)
+{
+    if (data.enabled && type >= 0 && type < FIGURE_TYPE_MAX) {
+        add_time(&data.figure_types[type], start);
+    }
+}
+
+void tick_stats_record_figures(uint64_t start)
+{
+    if (data.enabled) {
+        add_time(&data.figures, start);
+    }
+}
+
+void tick_stats_record_tick(uint64_t start)
+{
+    if (data.enabled) {
+        add_time(&data.tick, start);
+    }
+}
+
+const tick_stats_entry *tick_stats_get_slot(int slot)
+{
+    if (slot < 0 || slot >= TICK_STATS_SLOTS) {
+        return 0;
+    }
+    return &data.slots[slot];
+}
+
+const tick_stats_entry *tick_stats_get_handler(tick_stats_handler handler)
+{
+    if (handler < 0 || handler >= TICK_STATS_HANDLER_MAX) {
+        return 0;
+    }
+    return &data.handlers[handler];
+}
+
+const char *tick_stats_handler_name(tick_stats_handler handler)
+{
+    if (handler < 0 || handler >= TICK_STATS_HANDLER_MAX) {
+        return 0;
+    }
+    return HANDLER_NAMES[handler];
+}
+
+const tick_stats_entry *tick_stats_get_figure_type(figure_type type)
+{
+    if (type < 0 || type >= FIGURE_TYPE_MAX) {
+        return 0;
+    }
+    return &data.figure_types[type];
+}
+
+const tick_stats_entry *tick_stats_get_figures(void)
+{
+    return &data.figures;
+}
+
+const tick_stats_entry *tick_stats_get_tick(void)
+{
+    return &data.tick;
+}
+
+static void write_csv_line(FILE *fp, const char *category, int id, const char *name, const tick_stats_entry *entry)
+{
+    if (!entry->calls) {
+        return;
+    }
+    fprintf(fp, "%s,%d,\"%s\",%" PRIu32 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n", category, id, name ? name : "",
+        entry->calls, entry->total_us, entry->total_us / entry->calls, entry->max_us);
+}
+
+int tick_stats_write_csv(const char *filename)
+{
+    FILE *fp = file_open(filename, "w");
+    if (!fp) {
+        log_error("Unable to write tick statistics to", filename, 0);
+        return 0;
+    }
+    fprintf(fp, "category,id,name,calls,total_us,avg_us,max_us\n");
+    write_csv_line(fp, "tick", 0, "game_tick_run", &data.tick);
+    for (int slot = 0; slot < TICK_STATS_SLOTS; slot++) {
+        write_csv_line(fp, "slot", slot, game_tick_slot_name(slot), &data.slots[slot]);
+    }
+    for (tick_stats_handler handler = 0; handler < TICK_STATS_HANDLER_MAX; handler++) {
+        write_csv_line(fp, "handler", handler, HANDLER_NAMES[handler], &data.handlers[handler]);
+    }
+    write_csv_line(fp, "figures", 0, "figure_action_handle", &data.figures);
+    for (figure_type type = FIGURE_NONE; type < FIGURE_TYPE_MAX; type++) {
+        write_csv_line(fp, "figure_type", type, 0, &data.figure_types[type]);
+    }
+    file_close(fp);
+    log_info("Tick statistics written to", filename, 0);
+    return 1;
+}
@@ -0,0 +1,107 @@
+#ifndef GAME_TICK_STATS_H
+#define GAME_TICK_STATS_H
+
+#include "figure/type.h"
+
+#include <stdint.h>
+
+/**
+ * @file
+ * Timing statistics for the simulation tick.
+ * Collection is disabled by default and costs a single flag check per phase when off.
+ */
+
+#define TICK_STATS_SLOTS 50
+
+typedef enum {
+    TICK_STATS_HANDLER_DAY,
+    TICK_STATS_HANDLER_MONTH,
+    TICK_STATS_HANDLER_MONTH_MAP_UPDATE,
+    TICK_STATS_HANDLER_MONTH_SCENARIO_EVENTS,
+    TICK_STATS_HANDLER_MONTH_AUTOSAVE,
+    TICK_STATS_HANDLER_YEAR,
+    TICK_STATS_HANDLER_MAX
+} tick_stats_handler;
+
+typedef struct {
+    uint32_t calls;
+    uint64_t total_us;
+    uint64_t max_us;
+} tick_stats_entry;
+
+/**
+ * Enables or disables timing collection
+ * @param enabled Boolean: 1 for enable, 0 for disable
+ */
+void tick_stats_set_enabled(int enabled);
+
+/**
+ * Checks whether timing collection is enabled
+ * @return Boolean true when enabled
+ */
+int tick_stats_is_enabled(void);
+
+/**
+ * Clears all collected statistics
+ */
+void tick_stats_reset(void);
+
+/**
+ * Starts timing a phase
+ * @return Timestamp to pass to one of the record functions, 0 when collection is disabled
+ */
+uint64_t tick_stats_start(void);
+
+/**
+ * Records the time spent in an advance_tick slot
+ * @param slot Tick slot, 0 to TICK_STATS_SLOTS - 1
+ * @param start Timestamp returned by tick_stats_start
+ */
+void tick_stats_record_slot(int slot, uint64_t start);
+
+/**
+ * Records the time spent in a day, month or year handler
+ * @param handler Handler that was run
+ * @param start Timestamp returned by tick_stats_start
+ */
+void tick_stats_record_handler(tick_stats_handler handler, uint64_t start);
+
+/**
+ * Records the time spent running the action callback of a single figure
+ * @param type Figure type
+ * @param start Timestamp returned by tick_stats_start
+ */
+void tick_stats_record_figure_type(figure_type type, uint64_t start);
+
+/**
+ * Records the time spent handling figure actions
+ * @param start Timestamp returned by tick_stats_start
+ */
+void tick_stats_record_figures(uint64_t start);
+
+/**
+ * Records the time spent in a full game tick
+ * @param start Timestamp returned by tick_stats_start
+ */
+void tick_stats_record_tick(uint64_t start);
+
+const tick_stats_entry *tick_stats_get_slot(int slot);
+
+const tick_stats_entry *tick_stats_get_handler(tick_stats_handler handler);
+
+const char *tick_stats_handler_name(tick_stats_handler handler);
+
+const tick_stats_entry *tick_stats_get_figure_type(figure_type type);
+
+const tick_stats_entry *tick_stats_get_figures(void);
+
+const tick_stats_entry *tick_stats_get_tick(void);
+
+/**
+ * Writes all non-empty statistics as CSV
+ * @param filename File to write to
+ * @return Boolean true on success, false on failure
+ */
+int tick_stats_write_csv(const char *filename);
+
+#endif // GAME_TICK_STATS_H
@@ -8,6 +8,7 @@
 #include "building/monument.h"
 #include "building/properties.h"
 #include "building/storage.h"
+#include "building/storage_index.h"
 #include "building/warehouse.h"
 #include "building/storage.h"
 #include "city/buildings.h"
@@ -20,6 +21,7 @@
 #include "map/aqueduct.h"
 #include "map/building.h"
 #include "map/building_tiles.h"
+#include "map/desirability.h"
 #include "map/grid.h"
 #include "map/image.h"
 #include "map/property.h"
@@ -146,6 +148,7 @@ void game_undo_restore_building_state(void)
             building *b = building_get(data.buildings[i].id);
             if (b->state == BUILDING_STATE_DELETED_BY_PLAYER) {
                 b->state = BUILDING_STATE_IN_USE;
+                map_desirability_building_changed(b->id);
             }
             b->is_deleted = 0;
         }
@@ -204,6 +207,7 @@ static void add_building_to_terrain(building *b)
         }
     }
     b->state = BUILDING_STATE_IN_USE;
+    map_desirability_building_changed(b->id);
 }
 
 void game_undo_perform(void)
@@ -225,6 +229,9 @@ void game_undo_perform(void)
                         if (!building_storage_restore(b->storage_id)) {
                             building_storage_reset_building_ids();
                         }
+                        if (b->type == BUILDING_WAREHOUSE) {
+                            building_storage_index_warehouse_changed(b->id);
+                        }
                         break;
                     case BUILDING_TRIUMPHAL_ARCH:
                         city_buildings_build_triumphal_arch();
@@ -241,6 +248,7 @@ void game_undo_perform(void)
                 add_building_to_terrain(b);
             }
         }
+        building_storage_index_invalidate();
         map_terrain_restore();
         map_aqueduct_restore();
         map_sprite_restore();
@@ -271,6 +279,7 @@ void game_undo_perform(void)
         for (int i = 0; i < data.num_buildings; i++) {
             if (data.buildings[i].id) {
                 building_get(data.buildings[i].id)->state = BUILDING_STATE_UNDO;
+                map_desirability_building_changed(data.buildings[i].id);
             }
         }
         building_update_state();
@@ -85,7 +85,7 @@ int graphics_save_to_image(int image_id, int x, int y, int width, int height)
     return graphics_renderer()->save_image_from_screen(image_id, x, y, width, height);
 }
 
-void graphics_draw_from_image(int image_id, int x, int y)
+int graphics_draw_from_image(int image_id, int x, int y)
 {
-    graphics_renderer()->draw_image_to_screen(image_id, x, y);
+    return graphics_renderer()->draw_image_to_screen(image_id, x, y);
 }
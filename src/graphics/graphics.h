@@ -22,6 +22,7 @@ void graphics_shade_rect(int x, int y, int width, int height, int darkness);
 void graphics_tint_rect(int x, int y, int width, int height, color_t rgb, int alpha_level);
 
 int graphics_save_to_image(int image_id, int x, int y, int width, int height);
-void graphics_draw_from_image(int image_id, int x, int y);
+// Returns 0 when the image could not be drawn, such as after the render targets were reset
+int graphics_draw_from_image(int image_id, int x, int y);
 
 #endif // GRAPHICS_GRAPHICS_H
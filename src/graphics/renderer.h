@@ -76,8 +76,11 @@ typedef struct {
     void (*set_tooltip_position)(int x, int y);
     void (*set_tooltip_opacity)(int opacity);
 
+    int (*start_offscreen_render)(int width, int height);
+    void (*finish_offscreen_render)(void);
+
     int (*save_image_from_screen)(int image_id, int x, int y, int width, int height);
-    void (*draw_image_to_screen)(int image_id, int x, int y);
+    int (*draw_image_to_screen)(int image_id, int x, int y);
     int (*save_screen_buffer)(color_t *pixels, int x, int y, int width, int height, int row_width);
 
     void (*get_max_image_size)(int *width, int *height);
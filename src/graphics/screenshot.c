@@ -3,7 +3,6 @@
 #include "city/view.h"
 #include "city/warning.h"
 #include "core/buffer.h"
-#include "core/config.h"
 #include "core/file.h"
 #include "core/log.h"
 #include "core/string.h"
@@ -14,6 +13,7 @@
 #include "graphics/screen.h"
 #include "graphics/window.h"
 #include "map/grid.h"
+#include "platform/thread.h"
 #include "translation/translation.h"
 #include "widget/city_without_overlay.h"
 #include "widget/minimap.h"
@@ -30,6 +30,15 @@
 #define IMAGE_HEIGHT_CHUNK (TILE_Y_SIZE * 15)
 #define IMAGE_BYTES_PER_PIXEL 3
 #define MINIMAP_SCALE 2.0f
+#define MAX_QUEUED_ROW_BYTES (64 * 1024 * 1024)
+
+typedef struct png_rows {
+    uint8_t *pixels;
+    int num_rows;
+    int num_bytes;
+    int is_last;
+    struct png_rows *next;
+} png_rows;
 
 static struct {
     int width;
@@ -42,8 +51,21 @@ static struct {
     uint8_t *pixels;
     FILE *fp;
     spng_ctx *ctx;
+    char filename[FILE_NAME_MAX];
+    int notice_pending;
 } screenshot;
 
+// A single encoder thread compresses the queued rows of a full city screenshot in order
+static struct {
+    platform_thread *thread;
+    platform_mutex *lock;
+    platform_condition *changed;
+    png_rows *first;
+    png_rows *last;
+    int queued_bytes;
+    int aborted;
+} encoder;
+
 static void image_free(void)
 {
     screenshot.width = 0;
@@ -91,6 +113,24 @@ static int image_create(int width, int height, int has_alpha_channel, int rows_i
     return 1;
 }
 
+static const char *generate_filename_from_name(screenshot_type type, const char *name)
+{
+    char filename[FILE_NAME_MAX];
+    switch (type) {
+        case SCREENSHOT_FULL_CITY:
+            snprintf(filename, FILE_NAME_MAX, "%s full city.png", name);
+            break;
+        case SCREENSHOT_MINIMAP:
+            snprintf(filename, FILE_NAME_MAX, "%s minimap.png", name);
+            break;
+        case SCREENSHOT_DISPLAY:
+        default:
+            snprintf(filename, FILE_NAME_MAX, "%s city.png", name);
+            break;
+    }
+    return dir_append_location(filename, PATH_LOCATION_SCREENSHOT);
+}
+
 static const char *generate_filename(screenshot_type type)
 {
     char filename[FILE_NAME_MAX];
@@ -157,41 +197,172 @@ static int image_request_rows(void)
     return 0;
 }
 
-static int image_write_rows(const color_t *canvas, int canvas_width)
+static void image_pack_row(uint8_t *pixel, const color_t *canvas, int width)
 {
-    int bytes_per_pixel = IMAGE_BYTES_PER_PIXEL;
     if (screenshot.alpha_channel) {
-        bytes_per_pixel += 1;
+        for (int x = 0; x < width; x++) {
+            color_t input = canvas[x];
+            *(pixel + 0) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_RED);
+            *(pixel + 1) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_GREEN);
+            *(pixel + 2) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_BLUE);
+            *(pixel + 3) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_ALPHA);
+            pixel += IMAGE_BYTES_PER_PIXEL + 1;
+        }
+    } else {
+        for (int x = 0; x < width; x++) {
+            color_t input = canvas[x];
+            *(pixel + 0) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_RED);
+            *(pixel + 1) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_GREEN);
+            *(pixel + 2) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_BLUE);
+            pixel += IMAGE_BYTES_PER_PIXEL;
+        }
     }
+}
+
+static int image_encode_row(const uint8_t *pixels)
+{
+    int result = spng_encode_scanline(screenshot.ctx, pixels, screenshot.row_size);
+    return result == SPNG_OK || result == SPNG_EOI;
+}
+
+static int image_write_rows(const color_t *canvas, int canvas_width)
+{
     for (int y = 0; y < screenshot.rows_in_memory; ++y) {
-        uint8_t *pixel = screenshot.pixels;
-        if (screenshot.alpha_channel) {
-            for (int x = 0; x < screenshot.width; x++) {
-                color_t input = canvas[y * canvas_width + x];
-                *(pixel + 0) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_RED);
-                *(pixel + 1) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_GREEN);
-                *(pixel + 2) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_BLUE);
-                *(pixel + 3) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_ALPHA);
-                pixel += bytes_per_pixel;
-            }
+        image_pack_row(screenshot.pixels, &canvas[y * canvas_width], screenshot.width);
+        if (!image_encode_row(screenshot.pixels)) {
+            image_free();
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int encode_rows(png_rows *rows, int success)
+{
+    for (int y = 0; success && y < rows->num_rows; y++) {
+        success = image_encode_row(&rows->pixels[y * screenshot.row_size]);
+    }
+    if (rows->is_last) {
+        if (success) {
+            log_info("Saved full city screenshot:", screenshot.filename, 0);
         } else {
-            for (int x = 0; x < screenshot.width; x++) {
-                color_t input = canvas[y * canvas_width + x];
-                *(pixel + 0) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_RED);
-                *(pixel + 1) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_GREEN);
-                *(pixel + 2) = (uint8_t) COLOR_COMPONENT(input, COLOR_BITSHIFT_BLUE);
-                pixel += bytes_per_pixel;
-            }
+            log_error("Error writing image", screenshot.filename, 0);
         }
-        int result = spng_encode_scanline(screenshot.ctx, screenshot.pixels, (size_t) screenshot.width * bytes_per_pixel);
-        if (result != SPNG_OK && result != SPNG_EOI) {
-            image_free();
+        image_free();
+    }
+    free(rows);
+    return success;
+}
+
+static int encode_queued_rows(void *data)
+{
+    int success = 1;
+    int is_last = 0;
+    while (!is_last) {
+        platform_mutex_lock(encoder.lock);
+        while (!encoder.first && !encoder.aborted) {
+            platform_condition_wait(encoder.changed, encoder.lock);
+        }
+        png_rows *rows = encoder.first;
+        if (!rows) {
+            // Drawing failed, the image is released by the main thread
+            platform_mutex_unlock(encoder.lock);
             return 0;
         }
+        encoder.first = rows->next;
+        if (!encoder.first) {
+            encoder.last = 0;
+        }
+        platform_mutex_unlock(encoder.lock);
+
+        int num_bytes = rows->num_bytes;
+        is_last = rows->is_last;
+        success = encode_rows(rows, success);
+
+        platform_mutex_lock(encoder.lock);
+        encoder.queued_bytes -= num_bytes;
+        platform_condition_broadcast(encoder.changed);
+        platform_mutex_unlock(encoder.lock);
+    }
+    return success;
+}
+
+static png_rows *create_queued_rows(int num_rows, int row_size)
+{
+    png_rows *rows = malloc(sizeof(png_rows) + (size_t) num_rows * row_size);
+    if (!rows) {
+        return 0;
+    }
+    rows->pixels = (uint8_t *) (rows + 1);
+    rows->num_rows = num_rows;
+    rows->num_bytes = num_rows * row_size;
+    rows->is_last = 0;
+    rows->next = 0;
+    return rows;
+}
+
+static int start_encoder(void)
+{
+    if (!encoder.lock) {
+        encoder.lock = platform_mutex_create();
+    }
+    if (!encoder.changed) {
+        encoder.changed = platform_condition_create();
+    }
+    if (!encoder.lock || !encoder.changed) {
+        return 0;
+    }
+    encoder.first = 0;
+    encoder.last = 0;
+    encoder.queued_bytes = 0;
+    encoder.aborted = 0;
+    encoder.thread = platform_thread_create(encode_queued_rows, "screenshot", 0);
+    return encoder.thread != 0;
+}
+
+static int queue_rows(png_rows *rows)
+{
+    if (!encoder.thread && !start_encoder()) {
+        return encode_rows(rows, 1);
+    }
+    platform_mutex_lock(encoder.lock);
+    // Drawing waits for the encoder when too many rows are waiting to be compressed
+    while (encoder.queued_bytes > MAX_QUEUED_ROW_BYTES) {
+        platform_condition_wait(encoder.changed, encoder.lock);
+    }
+    if (encoder.last) {
+        encoder.last->next = rows;
+    } else {
+        encoder.first = rows;
     }
+    encoder.last = rows;
+    encoder.queued_bytes += rows->num_bytes;
+    platform_condition_broadcast(encoder.changed);
+    platform_mutex_unlock(encoder.lock);
     return 1;
 }
 
+static void abort_queued_rows(void)
+{
+    if (!encoder.thread) {
+        return;
+    }
+    platform_mutex_lock(encoder.lock);
+    encoder.aborted = 1;
+    platform_condition_broadcast(encoder.changed);
+    platform_mutex_unlock(encoder.lock);
+}
+
+static int finish_queued_rows(void)
+{
+    if (!encoder.thread) {
+        return 1;
+    }
+    int success = platform_thread_wait(encoder.thread);
+    encoder.thread = 0;
+    return success;
+}
+
 static int image_write_canvas(void)
 {
     const color_t *canvas;
@@ -215,10 +386,10 @@ static int image_write_canvas(void)
     return 1;
 }
 
-static void show_saved_notice(const char *filename)
+static void show_notice(translation_key key, const char *filename)
 {
     uint8_t notice_text[FILE_NAME_MAX];
-    const uint8_t *prefix = translation_for(TR_WARNING_SCREENSHOT_SAVED);
+    const uint8_t *prefix = translation_for(key);
     string_copy(prefix, notice_text, FILE_NAME_MAX);
     int prefix_length = string_length(prefix);
     string_copy(string_from_ascii(filename), &notice_text[prefix_length], FILE_NAME_MAX - prefix_length);
@@ -226,122 +397,140 @@ static void show_saved_notice(const char *filename)
     city_warning_show_custom(notice_text, 0);
 }
 
-static void create_window_screenshot(void)
+static void show_saved_notice(const char *filename)
+{
+    show_notice(TR_WARNING_SCREENSHOT_SAVED, filename);
+}
+
+static int create_window_screenshot(const char *filename)
 {
     int width = screen_width();
     int height = screen_height();
 
     if (!image_create(width, height, 0, 1)) {
         log_error("Unable to create memory for screenshot", 0, 0);
-        return;
+        return 0;
     }
 
-    const char *filename = generate_filename(SCREENSHOT_DISPLAY);
     if (!image_begin_io(filename) || !image_write_header()) {
         log_error("Unable to write screenshot to:", filename, 0);
         image_free();
-        return;
+        return 0;
     }
 
     if (!image_write_canvas()) {
         log_error("Error writing image", 0, 0);
         image_free();
-        return;
+        return 0;
     }
 
     log_info("Saved screenshot:", filename, 0);
     show_saved_notice(filename);
     image_free();
+    return 1;
 }
 
-static void create_full_city_screenshot(void)
+static int render_full_city_rows(png_rows *rows, color_t *canvas, int tile_width, int camera_x, int camera_y)
 {
-    if (!window_is(WINDOW_CITY) && !window_is(WINDOW_CITY_MILITARY)) {
-        return;
+    map_tile dummy_tile = { 0, 0, 0 };
+    for (int x = 0; x < screenshot.width; x += tile_width) {
+        int width = screenshot.width - x < tile_width ? screenshot.width - x : tile_width;
+        city_view_set_offscreen_camera(camera_x + x, camera_y);
+        city_without_overlay_draw(0, 0, &dummy_tile, 0);
+        if (!graphics_renderer()->save_screen_buffer(canvas, 0, 0, width, rows->num_rows, tile_width)) {
+            return 0;
+        }
+        for (int y = 0; y < rows->num_rows; y++) {
+            image_pack_row(&rows->pixels[y * screenshot.row_size + x * IMAGE_BYTES_PER_PIXEL],
+                &canvas[y * tile_width], width);
+        }
     }
-    pixel_offset original_camera_pixels;
-    city_view_get_camera_in_pixels(&original_camera_pixels.x, &original_camera_pixels.y);
+    return 1;
+}
 
+static int create_full_city_screenshot(const char *filename)
+{
+    if (!window_is(WINDOW_CITY) && !window_is(WINDOW_CITY_MILITARY)) {
+        return 0;
+    }
     int city_width_pixels = map_grid_width() * TILE_X_SIZE;
     int city_height_pixels = map_grid_height() * TILE_Y_SIZE;
 
     if (!image_create(city_width_pixels, city_height_pixels + TILE_Y_SIZE, 0, IMAGE_HEIGHT_CHUNK)) {
         log_error("Unable to set memory for full city screenshot", 0, 0);
-        return;
+        return 0;
     }
-    const char *filename = generate_filename(SCREENSHOT_FULL_CITY);
     if (!image_begin_io(filename) || !image_write_header()) {
         log_error("Unable to write screenshot to:", filename, 0);
         image_free();
-        return;
+        return 0;
     }
+    snprintf(screenshot.filename, FILE_NAME_MAX, "%s", filename);
 
-    color_t *canvas = malloc(sizeof(color_t) * city_width_pixels * IMAGE_HEIGHT_CHUNK);
-    if (!canvas) {
+    // The city is drawn in tiles as wide as the renderer allows, into a render target of its own,
+    // so the camera and the screen are left alone
+    int tile_width, tile_height;
+    graphics_renderer()->get_max_image_size(&tile_width, &tile_height);
+    tile_width = tile_width < city_width_pixels ? tile_width : city_width_pixels;
+    tile_height = tile_height < IMAGE_HEIGHT_CHUNK ? tile_height : IMAGE_HEIGHT_CHUNK;
+
+    color_t *canvas = malloc(sizeof(color_t) * tile_width * tile_height);
+    if (!canvas || !graphics_renderer()->start_offscreen_render(tile_width, tile_height)) {
+        log_error("Unable to set memory for full city screenshot", 0, 0);
+        free(canvas);
         image_free();
-        return;
+        return 0;
     }
-    memset(canvas, 0, sizeof(color_t) * city_width_pixels * IMAGE_HEIGHT_CHUNK);
-
-    int canvas_width = 8 * TILE_X_SIZE;
-    int old_scale = city_view_get_scale();
-
-    int draw_cloud_shadows = config_get(CONFIG_UI_DRAW_CLOUD_SHADOWS);
-    config_set(CONFIG_UI_DRAW_CLOUD_SHADOWS, 0);
+    city_view_begin_offscreen(tile_width, tile_height);
+    graphics_set_clip_rectangle(0, 0, tile_width, tile_height);
 
     int min_width = (GRID_SIZE * TILE_X_SIZE - city_width_pixels) / 2 + TILE_X_SIZE;
     int max_height = (GRID_SIZE * TILE_Y_SIZE + city_height_pixels) / 2;
     int min_height = max_height - city_height_pixels - TILE_Y_SIZE;
-    map_tile dummy_tile = { 0, 0, 0 };
+    // Once the last rows are queued the encoder releases the image, so the loop only reads these copies
+    int image_height = screenshot.height;
+    int row_size = screenshot.row_size;
     int error = 0;
-    int base_height = image_set_loop_height_limits(min_height, max_height);
-    int size;
-    city_view_set_scale(100);
-    graphics_set_clip_rectangle(0, TOP_MENU_HEIGHT, canvas_width, IMAGE_HEIGHT_CHUNK);
-    int viewport_x, viewport_y, viewport_width, viewport_height;
-    city_view_get_viewport(&viewport_x, &viewport_y, &viewport_width, &viewport_height);
-    city_view_set_viewport(canvas_width + (city_view_is_sidebar_collapsed() ? 42 : 162),
-        IMAGE_HEIGHT_CHUNK + TOP_MENU_HEIGHT);
-    int current_height = base_height;
-    while ((size = image_request_rows()) != 0) {
-        int y_offset = current_height + IMAGE_HEIGHT_CHUNK > max_height ?
-            IMAGE_HEIGHT_CHUNK - (max_height - current_height) - TILE_Y_SIZE : 0;
-        for (int width = 0; width < city_width_pixels; width += canvas_width) {
-            int image_section_width = canvas_width;
-            int x_offset = 0;
-            if (canvas_width + width > city_width_pixels) {
-                image_section_width = city_width_pixels - width;
-                x_offset = canvas_width - image_section_width - TILE_X_SIZE * 2;
-            }
-            city_view_set_camera_from_pixel_position(min_width + width, current_height);
-            city_without_overlay_draw(0, 0, &dummy_tile, 0);
-            graphics_renderer()->save_screen_buffer(&canvas[width], x_offset, TOP_MENU_HEIGHT + y_offset,
-                image_section_width, IMAGE_HEIGHT_CHUNK - y_offset, city_width_pixels);
+    for (int y = 0; y < image_height; y += tile_height) {
+        int num_rows = image_height - y < tile_height ? image_height - y : tile_height;
+        png_rows *rows = create_queued_rows(num_rows, row_size);
+        if (!rows || !render_full_city_rows(rows, canvas, tile_width, min_width, min_height + y)) {
+            free(rows);
+            error = 1;
+            break;
         }
-        if (!image_write_rows(canvas, city_width_pixels)) {
-            log_error("Error writing image", 0, 0);
+        // The rows are compressed and written on another thread while the next ones are drawn
+        rows->is_last = y + num_rows >= image_height;
+        if (!queue_rows(rows)) {
             error = 1;
             break;
         }
-        current_height += IMAGE_HEIGHT_CHUNK;
     }
-    city_view_set_viewport(viewport_width + (city_view_is_sidebar_collapsed() ? 42 : 162), viewport_height + TOP_MENU_HEIGHT);
-    city_view_set_scale(old_scale);
-    config_set(CONFIG_UI_DRAW_CLOUD_SHADOWS, draw_cloud_shadows);
     graphics_reset_clip_rectangle();
-    city_view_set_camera_from_pixel_position(original_camera_pixels.x, original_camera_pixels.y);
-    if (!error) {
-        log_info("Saved full city screenshot:", filename, 0);
-        show_saved_notice(filename);
+    city_view_end_offscreen();
+    graphics_renderer()->finish_offscreen_render();
+    free(canvas);
+    if (error) {
+        abort_queued_rows();
+        finish_queued_rows();
+        // The last rows close the image themselves, so only report errors that happened before them
+        if (screenshot.ctx) {
+            log_error("Error writing image", filename, 0);
+            image_free();
+        }
+        show_notice(TR_WARNING_SCREENSHOT_FAILED, filename);
+    } else {
+        // The last rows may still be encoding, the notice is shown once they are written
+        screenshot.notice_pending = 1;
     }
-    image_free();
     window_invalidate();
+    return !error;
 }
 
-static void create_minimap_screenshot(void)
+static int create_minimap_screenshot(const char *filename)
 {
     if (!window_is(WINDOW_CITY) && !window_is(WINDOW_CITY_MILITARY)) {
-        return;
+        return 0;
     }
 
     int width_pixels = map_grid_width() * (int) MINIMAP_SCALE * 2;
@@ -349,45 +538,73 @@ static void create_minimap_screenshot(void)
 
     if (!image_create(width_pixels, height_pixels, 1, height_pixels)) {
         log_error("Unable to set memory for minimap screenshot", 0, 0);
-        return;
+        return 0;
     }
-    const char *filename = generate_filename(SCREENSHOT_MINIMAP);
     if (!image_begin_io(filename) || !image_write_header()) {
         log_error("Unable to write screenshot to:", filename, 0);
         image_free();
-        return;
+        return 0;
     }
 
     color_t *canvas = malloc(sizeof(color_t) * width_pixels * height_pixels);
     if (!canvas) {
         image_free();
-        return;
+        return 0;
     }
     memset(canvas, 0, sizeof(color_t) * width_pixels * height_pixels);
     widget_minimap_update(0);
     graphics_clear_screen();
     graphics_renderer()->draw_custom_image(CUSTOM_IMAGE_MINIMAP, 0, 0, 1 / MINIMAP_SCALE, 1);
     graphics_renderer()->save_screen_buffer(canvas, 0, 0, width_pixels, height_pixels, width_pixels);
-    if (image_write_rows(canvas, width_pixels)) {
+    int success = image_write_rows(canvas, width_pixels);
+    free(canvas);
+    if (success) {
         log_info("Saved city map screenshot:", filename, 0);
         show_saved_notice(filename);
     }
     image_free();
     window_invalidate();
+    return success;
 }
 
-void graphics_save_screenshot(screenshot_type type)
+int graphics_finish_pending_screenshot(void)
+{
+    int success = finish_queued_rows();
+    if (screenshot.notice_pending) {
+        screenshot.notice_pending = 0;
+        show_notice(success ? TR_WARNING_SCREENSHOT_SAVED : TR_WARNING_SCREENSHOT_FAILED, screenshot.filename);
+    }
+    return success;
+}
+
+void graphics_check_pending_screenshot(void)
+{
+    if (encoder.thread && !platform_thread_is_finished(encoder.thread)) {
+        return;
+    }
+    graphics_finish_pending_screenshot();
+}
+
+static int save_screenshot(screenshot_type type, const char *filename)
 {
+    graphics_finish_pending_screenshot();
     switch (type) {
         case SCREENSHOT_FULL_CITY:
-            create_full_city_screenshot();
-            return;
+            return create_full_city_screenshot(filename);
         case SCREENSHOT_MINIMAP:
-            create_minimap_screenshot();
-            return;
+            return create_minimap_screenshot(filename);
         case SCREENSHOT_DISPLAY:
         default:
-            create_window_screenshot();
-            return;
+            return create_window_screenshot(filename);
     }
 }
+
+void graphics_save_screenshot(screenshot_type type)
+{
+    save_screenshot(type, generate_filename(type));
+}
+
+int graphics_save_screenshot_with_name(screenshot_type type, const char *name)
+{
+    return save_screenshot(type, generate_filename_from_name(type, name));
+}
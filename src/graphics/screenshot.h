@@ -10,4 +10,25 @@ typedef enum {
 
 void graphics_save_screenshot(screenshot_type type);
 
+/**
+ * Saves a screenshot named after the given name instead of the current time
+ * @param type Screenshot type
+ * @param name Name to start the file name with, without directory or extension
+ * @return 1 if the screenshot was saved or is being written in the background, 0 on error
+ */
+int graphics_save_screenshot_with_name(screenshot_type type, const char *name);
+
+/**
+ * Waits until a full city screenshot that is still being written in the background is saved,
+ * and shows whether saving it succeeded
+ * @return 1 if the screenshot was saved or none was pending, 0 if writing it failed
+ */
+int graphics_finish_pending_screenshot(void);
+
+/**
+ * Shows whether a full city screenshot written in the background was saved, once it is done.
+ * Does not wait for the screenshot, so it can be called every frame.
+ */
+void graphics_check_pending_screenshot(void);
+
 #endif // GRAPHICS_SCREENSHOT_H
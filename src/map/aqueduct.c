@@ -8,6 +8,12 @@
 static grid_u8 aqueduct;
 static grid_u8 aqueduct_backup;
 
+void map_aqueduct_init_grids(void)
+{
+    map_grid_register_u8(&aqueduct);
+    map_grid_register_u8(&aqueduct_backup);
+}
+
 int map_aqueduct_has_water_access_at(int grid_offset)
 {
     return aqueduct.items[grid_offset] >> WATER_ACCESS_OFFSET;
@@ -4,6 +4,8 @@
 #include "core/buffer.h"
 
 
+void map_aqueduct_init_grids(void);
+
 int map_aqueduct_has_water_access_at(int grid_offset);
 int map_aqueduct_image_at(int grid_offset);
 
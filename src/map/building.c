@@ -8,6 +8,13 @@ static grid_u16 buildings_grid;
 static grid_u8 damage_grid;
 static grid_u8 rubble_type_grid;
 
+void map_building_init_grids(void)
+{
+    map_grid_register_u16(&buildings_grid);
+    map_grid_register_u8(&damage_grid);
+    map_grid_register_u8(&rubble_type_grid);
+}
+
 int map_building_at(int grid_offset)
 {
     return map_grid_is_valid_offset(grid_offset) ? buildings_grid.items[grid_offset] : 0;
@@ -9,6 +9,8 @@
  * @param grid_offset Map offset
  * @return Building ID of building at offset, 0 means no building
  */
+void map_building_init_grids(void);
+
 int map_building_at(int grid_offset);
 
 int map_building_from_buffer(buffer *buildings, int grid_offset);
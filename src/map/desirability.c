@@ -1,24 +1,117 @@
 #include "desirability.h"
 
 #include "building/building.h"
+#include "building/house_service.h"
 #include "building/model.h"
 #include "building/monument.h"
 #include "core/calc.h"
+#include "core/log.h"
 #include "map/data.h"
 #include "map/grid.h"
 #include "map/property.h"
 #include "map/ring.h"
 #include "map/terrain.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int x;
+    int y;
+    int size;
+    int value;
+    int step;
+    int step_size;
+    int range;
+} desirability_source;
+
+typedef struct {
+    desirability_source applied;
+    int queued;
+} building_source;
+
+typedef struct {
+    int *items;
+    int size;
+    int capacity;
+} id_queue;
+
+typedef enum {
+    TERRAIN_SOURCE_NONE = 0,
+    TERRAIN_SOURCE_PLAZA,
+    TERRAIN_SOURCE_EARTHQUAKE,
+    TERRAIN_SOURCE_GARDEN,
+    TERRAIN_SOURCE_RUBBLE,
+    TERRAIN_SOURCE_HIGHWAY,
+    TERRAIN_SOURCE_MAX
+} terrain_source;
+
+enum {
+    TILE_QUEUED = 1
+};
+
+// Must be larger than the longest coverage a house can have
+#define VENUS_EXPIRY_DAYS 128
+
 static grid_i8 desirability_grid;
 
+static struct {
+    grid_u8 terrain_sources;
+    grid_u8 tile_flags;
+    grid_i16 positive;
+    grid_i16 negative;
+    desirability_source terrain_models[TERRAIN_SOURCE_MAX];
+    building_source *buildings;
+    int buildings_size;
+    id_queue changed_buildings;
+    id_queue changed_tiles;
+    id_queue venus_expiry[VENUS_EXPIRY_DAYS];
+    unsigned int venus_day;
+    int venus_module2;
+    int needs_full_update;
+    int bounded_tile_changed;
+} data = { .needs_full_update = 1 };
+
+void map_desirability_init_grids(void)
+{
+    map_grid_register_i8(&desirability_grid);
+    map_grid_register_u8(&data.terrain_sources);
+    map_grid_register_u8(&data.tile_flags);
+    map_grid_register_i16(&data.positive);
+    map_grid_register_i16(&data.negative);
+}
+
 void map_desirability_clear(void)
 {
     map_grid_clear_i8(desirability_grid.items);
+    data.needs_full_update = 1;
 }
 
-static void add_desirability_at_distance(int x, int y, int size, int distance, int desirability)
+static int queue_add(id_queue *queue, int id)
 {
+    if (queue->size >= queue->capacity) {
+        int capacity = queue->capacity ? queue->capacity * 2 : 64;
+        int *items = realloc(queue->items, capacity * sizeof(int));
+        if (!items) {
+            return 0;
+        }
+        queue->items = items;
+        queue->capacity = capacity;
+    }
+    queue->items[queue->size++] = id;
+    return 1;
+}
+
+static int is_sum_of_sources(int grid_offset)
+{
+    return data.positive.items[grid_offset] <= 100 && data.negative.items[grid_offset] >= -100;
+}
+
+static void add_desirability_at_distance(int x, int y, int size, int distance, int desirability, int sign)
+{
+    if (!desirability) {
+        return;
+    }
     int partially_outside_map = 0;
     if (x - distance < -1 || x + distance + size - 1 > map_data.width) {
         partially_outside_map = 1;
@@ -30,24 +123,33 @@ static void add_desirability_at_distance(int x, int y, int size, int distance, i
     int start = map_ring_start(size, distance);
     int end = map_ring_end(size, distance);
 
-    if (partially_outside_map) {
-        for (int i = start; i < end; i++) {
-            const ring_tile *tile = map_ring_tile(i);
-            if (map_ring_is_inside_map(x + tile->x, y + tile->y)) {
-                desirability_grid.items[base_offset + tile->grid_offset] =
-                    calc_bound(desirability_grid.items[base_offset + tile->grid_offset] + desirability, -100, 100);
-            }
+    for (int i = start; i < end; i++) {
+        const ring_tile *tile = map_ring_tile(i);
+        if (partially_outside_map && !map_ring_is_inside_map(x + tile->x, y + tile->y)) {
+            continue;
+        }
+        int grid_offset = base_offset + tile->grid_offset;
+        // While neither the positive nor the negative sources of a tile reach the bounds, no order of
+        // adding them can be bounded and the tile holds their plain sum. Otherwise the result depends on
+        // the order of the sources and only a full rebuild reproduces it.
+        if (!is_sum_of_sources(grid_offset)) {
+            data.bounded_tile_changed = 1;
+        }
+        if (desirability > 0) {
+            data.positive.items[grid_offset] += sign * desirability;
+        } else {
+            data.negative.items[grid_offset] += sign * desirability;
         }
-    } else {
-        for (int i = start; i < end; i++) {
-            const ring_tile *tile = map_ring_tile(i);
-            desirability_grid.items[base_offset + tile->grid_offset] =
-                calc_bound(desirability_grid.items[base_offset + tile->grid_offset] + desirability, -100, 100);
+        if (!is_sum_of_sources(grid_offset)) {
+            data.bounded_tile_changed = 1;
         }
+        // Each source is bounded as it is added, like the original daily rebuild did
+        desirability_grid.items[grid_offset] =
+            calc_bound(desirability_grid.items[grid_offset] + sign * desirability, -100, 100);
     }
 }
 
-static void add_to_terrain(int x, int y, int size, int desirability, int step, int step_size, int range)
+static void add_to_terrain(int x, int y, int size, int desirability, int step, int step_size, int range, int sign)
 {
     if (size > 0) {
         if (range > 8) {
@@ -56,7 +158,7 @@ static void add_to_terrain(int x, int y, int size, int desirability, int step, i
         int tiles_within_step = 0;
         int distance = 1;
         while (range > 0) {
-            add_desirability_at_distance(x, y, size, distance, desirability);
+            add_desirability_at_distance(x, y, size, distance, desirability, sign);
             distance++;
             range--;
             tiles_within_step++;
@@ -68,135 +170,325 @@ static void add_to_terrain(int x, int y, int size, int desirability, int step, i
     }
 }
 
-static void update_buildings(void)
+static void apply_source(const desirability_source *source, int sign)
 {
-    int value;
-    int value_bonus;
-    int step;
-    int step_size;
-    int range;
-    int venus_module2 = building_monument_gt_module_is_active(VENUS_MODULE_2_DESIRABILITY_ENTERTAINMENT);
-    int venus_gt = building_monument_working(BUILDING_GRAND_TEMPLE_VENUS);
-    for (int i = 1; i < building_count(); i++) {
-        building *b = building_get(i);
-        if (b->state == BUILDING_STATE_IN_USE) {
-
-            const model_building *model = model_get_building(b->type);
-            value = model->desirability_value;
-            step = model->desirability_step;
-            step_size = model->desirability_step_size;
-            range = model->desirability_range;
-
-            // Venus Module 2 House Desirability Bonus
-            if (building_is_house(b->type) && b->data.house.temple_venus && venus_module2) {
-                if (b->subtype.house_level >= HOUSE_SMALL_VILLA) {
-                    value += 4;
-                    range += 1;
-                } else if (b->subtype.house_level <= HOUSE_LARGE_TENT) {
-                    // tents normally confer -3, -2, -1, 0, 0, 0 (range=3)
-                    // now this becomes -1, 0, 0, 0, 0, 0 (range=1)
-                    value += 2;
-                    range = 1;
-                } else {
-                    if (range <= 1) {
-                        range = 1;
-                    }
-                    value += 2;
-                }
-            }
+    add_to_terrain(source->x, source->y, source->size,
+        source->value, source->step, source->step_size, source->range, sign);
+}
 
-            if (building_monument_is_monument(b) && b->monument.phase != MONUMENT_FINISHED) {
-                value = 0;
-                step = 0;
-                step_size = 0;
-                range = 0;
-            }
+static void set_source(desirability_source *source, int x, int y, int size, const model_building *model)
+{
+    source->x = x;
+    source->y = y;
+    source->size = size;
+    source->value = model->desirability_value;
+    source->step = model->desirability_step;
+    source->step_size = model->desirability_step_size;
+    source->range = model->desirability_range;
+}
 
-            // Venus GT Base Bonus
-            if (building_is_statue_garden_temple(b->type) && venus_gt) {
-                value_bonus = ((value / 4) > 1) ? (value / 4) : 1;
-                value += value_bonus;
-                step += 1;
-                range += 1;
-            }
+static int source_has_effect(const desirability_source *source)
+{
+    return source->size > 0 && source->range > 0 && (source->value || source->step_size);
+}
+
+static void get_building_source(const building *b, int venus_module2, int venus_gt, desirability_source *source)
+{
+    memset(source, 0, sizeof(desirability_source));
+    if (b->state != BUILDING_STATE_IN_USE) {
+        return;
+    }
+    set_source(source, b->x, b->y, b->size, model_get_building(b->type));
 
-            add_to_terrain(
-                b->x, b->y, b->size,
-                value,
-                step,
-                step_size,
-                range);
+    // Venus Module 2 House Desirability Bonus
+    if (building_is_house(b->type) && house_service_get(b, HOUSE_SERVICE_TEMPLE_VENUS) && venus_module2) {
+        if (b->subtype.house_level >= HOUSE_SMALL_VILLA) {
+            source->value += 4;
+            source->range += 1;
+        } else if (b->subtype.house_level <= HOUSE_LARGE_TENT) {
+            // tents normally confer -3, -2, -1, 0, 0, 0 (range=3)
+            // now this becomes -1, 0, 0, 0, 0, 0 (range=1)
+            source->value += 2;
+            source->range = 1;
+        } else {
+            if (source->range <= 1) {
+                source->range = 1;
+            }
+            source->value += 2;
         }
     }
+
+    if (building_monument_is_monument(b) && b->monument.phase != MONUMENT_FINISHED) {
+        source->value = 0;
+        source->step = 0;
+        source->step_size = 0;
+        source->range = 0;
+    }
+
+    // Venus GT Base Bonus
+    if (building_is_statue_garden_temple(b->type) && venus_gt) {
+        int value_bonus = ((source->value / 4) > 1) ? (source->value / 4) : 1;
+        source->value += value_bonus;
+        source->step += 1;
+        source->range += 1;
+    }
+
+    if (!source_has_effect(source)) {
+        memset(source, 0, sizeof(desirability_source));
+    }
 }
 
-static void add_garden_desirability(int x, int y)
+static int ensure_building_capacity(int size)
 {
-    const model_building *model = model_get_building(BUILDING_GARDENS);
+    if (size <= data.buildings_size) {
+        return 1;
+    }
+    building_source *buildings = realloc(data.buildings, sizeof(building_source) * size);
+    if (!buildings) {
+        return 0;
+    }
+    memset(&buildings[data.buildings_size], 0, sizeof(building_source) * (size - data.buildings_size));
+    data.buildings = buildings;
+    data.buildings_size = size;
+    return 1;
+}
 
-    int value = model->desirability_value;
-    int step = model->desirability_step;
-    int step_size = model->desirability_step_size;
-    int range = model->desirability_range;
+static void schedule_venus_expiry(const building *b)
+{
+    int remaining = house_service_get(b, HOUSE_SERVICE_TEMPLE_VENUS);
+    if (!remaining) {
+        return;
+    }
+    // Coverage that lasts longer than the schedule is checked again when its slot comes up early
+    unsigned int day = data.venus_day + remaining;
+    if (!queue_add(&data.venus_expiry[day % VENUS_EXPIRY_DAYS], b->id)) {
+        data.needs_full_update = 1;
+    }
+}
 
+static void update_building(int building_id, int venus_gt)
+{
+    desirability_source current;
+    memset(&current, 0, sizeof(desirability_source));
+    if (building_id < building_count()) {
+        building *b = building_get(building_id);
+        get_building_source(b, data.venus_module2, venus_gt, &current);
+        if (data.venus_module2 && b->state == BUILDING_STATE_IN_USE && building_is_house(b->type)) {
+            schedule_venus_expiry(b);
+        }
+    }
+    building_source *source = &data.buildings[building_id];
+    source->queued = 0;
+    if (memcmp(&current, &source->applied, sizeof(desirability_source)) != 0) {
+        apply_source(&source->applied, -1);
+        apply_source(&current, 1);
+        source->applied = current;
+    }
+}
+
+static void update_terrain_models(void)
+{
+    desirability_source models[TERRAIN_SOURCE_MAX];
+    memset(models, 0, sizeof(models));
+    set_source(&models[TERRAIN_SOURCE_PLAZA], 0, 0, 1, model_get_building(BUILDING_PLAZA));
+    // earthquake fault line: slight negative
+    set_source(&models[TERRAIN_SOURCE_EARTHQUAKE], 0, 0, 1, model_get_building(BUILDING_HOUSE_VACANT_LOT));
+    set_source(&models[TERRAIN_SOURCE_GARDEN], 0, 0, 1, model_get_building(BUILDING_GARDENS));
     if (building_monument_working(BUILDING_GRAND_TEMPLE_VENUS)) {
-        int value_bonus = ((value / 4) > 1) ? (value / 4) : 1;
-        value += value_bonus;
-        step += 1;
-        range += 1;
+        desirability_source *garden = &models[TERRAIN_SOURCE_GARDEN];
+        int value_bonus = ((garden->value / 4) > 1) ? (garden->value / 4) : 1;
+        garden->value += value_bonus;
+        garden->step += 1;
+        garden->range += 1;
     }
+    desirability_source *rubble = &models[TERRAIN_SOURCE_RUBBLE];
+    rubble->size = 1;
+    rubble->value = -2;
+    rubble->step = 1;
+    rubble->step_size = 1;
+    rubble->range = 2;
+    set_source(&models[TERRAIN_SOURCE_HIGHWAY], 0, 0, 1, model_get_building(BUILDING_HIGHWAY));
 
-    add_to_terrain(x, y, 1, value, step, step_size, range);
+    // The terrain sources are not stored per tile, so a change of their values requires a full rebuild.
+    // The Venus grand temple also changes the statues, gardens and temples, which are rebuilt along with them.
+    if (!data.needs_full_update && memcmp(models, data.terrain_models, sizeof(models)) != 0) {
+        data.needs_full_update = 1;
+    }
+    memcpy(data.terrain_models, models, sizeof(models));
 }
 
-static void update_terrain(void)
+static terrain_source get_terrain_source(int grid_offset)
 {
+    int terrain = map_terrain_get(grid_offset);
+    if (map_property_is_plaza_earthquake_or_overgrown_garden(grid_offset)) {
+        if (terrain & TERRAIN_ROAD) {
+            return TERRAIN_SOURCE_PLAZA;
+        } else if (terrain & TERRAIN_ROCK) {
+            return TERRAIN_SOURCE_EARTHQUAKE;
+        } else if (terrain & TERRAIN_GARDEN) {
+            return TERRAIN_SOURCE_GARDEN;
+        } else {
+            // invalid plaza/earthquake flag
+            map_property_clear_plaza_earthquake_or_overgrown_garden(grid_offset);
+            return TERRAIN_SOURCE_NONE;
+        }
+    } else if (terrain & TERRAIN_GARDEN) {
+        return TERRAIN_SOURCE_GARDEN;
+    } else if (terrain & TERRAIN_RUBBLE) {
+        return TERRAIN_SOURCE_RUBBLE;
+    } else if (terrain & TERRAIN_HIGHWAY) {
+        return TERRAIN_SOURCE_HIGHWAY;
+    }
+    return TERRAIN_SOURCE_NONE;
+}
+
+static void apply_terrain_source(int x, int y, terrain_source type, int sign)
+{
+    if (type == TERRAIN_SOURCE_NONE) {
+        return;
+    }
+    desirability_source source = data.terrain_models[type];
+    source.x = x;
+    source.y = y;
+    apply_source(&source, sign);
+}
+
+static void update_tile(int grid_offset)
+{
+    data.tile_flags.items[grid_offset] &= ~TILE_QUEUED;
+    terrain_source current = get_terrain_source(grid_offset);
+    terrain_source applied = data.terrain_sources.items[grid_offset];
+    if (current != applied) {
+        int x = map_grid_offset_to_x(grid_offset);
+        int y = map_grid_offset_to_y(grid_offset);
+        apply_terrain_source(x, y, applied, -1);
+        apply_terrain_source(x, y, current, 1);
+        data.terrain_sources.items[grid_offset] = current;
+    }
+}
+
+static void clear_queues(void)
+{
+    data.changed_buildings.size = 0;
+    data.changed_tiles.size = 0;
+    for (int i = 0; i < VENUS_EXPIRY_DAYS; i++) {
+        data.venus_expiry[i].size = 0;
+    }
+}
+
+static void rebuild_all(int venus_gt)
+{
+    clear_queues();
+    map_grid_clear_map_area_i8(desirability_grid.items);
+    map_grid_clear_map_area_u8(data.terrain_sources.items);
+    map_grid_clear_map_area_u8(data.tile_flags.items);
+    map_grid_clear_map_area_i16(data.positive.items);
+    map_grid_clear_map_area_i16(data.negative.items);
+    if (!ensure_building_capacity(building_count())) {
+        log_error("Unable to allocate memory for the desirability sources. Desirability will not be updated.", 0, 0);
+        return;
+    }
+    data.needs_full_update = 0;
+    if (data.buildings) {
+        memset(data.buildings, 0, sizeof(building_source) * data.buildings_size);
+    }
+    // Buildings first and then the terrain, in the same order as the original daily rebuild
+    for (int i = 1; i < building_count(); i++) {
+        update_building(i, venus_gt);
+    }
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
-            int terrain = map_terrain_get(grid_offset);
-            if (map_property_is_plaza_earthquake_or_overgrown_garden(grid_offset)) {
-                int type;
-                if (terrain & TERRAIN_ROAD) {
-                    type = BUILDING_PLAZA;
-                } else if (terrain & TERRAIN_ROCK) {
-                    // earthquake fault line: slight negative
-                    type = BUILDING_HOUSE_VACANT_LOT;
-                } else if (terrain & TERRAIN_GARDEN) {
-                    add_garden_desirability(x, y);
-                    continue;
-                } else {
-                    // invalid plaza/earthquake flag
-                    map_property_clear_plaza_earthquake_or_overgrown_garden(grid_offset);
-                    continue;
-                }
-                const model_building *model = model_get_building(type);
-                add_to_terrain(x, y, 1,
-                    model->desirability_value,
-                    model->desirability_step,
-                    model->desirability_step_size,
-                    model->desirability_range);
-            } else if (terrain & TERRAIN_GARDEN) {
-                add_garden_desirability(x, y);
-            } else if (terrain & TERRAIN_RUBBLE) {
-                add_to_terrain(x, y, 1, -2, 1, 1, 2);
-            } else if (terrain & TERRAIN_HIGHWAY) {
-                const model_building *model = model_get_building(BUILDING_HIGHWAY);
-                add_to_terrain(x, y, 1,
-                    model->desirability_value,
-                    model->desirability_step,
-                    model->desirability_step_size,
-                    model->desirability_range);
-            }
+            terrain_source source = get_terrain_source(grid_offset);
+            apply_terrain_source(x, y, source, 1);
+            data.terrain_sources.items[grid_offset] = source;
+        }
+    }
+    data.bounded_tile_changed = 0;
+}
+
+static void expire_venus_coverage(unsigned int today)
+{
+    if (today - data.venus_day >= VENUS_EXPIRY_DAYS) {
+        data.venus_day = today - VENUS_EXPIRY_DAYS;
+    }
+    while (data.venus_day != today) {
+        data.venus_day++;
+        id_queue *expiring = &data.venus_expiry[data.venus_day % VENUS_EXPIRY_DAYS];
+        for (int i = 0; i < expiring->size; i++) {
+            map_desirability_building_changed(expiring->items[i]);
         }
+        expiring->size = 0;
     }
 }
 
+void map_desirability_building_changed(int building_id)
+{
+    if (data.needs_full_update || building_id <= 0) {
+        return;
+    }
+    if (building_id >= data.buildings_size && !ensure_building_capacity(building_count())) {
+        data.needs_full_update = 1;
+        return;
+    }
+    building_source *source = &data.buildings[building_id];
+    if (source->queued) {
+        return;
+    }
+    if (!queue_add(&data.changed_buildings, building_id)) {
+        data.needs_full_update = 1;
+        return;
+    }
+    source->queued = 1;
+}
+
+void map_desirability_tile_changed(int grid_offset)
+{
+    if (data.needs_full_update || (data.tile_flags.items[grid_offset] & TILE_QUEUED)) {
+        return;
+    }
+    if (!map_grid_is_inside(map_grid_offset_to_x(grid_offset), map_grid_offset_to_y(grid_offset), 1)) {
+        return;
+    }
+    if (!queue_add(&data.changed_tiles, grid_offset)) {
+        data.needs_full_update = 1;
+        return;
+    }
+    data.tile_flags.items[grid_offset] |= TILE_QUEUED;
+}
+
 void map_desirability_update(void)
 {
-    map_desirability_clear();
-    update_buildings();
-    update_terrain();
+    update_terrain_models();
+    int venus_gt = building_monument_working(BUILDING_GRAND_TEMPLE_VENUS);
+    int venus_module2 = building_monument_gt_module_is_active(VENUS_MODULE_2_DESIRABILITY_ENTERTAINMENT);
+    unsigned int today = house_service_current_day(HOUSE_SERVICE_TEMPLE_VENUS);
+    if (venus_module2 != data.venus_module2) {
+        data.venus_module2 = venus_module2;
+        for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
+            for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
+                map_desirability_building_changed(b->id);
+            }
+        }
+    }
+    if (data.needs_full_update) {
+        data.venus_day = today;
+        rebuild_all(venus_gt);
+        return;
+    }
+    expire_venus_coverage(today);
+    // Only the buildings and tiles that were reported as changed since the last update touch the grid
+    for (int i = 0; i < data.changed_buildings.size; i++) {
+        update_building(data.changed_buildings.items[i], venus_gt);
+    }
+    data.changed_buildings.size = 0;
+    for (int i = 0; i < data.changed_tiles.size; i++) {
+        update_tile(data.changed_tiles.items[i]);
+    }
+    data.changed_tiles.size = 0;
+    if (data.bounded_tile_changed || data.needs_full_update) {
+        rebuild_all(venus_gt);
+    }
 }
 
 int map_desirability_get(int grid_offset)
@@ -229,4 +521,6 @@ void map_desirability_save_state(buffer *buf)
 void map_desirability_load_state(buffer *buf)
 {
     map_grid_load_state_i8(desirability_grid.items, buf);
+    // The loaded grid stays in use until the next update, which rebuilds all sources
+    data.needs_full_update = 1;
 }
@@ -2,11 +2,34 @@
 #define MAP_DESIRABILITY_H
 
 #include "core/buffer.h"
+#include "map/terrain.h"
+
+#define MAP_DESIRABILITY_TERRAIN (TERRAIN_ROAD | TERRAIN_ROCK | TERRAIN_GARDEN | TERRAIN_RUBBLE | TERRAIN_HIGHWAY)
+
+void map_desirability_init_grids(void);
 
 void map_desirability_clear(void);
 
+/**
+ * Applies the desirability of the buildings and tiles that changed since the last update.
+ * The whole map is only rebuilt after loading, when a change affects many sources at once,
+ * or when a change touches a tile whose sources add up beyond the -100 to 100 bounds.
+ */
 void map_desirability_update(void);
 
+/**
+ * Reports that a building was built, removed, or changed its type, position, size or Venus bonus
+ * @param building_id Building that changed
+ */
+void map_desirability_building_changed(int building_id);
+
+/**
+ * Reports that a tile gained or lost a terrain that is a desirability source (MAP_DESIRABILITY_TERRAIN)
+ * or its plaza property
+ * @param grid_offset Tile that changed
+ */
+void map_desirability_tile_changed(int grid_offset);
+
 int map_desirability_get(int grid_offset);
 
 int map_desirability_get_max(int x, int y, int size);
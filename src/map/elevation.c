@@ -6,6 +6,11 @@
 
 static grid_u8 elevation;
 
+void map_elevation_init_grids(void)
+{
+    map_grid_register_u8(&elevation);
+}
+
 int map_elevation_at(int grid_offset)
 {
     return elevation.items[grid_offset];
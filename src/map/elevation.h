@@ -3,6 +3,8 @@
 
 #include "core/buffer.h"
 
+void map_elevation_init_grids(void);
+
 int map_elevation_at(int grid_offset);
 
 void map_elevation_set(int grid_offset, int value);
@@ -1,9 +1,41 @@
 #include "figure.h"
 
+#include "core/log.h"
+#include "figure/combat.h"
 #include "map/grid.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#define BUCKETS_SIZE_STEP 1024
+#define INITIAL_BUCKET_CAPACITY 4
+#define MAX_FIGURES_ON_SAME_TILE_INDEX 20
+
+// The figures on a single tile, in the order in which they arrived
+typedef struct {
+    unsigned int count;
+    unsigned int capacity;
+    uint16_t *figure_ids;
+} tile_figures;
+
 static grid_u16 figures;
 
+static struct {
+    grid_u16 bucket_id;
+    tile_figures *buckets;
+    unsigned int total_buckets;
+    unsigned int capacity;
+    unsigned int *free_ids;
+    unsigned int total_free;
+    int needs_rebuild;
+} data;
+
+void map_figure_init_grids(void)
+{
+    map_grid_register_u16(&figures);
+    map_grid_register_u16(&data.bucket_id);
+}
+
 int map_has_figure_at(int grid_offset)
 {
     return map_grid_is_valid_offset(grid_offset) && figures.items[grid_offset] > 0;
@@ -14,52 +46,182 @@ int map_figure_at(int grid_offset)
     return map_grid_is_valid_offset(grid_offset) ? figures.items[grid_offset] : 0;
 }
 
-static void cap_figures_on_same_tile_index(figure *f)
+static void release_bucket(int grid_offset)
+{
+    unsigned int bucket_id = data.bucket_id.items[grid_offset];
+    data.bucket_id.items[grid_offset] = 0;
+    data.buckets[bucket_id].count = 0;
+    // The id list is kept, so the next tile to use this bucket does not have to allocate it again
+    data.free_ids[data.total_free++] = bucket_id;
+}
+
+static void clear_buckets(void)
+{
+    map_grid_clear_map_area_u16(data.bucket_id.items);
+    data.total_free = 0;
+    // Bucket 0 means "no bucket" and is never handed out
+    for (unsigned int i = data.total_buckets; i > 1; i--) {
+        data.buckets[i - 1].count = 0;
+        data.free_ids[data.total_free++] = i - 1;
+    }
+}
+
+static int expand_buckets(void)
+{
+    unsigned int capacity = data.capacity + BUCKETS_SIZE_STEP;
+    if (capacity > UINT16_MAX + 1) {
+        capacity = UINT16_MAX + 1;
+    }
+    if (capacity <= data.capacity) {
+        return 0;
+    }
+    tile_figures *buckets = realloc(data.buckets, capacity * sizeof(tile_figures));
+    if (!buckets) {
+        return 0;
+    }
+    data.buckets = buckets;
+    unsigned int *free_ids = realloc(data.free_ids, capacity * sizeof(unsigned int));
+    if (!free_ids) {
+        return 0;
+    }
+    data.free_ids = free_ids;
+    memset(&data.buckets[data.capacity], 0, (capacity - data.capacity) * sizeof(tile_figures));
+    data.capacity = capacity;
+    return 1;
+}
+
+static tile_figures *get_bucket(int grid_offset)
+{
+    unsigned int bucket_id = data.bucket_id.items[grid_offset];
+    return bucket_id ? &data.buckets[bucket_id] : 0;
+}
+
+static tile_figures *get_or_create_bucket(int grid_offset)
+{
+    tile_figures *bucket = get_bucket(grid_offset);
+    if (bucket) {
+        return bucket;
+    }
+    unsigned int bucket_id;
+    if (data.total_free) {
+        bucket_id = data.free_ids[--data.total_free];
+    } else {
+        if (!data.total_buckets) {
+            // Reserve bucket 0
+            data.total_buckets = 1;
+        }
+        if (data.total_buckets >= data.capacity && !expand_buckets()) {
+            return 0;
+        }
+        bucket_id = data.total_buckets++;
+    }
+    data.bucket_id.items[grid_offset] = bucket_id;
+    return &data.buckets[bucket_id];
+}
+
+static int append_to_bucket(tile_figures *bucket, int figure_id)
+{
+    if (bucket->count == bucket->capacity) {
+        unsigned int capacity = bucket->capacity ? bucket->capacity * 2 : INITIAL_BUCKET_CAPACITY;
+        uint16_t *figure_ids = realloc(bucket->figure_ids, capacity * sizeof(uint16_t));
+        if (!figure_ids) {
+            return 0;
+        }
+        bucket->figure_ids = figure_ids;
+        bucket->capacity = capacity;
+    }
+    bucket->figure_ids[bucket->count++] = figure_id;
+    return 1;
+}
+
+static void rebuild_buckets(void)
+{
+    data.needs_rebuild = 0;
+    clear_buckets();
+    int max_figures = figure_count();
+    int grid_offset = map_data.start_offset;
+    for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
+        for (int x = 0; x < map_data.width; x++, grid_offset++) {
+            int figure_id = figures.items[grid_offset];
+            int remaining = max_figures;
+            while (figure_id > 0 && figure_id < max_figures && remaining--) {
+                tile_figures *bucket = get_or_create_bucket(grid_offset);
+                if (!bucket || !append_to_bucket(bucket, figure_id)) {
+                    log_error("Unable to allocate memory for the figures on a tile", 0, grid_offset);
+                    break;
+                }
+                figure_id = figure_get(figure_id)->next_figure_id_on_same_tile;
+            }
+        }
+    }
+}
+
+static void check_buckets(void)
 {
-    if (f->figures_on_same_tile_index > 20) {
-        f->figures_on_same_tile_index = 20;
+    if (data.needs_rebuild) {
+        rebuild_buckets();
     }
 }
 
 void map_figure_add(figure *f)
 {
+    figure_combat_move_target(f);
     if (!map_grid_is_valid_offset(f->grid_offset)) {
         return;
     }
+    check_buckets();
     f->figures_on_same_tile_index = 0;
     f->next_figure_id_on_same_tile = 0;
 
-    if (figures.items[f->grid_offset]) {
-        figure *next = figure_get(figures.items[f->grid_offset]);
-        f->figures_on_same_tile_index++;
-        while (next->next_figure_id_on_same_tile) {
-            next = figure_get(next->next_figure_id_on_same_tile);
-            f->figures_on_same_tile_index++;
+    tile_figures *bucket = get_or_create_bucket(f->grid_offset);
+    if (!bucket) {
+        log_error("Unable to allocate memory for the figures on a tile", 0, f->grid_offset);
+        return;
+    }
+    unsigned int index = bucket->count;
+    if (!append_to_bucket(bucket, f->id)) {
+        log_error("Unable to allocate memory for the figures on a tile", 0, f->grid_offset);
+        if (!bucket->count) {
+            release_bucket(f->grid_offset);
         }
-        cap_figures_on_same_tile_index(f);
-        next->next_figure_id_on_same_tile = f->id;
+        return;
+    }
+    if (index) {
+        figure_get(bucket->figure_ids[index - 1])->next_figure_id_on_same_tile = f->id;
+        f->figures_on_same_tile_index = index > MAX_FIGURES_ON_SAME_TILE_INDEX ?
+            MAX_FIGURES_ON_SAME_TILE_INDEX : index;
     } else {
         figures.items[f->grid_offset] = f->id;
     }
 }
 
+static int find_in_bucket(const tile_figures *bucket, int figure_id)
+{
+    for (unsigned int i = 0; i < bucket->count; i++) {
+        if (bucket->figure_ids[i] == figure_id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 void map_figure_update(figure *f)
 {
+    figure_combat_move_target(f);
     if (!map_grid_is_valid_offset(f->grid_offset)) {
         return;
     }
-    f->figures_on_same_tile_index = 0;
-
-    figure *next = figure_get(figures.items[f->grid_offset]);
-    while (next->id) {
-        if (next->id == f->id) {
-            cap_figures_on_same_tile_index(f);
-            return;
-        }
-        f->figures_on_same_tile_index++;
-        next = figure_get(next->next_figure_id_on_same_tile);
+    check_buckets();
+    const tile_figures *bucket = get_bucket(f->grid_offset);
+    if (!bucket) {
+        f->figures_on_same_tile_index = 0;
+        return;
     }
-    cap_figures_on_same_tile_index(f);
+    int index = find_in_bucket(bucket, f->id);
+    if (index < 0) {
+        index = bucket->count;
+    }
+    f->figures_on_same_tile_index = index > MAX_FIGURES_ON_SAME_TILE_INDEX ? MAX_FIGURES_ON_SAME_TILE_INDEX : index;
 }
 
 void map_figure_delete(figure *f)
@@ -68,29 +230,49 @@ void map_figure_delete(figure *f)
         f->next_figure_id_on_same_tile = 0;
         return;
     }
-    if (figures.items[f->grid_offset] == f->id) {
+    check_buckets();
+    tile_figures *bucket = get_bucket(f->grid_offset);
+    int index = bucket ? find_in_bucket(bucket, f->id) : -1;
+    if (index < 0) {
+        f->next_figure_id_on_same_tile = 0;
+        return;
+    }
+    if (index == 0) {
         figures.items[f->grid_offset] = f->next_figure_id_on_same_tile;
     } else {
-        figure *prev = figure_get(figures.items[f->grid_offset]);
-        while (prev->id && prev->next_figure_id_on_same_tile != f->id) {
-            prev = figure_get(prev->next_figure_id_on_same_tile);
-        }
-        prev->next_figure_id_on_same_tile = f->next_figure_id_on_same_tile;
+        figure_get(bucket->figure_ids[index - 1])->next_figure_id_on_same_tile = f->next_figure_id_on_same_tile;
+    }
+    bucket->count--;
+    memmove(&bucket->figure_ids[index], &bucket->figure_ids[index + 1],
+        (bucket->count - index) * sizeof(uint16_t));
+    if (!bucket->count) {
+        release_bucket(f->grid_offset);
     }
     f->next_figure_id_on_same_tile = 0;
 }
 
+unsigned int map_figure_get_all_at(int grid_offset, const uint16_t **figure_ids)
+{
+    if (!map_grid_is_valid_offset(grid_offset) || !figures.items[grid_offset]) {
+        return 0;
+    }
+    check_buckets();
+    const tile_figures *bucket = get_bucket(grid_offset);
+    if (!bucket) {
+        return 0;
+    }
+    *figure_ids = bucket->figure_ids;
+    return bucket->count;
+}
+
 int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f))
 {
-    if (figures.items[grid_offset] > 0) {
-        int figure_id = figures.items[grid_offset];
-        while (figure_id) {
-            figure *f = figure_get(figure_id);
-            int result = callback(f);
-            if (result) {
-                return result;
-            }
-            figure_id = f->next_figure_id_on_same_tile;
+    const uint16_t *figure_ids;
+    unsigned int total = map_figure_get_all_at(grid_offset, &figure_ids);
+    for (unsigned int i = 0; i < total; i++) {
+        int result = callback(figure_get(figure_ids[i]));
+        if (result) {
+            return result;
         }
     }
     return 0;
@@ -99,6 +281,8 @@ int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f))
 void map_figure_clear(void)
 {
     map_grid_clear_u16(figures.items);
+    clear_buckets();
+    data.needs_rebuild = 0;
 }
 
 void map_figure_save_state(buffer *buf)
@@ -109,4 +293,6 @@ void map_figure_save_state(buffer *buf)
 void map_figure_load_state(buffer *buf)
 {
     map_grid_load_state_u16(figures.items, buf);
+    // The figures themselves are loaded afterwards, so their tile lists are rebuilt on first use
+    data.needs_rebuild = 1;
 }
@@ -4,6 +4,13 @@
 #include "core/buffer.h"
 #include "figure/figure.h"
 
+#include <stdint.h>
+
+/**
+ * Registers the figure grids, see map_grid_register_u16
+ */
+void map_figure_init_grids(void);
+
 /**
  * Returns the first figure at the given offset
  * @param grid_offset Map offset
@@ -24,6 +31,14 @@ void map_figure_update(figure *f);
 
 void map_figure_delete(figure *f);
 
+/**
+ * Returns all figures at the given offset, in the order in which they arrived
+ * @param grid_offset Map offset
+ * @param figure_ids Set to the list of figure IDs. The list is only valid until a figure enters or leaves the tile.
+ * @return Number of figures at the offset
+ */
+unsigned int map_figure_get_all_at(int grid_offset, const uint16_t **figure_ids);
+
 int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f));
 
 /**
@@ -1,5 +1,6 @@
 #include "grid.h"
 
+#include "core/log.h"
 #include "map/data.h"
 
 #include <stdlib.h>
@@ -8,42 +9,136 @@
 
 #define OFFSET(x,y) (x + GRID_SIZE * y)
 
-struct map_data_t map_data;
-
-static const int DIRECTION_DELTA[] = {
-    -OFFSET(0,1), OFFSET(1,-1), 1, OFFSET(1,1), OFFSET(0,1), OFFSET(-1,1), -1, -OFFSET(1,1)
-};
-
-static const int ADJACENT_OFFSETS[][29] = {
-    {0},
-    {OFFSET(0,-1), OFFSET(1,0), OFFSET(0,1), OFFSET(-1,0), 0},
-    {OFFSET(0,-1), OFFSET(1,-1), OFFSET(2,0), OFFSET(2,1), OFFSET(1,2), OFFSET(0,2), OFFSET(-1,1), OFFSET(-1,0), 0},
-    {
-        OFFSET(0,-1), OFFSET(1,-1), OFFSET(2,-1),
-        OFFSET(3,0), OFFSET(3,1), OFFSET(3,2),
-        OFFSET(2,3), OFFSET(1,3), OFFSET(0,3),
-        OFFSET(-1,2), OFFSET(-1,1), OFFSET(-1,0), 0
-    },
-    {
-        OFFSET(0,-1), OFFSET(1,-1), OFFSET(2,-1), OFFSET(3,-1),
-        OFFSET(4,0), OFFSET(4,1), OFFSET(4,2), OFFSET(4,3),
-        OFFSET(3,4), OFFSET(2,4), OFFSET(1,4), OFFSET(0,4),
-        OFFSET(-1,3), OFFSET(-1,2), OFFSET(-1,1), OFFSET(-1,0), 0
-    },
-    {
-        OFFSET(0,-1), OFFSET(1,-1), OFFSET(2,-1), OFFSET(3,-1), OFFSET(4,-1),
-        OFFSET(5,0), OFFSET(5,1), OFFSET(5,2), OFFSET(5,3), OFFSET(5,4),
-        OFFSET(4,5), OFFSET(3,5), OFFSET(2,5), OFFSET(1,5), OFFSET(0,5),
-        OFFSET(-1,4), OFFSET(-1,3), OFFSET(-1,2), OFFSET(-1,1), OFFSET(-1,0), 0
-    },
-    { 0
-    },
-    {   OFFSET(0,-1), OFFSET(1,-1), OFFSET(2,-1), OFFSET(3,-1), OFFSET(4,-1), OFFSET(5,-1), OFFSET(6,-1),
-        OFFSET(7,0), OFFSET(7,1), OFFSET(7,2), OFFSET(7,3), OFFSET(7,4), OFFSET(7,5), OFFSET(7,6),
-        OFFSET(6,7), OFFSET(5,7), OFFSET(4,7), OFFSET(3,7), OFFSET(2,7), OFFSET(1,7), OFFSET(0,7),
-        OFFSET(-1,6), OFFSET(-1,5), OFFSET(-1,4), OFFSET(-1,3), OFFSET(-1,2), OFFSET(-1,1), OFFSET(-1,0), 0
-    }
-};
+#define MAX_GRIDS 80
+#define MAX_ADJACENT_SIZE 7
+#define MAX_ADJACENT_OFFSETS (4 * MAX_ADJACENT_SIZE + 1)
+
+struct map_data_t map_data = { .grid_size = GRID_SIZE_ORIGINAL };
+
+static struct {
+    void **items;
+    size_t item_size;
+} grids[MAX_GRIDS];
+
+static int num_grids;
+
+static int offsets_grid_size;
+
+static int direction_delta[8];
+
+static int adjacent_offsets[MAX_ADJACENT_SIZE + 1][MAX_ADJACENT_OFFSETS];
+
+static void calculate_offsets(void)
+{
+    const int directions[8][2] = { {0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1} };
+    for (int i = 0; i < 8; i++) {
+        direction_delta[i] = OFFSET(directions[i][0], directions[i][1]);
+    }
+    // The tiles touching a building of the given size, clockwise from the top left, terminated by 0
+    for (int size = 1; size <= MAX_ADJACENT_SIZE; size++) {
+        int *offsets = adjacent_offsets[size];
+        for (int i = 0; i < size; i++) {
+            *offsets++ = OFFSET(i, -1);
+        }
+        for (int i = 0; i < size; i++) {
+            *offsets++ = OFFSET(size, i);
+        }
+        for (int i = size - 1; i >= 0; i--) {
+            *offsets++ = OFFSET(i, size);
+        }
+        for (int i = size - 1; i >= 0; i--) {
+            *offsets++ = OFFSET(-1, i);
+        }
+        *offsets = 0;
+    }
+    offsets_grid_size = GRID_SIZE;
+}
+
+static void register_grid(void **items, size_t item_size)
+{
+    for (int i = 0; i < num_grids; i++) {
+        if (grids[i].items == items) {
+            return;
+        }
+    }
+    if (num_grids >= MAX_GRIDS) {
+        log_error("Too many map grids registered", 0, num_grids);
+        return;
+    }
+    grids[num_grids].items = items;
+    grids[num_grids].item_size = item_size;
+    num_grids++;
+    *items = calloc((size_t) GRID_SIZE * GRID_SIZE, item_size);
+    if (!*items) {
+        log_error("Unable to allocate map grid of size", 0, GRID_SIZE);
+    }
+}
+
+void map_grid_register_u8(grid_u8 *grid)
+{
+    register_grid((void **) &grid->items, sizeof(uint8_t));
+}
+
+void map_grid_register_i8(grid_i8 *grid)
+{
+    register_grid((void **) &grid->items, sizeof(int8_t));
+}
+
+void map_grid_register_u16(grid_u16 *grid)
+{
+    register_grid((void **) &grid->items, sizeof(uint16_t));
+}
+
+void map_grid_register_i16(grid_i16 *grid)
+{
+    register_grid((void **) &grid->items, sizeof(int16_t));
+}
+
+void map_grid_register_i32(grid_i32 *grid)
+{
+    register_grid((void **) &grid->items, sizeof(int32_t));
+}
+
+void map_grid_register_u32(grid_u32 *grid)
+{
+    register_grid((void **) &grid->items, sizeof(uint32_t));
+}
+
+int map_grid_allocate(int grid_size)
+{
+    if (grid_size < GRID_SIZE_ORIGINAL || grid_size > GRID_SIZE_MAX) {
+        log_error("Invalid map grid size", 0, grid_size);
+        return 0;
+    }
+    if (grid_size == GRID_SIZE) {
+        return 1;
+    }
+    void *items[MAX_GRIDS];
+    for (int i = 0; i < num_grids; i++) {
+        items[i] = calloc((size_t) grid_size * grid_size, grids[i].item_size);
+        if (!items[i]) {
+            log_error("Unable to allocate map grid of size", 0, grid_size);
+            while (--i >= 0) {
+                free(items[i]);
+            }
+            return 0;
+        }
+    }
+    for (int i = 0; i < num_grids; i++) {
+        free(*grids[i].items);
+        *grids[i].items = items[i];
+    }
+    map_data.grid_size = grid_size;
+    calculate_offsets();
+    return 1;
+}
+
+int map_grid_size_for_map(int width, int height)
+{
+    // The map is surrounded by a border of at least one tile
+    int grid_size = (width > height ? width : height) + 2;
+    return grid_size < GRID_SIZE_ORIGINAL ? GRID_SIZE_ORIGINAL : grid_size;
+}
 
 void map_grid_init(int width, int height, int start_offset, int border_size)
 {
@@ -51,6 +146,9 @@ void map_grid_init(int width, int height, int start_offset, int border_size)
     map_data.height = height;
     map_data.start_offset = start_offset;
     map_data.border_size = border_size;
+    if (offsets_grid_size != GRID_SIZE) {
+        calculate_offsets();
+    }
 }
 
 int map_grid_is_valid_offset(int grid_offset)
@@ -92,7 +190,7 @@ int map_grid_add_delta(int grid_offset, int x, int y)
 int map_grid_direction_delta(int direction)
 {
     if (direction >= 0 && direction < 8) {
-        return DIRECTION_DELTA[direction];
+        return direction_delta[direction];
     } else {
         return 0;
     }
@@ -196,7 +294,7 @@ int map_grid_is_inside(int x, int y, int size)
 
 const int *map_grid_adjacent_offsets(int size)
 {
-    return ADJACENT_OFFSETS[size];
+    return adjacent_offsets[size];
 }
 
 void map_grid_get_corner_tiles(int start_x, int start_y, int x, int y, int *c1x, int *c1y, int *c2x, int *c2y)
@@ -229,6 +327,11 @@ void map_grid_clear_u16(uint16_t *grid)
     memset(grid, 0, GRID_SIZE * GRID_SIZE * sizeof(uint16_t));
 }
 
+void map_grid_clear_i32(int32_t *grid)
+{
+    memset(grid, 0, GRID_SIZE * GRID_SIZE * sizeof(int32_t));
+}
+
 void map_grid_clear_u32(uint32_t *grid)
 {
     memset(grid, 0, GRID_SIZE * GRID_SIZE * sizeof(uint32_t));
@@ -239,6 +342,53 @@ void map_grid_clear_i16(int16_t *grid)
     memset(grid, 0, GRID_SIZE * GRID_SIZE * sizeof(int16_t));
 }
 
+static void clear_map_area(void *grid, size_t item_size)
+{
+    // The map tiles plus a one tile margin, which is as far as the per-update grids are ever written
+    int x_min = map_data.start_offset % GRID_SIZE - 1;
+    int y_min = map_data.start_offset / GRID_SIZE - 1;
+    int x_max = x_min + map_data.width + 2;
+    int y_max = y_min + map_data.height + 2;
+    if (x_min < 0) {
+        x_min = 0;
+    }
+    if (y_min < 0) {
+        y_min = 0;
+    }
+    if (x_max > GRID_SIZE) {
+        x_max = GRID_SIZE;
+    }
+    if (y_max > GRID_SIZE) {
+        y_max = GRID_SIZE;
+    }
+    if (x_min >= x_max) {
+        return;
+    }
+    for (int y = y_min; y < y_max; y++) {
+        memset((char *) grid + (size_t) OFFSET(x_min, y) * item_size, 0, (size_t) (x_max - x_min) * item_size);
+    }
+}
+
+void map_grid_clear_map_area_u8(uint8_t *grid)
+{
+    clear_map_area(grid, sizeof(uint8_t));
+}
+
+void map_grid_clear_map_area_i8(int8_t *grid)
+{
+    clear_map_area(grid, sizeof(int8_t));
+}
+
+void map_grid_clear_map_area_u16(uint16_t *grid)
+{
+    clear_map_area(grid, sizeof(uint16_t));
+}
+
+void map_grid_clear_map_area_i16(int16_t *grid)
+{
+    clear_map_area(grid, sizeof(int16_t));
+}
+
 void map_grid_init_i8(int8_t *grid, int8_t value)
 {
     memset(grid, value, GRID_SIZE * GRID_SIZE * sizeof(int8_t));
@@ -2,33 +2,74 @@
 #define MAP_GRID_H
 
 #include "core/buffer.h"
+#include "map/data.h"
 
 #include <stdint.h>
 
+/**
+ * GRID_SIZE_MAX fits the largest editor map (512 tiles) plus its border. Grid offsets are stored as int
+ * and map coordinates as unsigned short, so every tile of such a grid can be addressed.
+ */
 enum {
-    GRID_SIZE = 162
+    GRID_SIZE_ORIGINAL = 162,
+    GRID_SIZE_MAX = 514
 };
 
+/**
+ * Number of tiles per side of the grids, which is also the stride between two rows.
+ * Set by map_grid_allocate when a map is created or loaded.
+ */
+#define GRID_SIZE (map_data.grid_size)
+
 typedef struct {
-    uint8_t items[GRID_SIZE * GRID_SIZE];
+    uint8_t *items;
 } grid_u8;
 
 typedef struct {
-    int8_t items[GRID_SIZE * GRID_SIZE];
+    int8_t *items;
 } grid_i8;
 
 typedef struct {
-    uint16_t items[GRID_SIZE * GRID_SIZE];
+    uint16_t *items;
 } grid_u16;
 
 typedef struct {
-    int16_t items[GRID_SIZE * GRID_SIZE];
+    int16_t *items;
 } grid_i16;
 
 typedef struct {
-    uint32_t items[GRID_SIZE * GRID_SIZE];
+    int32_t *items;
+} grid_i32;
+
+typedef struct {
+    uint32_t *items;
 } grid_u32;
 
+/**
+ * Registers a grid whose items are allocated with one element per tile.
+ * The grid is allocated right away for the current grid size, and reallocated by map_grid_allocate.
+ * Registering the same grid again has no effect.
+ */
+void map_grid_register_u8(grid_u8 *grid);
+void map_grid_register_i8(grid_i8 *grid);
+void map_grid_register_u16(grid_u16 *grid);
+void map_grid_register_i16(grid_i16 *grid);
+void map_grid_register_i32(grid_i32 *grid);
+void map_grid_register_u32(grid_u32 *grid);
+
+/**
+ * Sets the grid size and reallocates all registered grids for it.
+ * The grid contents are cleared when the size changes, and kept when it stays the same.
+ * @param grid_size Number of tiles per side, between GRID_SIZE_ORIGINAL and GRID_SIZE_MAX
+ * @return 1 on success, 0 if the size is out of range or the grids could not be allocated
+ */
+int map_grid_allocate(int grid_size);
+
+/**
+ * Returns the grid size required to fit a map of the given dimensions plus its border
+ */
+int map_grid_size_for_map(int width, int height);
+
 void map_grid_init(int width, int height, int start_offset, int border_size);
 
 int map_grid_is_valid_offset(int grid_offset);
@@ -81,8 +122,23 @@ void map_grid_clear_u16(uint16_t *grid);
 
 void map_grid_clear_i16(int16_t *grid);
 
+void map_grid_clear_i32(int32_t *grid);
+
 void map_grid_clear_u32(uint32_t *grid);
 
+/**
+ * Clears only the map tiles and the one tile margin around them, instead of the whole grid.
+ * Only meant for grids that are never written further out than that, such as per-update scratch grids.
+ * @param grid Grid to clear
+ */
+void map_grid_clear_map_area_u8(uint8_t *grid);
+
+void map_grid_clear_map_area_i8(int8_t *grid);
+
+void map_grid_clear_map_area_u16(uint16_t *grid);
+
+void map_grid_clear_map_area_i16(int16_t *grid);
+
 void map_grid_init_i8(int8_t *grid, int8_t value);
 
 void map_grid_and_u8(uint8_t *grid, uint8_t mask);
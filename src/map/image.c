@@ -12,6 +12,13 @@
 
 static grid_u32 images;
 static grid_u32 images_backup;
+static unsigned int version;
+
+void map_image_init_grids(void)
+{
+    map_grid_register_u32(&images);
+    map_grid_register_u32(&images_backup);
+}
 
 unsigned int map_image_at(int grid_offset)
 {
@@ -19,10 +26,23 @@ unsigned int map_image_at(int grid_offset)
 }
 
 void map_image_set(int grid_offset, int image_id)
+{
+    if (images.items[grid_offset] != (unsigned int) image_id) {
+        images.items[grid_offset] = image_id;
+        version++;
+    }
+}
+
+void map_image_set_animation_frame(int grid_offset, int image_id)
 {
     images.items[grid_offset] = image_id;
 }
 
+unsigned int map_image_get_version(void)
+{
+    return version;
+}
+
 void map_image_backup(void)
 {
     map_grid_copy_u32(images.items, images_backup.items);
@@ -31,16 +51,21 @@ void map_image_backup(void)
 void map_image_restore(void)
 {
     map_grid_copy_u32(images_backup.items, images.items);
+    version++;
 }
 
 void map_image_restore_at(int grid_offset)
 {
-    images.items[grid_offset] = images_backup.items[grid_offset];
+    if (images.items[grid_offset] != images_backup.items[grid_offset]) {
+        images.items[grid_offset] = images_backup.items[grid_offset];
+        version++;
+    }
 }
 
 void map_image_clear(void)
 {
     map_grid_clear_u32(images.items);
+    version++;
 }
 
 void map_image_init_edges(void)
@@ -56,6 +81,7 @@ void map_image_init_edges(void)
     images.items[map_grid_offset(0, height)] = 3;
     images.items[map_grid_offset(width, 0)] = 4;
     images.items[map_grid_offset(width, height)] = 5;
+    version++;
 }
 
 void map_image_update_all(void)
@@ -92,4 +118,5 @@ void map_image_save_state_legacy(buffer *buf)
 void map_image_load_state_legacy(buffer *buf)
 {
     map_grid_load_state_u16_to_u32(images.items, buf);
+    version++;
 }
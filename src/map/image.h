@@ -3,10 +3,25 @@
 
 #include "core/buffer.h"
 
+void map_image_init_grids(void);
+
 unsigned int map_image_at(int grid_offset);
 
 void map_image_set(int grid_offset, int image_id);
 
+/**
+ * Sets the next frame of an animated terrain image, such as water, without counting it as a change
+ * @param grid_offset Tile to set
+ * @param image_id Image of the next frame
+ */
+void map_image_set_animation_frame(int grid_offset, int image_id);
+
+/**
+ * Returns a number that changes whenever the image of any tile changes
+ * @return Change counter of the tile images
+ */
+unsigned int map_image_get_version(void);
+
 void map_image_backup(void);
 
 void map_image_restore(void);
@@ -14,6 +14,7 @@
 #include "map/building.h"
 #include "map/building_tiles.h"
 #include "map/data.h"
+#include "map/desirability.h"
 #include "map/grid.h"
 #include "map/image.h"
 #include "map/property.h"
@@ -155,6 +156,7 @@ void map_natives_init(void)
             building *b = building_create(type, x, y);
             map_building_set(grid_offset, b->id);
             b->state = BUILDING_STATE_IN_USE;
+            map_desirability_building_changed(b->id);
             switch (type) {
                 case BUILDING_NATIVE_CROPS:
                     b->data.industry.progress = random_bit;
@@ -240,6 +242,7 @@ void map_natives_init_editor(void)
             }
             building *b = building_create(type, x, y);
             b->state = BUILDING_STATE_IN_USE;
+            map_desirability_building_changed(b->id);
             map_building_set(grid_offset, b->id);
             if (type == BUILDING_NATIVE_MEETING) {
                 map_building_set(grid_offset + map_grid_delta(1, 0), b->id);
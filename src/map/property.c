@@ -1,5 +1,6 @@
 #include "property.h"
 
+#include "map/desirability.h"
 #include "map/grid.h"
 #include "map/random.h"
 
@@ -35,6 +36,16 @@ static grid_u8 bitfields_grid;
 static grid_u8 edge_backup;
 static grid_u8 bitfields_backup;
 
+static unsigned int marking_version;
+
+void map_property_init_grids(void)
+{
+    map_grid_register_u8(&edge_grid);
+    map_grid_register_u8(&bitfields_grid);
+    map_grid_register_u8(&edge_backup);
+    map_grid_register_u8(&bitfields_backup);
+}
+
 static int edge_for(int x, int y)
 {
     return 8 * y + x;
@@ -175,11 +186,17 @@ int map_property_is_plaza_earthquake_or_overgrown_garden(int grid_offset)
 
 void map_property_mark_plaza_earthquake_or_overgrown_garden(int grid_offset)
 {
+    if (!(bitfields_grid.items[grid_offset] & BIT_PLAZA_EARTHQUAKE_OR_OVERGROWN_GARDEN)) {
+        map_desirability_tile_changed(grid_offset);
+    }
     bitfields_grid.items[grid_offset] |= BIT_PLAZA_EARTHQUAKE_OR_OVERGROWN_GARDEN;
 }
 
 void map_property_clear_plaza_earthquake_or_overgrown_garden(int grid_offset)
 {
+    if (bitfields_grid.items[grid_offset] & BIT_PLAZA_EARTHQUAKE_OR_OVERGROWN_GARDEN) {
+        map_desirability_tile_changed(grid_offset);
+    }
     bitfields_grid.items[grid_offset] &= BIT_NO_PLAZA;
 }
 
@@ -190,12 +207,18 @@ int map_property_is_constructing(int grid_offset)
 
 void map_property_mark_constructing(int grid_offset)
 {
-    bitfields_grid.items[grid_offset] |= BIT_CONSTRUCTION;
+    if (!(bitfields_grid.items[grid_offset] & BIT_CONSTRUCTION)) {
+        bitfields_grid.items[grid_offset] |= BIT_CONSTRUCTION;
+        marking_version++;
+    }
 }
 
 void map_property_clear_constructing(int grid_offset)
 {
-    bitfields_grid.items[grid_offset] &= BIT_NO_CONSTRUCTION;
+    if (bitfields_grid.items[grid_offset] & BIT_CONSTRUCTION) {
+        bitfields_grid.items[grid_offset] &= BIT_NO_CONSTRUCTION;
+        marking_version++;
+    }
 }
 
 int map_property_is_deleted(int grid_offset)
@@ -205,23 +228,36 @@ int map_property_is_deleted(int grid_offset)
 
 void map_property_mark_deleted(int grid_offset)
 {
-    bitfields_grid.items[grid_offset] |= BIT_DELETED;
+    if (!(bitfields_grid.items[grid_offset] & BIT_DELETED)) {
+        bitfields_grid.items[grid_offset] |= BIT_DELETED;
+        marking_version++;
+    }
 }
 
 void map_property_clear_deleted(int grid_offset)
 {
-    bitfields_grid.items[grid_offset] &= BIT_NO_DELETED;
+    if (bitfields_grid.items[grid_offset] & BIT_DELETED) {
+        bitfields_grid.items[grid_offset] &= BIT_NO_DELETED;
+        marking_version++;
+    }
 }
 
 void map_property_clear_constructing_and_deleted(void)
 {
     map_grid_and_u8(bitfields_grid.items, BIT_NO_CONSTRUCTION_AND_DELETED);
+    marking_version++;
+}
+
+unsigned int map_property_get_marking_version(void)
+{
+    return marking_version;
 }
 
 void map_property_clear(void)
 {
     map_grid_clear_u8(bitfields_grid.items);
     map_grid_clear_u8(edge_grid.items);
+    marking_version++;
 }
 
 void map_property_backup(void)
@@ -232,8 +268,14 @@ void map_property_backup(void)
 
 void map_property_restore(void)
 {
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        if ((bitfields_grid.items[i] ^ bitfields_backup.items[i]) & BIT_PLAZA_EARTHQUAKE_OR_OVERGROWN_GARDEN) {
+            map_desirability_tile_changed(i);
+        }
+    }
     map_grid_copy_u8(bitfields_backup.items, bitfields_grid.items);
     map_grid_copy_u8(edge_backup.items, edge_grid.items);
+    marking_version++;
 }
 
 void map_property_save_state(buffer *bitfields, buffer *edge)
@@ -246,4 +288,5 @@ void map_property_load_state(buffer *bitfields, buffer *edge)
 {
     map_grid_load_state_u8(bitfields_grid.items, bitfields);
     map_grid_load_state_u8(edge_grid.items, edge);
+    marking_version++;
 }
@@ -15,6 +15,8 @@ enum {
     EDGE_X2Y2 = 18
 };
 
+void map_property_init_grids(void);
+
 int map_property_is_draw_tile(int grid_offset);
 int map_property_is_draw_tile_from_buffer(buffer *edge, int grid_offset);
 void map_property_mark_draw_tile(int grid_offset);
@@ -53,6 +55,12 @@ void map_property_clear_deleted(int grid_offset);
 
 void map_property_clear_constructing_and_deleted(void);
 
+/**
+ * Returns a number that changes whenever tiles are marked or unmarked as being constructed or deleted
+ * @return Change counter of the construction and deletion marks
+ */
+unsigned int map_property_get_marking_version(void);
+
 void map_property_clear(void);
 
 void map_property_backup(void);
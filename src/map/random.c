@@ -5,6 +5,11 @@
 
 static grid_u8 random;
 
+void map_random_init_grids(void)
+{
+    map_grid_register_u8(&random);
+}
+
 void map_random_clear(void)
 {
     map_grid_clear_u8(random.items);
@@ -3,6 +3,8 @@
 
 #include "core/buffer.h"
 
+void map_random_init_grids(void);
+
 void map_random_clear(void);
 
 void map_random_init(void);
@@ -6,90 +6,337 @@
 #include "map/routing_terrain.h"
 #include "map/terrain.h"
 
-#include <string.h>
+#define TOTAL_TILES (GRID_SIZE * GRID_SIZE)
+#define NO_PARENT -1
 
-#define MAX_QUEUE 1000
+typedef enum {
+    TILE_NONE = 0,
+    TILE_CONNECTOR = 1, // highway, access ramp or building that can be walked through like a road
+    TILE_ROAD = 2
+} tile_state;
 
-static const int ADJACENT_OFFSETS[] = {-GRID_SIZE, 1, GRID_SIZE, -1};
-
-static grid_u8 network;
+// Tiles that are connected form a set in a union-find structure. The set data is kept at the root tile.
+static struct {
+    grid_u8 state;
+    grid_i32 parent;
+    grid_i32 size;
+    grid_i32 roads;
+    grid_i32 network_id;
+    grid_u8 id_in_use;
+    int first_free_id;
+    int terrain_changed;
+} data;
 
+// Scratch space for an update
 static struct {
-    int items[MAX_QUEUE];
-    int head;
-    int tail;
-} queue;
+    grid_i32 removed;
+    int total_removed;
+    grid_i32 added;
+    int total_added;
+    grid_i32 changed;
+    int total_changed;
+    grid_i32 relabelled;
+    int total_relabelled;
+    grid_i32 queue;
+    grid_u16 visited;
+    uint16_t visit_id;
+} update;
+
+void map_road_network_init_grids(void)
+{
+    map_grid_register_u8(&data.state);
+    map_grid_register_i32(&data.parent);
+    map_grid_register_i32(&data.size);
+    map_grid_register_i32(&data.roads);
+    map_grid_register_i32(&data.network_id);
+    map_grid_register_u8(&data.id_in_use);
+    map_grid_register_i32(&update.removed);
+    map_grid_register_i32(&update.added);
+    map_grid_register_i32(&update.changed);
+    map_grid_register_i32(&update.relabelled);
+    map_grid_register_i32(&update.queue);
+    map_grid_register_u16(&update.visited);
+}
 
 void map_road_network_clear(void)
 {
-    map_grid_clear_u8(network.items);
+    map_grid_clear_u8(data.state.items);
+    map_grid_clear_i32(data.size.items);
+    map_grid_clear_i32(data.roads.items);
+    map_grid_clear_i32(data.network_id.items);
+    map_grid_clear_u8(data.id_in_use.items);
+    for (int i = 0; i < TOTAL_TILES; i++) {
+        data.parent.items[i] = NO_PARENT;
+    }
+    data.first_free_id = 1;
+    data.terrain_changed = 1;
+}
+
+static int find_root(int grid_offset)
+{
+    int root = grid_offset;
+    while (data.parent.items[root] != root) {
+        root = data.parent.items[root];
+    }
+    while (data.parent.items[grid_offset] != root) {
+        int next = data.parent.items[grid_offset];
+        data.parent.items[grid_offset] = root;
+        grid_offset = next;
+    }
+    return root;
 }
 
 int map_road_network_get(int grid_offset)
 {
-    return network.items[grid_offset];
+    if (data.parent.items[grid_offset] == NO_PARENT) {
+        return 0;
+    }
+    return data.network_id.items[find_root(grid_offset)];
+}
+
+void map_road_network_terrain_changed(void)
+{
+    data.terrain_changed = 1;
 }
 
-static int mark_road_network(int grid_offset, uint8_t network_id)
+static tile_state get_tile_state(int grid_offset)
 {
-    memset(&queue, 0, sizeof(queue));
-    int guard = 0;
-    int next_offset;
-    int size = 1;
-    do {
-        if (++guard >= GRID_SIZE * GRID_SIZE) {
-            break;
+    if (!map_routing_citizen_is_passable(grid_offset)) {
+        return TILE_NONE;
+    }
+    if (!map_routing_citizen_is_road(grid_offset) && !map_terrain_is(grid_offset, TERRAIN_ACCESS_RAMP) &&
+        !map_routing_citizen_is_highway(grid_offset)) {
+        return TILE_NONE;
+    }
+    return map_terrain_is(grid_offset, TERRAIN_ROAD) ? TILE_ROAD : TILE_CONNECTOR;
+}
+
+static int allocate_network_id(void)
+{
+    for (int id = data.first_free_id; id < TOTAL_TILES; id++) {
+        if (!data.id_in_use.items[id]) {
+            data.id_in_use.items[id] = 1;
+            data.first_free_id = id + 1;
+            return id;
+        }
+    }
+    return 0;
+}
+
+static void release_network_id(int root)
+{
+    int id = data.network_id.items[root];
+    data.id_in_use.items[id] = 0;
+    if (id < data.first_free_id) {
+        data.first_free_id = id;
+    }
+    data.network_id.items[root] = 0;
+}
+
+static void next_visit(void)
+{
+    update.visit_id++;
+    if (!update.visit_id) {
+        map_grid_clear_map_area_u16(update.visited.items);
+        update.visit_id = 1;
+    }
+}
+
+static void join(int a, int b)
+{
+    a = find_root(a);
+    b = find_root(b);
+    if (a == b) {
+        return;
+    }
+    if (data.size.items[a] < data.size.items[b]) {
+        int tmp = a;
+        a = b;
+        b = tmp;
+    }
+    data.parent.items[b] = a;
+    data.size.items[a] += data.size.items[b];
+    data.roads.items[a] += data.roads.items[b];
+    // Keep the lowest network id of the two
+    if (data.network_id.items[b] && (!data.network_id.items[a] || data.network_id.items[b] < data.network_id.items[a])) {
+        int id = data.network_id.items[a];
+        data.network_id.items[a] = data.network_id.items[b];
+        data.network_id.items[b] = id;
+    }
+    if (data.network_id.items[b]) {
+        release_network_id(b);
+    }
+}
+
+static void relabel_from(int start)
+{
+    int head = 0;
+    int tail = 0;
+    data.parent.items[start] = start;
+    data.size.items[start] = 0;
+    data.roads.items[start] = 0;
+    data.network_id.items[start] = 0;
+    update.visited.items[start] = update.visit_id;
+    update.queue.items[tail++] = start;
+    while (head < tail) {
+        int grid_offset = update.queue.items[head++];
+        data.parent.items[grid_offset] = start;
+        data.size.items[start]++;
+        if (data.state.items[grid_offset] == TILE_ROAD) {
+            data.roads.items[start]++;
         }
-        network.items[grid_offset] = network_id;
-        next_offset = -1;
         for (int i = 0; i < 4; i++) {
-            int new_offset = grid_offset + ADJACENT_OFFSETS[i];
-            if (map_routing_citizen_is_passable(new_offset) && !network.items[new_offset]) {
-                if (
-                    map_routing_citizen_is_road(new_offset) ||
-                    map_terrain_is(new_offset, TERRAIN_ACCESS_RAMP) ||
-                    map_routing_citizen_is_highway(new_offset)
-                ) {
-                    network.items[new_offset] = network_id;
-                    size++;
-                    if (next_offset == -1) {
-                        next_offset = new_offset;
-                    } else {
-                        queue.items[queue.tail++] = new_offset;
-                        if (queue.tail >= MAX_QUEUE) {
-                            queue.tail = 0;
-                        }
-                    }
-                }
+            int next_offset = grid_offset + map_grid_direction_delta(2 * i);
+            if (data.parent.items[next_offset] != NO_PARENT && update.visited.items[next_offset] != update.visit_id) {
+                update.visited.items[next_offset] = update.visit_id;
+                update.queue.items[tail++] = next_offset;
+            }
+        }
+    }
+}
+
+static void find_changed_tiles(void)
+{
+    update.total_removed = 0;
+    update.total_added = 0;
+    update.total_changed = 0;
+    int grid_offset = map_data.start_offset;
+    for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
+        for (int x = 0; x < map_data.width; x++, grid_offset++) {
+            tile_state current = get_tile_state(grid_offset);
+            tile_state previous = data.state.items[grid_offset];
+            if (current == previous) {
+                continue;
+            }
+            if (current == TILE_NONE) {
+                update.removed.items[update.total_removed++] = grid_offset;
+            } else if (previous == TILE_NONE) {
+                update.added.items[update.total_added++] = grid_offset;
+            } else {
+                update.changed.items[update.total_changed++] = grid_offset;
+            }
+        }
+    }
+}
+
+static void remove_tiles(void)
+{
+    // Every set that loses a tile may split up, so all of its remaining tiles are labelled again
+    next_visit();
+    for (int i = 0; i < update.total_removed; i++) {
+        int root = find_root(update.removed.items[i]);
+        if (update.visited.items[root] != update.visit_id) {
+            update.visited.items[root] = update.visit_id;
+            if (data.network_id.items[root]) {
+                release_network_id(root);
             }
         }
-        if (next_offset == -1) {
-            if (queue.head == queue.tail) {
-                return size;
+    }
+    for (int i = 0; i < update.total_removed; i++) {
+        int grid_offset = update.removed.items[i];
+        data.parent.items[grid_offset] = NO_PARENT;
+        data.state.items[grid_offset] = TILE_NONE;
+    }
+    next_visit();
+    update.total_relabelled = 0;
+    for (int i = 0; i < update.total_removed; i++) {
+        int grid_offset = update.removed.items[i];
+        for (int d = 0; d < 4; d++) {
+            int next_offset = grid_offset + map_grid_direction_delta(2 * d);
+            if (data.parent.items[next_offset] != NO_PARENT && update.visited.items[next_offset] != update.visit_id) {
+                relabel_from(next_offset);
+                update.relabelled.items[update.total_relabelled++] = next_offset;
             }
-            next_offset = queue.items[queue.head++];
-            if (queue.head >= MAX_QUEUE) {
-                queue.head = 0;
+        }
+    }
+}
+
+static void add_tiles(void)
+{
+    for (int i = 0; i < update.total_added; i++) {
+        int grid_offset = update.added.items[i];
+        data.state.items[grid_offset] = get_tile_state(grid_offset);
+        data.parent.items[grid_offset] = grid_offset;
+        data.size.items[grid_offset] = 1;
+        data.roads.items[grid_offset] = data.state.items[grid_offset] == TILE_ROAD;
+        data.network_id.items[grid_offset] = 0;
+        for (int d = 0; d < 4; d++) {
+            int next_offset = grid_offset + map_grid_direction_delta(2 * d);
+            if (data.parent.items[next_offset] != NO_PARENT) {
+                join(grid_offset, next_offset);
             }
         }
-        grid_offset = next_offset;
-    } while (next_offset > -1);
-    return size;
+    }
 }
 
-void map_road_network_update(void)
+static void change_tiles(void)
+{
+    for (int i = 0; i < update.total_changed; i++) {
+        int grid_offset = update.changed.items[i];
+        int root = find_root(grid_offset);
+        data.state.items[grid_offset] = get_tile_state(grid_offset);
+        if (data.state.items[grid_offset] == TILE_ROAD) {
+            data.roads.items[root]++;
+        } else if (!--data.roads.items[root] && data.network_id.items[root]) {
+            release_network_id(root);
+        }
+    }
+}
+
+static void assign_network_id(int grid_offset)
+{
+    int root = find_root(grid_offset);
+    if (data.roads.items[root] && !data.network_id.items[root]) {
+        data.network_id.items[root] = allocate_network_id();
+    }
+}
+
+static void assign_new_network_ids(void)
+{
+    // Only sets that contain at least one road tile are a road network
+    for (int i = 0; i < update.total_relabelled; i++) {
+        assign_network_id(update.relabelled.items[i]);
+    }
+    for (int i = 0; i < update.total_added; i++) {
+        assign_network_id(update.added.items[i]);
+    }
+    for (int i = 0; i < update.total_changed; i++) {
+        if (data.state.items[update.changed.items[i]] == TILE_ROAD) {
+            assign_network_id(update.changed.items[i]);
+        }
+    }
+}
+
+static void update_largest_networks(void)
 {
     city_map_clear_largest_road_networks();
-    map_grid_clear_u8(network.items);
-    int network_id = 1;
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
-            if (map_terrain_is(grid_offset, TERRAIN_ROAD) && !network.items[grid_offset]) {
-                int size = mark_road_network(grid_offset, network_id);
-                city_map_add_to_largest_road_networks(network_id, size);
-                network_id++;
+            if (data.parent.items[grid_offset] == grid_offset && data.network_id.items[grid_offset]) {
+                city_map_add_to_largest_road_networks(data.network_id.items[grid_offset], data.size.items[grid_offset]);
             }
         }
     }
 }
+
+int map_road_network_update(void)
+{
+    if (!data.first_free_id) {
+        map_road_network_clear();
+    }
+    if (!data.terrain_changed) {
+        return 0;
+    }
+    data.terrain_changed = 0;
+    find_changed_tiles();
+    if (!update.total_removed && !update.total_added && !update.total_changed) {
+        return 1;
+    }
+    remove_tiles();
+    add_tiles();
+    change_tiles();
+    assign_new_network_ids();
+    update_largest_networks();
+    return 1;
+}
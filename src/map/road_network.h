@@ -1,10 +1,27 @@
 #ifndef MAP_ROAD_NETWORK_H
 #define MAP_ROAD_NETWORK_H
 
+void map_road_network_init_grids(void);
+
 void map_road_network_clear(void);
 
+/**
+ * Gets the road network a tile belongs to
+ * @param grid_offset Tile to check
+ * @return Network id, or 0 if the tile is not part of a road network
+ */
 int map_road_network_get(int grid_offset);
 
-void map_road_network_update(void);
+/**
+ * Marks the citizen terrain as changed, so the next update checks which tiles joined or left a network
+ */
+void map_road_network_terrain_changed(void);
+
+/**
+ * Updates the road networks with the tiles that changed since the last update.
+ * Network ids of unaffected networks stay the same.
+ * @return Boolean true if the citizen terrain changed since the last update
+ */
+int map_road_network_update(void);
 
 #endif // MAP_ROAD_NETWORK_H
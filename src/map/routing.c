@@ -12,7 +12,7 @@
 
 #include <stdlib.h>
 
-#define MAX_QUEUE GRID_SIZE * GRID_SIZE
+#define MAX_QUEUE (GRID_SIZE * GRID_SIZE)
 #define GUARD 50000
 
 #define UNTIL_STOP 0
@@ -23,9 +23,9 @@ typedef enum {
     DIRECTIONS_DIAGONALS = 8
 } max_directions;
 
-static const int ROUTE_OFFSETS[] = { -162, 1, 162, -1, -161, 163, 161, -163 };
 static const int ROUTE_OFFSETS_X[] = { 0, 1, 0, -1,  1, 1, -1, -1 };
 static const int ROUTE_OFFSETS_Y[] = { -1, 0, 1,  0, -1, 1,  1, -1 };
+#define ROUTE_OFFSET(direction) (ROUTE_OFFSETS_X[direction] + ROUTE_OFFSETS_Y[direction] * GRID_SIZE)
 static const int HIGHWAY_DIRECTIONS[] = {
     TERRAIN_HIGHWAY_TOP_RIGHT | TERRAIN_HIGHWAY_BOTTOM_RIGHT, // up
     TERRAIN_HIGHWAY_BOTTOM_LEFT | TERRAIN_HIGHWAY_BOTTOM_RIGHT, // right
@@ -47,16 +47,39 @@ static struct {
 static struct {
     int head;
     int tail;
-    int items[MAX_QUEUE];
+    grid_i32 items;
+    grid_i32 positions; // heap index of each queued grid offset, only valid while the offset is queued
 } queue;
 
 static grid_u8 water_drag;
 
+// Tiles are only valid in the distance and water drag grids when their generation matches the current one,
+// so starting a new route does not need to clear the full grids
+static struct {
+    uint16_t current;
+    grid_u16 tiles;
+} generation;
+
 static struct {
     grid_u8 status;
     time_millis last_check;
 } fighting_data;
 
+void map_routing_init_grids(void)
+{
+    map_grid_register_i16(&distance.possible);
+    map_grid_register_i16(&distance.determined);
+    map_grid_register_i32(&queue.items);
+    map_grid_register_i32(&queue.positions);
+    map_grid_register_u8(&water_drag);
+    map_grid_register_u16(&generation.tiles);
+    map_grid_register_u8(&fighting_data.status);
+    map_grid_register_i8(&terrain_land_citizen);
+    map_grid_register_i8(&terrain_land_noncitizen);
+    map_grid_register_i8(&terrain_water);
+    map_grid_register_i8(&terrain_walls);
+}
+
 static struct {
     int through_building_id;
     int dest_building_id;
@@ -66,7 +89,7 @@ static void reset_fighting_status(void)
 {
     time_millis current_time = time_get_millis();
     if (current_time != fighting_data.last_check) {
-        map_grid_clear_u8(fighting_data.status.items);
+        map_grid_clear_map_area_u8(fighting_data.status.items);
         fighting_data.last_check = current_time;
     }
 }
@@ -79,16 +102,50 @@ const map_routing_distance_grid *map_routing_get_distance_grid(void)
 static void clear_data(void)
 {
     reset_fighting_status();
-    map_grid_clear_i16(distance.possible.items);
-    map_grid_clear_i16(distance.determined.items);
+    if (++generation.current == 0) {
+        map_grid_clear_map_area_u16(generation.tiles.items);
+        generation.current = 1;
+    }
     queue.head = 0;
     queue.tail = 0;
 }
 
+static inline void touch_tile(int grid_offset)
+{
+    if (generation.tiles.items[grid_offset] != generation.current) {
+        generation.tiles.items[grid_offset] = generation.current;
+        distance.possible.items[grid_offset] = 0;
+        distance.determined.items[grid_offset] = 0;
+        water_drag.items[grid_offset] = 0;
+    }
+}
+
+static inline int get_determined(int grid_offset)
+{
+    return generation.tiles.items[grid_offset] == generation.current ? distance.determined.items[grid_offset] : 0;
+}
+
+static inline void set_determined(int grid_offset, int dist)
+{
+    touch_tile(grid_offset);
+    distance.determined.items[grid_offset] = dist;
+}
+
+static inline int get_possible(int grid_offset)
+{
+    return generation.tiles.items[grid_offset] == generation.current ? distance.possible.items[grid_offset] : 0;
+}
+
+static inline void set_possible(int grid_offset, int dist)
+{
+    touch_tile(grid_offset);
+    distance.possible.items[grid_offset] = dist;
+}
+
 static inline void enqueue(int next_offset, int dist)
 {
-    distance.determined.items[next_offset] = dist;
-    queue.items[queue.tail++] = next_offset;
+    set_determined(next_offset, dist);
+    queue.items.items[queue.tail++] = next_offset;
     if (queue.tail >= MAX_QUEUE) {
         queue.tail = 0;
     }
@@ -96,23 +153,31 @@ static inline void enqueue(int next_offset, int dist)
 
 static inline int queue_pop(void)
 {
-    int result = queue.items[queue.head];
+    int result = queue.items.items[queue.head];
     if (++queue.head >= MAX_QUEUE) {
         queue.head = 0;
     }
     return result;
 }
 
+// Tiles in the queue always belong to the current generation, so their distances can be read directly
+
 static inline int ordered_queue_parent(int index)
 {
     return (index - 1) / 2;
 }
 
+static inline void ordered_queue_set(int index, int offset)
+{
+    queue.items.items[index] = offset;
+    queue.positions.items[offset] = index;
+}
+
 static inline void ordered_queue_swap(int first, int second)
 {
-    int temp = queue.items[first];
-    queue.items[first] = queue.items[second];
-    queue.items[second] = temp;
+    int temp = queue.items.items[first];
+    ordered_queue_set(first, queue.items.items[second]);
+    ordered_queue_set(second, temp);
 }
 
 static void ordered_queue_reorder(int start_index)
@@ -123,13 +188,13 @@ static void ordered_queue_reorder(int start_index)
     }
     int right_child = left_child + 1;
     int smallest = start_index;
-    int16_t *offset_smallest = &distance.possible.items[queue.items[smallest]];
-    if (distance.possible.items[queue.items[left_child]] < *offset_smallest) {
+    int16_t *offset_smallest = &distance.possible.items[queue.items.items[smallest]];
+    if (distance.possible.items[queue.items.items[left_child]] < *offset_smallest) {
         smallest = left_child;
-        offset_smallest = &distance.possible.items[queue.items[smallest]];
+        offset_smallest = &distance.possible.items[queue.items.items[smallest]];
     }
     if (right_child < queue.tail &&
-        distance.possible.items[queue.items[right_child]] < *offset_smallest) {
+        distance.possible.items[queue.items.items[right_child]] < *offset_smallest) {
         smallest = right_child;
     }
     if (smallest != start_index) {
@@ -140,16 +205,16 @@ static void ordered_queue_reorder(int start_index)
 
 static inline int ordered_queue_pop(void)
 {
-    int min = queue.items[0];
-    queue.items[0] = queue.items[--queue.tail];
+    int min = queue.items.items[0];
+    ordered_queue_set(0, queue.items.items[--queue.tail]);
     ordered_queue_reorder(0);
     return min;
 }
 
 static inline void ordered_queue_reduce_index(int index, int offset, int dist)
 {
-    queue.items[index] = offset;
-    while (index && distance.possible.items[queue.items[ordered_queue_parent(index)]] > dist) {
+    ordered_queue_set(index, offset);
+    while (index && distance.possible.items[queue.items.items[ordered_queue_parent(index)]] > dist) {
         ordered_queue_swap(index, ordered_queue_parent(index));
         index = ordered_queue_parent(index);
     }
@@ -158,31 +223,30 @@ static inline void ordered_queue_reduce_index(int index, int offset, int dist)
 static void ordered_enqueue(int next_offset, int current_dist, int remaining_dist)
 {
     int possible_dist = remaining_dist + current_dist;
-    int index = queue.tail;
-    if (distance.possible.items[next_offset]) {
-        if (distance.possible.items[next_offset] <= possible_dist) {
+    int index;
+    int current_possible = get_possible(next_offset);
+    if (current_possible) {
+        // Tiles that were already popped have a possible distance of 1, so only queued tiles get past this check
+        if (current_possible <= possible_dist) {
             return;
-        } else {
-            for (int i = 0; i < queue.tail; i++) {
-                if (queue.items[i] == next_offset) {
-                    index = i;
-                    break;
-                }
-            }
         }
+        index = queue.positions.items[next_offset];
     } else {
-        queue.tail++;
+        index = queue.tail++;
     }
-    distance.determined.items[next_offset] = current_dist;
-    distance.possible.items[next_offset] = possible_dist;
+    set_determined(next_offset, current_dist);
+    set_possible(next_offset, possible_dist);
 
     ordered_queue_reduce_index(index, next_offset, possible_dist);
 }
 
 static inline int valid_offset(int grid_offset, int possible_dist)
 {
-    int determined = distance.determined.items[grid_offset];
-    return map_grid_is_valid_offset(grid_offset) && (determined == 0 || possible_dist < determined);
+    if (!map_grid_is_valid_offset(grid_offset)) {
+        return 0;
+    }
+    int determined = get_determined(grid_offset);
+    return determined == 0 || possible_dist < determined;
 }
 
 static inline int distance_left(int x, int y)
@@ -217,7 +281,7 @@ static void route_queue_from_to(int src_x, int src_y, int dst_x, int dst_y, int
         int y = map_grid_offset_to_y(offset);
         distance.possible.items[offset] = 1;
         for (int i = 0; i < num_directions; i++) {
-            int next_offset = offset + ROUTE_OFFSETS[i];
+            int next_offset = offset + ROUTE_OFFSET(i);
             int remaining_dist = distance_left(x + ROUTE_OFFSETS_X[i], y + ROUTE_OFFSETS_Y[i]);
             int dist = 2 + distance.determined.items[offset];
             if (receive_highway_bonus(next_offset, i)) {
@@ -234,7 +298,6 @@ static void route_queue_all_from(int source, max_directions directions,
     int (*callback)(int next_offset, int dist, int direction), int is_boat)
 {
     clear_data();
-    map_grid_clear_u8(water_drag.items);
     enqueue(source, 1);
     int tiles = 0;
     while (queue.head != queue.tail) {
@@ -245,14 +308,14 @@ static void route_queue_all_from(int source, max_directions directions,
         int drag = is_boat && terrain_water.items[offset] == WATER_N2_MAP_EDGE ? 4 : 0;
         if (water_drag.items[offset] < drag) {
             water_drag.items[offset]++;
-            queue.items[queue.tail++] = offset;
+            queue.items.items[queue.tail++] = offset;
             if (queue.tail >= MAX_QUEUE) {
                 queue.tail = 0;
             }
         } else {
             int dist = 1 + distance.determined.items[offset];
             for (max_directions i = 0; i < directions; i++) {
-                int route_offset = ROUTE_OFFSETS[i];
+                int route_offset = ROUTE_OFFSET(i);
                 int next_offset = offset + route_offset;
                 if (valid_offset(next_offset, dist)) {
                     if (callback(next_offset, dist, i) == UNTIL_STOP) {
@@ -284,7 +347,7 @@ static int callback_calc_distance_water_boat(int next_offset, int dist, int dire
         terrain_water.items[next_offset] != WATER_N3_LOW_BRIDGE) {
         enqueue(next_offset, dist);
         if (terrain_water.items[next_offset] == WATER_N2_MAP_EDGE) {
-            distance.determined.items[next_offset] += 4;
+            set_determined(next_offset, get_determined(next_offset) + 4);
         }
     }
     return 1;
@@ -358,7 +421,7 @@ static int callback_calc_distance_build_road(int next_offset, int dist, int dire
     switch (terrain_land_citizen.items[next_offset]) {
         case CITIZEN_N3_AQUEDUCT:
             if (!map_can_place_road_under_aqueduct(next_offset)) {
-                distance.determined.items[next_offset] = -1;
+                set_determined(next_offset, -1);
                 blocked = 1;
             }
             break;
@@ -401,7 +464,7 @@ static int callback_calc_distance_build_aqueduct(int next_offset, int dist, int
             break;
     }
     if (map_terrain_is(next_offset, TERRAIN_ROAD) && !map_can_place_aqueduct_on_road(next_offset)) {
-        distance.determined.items[next_offset] = -1;
+        set_determined(next_offset, -1);
         blocked = 1;
     }
     if (!blocked) {
@@ -559,7 +622,7 @@ int map_routing_citizen_can_travel_over_land(int src_x, int src_y, int dst_x, in
 {
     ++stats.total_routes_calculated;
     route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_citizen_land);
-    return distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+    return get_determined(map_grid_offset(dst_x, dst_y)) != 0;
 }
 
 static int callback_travel_citizen_road_garden(int offset, int next_offset, int direction)
@@ -580,7 +643,7 @@ int map_routing_citizen_can_travel_over_road_garden(int src_x, int src_y, int ds
     }
     ++stats.total_routes_calculated;
     route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_citizen_road_garden);
-    return distance.determined.items[dst_offset] != 0;
+    return get_determined(dst_offset) != 0;
 }
 
 static int callback_travel_citizen_road_garden_highway(int offset, int next_offset, int direction)
@@ -601,7 +664,7 @@ int map_routing_citizen_can_travel_over_road_garden_highway(int src_x, int src_y
     }
     ++stats.total_routes_calculated;
     route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_citizen_road_garden_highway);
-    return distance.determined.items[dst_offset] != 0;
+    return get_determined(dst_offset) != 0;
 }
 
 static int callback_travel_walls(int offset, int next_offset, int direction)
@@ -617,7 +680,7 @@ int map_routing_can_travel_over_walls(int src_x, int src_y, int dst_x, int dst_y
 {
     ++stats.total_routes_calculated;
     route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_walls);
-    return distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+    return get_determined(map_grid_offset(dst_x, dst_y)) != 0;
 }
 
 static int callback_travel_noncitizen_land_through_building(int offset, int next_offset, int direction)
@@ -662,7 +725,7 @@ int map_routing_noncitizen_can_travel_over_land(
     } else {
         route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, max_tiles, callback_travel_noncitizen_land);
     }
-    return distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+    return get_determined(map_grid_offset(dst_x, dst_y)) != 0;
 }
 
 static int callback_travel_noncitizen_through_everything(int offset, int next_offset, int direction)
@@ -677,7 +740,7 @@ int map_routing_noncitizen_can_travel_through_everything(int src_x, int src_y, i
 {
     ++stats.total_routes_calculated;
     route_queue_from_to(src_x, src_y, dst_x, dst_y, num_directions, 0, callback_travel_noncitizen_through_everything);
-    return distance.determined.items[map_grid_offset(dst_x, dst_y)] != 0;
+    return get_determined(map_grid_offset(dst_x, dst_y)) != 0;
 }
 
 void map_routing_block(int x, int y, int size)
@@ -687,14 +750,14 @@ void map_routing_block(int x, int y, int size)
     }
     for (int dy = 0; dy < size; dy++) {
         for (int dx = 0; dx < size; dx++) {
-            distance.determined.items[map_grid_offset(x + dx, y + dy)] = 0;
+            set_determined(map_grid_offset(x + dx, y + dy), 0);
         }
     }
 }
 
 int map_routing_distance(int grid_offset)
 {
-    return distance.determined.items[grid_offset];
+    return get_determined(grid_offset);
 }
 
 void map_routing_save_state(buffer *buf)
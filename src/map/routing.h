@@ -19,6 +19,15 @@ typedef struct map_routing_distance_grid {
     int dst_y;
 } map_routing_distance_grid;
 
+/**
+ * Registers the routing grids, including the terrain grids of map/routing_data.h
+ */
+void map_routing_init_grids(void);
+
+/**
+ * Gets the distance grids of the last route calculation.
+ * The grids are reset lazily, so use map_routing_distance to read distances.
+ */
 const map_routing_distance_grid *map_routing_get_distance_grid(void);
 
 void map_routing_calculate_distances(int x, int y);
@@ -0,0 +1,186 @@
+#include "routing_cache.h"
+
+#include "map/grid.h"
+#include "map/road_network.h"
+#include "map/routing_data.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_CACHED_FIELDS 16
+
+typedef struct {
+    int in_use;
+    int network_id;
+    int grid_offset;
+    unsigned int last_used;
+    grid_u16 distance; // steps to the destination plus one, 0 when the destination cannot be reached
+    // Tiles that have a distance, so the next field in this slot only has to clear those.
+    // A negative count means the tiles could not be stored and the whole grid has to be cleared.
+    int *tiles;
+    int total_tiles;
+    int tiles_capacity;
+} distance_field;
+
+static struct {
+    distance_field fields[MAX_CACHED_FIELDS];
+    unsigned int lookups;
+    grid_i32 queue;
+} data;
+
+void map_routing_cache_init_grids(void)
+{
+    for (int i = 0; i < MAX_CACHED_FIELDS; i++) {
+        map_grid_register_u16(&data.fields[i].distance);
+    }
+    map_grid_register_i32(&data.queue);
+}
+
+static inline int is_road_or_garden(int grid_offset)
+{
+    return terrain_land_citizen.items[grid_offset] == CITIZEN_0_ROAD ||
+        terrain_land_citizen.items[grid_offset] == CITIZEN_2_PASSABLE_TERRAIN;
+}
+
+static void clear_field(distance_field *field)
+{
+    uint16_t *distance = field->distance.items;
+    if (field->total_tiles < 0) {
+        map_grid_clear_u16(distance);
+    } else {
+        int total_offsets = GRID_SIZE * GRID_SIZE;
+        for (int i = 0; i < field->total_tiles; i++) {
+            // The grids are allocated anew when the map size changes
+            if (field->tiles[i] < total_offsets) {
+                distance[field->tiles[i]] = 0;
+            }
+        }
+    }
+    field->total_tiles = 0;
+}
+
+static void store_field_tiles(distance_field *field, int total_tiles)
+{
+    if (total_tiles > field->tiles_capacity) {
+        int *tiles = realloc(field->tiles, total_tiles * sizeof(int));
+        if (!tiles) {
+            field->total_tiles = -1;
+            return;
+        }
+        field->tiles = tiles;
+        field->tiles_capacity = total_tiles;
+    }
+    memcpy(field->tiles, data.queue.items, total_tiles * sizeof(int));
+    field->total_tiles = total_tiles;
+}
+
+static void calculate_field(distance_field *field)
+{
+    uint16_t *distance = field->distance.items;
+    int head = 0;
+    int tail = 0;
+    clear_field(field);
+    distance[field->grid_offset] = 1;
+    data.queue.items[tail++] = field->grid_offset;
+    while (head < tail) {
+        int offset = data.queue.items[head++];
+        if (distance[offset] == UINT16_MAX) {
+            continue;
+        }
+        uint16_t next_distance = distance[offset] + 1;
+        for (int direction = 0; direction < 8; direction++) {
+            int next_offset = offset + map_grid_direction_delta(direction);
+            if (map_grid_is_valid_offset(next_offset) && !distance[next_offset] && is_road_or_garden(next_offset)) {
+                distance[next_offset] = next_distance;
+                data.queue.items[tail++] = next_offset;
+            }
+        }
+    }
+    // The queue holds every tile that was given a distance
+    store_field_tiles(field, tail);
+}
+
+static distance_field *get_field(int network_id, int grid_offset)
+{
+    distance_field *oldest = 0;
+    for (int i = 0; i < MAX_CACHED_FIELDS; i++) {
+        distance_field *field = &data.fields[i];
+        if (field->in_use && field->network_id == network_id && field->grid_offset == grid_offset) {
+            field->last_used = ++data.lookups;
+            return field;
+        }
+        if (!oldest || (oldest->in_use && (!field->in_use || field->last_used < oldest->last_used))) {
+            oldest = field;
+        }
+    }
+    oldest->in_use = 1;
+    oldest->network_id = network_id;
+    oldest->grid_offset = grid_offset;
+    oldest->last_used = ++data.lookups;
+    calculate_field(oldest);
+    return oldest;
+}
+
+// Same preference as map_routing_get_path: the first direction with the lowest distance,
+// unless a later straight direction has the same distance as a diagonal one
+static int is_better_direction(int distance, int next_distance, int direction, int next_direction)
+{
+    if (next_distance < distance) {
+        return 1;
+    } else if (next_distance != distance) {
+        return 0;
+    } else if (direction == -1) {
+        return 1;
+    }
+    return direction % 2 == 1 && next_direction % 2 == 0;
+}
+
+int map_routing_cache_get_road_path(uint8_t *path, int max_length,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions)
+{
+    int dst_offset = map_grid_offset(dst_x, dst_y);
+    if (num_directions != 8 || !is_road_or_garden(dst_offset)) {
+        return 0;
+    }
+    // Road networks only join roads that share an edge, while the field also follows gardens and
+    // diagonal steps, so a source on another network may still be reached
+    const distance_field *field = get_field(map_road_network_get(dst_offset), dst_offset);
+    const uint16_t *distance = field->distance.items;
+    int grid_offset = map_grid_offset(src_x, src_y);
+    int current = distance[grid_offset];
+    if (current <= 1 || current - 1 > max_length) {
+        return 0;
+    }
+    int num_tiles = 0;
+    int last_direction = -1;
+    while (current > 1) {
+        int base_distance = current;
+        int best_direction = -1;
+        for (int direction = 0; direction < 8; direction++) {
+            if (direction == last_direction) {
+                continue;
+            }
+            int next_offset = grid_offset + map_grid_direction_delta(direction);
+            int next_distance = map_grid_is_valid_offset(next_offset) ? distance[next_offset] : 0;
+            if (next_distance && is_better_direction(current, next_distance, best_direction, direction)) {
+                current = next_distance;
+                best_direction = direction;
+            }
+        }
+        if (best_direction == -1 || current >= base_distance) {
+            return 0;
+        }
+        path[num_tiles++] = best_direction;
+        grid_offset += map_grid_direction_delta(best_direction);
+        last_direction = (best_direction + 4) % 8;
+    }
+    return num_tiles;
+}
+
+void map_routing_cache_invalidate(void)
+{
+    for (int i = 0; i < MAX_CACHED_FIELDS; i++) {
+        data.fields[i].in_use = 0;
+    }
+    data.lookups = 0;
+}
@@ -0,0 +1,37 @@
+#ifndef MAP_ROUTING_CACHE_H
+#define MAP_ROUTING_CACHE_H
+
+#include <stdint.h>
+
+/**
+ * @file
+ * Cached reverse distance fields over the road and garden network, keyed by road network and destination tile.
+ * Figures that are routed to the same destination over and over follow the cached field instead of running a search.
+ */
+
+/**
+ * Registers the grids of the distance fields
+ */
+void map_routing_cache_init_grids(void);
+
+/**
+ * Gets a road and garden path to a destination from its cached distance field,
+ * calculating the field if the destination is not cached yet
+ * @param path Path buffer to fill, must hold at least max_length directions
+ * @param max_length Maximum path length
+ * @param src_x Source X
+ * @param src_y Source Y
+ * @param dst_x Destination X, usually the road access tile of a building
+ * @param dst_y Destination Y
+ * @param num_directions 4 or 8, only routes that may use diagonals are cached
+ * @return Path length, or 0 when the field cannot provide a path and a regular route should be calculated
+ */
+int map_routing_cache_get_road_path(uint8_t *path, int max_length,
+    int src_x, int src_y, int dst_x, int dst_y, int num_directions);
+
+/**
+ * Discards all cached distance fields. Called whenever the citizen land routing grid changes.
+ */
+void map_routing_cache_invalidate(void);
+
+#endif // MAP_ROUTING_CACHE_H
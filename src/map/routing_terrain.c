@@ -9,6 +9,8 @@
 #include "map/image.h"
 #include "map/property.h"
 #include "map/random.h"
+#include "map/road_network.h"
+#include "map/routing_cache.h"
 #include "map/routing_data.h"
 #include "map/sprite.h"
 #include "map/terrain.h"
@@ -101,6 +103,8 @@ static int get_land_type_citizen_aqueduct(int grid_offset)
 
 void map_routing_update_land_citizen(void)
 {
+    map_routing_cache_invalidate();
+    map_road_network_terrain_changed();
     map_grid_init_i8(terrain_land_citizen.items, -1);
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
@@ -7,6 +7,11 @@
 
 static grid_u8 strength;
 
+void map_soldier_strength_init_grids(void)
+{
+    map_grid_register_u8(&strength);
+}
+
 void map_soldier_strength_clear(void)
 {
     map_grid_clear_u8(strength.items);
@@ -1,6 +1,8 @@
 #ifndef MAP_SOLDIER_STRENGTH_H
 #define MAP_SOLDIER_STRENGTH_H
 
+void map_soldier_strength_init_grids(void);
+
 void map_soldier_strength_clear(void);
 
 void map_soldier_strength_add(int x, int y, int radius, int amount);
@@ -5,6 +5,12 @@
 static grid_u8 sprite;
 static grid_u8 sprite_backup;
 
+void map_sprite_init_grids(void)
+{
+    map_grid_register_u8(&sprite);
+    map_grid_register_u8(&sprite_backup);
+}
+
 int map_sprite_animation_at(int grid_offset)
 {
     return sprite.items[grid_offset];
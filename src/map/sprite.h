@@ -11,6 +11,8 @@
  * 2) for buildings: which offset in the animation cycle is currently shown
  */
 
+void map_sprite_init_grids(void);
+
 int map_sprite_animation_at(int grid_offset);
 
 void map_sprite_animation_set(int grid_offset, int value);
@@ -5,6 +5,8 @@
 #include "core/image.h"
 #include "map/bridge.h"
 #include "map/building.h"
+#include "map/data.h"
+#include "map/desirability.h"
 #include "map/grid.h"
 #include "map/ring.h"
 #include "map/routing.h"
@@ -13,6 +15,12 @@
 static grid_u32 terrain_grid;
 static grid_u32 terrain_grid_backup;
 
+void map_terrain_init_grids(void)
+{
+    map_grid_register_u32(&terrain_grid);
+    map_grid_register_u32(&terrain_grid_backup);
+}
+
 int map_terrain_is(int grid_offset, int terrain)
 {
     return map_grid_is_valid_offset(grid_offset) && terrain_grid.items[grid_offset] & terrain;
@@ -40,19 +48,27 @@ int map_terrain_get_from_buffer_32(buffer *buf, int grid_offset)
     return buffer_read_u32(buf);
 }
 
-void map_terrain_set(int grid_offset, int terrain)
+static void set_terrain(int grid_offset, unsigned int terrain)
 {
+    if ((terrain_grid.items[grid_offset] ^ terrain) & MAP_DESIRABILITY_TERRAIN) {
+        map_desirability_tile_changed(grid_offset);
+    }
     terrain_grid.items[grid_offset] = terrain;
 }
 
+void map_terrain_set(int grid_offset, int terrain)
+{
+    set_terrain(grid_offset, terrain);
+}
+
 void map_terrain_add(int grid_offset, int terrain)
 {
-    terrain_grid.items[grid_offset] |= terrain;
+    set_terrain(grid_offset, terrain_grid.items[grid_offset] | terrain);
 }
 
 void map_terrain_remove(int grid_offset, int terrain)
 {
-    terrain_grid.items[grid_offset] &= ~terrain;
+    set_terrain(grid_offset, terrain_grid.items[grid_offset] & ~terrain);
 }
 
 void map_terrain_add_with_radius(int x, int y, int size, int radius, int terrain)
@@ -81,6 +97,13 @@ void map_terrain_remove_with_radius(int x, int y, int size, int radius, int terr
 
 void map_terrain_remove_all(int terrain)
 {
+    if (terrain & MAP_DESIRABILITY_TERRAIN) {
+        for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+            if (terrain_grid.items[i] & terrain & MAP_DESIRABILITY_TERRAIN) {
+                map_desirability_tile_changed(i);
+            }
+        }
+    }
     map_grid_and_u32(terrain_grid.items, ~terrain);
 }
 
@@ -402,6 +425,11 @@ void map_terrain_backup(void)
 
 void map_terrain_restore(void)
 {
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        if ((terrain_grid.items[i] ^ terrain_grid_backup.items[i]) & MAP_DESIRABILITY_TERRAIN) {
+            map_desirability_tile_changed(i);
+        }
+    }
     map_grid_copy_u32(terrain_grid_backup.items, terrain_grid.items);
 }
 
@@ -531,12 +559,9 @@ int map_bridge_find_start_and_direction_legacy(int grid_offset, int *axis, int *
 
 void map_terrain_migrate_old_bridges(void)
 {
-    for (int y = 0; y < GRID_SIZE; y++) {
-        for (int x = 0; x < GRID_SIZE; x++) {
-            int grid_offset = map_grid_offset(x, y);
-            if (!map_grid_is_valid_offset(grid_offset)) {
-                continue;
-            }
+    int grid_offset = map_data.start_offset;
+    for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
+        for (int x = 0; x < map_data.width; x++, grid_offset++) {
             if (legacy_map_is_bridge(grid_offset) && !map_is_bridge(grid_offset)) {
                 // Find true start of the old bridge
                 // Only process tiles that are part of a legacy bridge and haven't been upgraded yet 
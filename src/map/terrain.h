@@ -62,6 +62,8 @@ enum {
     TERRAIN_MAP_EDGE = TERRAIN_TREE | TERRAIN_WATER,
 };
 
+void map_terrain_init_grids(void);
+
 int map_terrain_is(int grid_offset, int terrain);
 
 int map_terrain_is_superset(int grid_offset, unsigned int terrain_sum);
@@ -17,6 +17,7 @@
 #include "map/grid.h"
 #include "map/image.h"
 #include "map/image_context.h"
+#include "map/point.h"
 #include "map/property.h"
 #include "map/random.h"
 #include "map/terrain.h"
@@ -36,7 +37,7 @@
 #define GARDEN_IMAGES_PER_VARIANT 4
 
 static int aqueduct_include_construction = 0;
-static int highway_top_tile_offsets[4] = { 0, -GRID_SIZE, -1, -GRID_SIZE - 1 };
+static const map_point HIGHWAY_TOP_TILE_OFFSETS[4] = { {0, 0}, {0, -1}, {-1, 0}, {-1, -1} };
 static int elevation_recalculate_trees = 0;
 
 static int is_clear(int x, int y, int size, int disallowed_terrain, int check_figure, int check_image)
@@ -891,7 +892,7 @@ int map_tiles_clear_highway(int grid_offset, int measure_only)
     int highway_terrain = TERRAIN_HIGHWAY_TOP_LEFT;
     for (int i = 0; i < 4; i++) {
         if (terrain & highway_terrain) {
-            int highway_top_tile = grid_offset + highway_top_tile_offsets[i];
+            int highway_top_tile = grid_offset + OFFSET(HIGHWAY_TOP_TILE_OFFSETS[i].x, HIGHWAY_TOP_TILE_OFFSETS[i].y);
             items_cleared += clear_highway_from_top(highway_top_tile, measure_only);
         }
         highway_terrain <<= 1;
@@ -1170,11 +1171,11 @@ static int get_access_ramp_image_offset(int x, int y)
     if (!map_grid_is_inside(x, y, 1)) {
         return -1;
     }
-    static const int offsets[4][6] = {
-        {OFFSET(0,1), OFFSET(1,1), OFFSET(0,0), OFFSET(1,0), OFFSET(0,2), OFFSET(1,2)},
-        {OFFSET(0,0), OFFSET(0,1), OFFSET(1,0), OFFSET(1,1), OFFSET(-1,0), OFFSET(-1,1)},
-        {OFFSET(0,0), OFFSET(1,0), OFFSET(0,1), OFFSET(1,1), OFFSET(0,-1), OFFSET(1,-1)},
-        {OFFSET(1,0), OFFSET(1,1), OFFSET(0,0), OFFSET(0,1), OFFSET(2,0), OFFSET(2,1)},
+    static const map_point offsets[4][6] = {
+        {{0, 1}, {1, 1}, {0, 0}, {1, 0}, {0, 2}, {1, 2}},
+        {{0, 0}, {0, 1}, {1, 0}, {1, 1}, {-1, 0}, {-1, 1}},
+        {{0, 0}, {1, 0}, {0, 1}, {1, 1}, {0, -1}, {1, -1}},
+        {{1, 0}, {1, 1}, {0, 0}, {0, 1}, {2, 0}, {2, 1}},
     };
     int base_offset = map_grid_offset(x, y);
     int image_offset = -1;
@@ -1182,7 +1183,7 @@ static int get_access_ramp_image_offset(int x, int y)
         int right_tiles = 0;
         int height = -1;
         for (int i = 0; i < 6; i++) {
-            int grid_offset = base_offset + offsets[dir][i];
+            int grid_offset = base_offset + OFFSET(offsets[dir][i].x, offsets[dir][i].y);
             if (i < 2) { // 2nd row
                 if (map_terrain_is(grid_offset, TERRAIN_ELEVATION)) {
                     right_tiles++;
@@ -13,6 +13,7 @@
 #include "map/building.h"
 #include "map/grid.h"
 #include "map/image.h"
+#include "map/point.h"
 #include "map/property.h"
 #include "map/terrain.h"
 #include "map/tiles.h"
@@ -28,8 +29,7 @@
 #define LATRINES_RADIUS 3
 #define FOUNTAIN_RADIUS 4
 
-static const int ADJACENT_OFFSETS[] = { -GRID_SIZE, 1, GRID_SIZE, -1 };
-static const int CONNECTOR_OFFSETS[] = { OFFSET(1,-1), OFFSET(3,1), OFFSET(1,3), OFFSET(-1,1) };
+static const map_point CONNECTOR_OFFSETS[] = { {1, -1}, {3, 1}, {1, 3}, {-1, 1} };
 
 static struct {
     int items[MAX_QUEUE];
@@ -157,7 +157,7 @@ static void fill_aqueducts_from_offset(int grid_offset)
         }
         next_offset = -1;
         for (int i = 0; i < 4; i++) {
-            int new_offset = grid_offset + ADJACENT_OFFSETS[i];
+            int new_offset = grid_offset + map_grid_direction_delta(2 * i);
             building *b = building_get(map_building_at(new_offset));
             if (b->id && b->type == BUILDING_RESERVOIR) {
                 if (!b->has_water_access && is_valid_reservoir_connection(new_offset)) {
@@ -216,7 +216,7 @@ void map_water_supply_update_reservoir_fountain(void)
                 b->has_water_access = 1;
                 changed = 1;
                 for (int d = 0; d < 4; d++) {
-                    fill_aqueducts_from_offset(b->grid_offset + CONNECTOR_OFFSETS[d]);
+                    fill_aqueducts_from_offset(b->grid_offset + OFFSET(CONNECTOR_OFFSETS[d].x, CONNECTOR_OFFSETS[d].y));
                 }
             }
         }
@@ -300,7 +300,7 @@ void map_water_supply_update_reservoir_fountain(void)
 int map_water_supply_has_aqueduct_access(int grid_offset)
 {
     for (int i = 0; i < 4; i++) {
-        int new_offset = grid_offset + CONNECTOR_OFFSETS[i];
+        int new_offset = grid_offset + OFFSET(CONNECTOR_OFFSETS[i].x, CONNECTOR_OFFSETS[i].y);
         if (!map_grid_is_valid_offset(new_offset)) {
             continue;
         }
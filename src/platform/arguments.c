@@ -8,6 +8,8 @@
 #define DISPLAY_SCALE_ERROR_MESSAGE "Option --display-scale must be followed by a scale value between 0.5 and 5"
 #define WINDOWED_AND_FULLSCREEN_ERROR_MESSAGE "Option --windowed and --fullscreen cannot both be specified"
 #define DISPLAY_ID_ERROR_MESSAGE "Option --display must be followed by a number indicating the display, starting from 0"
+#define EXPORT_JOBS_ERROR_MESSAGE "Option --export-jobs must be followed by a number of processes between 1 and 64"
+#define EXPORT_FILES_ERROR_MESSAGE "Option --export-screenshots must be followed by at least one saved game"
 #define UNKNOWN_OPTION_ERROR_MESSAGE "Option %s not recognized"
 
 static void print_log(const char *message)
@@ -74,6 +76,9 @@ int platform_parse_arguments(int argc, char **argv, augustus_args *output_args)
     output_args->use_software_cursor = 0;
     output_args->force_fullscreen = 0;
     output_args->display_id = 0;
+    output_args->export_jobs = 1;
+    output_args->num_export_files = 0;
+    output_args->export_files = 0;
 
     for (int i = 1; i < argc; i++) {
         // we ignore "-psn" arguments, this is needed to launch the app
@@ -128,6 +133,30 @@ int platform_parse_arguments(int argc, char **argv, augustus_args *output_args)
             output_args->use_software_cursor = 1;
         } else if (SDL_strcmp(argv[i], "--fullscreen") == 0) {
             output_args->force_fullscreen = 1;
+        } else if (SDL_strcmp(argv[i], "--export-jobs") == 0) {
+            if (i + 1 < argc) {
+                int jobs = SDL_strtol(argv[i + 1], 0, 10);
+                i++;
+                if (jobs < 1 || jobs > 64) {
+                    print_log(EXPORT_JOBS_ERROR_MESSAGE);
+                    ok = 0;
+                } else {
+                    output_args->export_jobs = jobs;
+                }
+            } else {
+                print_log(EXPORT_JOBS_ERROR_MESSAGE);
+                ok = 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--export-screenshots") == 0) {
+            // All remaining arguments are saved games
+            if (i + 1 < argc) {
+                output_args->export_files = &argv[i + 1];
+                output_args->num_export_files = argc - i - 1;
+            } else {
+                print_log(EXPORT_FILES_ERROR_MESSAGE);
+                ok = 0;
+            }
+            break;
         } else if (SDL_strcmp(argv[i], "--help") == 0) {
             add_blank_line = 0;
             ok = 0;
@@ -165,7 +194,14 @@ int platform_parse_arguments(int argc, char **argv, augustus_args *output_args)
         print_log("          Enables joystick support");
         print_log("--software-cursor");
         print_log("          Uses a software cursor instead of the default hardware cursor");
+        print_log("--export-jobs NUMBER");
+        print_log("          Splits --export-screenshots across NUMBER processes. Number can be between 1 and 64");
+        print_log("--export-screenshots FILE...");
+        print_log("          Saves the full city and minimap screenshots of each saved game (.sav or .svx)");
+        print_log("          without showing a window, then exits. Must be the last option");
+        print_log("          The screenshots are named after each file. Repeated file names get a number");
         print_log("The last argument, if present, is interpreted as data directory for the Caesar 3 installation");
+        print_log("When exporting screenshots, the data directory must come before --export-screenshots");
     }
     return ok;
 }
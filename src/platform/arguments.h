@@ -11,6 +11,9 @@ typedef struct {
     int use_software_cursor;
     int force_fullscreen;
     int display_id;
+    int export_jobs;
+    int num_export_files;
+    char **export_files;
 } augustus_args;
 
 int platform_parse_arguments(int argc, char **argv, augustus_args *output_args);
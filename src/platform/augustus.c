@@ -6,10 +6,12 @@
 #include "core/lang.h"
 #include "core/log.h"
 #include "core/time.h"
+#include "game/file.h"
 #include "game/game.h"
 #include "game/settings.h"
 #include "game/system.h"
 #include "graphics/screen.h"
+#include "graphics/screenshot.h"
 #include "graphics/window.h"
 #include "input/mouse.h"
 #include "input/touch.h"
@@ -30,6 +32,7 @@
 #include "platform/touch.h"
 #include "platform/vita/vita.h"
 #include "window/asset_previewer.h"
+#include "window/city.h"
 
 #include "tinyfiledialogs/tinyfiledialogs.h"
 
@@ -42,11 +45,20 @@
 #include <windows.h>
 #endif
 
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__) && !defined(__vita__) && !defined(__SWITCH__) && \
+    !defined(__ANDROID__) && !defined(__IPHONEOS__)
+#define USE_EXPORT_PROCESSES
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #if defined(USE_TINYFILEDIALOGS) || defined(__ANDROID__) || defined(__IPHONEOS__)
 #define SHOW_FOLDER_SELECT_DIALOG
 #endif
 
 #define INTPTR(d) (*(int*)(d))
+#define MAX_EXPORT_JOBS 64
 
 enum {
     USER_EVENT_QUIT,
@@ -63,8 +75,21 @@ static struct {
         int frame_count;
         int last_fps;
         Uint32 last_update_time;
+#ifdef DRAW_FPS
+        uint64_t frame_time_total;
+        uint64_t frame_time_max;
+        int last_average_frame_ms;
+        int last_max_frame_ms;
+#endif
     } fps;
     FILE *log_file;
+    struct {
+        int job;
+        int is_own_job[MAX_EXPORT_JOBS];
+#ifdef USE_EXPORT_PROCESSES
+        pid_t processes[MAX_EXPORT_JOBS];
+#endif
+    } export;
 } data = { 1 };
 
 static void write_to_output(FILE *output, const char *message)
@@ -183,19 +208,6 @@ void system_set_fullscreen(int fullscreen)
     post_event(fullscreen ? USER_EVENT_FULLSCREEN : USER_EVENT_WINDOWED);
 }
 
-uint64_t system_get_ticks(void)
-{
-#if SDL_VERSION_ATLEAST(2, 0, 18)
-    if (platform_sdl_version_at_least(2, 0, 18)) {
-        return SDL_GetTicks64();
-    } else {
-        return SDL_GetTicks();
-    }
-#else
-    return SDL_GetTicks();
-#endif
-}
-
 #ifdef _WIN32
 #define PLATFORM_ENABLE_PER_FRAME_CALLBACK
 static void platform_per_frame_callback(void)
@@ -208,21 +220,44 @@ static void run_and_draw(void)
 {
     time_millis time_before_run = system_get_ticks();
     time_set_millis(time_before_run);
+#ifdef DRAW_FPS
+    uint64_t frame_start = system_get_microseconds();
+#endif
 
     game_run();
     game_draw();
     Uint32 time_after_draw = system_get_ticks();
 
+#ifdef DRAW_FPS
+    uint64_t frame_time = system_get_microseconds() - frame_start;
+    data.fps.frame_time_total += frame_time;
+    if (frame_time > data.fps.frame_time_max) {
+        data.fps.frame_time_max = frame_time;
+    }
+#endif
+
     data.fps.frame_count++;
     if (time_after_draw - data.fps.last_update_time > 1000) {
+#ifdef DRAW_FPS
+        data.fps.last_average_frame_ms = (int) (data.fps.frame_time_total / data.fps.frame_count / 1000);
+        data.fps.last_max_frame_ms = (int) (data.fps.frame_time_max / 1000);
+        data.fps.frame_time_total = 0;
+        data.fps.frame_time_max = 0;
+#endif
         data.fps.last_fps = data.fps.frame_count;
         data.fps.last_update_time = time_after_draw;
         data.fps.frame_count = 0;
     }
 
+#ifdef DRAW_FPS
+    const platform_renderer_frame_stats *stats = platform_renderer_get_frame_stats();
+    game_display_render_stats(data.fps.last_fps, data.fps.last_average_frame_ms, data.fps.last_max_frame_ms,
+        stats->draw_calls, stats->sprites);
+#else
     if (config_get(CONFIG_UI_DISPLAY_FPS)) {
         game_display_fps(data.fps.last_fps);
     }
+#endif
 
     platform_renderer_render();
 }
@@ -620,7 +655,12 @@ static int pre_init(const char *custom_data_dir)
 static void setup(const augustus_args *args)
 {
     system_setup_crash_handler();
-    setup_logging();
+    if (data.export.job) {
+        // Export processes other than the first one print to the console and leave the log file alone
+        SDL_LogSetOutputFunction(write_log, NULL);
+    } else {
+        setup_logging();
+    }
 
     if (data.log_file) {
         SDL_Log("Augustus version %s, %s build", system_version(), system_architecture());
@@ -645,7 +685,7 @@ static void setup(const augustus_args *args)
 
     // If starting the log file failed (because, for example, the executable path isn't writable)
     // try again, placing the log file on the C3 path
-    if (!data.log_file) {
+    if (!data.log_file && !data.export.job) {
         setup_logging();
         // We always want this info
         SDL_Log("Augustus version %s, %s build", system_version(), system_architecture());
@@ -702,6 +742,134 @@ static void setup(const augustus_args *args)
     data.active = 1;
 }
 
+static void start_export_processes(int jobs)
+{
+    data.export.job = 0;
+    data.export.is_own_job[0] = 1;
+    for (int job = 1; job < jobs; job++) {
+        data.export.is_own_job[job] = 1;
+#ifdef USE_EXPORT_PROCESSES
+        // Each process is a copy of this one, started before SDL is, that exports its own share of the games
+        pid_t process = fork();
+        if (process == 0) {
+            memset(data.export.is_own_job, 0, sizeof(data.export.is_own_job));
+            data.export.job = job;
+            data.export.is_own_job[job] = 1;
+            return;
+        }
+        if (process > 0) {
+            data.export.processes[job] = process;
+            data.export.is_own_job[job] = 0;
+        }
+#endif
+    }
+}
+
+static int wait_for_export_processes(int jobs)
+{
+    int failed = 0;
+#ifdef USE_EXPORT_PROCESSES
+    for (int job = 1; job < jobs; job++) {
+        if (data.export.is_own_job[job]) {
+            continue;
+        }
+        int status;
+        if (waitpid(data.export.processes[job], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status)) {
+            failed = 1;
+        }
+    }
+#endif
+    return failed;
+}
+
+typedef char export_name[FILE_NAME_MAX];
+
+static int is_export_name_taken(const augustus_args *args, const export_name *names, int index, const char *name)
+{
+    for (int i = 0; i < args->num_export_files; i++) {
+        if (i < index && SDL_strcasecmp(names[i], name) == 0) {
+            return 1;
+        }
+        if (i != index && SDL_strcasecmp(file_remove_path(args->export_files[i]), name) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// The screenshots are named after the saved game file, extension included. A file name that is used more than once
+// gets the first free number after it. The names only depend on the file list, so all export processes agree on them.
+static export_name *get_export_names(const augustus_args *args)
+{
+    export_name *names = malloc(sizeof(export_name) * args->num_export_files);
+    if (!names) {
+        return 0;
+    }
+    for (int i = 0; i < args->num_export_files; i++) {
+        const char *file_name = file_remove_path(args->export_files[i]);
+        snprintf(names[i], FILE_NAME_MAX, "%s", file_name);
+        int is_first = 1;
+        for (int j = 0; j < i; j++) {
+            if (SDL_strcasecmp(file_remove_path(args->export_files[j]), file_name) == 0) {
+                is_first = 0;
+                break;
+            }
+        }
+        for (int number = 2; !is_first && is_export_name_taken(args, names, i, names[i]); number++) {
+            snprintf(names[i], FILE_NAME_MAX, "%s (%d)", file_name, number);
+        }
+    }
+    return names;
+}
+
+static int export_saved_game_screenshots(const char *filename, const char *name)
+{
+    if (game_file_load_saved_game(filename) != FILE_LOAD_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to load %s", filename);
+        return 0;
+    }
+    window_city_show();
+    window_draw(1);
+
+    if (!graphics_save_screenshot_with_name(SCREENSHOT_FULL_CITY, name) || !graphics_finish_pending_screenshot() ||
+        !graphics_save_screenshot_with_name(SCREENSHOT_MINIMAP, name)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to export screenshots of %s", filename);
+        return 0;
+    }
+    SDL_Log("Exported screenshots of %s", filename);
+    return 1;
+}
+
+static int export_screenshots(const augustus_args *args)
+{
+    // Nothing is shown, so use the dummy drivers and the renderer that works without a display
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+
+    // Names are computed before forking, so an allocation failure never leaves export processes to reap
+    export_name *names = get_export_names(args);
+    if (!names) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to allocate memory for the screenshot names");
+        return 1;
+    }
+    start_export_processes(args->export_jobs);
+    setup(args);
+
+    int failed = 0;
+    for (int i = 0; i < args->num_export_files; i++) {
+        if (data.export.is_own_job[i % args->export_jobs] &&
+            !export_saved_game_screenshots(args->export_files[i], names[i])) {
+            failed = 1;
+        }
+    }
+    free(names);
+    if (!data.export.job && wait_for_export_processes(args->export_jobs)) {
+        failed = 1;
+    }
+    return failed;
+}
+
 int main(int argc, char **argv)
 {
     augustus_args args;
@@ -712,6 +880,10 @@ int main(int argc, char **argv)
 #endif
     }
 
+    if (args.num_export_files) {
+        exit_with_status(export_screenshots(&args));
+    }
+
     setup(&args);
 
 
@@ -0,0 +1,937 @@
+#include "SDL.h"
+
+#include "assets/assets.h"
+#include "assets/group.h"
+#include "assets/image.h"
+#include "core/dir.h"
+#include "core/file.h"
+#include "core/image.h"
+#include "core/log.h"
+#include "core/smacker.h"
+#include "core/xml_parser.h"
+#include "figure/figure.h"
+#include "game/file.h"
+#include "game/file_io.h"
+#include "game/game.h"
+#include "game/system.h"
+#include "game/tick.h"
+#include "game/tick_stats.h"
+#include "graphics/renderer.h"
+#include "graphics/screen.h"
+#include "map/grid.h"
+#include "map/routing.h"
+#include "platform/file_manager.h"
+#include "platform/platform.h"
+#include "scenario/map.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_TICKS 5000
+#define MAX_ATLAS_SIZE 4096
+#define MAX_PACKED_IMAGE_SIZE 64000
+#define HEADLESS_SCREEN_WIDTH 1024
+#define HEADLESS_SCREEN_HEIGHT 768
+#define SMK_AUDIO_TRACKS 7
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+#define XML_BENCH_CHUNK_SIZE 1024
+#define XML_BENCH_ELEMENTS 5
+
+typedef struct {
+    const char *data_directory;
+    const char *saved_game;
+    const char *csv_file;
+    int ticks;
+    int route_runs;
+    int asset_runs;
+    int figure_runs;
+    int xml_runs;
+    int num_smk_files;
+    char **smk_files;
+} headless_args;
+
+static struct {
+    graphics_renderer_interface renderer_interface;
+    image_atlas_data atlas_data[ATLAS_MAX];
+    int has_atlas[ATLAS_MAX];
+} data;
+
+static struct {
+    uint32_t checksum;
+    int elements;
+} xml_bench;
+
+// Null renderer: image loading still needs atlas buffers to decode into, everything else is a no-op
+
+static void null_clear_screen(void)
+{}
+
+static void null_set_viewport(int x, int y, int width, int height)
+{}
+
+static void null_reset_viewport(void)
+{}
+
+static void null_draw_shape(int x_start, int x_end, int y_start, int y_end, color_t color)
+{}
+
+static void null_draw_image(const image *img, int x, int y, color_t color, float scale)
+{}
+
+static void null_draw_image_advanced(const image *img, float x, float y, color_t color,
+    float scale_x, float scale_y, double angle, int disable_coord_scaling)
+{}
+
+static void null_create_custom_image(custom_image_type type, int width, int height, int is_yuv)
+{}
+
+static int null_has_custom_image(custom_image_type type)
+{
+    return 0;
+}
+
+static color_t *null_get_custom_image_buffer(custom_image_type type, int *actual_texture_width)
+{
+    return 0;
+}
+
+static void null_custom_image_operation(custom_image_type type)
+{}
+
+static void null_update_custom_image_from(custom_image_type type, const color_t *buffer,
+    int x_offset, int y_offset, int width, int height)
+{}
+
+static void null_update_custom_image_yuv(custom_image_type type, const uint8_t *y_data, int y_width,
+    const uint8_t *cb_data, int cb_width, const uint8_t *cr_data, int cr_width)
+{}
+
+static void null_draw_custom_image(custom_image_type type, int x, int y, float scale, int disable_filtering)
+{}
+
+static int null_false(void)
+{
+    return 0;
+}
+
+static int null_start_tooltip_creation(int width, int height)
+{
+    return 0;
+}
+
+static void null_finish_tooltip_creation(void)
+{}
+
+static void null_set_tooltip_position(int x, int y)
+{}
+
+static void null_set_tooltip_opacity(int opacity)
+{}
+
+static int null_start_offscreen_render(int width, int height)
+{
+    return 0;
+}
+
+static void null_finish_offscreen_render(void)
+{}
+
+static int null_save_image_from_screen(int image_id, int x, int y, int width, int height)
+{
+    return 0;
+}
+
+static int null_draw_image_to_screen(int image_id, int x, int y)
+{
+    return 0;
+}
+
+static int null_save_screen_buffer(color_t *pixels, int x, int y, int width, int height, int row_width)
+{
+    return 0;
+}
+
+static void null_get_max_image_size(int *width, int *height)
+{
+    *width = MAX_ATLAS_SIZE;
+    *height = MAX_ATLAS_SIZE;
+}
+
+static void free_atlas(atlas_type type)
+{
+    image_atlas_data *atlas_data = &data.atlas_data[type];
+    if (atlas_data->buffers) {
+        for (int i = 0; i < atlas_data->num_images; i++) {
+            free(atlas_data->buffers[i]);
+        }
+        free(atlas_data->buffers);
+    }
+    free(atlas_data->image_widths);
+    free(atlas_data->image_heights);
+    memset(atlas_data, 0, sizeof(image_atlas_data));
+    atlas_data->type = type;
+    data.has_atlas[type] = 0;
+}
+
+static const image_atlas_data *prepare_atlas(atlas_type type, int num_images, int last_width, int last_height)
+{
+    free_atlas(type);
+    image_atlas_data *atlas_data = &data.atlas_data[type];
+    atlas_data->num_images = num_images;
+    atlas_data->image_widths = malloc(sizeof(int) * num_images);
+    atlas_data->image_heights = malloc(sizeof(int) * num_images);
+    atlas_data->buffers = calloc(num_images, sizeof(color_t *));
+    if (!atlas_data->image_widths || !atlas_data->image_heights || !atlas_data->buffers) {
+        free_atlas(type);
+        return 0;
+    }
+    for (int i = 0; i < num_images; i++) {
+        atlas_data->image_widths[i] = i == num_images - 1 ? last_width : MAX_ATLAS_SIZE;
+        atlas_data->image_heights[i] = i == num_images - 1 ? last_height : MAX_ATLAS_SIZE;
+        atlas_data->buffers[i] = calloc((size_t) atlas_data->image_widths[i] * atlas_data->image_heights[i],
+            sizeof(color_t));
+        if (!atlas_data->buffers[i]) {
+            free_atlas(type);
+            return 0;
+        }
+    }
+    return atlas_data;
+}
+
+static int create_atlas(const image_atlas_data *atlas_data, int delete_buffers)
+{
+    if (!atlas_data || atlas_data != &data.atlas_data[atlas_data->type] || !atlas_data->num_images) {
+        return 0;
+    }
+    atlas_type type = atlas_data->type;
+    if (delete_buffers) {
+        free_atlas(type);
+    }
+    data.has_atlas[type] = 1;
+    return 1;
+}
+
+static const image_atlas_data *get_atlas(atlas_type type)
+{
+    return data.has_atlas[type] ? &data.atlas_data[type] : 0;
+}
+
+static int has_atlas(atlas_type type)
+{
+    return data.has_atlas[type];
+}
+
+static void null_load_unpacked_image(const image *img, const color_t *pixels)
+{}
+
+static void null_free_unpacked_image(const image *img)
+{}
+
+static int null_should_pack_image(int width, int height)
+{
+    return width * height < MAX_PACKED_IMAGE_SIZE;
+}
+
+static void null_update_scale(int city_scale)
+{}
+
+static void init_null_renderer(void)
+{
+    graphics_renderer_interface *renderer = &data.renderer_interface;
+    for (atlas_type type = ATLAS_FIRST; type < ATLAS_MAX; type++) {
+        data.atlas_data[type].type = type;
+    }
+    renderer->clear_screen = null_clear_screen;
+    renderer->set_viewport = null_set_viewport;
+    renderer->reset_viewport = null_reset_viewport;
+    renderer->set_clip_rectangle = null_set_viewport;
+    renderer->reset_clip_rectangle = null_reset_viewport;
+    renderer->draw_line = null_draw_shape;
+    renderer->draw_rect = null_draw_shape;
+    renderer->fill_rect = null_draw_shape;
+    renderer->draw_image = null_draw_image;
+    renderer->draw_image_advanced = null_draw_image_advanced;
+    renderer->draw_silhouette = null_draw_image;
+    renderer->create_custom_image = null_create_custom_image;
+    renderer->has_custom_image = null_has_custom_image;
+    renderer->get_custom_image_buffer = null_get_custom_image_buffer;
+    renderer->release_custom_image_buffer = null_custom_image_operation;
+    renderer->update_custom_image = null_custom_image_operation;
+    renderer->update_custom_image_from = null_update_custom_image_from;
+    renderer->update_custom_image_yuv = null_update_custom_image_yuv;
+    renderer->draw_custom_image = null_draw_custom_image;
+    renderer->supports_yuv_image_format = null_false;
+    renderer->start_tooltip_creation = null_start_tooltip_creation;
+    renderer->finish_tooltip_creation = null_finish_tooltip_creation;
+    renderer->has_tooltip = null_false;
+    renderer->set_tooltip_position = null_set_tooltip_position;
+    renderer->set_tooltip_opacity = null_set_tooltip_opacity;
+    renderer->start_offscreen_render = null_start_offscreen_render;
+    renderer->finish_offscreen_render = null_finish_offscreen_render;
+    renderer->save_image_from_screen = null_save_image_from_screen;
+    renderer->draw_image_to_screen = null_draw_image_to_screen;
+    renderer->save_screen_buffer = null_save_screen_buffer;
+    renderer->get_max_image_size = null_get_max_image_size;
+    renderer->prepare_image_atlas = prepare_atlas;
+    renderer->create_image_atlas = create_atlas;
+    renderer->get_image_atlas = get_atlas;
+    renderer->has_image_atlas = has_atlas;
+    renderer->free_image_atlas = free_atlas;
+    renderer->load_unpacked_image = null_load_unpacked_image;
+    renderer->free_unpacked_image = null_free_unpacked_image;
+    renderer->should_pack_image = null_should_pack_image;
+    renderer->update_scale = null_update_scale;
+
+    graphics_renderer_set_interface(renderer);
+}
+
+// System functions normally provided by the windowed main loop
+
+int system_supports_select_folder_dialog(void)
+{
+    return 0;
+}
+
+const char *system_show_select_folder_dialog(const char *title, const char *default_path)
+{
+    return 0;
+}
+
+void system_exit(void)
+{}
+
+void system_resize(int width, int height)
+{}
+
+void system_center(void)
+{}
+
+void system_set_fullscreen(int fullscreen)
+{}
+
+static void print_usage(void)
+{
+    printf("Usage: augustus-headless [ARGS] SAVED_GAME\n\n");
+    printf("Loads SAVED_GAME (.sav or .svx) and runs the simulation without a window,\n");
+    printf("then reports ticks per second and the time spent in each tick phase.\n");
+    printf("Relative paths to SAVED_GAME are resolved against the data directory.\n");
+    printf("SAVED_GAME may be left out when only --xml-bench and --smk-bench are used.\n\n");
+    printf("Arguments:\n");
+    printf("--ticks N\n");
+    printf("          Number of ticks to run, defaults to %d\n", DEFAULT_TICKS);
+    printf("--route-bench N\n");
+    printf("          Before running the simulation, time N runs of long cross-map land and water routes\n");
+    printf("--asset-bench N\n");
+    printf("          Before running the simulation, time N lookups of every asset image by group and image name,\n");
+    printf("          both with a linear search and with the lookup tables, and the time to build the tables\n");
+    printf("--figure-bench N\n");
+    printf("          Before running the simulation, time N passes over the figures in use,\n");
+    printf("          both by checking every figure slot and by following the list of figures in use\n");
+    printf("--xml-bench N\n");
+    printf("          Time N passes of parsing every asset XML file, reading the same attributes as the asset loader\n");
+    printf("--smk-bench FILE...\n");
+    printf("          Decode every video and audio frame of each Smacker video FILE and report the decode time\n");
+    printf("          and checksums of the video, palette and audio data. Must be the last option\n");
+    printf("--csv FILE\n");
+    printf("          Also write the timing statistics to FILE as CSV\n");
+    printf("--data-dir DIR\n");
+    printf("          Location of the Caesar 3 files, defaults to the working directory\n");
+}
+
+static int parse_arguments(int argc, char **argv, headless_args *args)
+{
+    args->data_directory = 0;
+    args->saved_game = 0;
+    args->csv_file = 0;
+    args->ticks = DEFAULT_TICKS;
+    args->route_runs = 0;
+    args->asset_runs = 0;
+    args->figure_runs = 0;
+    args->xml_runs = 0;
+    args->num_smk_files = 0;
+    args->smk_files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            args->ticks = SDL_atoi(argv[++i]);
+            if (args->ticks <= 0) {
+                printf("Option --ticks must be followed by a positive number\n\n");
+                return 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--route-bench") == 0 && i + 1 < argc) {
+            args->route_runs = SDL_atoi(argv[++i]);
+            if (args->route_runs <= 0) {
+                printf("Option --route-bench must be followed by a positive number\n\n");
+                return 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--asset-bench") == 0 && i + 1 < argc) {
+            args->asset_runs = SDL_atoi(argv[++i]);
+            if (args->asset_runs <= 0) {
+                printf("Option --asset-bench must be followed by a positive number\n\n");
+                return 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--figure-bench") == 0 && i + 1 < argc) {
+            args->figure_runs = SDL_atoi(argv[++i]);
+            if (args->figure_runs <= 0) {
+                printf("Option --figure-bench must be followed by a positive number\n\n");
+                return 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--xml-bench") == 0 && i + 1 < argc) {
+            args->xml_runs = SDL_atoi(argv[++i]);
+            if (args->xml_runs <= 0) {
+                printf("Option --xml-bench must be followed by a positive number\n\n");
+                return 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--smk-bench") == 0) {
+            if (i + 1 >= argc) {
+                printf("Option --smk-bench must be followed by at least one video file\n\n");
+                return 0;
+            }
+            args->smk_files = &argv[i + 1];
+            args->num_smk_files = argc - i - 1;
+            break;
+        } else if (SDL_strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            args->csv_file = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--data-dir") == 0 && i + 1 < argc) {
+            args->data_directory = argv[++i];
+        } else if (SDL_strncmp(argv[i], "--", 2) == 0) {
+            if (SDL_strcmp(argv[i], "--help") != 0) {
+                printf("Option %s not recognized\n\n", argv[i]);
+            }
+            return 0;
+        } else {
+            args->saved_game = argv[i];
+        }
+    }
+    if (!args->saved_game && !args->num_smk_files && !args->xml_runs) {
+        printf("No saved game specified\n\n");
+        return 0;
+    }
+    return 1;
+}
+
+static void print_route_time(const char *name, int runs, uint64_t elapsed_us, int result)
+{
+    printf("%-58s %10d %12.2f %8s\n", name, runs, (double) elapsed_us / runs, result ? "yes" : "no");
+}
+
+static void run_route_benchmark(int runs)
+{
+    int width, height;
+    map_grid_size(&width, &height);
+    map_point entry = scenario_map_entry();
+    map_point exit_point = scenario_map_exit();
+    int result = 0;
+
+    printf("\n%-58s %10s %12s %8s\n", "Route", "Runs", "Avg (us)", "Found");
+
+    uint64_t start = system_get_microseconds();
+    for (int i = 0; i < runs; i++) {
+        result = map_routing_citizen_can_travel_over_land(entry.x, entry.y, exit_point.x, exit_point.y, 8);
+    }
+    print_route_time("Citizen over land, entry to exit", runs, system_get_microseconds() - start, result);
+
+    start = system_get_microseconds();
+    for (int i = 0; i < runs; i++) {
+        result = map_routing_noncitizen_can_travel_over_land(entry.x, entry.y, exit_point.x, exit_point.y, 8, -1, 0);
+    }
+    print_route_time("Non-citizen over land, entry to exit", runs, system_get_microseconds() - start, result);
+
+    start = system_get_microseconds();
+    for (int i = 0; i < runs; i++) {
+        result = map_routing_noncitizen_can_travel_through_everything(0, 0, width - 1, height - 1, 8);
+    }
+    print_route_time("Non-citizen through everything, corner to corner", runs,
+        system_get_microseconds() - start, result);
+
+    if (scenario_map_has_river_entry() && scenario_map_has_river_exit()) {
+        map_point river_entry = scenario_map_river_entry();
+        map_point river_exit = scenario_map_river_exit();
+        start = system_get_microseconds();
+        for (int i = 0; i < runs; i++) {
+            map_routing_calculate_distances_water_boat(river_entry.x, river_entry.y);
+        }
+        result = map_routing_distance(map_grid_offset(river_exit.x, river_exit.y)) > 0;
+        print_route_time("Boat, river entry to exit", runs, system_get_microseconds() - start, result);
+    }
+}
+
+static int count_asset_lookups(void)
+{
+    int lookups = 0;
+    for (int i = 0; i < group_get_total(); i++) {
+        const image_groups *group = group_get_from_id(i);
+        if (!group->name || SDL_strcmp(group->name, ASSET_EXTERNAL_FILE_LIST) == 0) {
+            continue;
+        }
+        const asset_image *img = asset_image_get_from_id(group->first_image_index);
+        while (img && img->index <= group->last_image_index) {
+            if (img->id) {
+                lookups++;
+            }
+            img = asset_image_get_from_id(img->index + 1);
+        }
+    }
+    return lookups;
+}
+
+static uint64_t time_asset_lookups(int runs, int *results)
+{
+    uint64_t start = system_get_microseconds();
+    for (int run = 0; run < runs; run++) {
+        int lookup = 0;
+        for (int i = 0; i < group_get_total(); i++) {
+            const image_groups *group = group_get_from_id(i);
+            if (!group->name || SDL_strcmp(group->name, ASSET_EXTERNAL_FILE_LIST) == 0) {
+                continue;
+            }
+            const asset_image *img = asset_image_get_from_id(group->first_image_index);
+            while (img && img->index <= group->last_image_index) {
+                if (img->id) {
+                    results[lookup++] = assets_get_image_id(group->name, img->id);
+                }
+                img = asset_image_get_from_id(img->index + 1);
+            }
+        }
+    }
+    return system_get_microseconds() - start;
+}
+
+static void run_asset_benchmark(int runs)
+{
+    int lookups = count_asset_lookups();
+    int *linear_results = malloc(sizeof(int) * (lookups ? lookups : 1));
+    int *hashed_results = malloc(sizeof(int) * (lookups ? lookups : 1));
+    if (!linear_results || !hashed_results) {
+        free(linear_results);
+        free(hashed_results);
+        printf("\nNot enough memory for the asset benchmark\n");
+        return;
+    }
+
+    // Both searches look up the same names: first without the hash tables, then with them
+    group_free_lookup();
+    uint64_t linear_us = time_asset_lookups(runs, linear_results);
+
+    uint64_t start = system_get_microseconds();
+    group_build_lookup();
+    uint64_t build_us = system_get_microseconds() - start;
+
+    uint64_t hashed_us = time_asset_lookups(runs, hashed_results);
+
+    int not_found = 0;
+    int differ = 0;
+    int lookup = 0;
+    for (int i = 0; i < group_get_total(); i++) {
+        const image_groups *group = group_get_from_id(i);
+        if (!group->name || SDL_strcmp(group->name, ASSET_EXTERNAL_FILE_LIST) == 0) {
+            continue;
+        }
+        const asset_image *img = asset_image_get_from_id(group->first_image_index);
+        while (img && img->index <= group->last_image_index) {
+            if (img->id) {
+                if (hashed_results[lookup] != img->index + IMAGE_MAIN_ENTRIES) {
+                    not_found++;
+                }
+                if (hashed_results[lookup] != linear_results[lookup]) {
+                    differ++;
+                }
+                lookup++;
+            }
+            img = asset_image_get_from_id(img->index + 1);
+        }
+    }
+    free(linear_results);
+    free(hashed_results);
+
+    int total = lookups * runs;
+    printf("\nAsset lookup tables built in %.3f ms for %d groups\n", build_us / 1000.0, group_get_total());
+    printf("%d asset image lookups, %d resolved to another image\n", total, not_found);
+    printf("Linear search: %.3f ms, %.3f us per lookup\n", linear_us / 1000.0,
+        total ? (double) linear_us / total : 0.0);
+    printf("Hash tables:   %.3f ms, %.3f us per lookup, %.1fx faster%s\n", hashed_us / 1000.0,
+        total ? (double) hashed_us / total : 0.0, hashed_us ? (double) linear_us / hashed_us : 0.0,
+        differ ? ", results differ" : "");
+}
+
+static void run_figure_benchmark(int runs)
+{
+    int in_use = 0;
+    unsigned int checksum = 0;
+    uint64_t start = system_get_microseconds();
+    for (int run = 0; run < runs; run++) {
+        for (int i = 1; i < figure_count(); i++) {
+            const figure *f = figure_get(i);
+            if (f->state) {
+                checksum += f->type + f->grid_offset + f->progress_on_tile;
+            }
+        }
+    }
+    uint64_t scan_us = system_get_microseconds() - start;
+
+    start = system_get_microseconds();
+    for (int run = 0; run < runs; run++) {
+        in_use = 0;
+        for (int i = figure_next_in_use(0); i; i = figure_next_in_use(i)) {
+            const figure *f = figure_get(i);
+            checksum -= f->type + f->grid_offset + f->progress_on_tile;
+            in_use++;
+        }
+    }
+    uint64_t list_us = system_get_microseconds() - start;
+
+    printf("\n%d figures in use out of %d slots\n", in_use, figure_count() - 1);
+    printf("Checking every slot: %.3f us per pass\n", (double) scan_us / runs);
+    printf("Figures in use list: %.3f us per pass%s\n", (double) list_us / runs,
+        checksum ? ", results differ" : "");
+}
+
+static uint32_t checksum_bytes(uint32_t checksum, const uint8_t *bytes, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        checksum = (checksum ^ bytes[i]) * FNV_PRIME;
+    }
+    return checksum;
+}
+
+static uint32_t checksum_palette(uint32_t checksum, const color_t *palette)
+{
+    for (int i = 0; i < 256; i++) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            checksum = (checksum ^ ((palette[i] >> shift) & 0xff)) * FNV_PRIME;
+        }
+    }
+    return checksum;
+}
+
+static int run_smk_benchmark_file(const char *filename)
+{
+    smacker s = smacker_open(file_open(filename, "rb"));
+    if (!s) {
+        printf("%-40s unable to open\n", filename);
+        return 0;
+    }
+    int frame_count, usf, width, height, y_scale_mode;
+    smacker_get_frames_info(s, &frame_count, &usf);
+    smacker_get_video_info(s, &width, &height, &y_scale_mode);
+    int audio_enabled[SMK_AUDIO_TRACKS];
+    for (int track = 0; track < SMK_AUDIO_TRACKS; track++) {
+        int channels, bitdepth, rate;
+        smacker_get_audio_info(s, track, &audio_enabled[track], &channels, &bitdepth, &rate);
+    }
+
+    uint32_t video_checksum = FNV_OFFSET_BASIS;
+    uint32_t palette_checksum = FNV_OFFSET_BASIS;
+    uint32_t audio_checksum = FNV_OFFSET_BASIS;
+    size_t audio_bytes = 0;
+    int decoded = 0;
+    uint64_t decode_us = 0;
+
+    uint64_t start = system_get_microseconds();
+    smacker_frame_status status = smacker_first_frame(s);
+    decode_us += system_get_microseconds() - start;
+    while (status == SMACKER_FRAME_OK) {
+        decoded++;
+        video_checksum = checksum_bytes(video_checksum, smacker_get_frame_video(s), (size_t) width * height);
+        palette_checksum = checksum_palette(palette_checksum, smacker_get_frame_palette(s));
+        for (int track = 0; track < SMK_AUDIO_TRACKS; track++) {
+            if (audio_enabled[track]) {
+                int size = smacker_get_frame_audio_size(s, track);
+                audio_checksum = checksum_bytes(audio_checksum, smacker_get_frame_audio(s, track), size);
+                audio_bytes += size;
+            }
+        }
+        start = system_get_microseconds();
+        status = smacker_next_frame(s);
+        decode_us += system_get_microseconds() - start;
+    }
+    smacker_close(s);
+
+    int ok = status == SMACKER_FRAME_DONE && decoded == frame_count;
+    printf("%-40s %4dx%-4d %7d %12.3f %10.2f %10zu %08x %08x %08x%s\n", filename, width, height, decoded,
+        decode_us / 1000.0, decoded ? (double) decode_us / decoded : 0.0, audio_bytes,
+        video_checksum, palette_checksum, audio_checksum, ok ? "" : " decode error");
+    return ok;
+}
+
+static int run_smk_benchmark(char **files, int num_files)
+{
+    printf("\n%-40s %9s %7s %12s %10s %10s %8s %8s %8s\n", "Video", "Size", "Frames", "Decode (ms)",
+        "Avg (us)", "Audio (B)", "Video", "Palette", "Audio");
+    int ok = 1;
+    for (int i = 0; i < num_files; i++) {
+        if (!run_smk_benchmark_file(files[i])) {
+            ok = 0;
+        }
+    }
+    return ok;
+}
+
+static void checksum_xml_string(const char *key)
+{
+    const char *value = xml_parser_get_attribute_string(key);
+    if (value) {
+        xml_bench.checksum = checksum_bytes(xml_bench.checksum, (const uint8_t *) value, strlen(value));
+    }
+}
+
+static void checksum_xml_value(int value)
+{
+    xml_bench.checksum = (xml_bench.checksum ^ (uint32_t) value) * FNV_PRIME;
+}
+
+static void checksum_xml_layer(void)
+{
+    static const char *invert_values[3] = { "horizontal", "vertical", "both" };
+    static const char *rotate_values[3] = { "90", "180", "270" };
+    checksum_xml_string("src");
+    checksum_xml_string("group");
+    checksum_xml_string("image");
+    checksum_xml_value(xml_parser_get_attribute_int("src_x"));
+    checksum_xml_value(xml_parser_get_attribute_int("src_y"));
+    checksum_xml_value(xml_parser_get_attribute_int("x"));
+    checksum_xml_value(xml_parser_get_attribute_int("y"));
+    checksum_xml_value(xml_parser_get_attribute_int("width"));
+    checksum_xml_value(xml_parser_get_attribute_int("height"));
+    checksum_xml_value(xml_parser_get_attribute_enum("invert", invert_values, 3, 1));
+    checksum_xml_value(xml_parser_get_attribute_enum("rotate", rotate_values, 3, 1));
+}
+
+// The element callbacks read the same attributes as assets/xml.c, without creating any images
+
+static int xml_bench_assetlist(void)
+{
+    xml_bench.elements++;
+    checksum_xml_string("name");
+    return 1;
+}
+
+static int xml_bench_image(void)
+{
+    xml_bench.elements++;
+    checksum_xml_string("id");
+    checksum_xml_string("src");
+    checksum_xml_value(xml_parser_get_attribute_int("width"));
+    checksum_xml_value(xml_parser_get_attribute_int("height"));
+    checksum_xml_string("group");
+    checksum_xml_string("image");
+    checksum_xml_value(xml_parser_get_attribute_bool("isometric"));
+    return 1;
+}
+
+static int xml_bench_layer(void)
+{
+    static const char *part_values[2] = { "footprint", "top" };
+    static const char *mask_values[2] = { "grayscale", "alpha" };
+    xml_bench.elements++;
+    checksum_xml_layer();
+    checksum_xml_value(xml_parser_get_attribute_enum("part", part_values, 2, 1));
+    checksum_xml_value(xml_parser_get_attribute_enum("mask", mask_values, 2, 1));
+    return 1;
+}
+
+static int xml_bench_animation(void)
+{
+    xml_bench.elements++;
+    checksum_xml_value(xml_parser_get_attribute_int("frames"));
+    checksum_xml_value(xml_parser_get_attribute_int("speed"));
+    checksum_xml_value(xml_parser_get_attribute_bool("reversible"));
+    checksum_xml_value(xml_parser_get_attribute_int("x"));
+    checksum_xml_value(xml_parser_get_attribute_int("y"));
+    return 1;
+}
+
+static int xml_bench_frame(void)
+{
+    xml_bench.elements++;
+    checksum_xml_layer();
+    return 1;
+}
+
+static char *read_xml_file(const char *filename, long *size)
+{
+    char full_path[FILE_NAME_MAX];
+    snprintf(full_path, FILE_NAME_MAX, "%s/%s", ASSETS_IMAGE_PATH, filename);
+    FILE *fp = file_open_asset(full_path, "rb");
+    if (!fp) {
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    *size = ftell(fp);
+    rewind(fp);
+    char *contents = *size > 0 ? malloc(*size) : 0;
+    if (contents && fread(contents, 1, *size, fp) != (size_t) *size) {
+        free(contents);
+        contents = 0;
+    }
+    file_close(fp);
+    return contents;
+}
+
+static int run_xml_benchmark(int runs)
+{
+    static const xml_parser_element elements[XML_BENCH_ELEMENTS] = {
+        { "assetlist", xml_bench_assetlist },
+        { "image", xml_bench_image, 0, "assetlist" },
+        { "layer", xml_bench_layer, 0, "image" },
+        { "animation", xml_bench_animation, 0, "image" },
+        { "frame", xml_bench_frame, 0, "animation" }
+    };
+    const dir_listing *xml_files = dir_find_files_with_extension(ASSETS_DIRECTORY "/" ASSETS_IMAGE_PATH, "xml");
+    int num_files = xml_files->num_files;
+    char **contents = calloc(num_files ? num_files : 1, sizeof(char *));
+    long *sizes = calloc(num_files ? num_files : 1, sizeof(long));
+    if (!contents || !sizes) {
+        free(contents);
+        free(sizes);
+        printf("\nNot enough memory for the XML benchmark\n");
+        return 0;
+    }
+    // The files are read up front so only the parsing is timed
+    long total_bytes = 0;
+    int ok = 1;
+    for (int i = 0; i < num_files; i++) {
+        contents[i] = read_xml_file(xml_files->files[i].name, &sizes[i]);
+        if (!contents[i]) {
+            printf("\nUnable to read %s\n", xml_files->files[i].name);
+            ok = 0;
+        }
+        total_bytes += sizes[i];
+    }
+    if (ok && !xml_parser_init(elements, XML_BENCH_ELEMENTS, 0)) {
+        ok = 0;
+    }
+    xml_bench.checksum = FNV_OFFSET_BASIS;
+    xml_bench.elements = 0;
+    uint64_t start = system_get_microseconds();
+    for (int run = 0; ok && run < runs; run++) {
+        for (int i = 0; ok && i < num_files; i++) {
+            // Parsed in the same chunk size as the asset loader reads the files
+            xml_parser_reset();
+            for (long offset = 0; ok && offset < sizes[i]; offset += XML_BENCH_CHUNK_SIZE) {
+                long chunk = sizes[i] - offset < XML_BENCH_CHUNK_SIZE ? sizes[i] - offset : XML_BENCH_CHUNK_SIZE;
+                ok = xml_parser_parse(&contents[i][offset], (unsigned int) chunk, offset + chunk >= sizes[i]);
+            }
+        }
+    }
+    uint64_t elapsed_us = system_get_microseconds() - start;
+    xml_parser_free();
+    for (int i = 0; i < num_files; i++) {
+        free(contents[i]);
+    }
+    free(contents);
+    free(sizes);
+
+    if (!ok) {
+        printf("\nUnable to parse the asset XML files\n");
+        return 0;
+    }
+    printf("\nParsed %d asset XML files (%ld bytes, %d elements) %d times in %.3f ms: %.3f ms per pass\n",
+        num_files, total_bytes, xml_bench.elements / runs, runs, elapsed_us / 1000.0,
+        elapsed_us / 1000.0 / runs);
+    printf("Attribute checksum: %08x\n", xml_bench.checksum);
+    return 1;
+}
+
+static void print_entry(const char *label, const char *name, const tick_stats_entry *entry, uint64_t total_us)
+{
+    if (!entry->calls) {
+        return;
+    }
+    double percentage = total_us ? 100.0 * entry->total_us / total_us : 0.0;
+    printf("%-12s %-50s %10u %14.3f %12.2f %10u %7.2f%%\n", label, name ? name : "", entry->calls,
+        entry->total_us / 1000.0, (double) entry->total_us / entry->calls, (unsigned int) entry->max_us, percentage);
+}
+
+static void print_report(int ticks, uint64_t elapsed_us)
+{
+    const tick_stats_entry *tick = tick_stats_get_tick();
+    double seconds = elapsed_us / 1000000.0;
+    printf("\nRan %d ticks in %.3f s: %.1f ticks per second\n\n", ticks, seconds,
+        seconds > 0 ? ticks / seconds : 0.0);
+    printf("%-12s %-50s %10s %14s %12s %10s %8s\n",
+        "Phase", "Function", "Calls", "Total (ms)", "Avg (us)", "Max (us)", "Share");
+    char label[16];
+    for (int slot = 0; slot < TICK_STATS_SLOTS; slot++) {
+        snprintf(label, sizeof(label), "slot %d", slot);
+        print_entry(label, game_tick_slot_name(slot), tick_stats_get_slot(slot), tick->total_us);
+    }
+    for (tick_stats_handler handler = 0; handler < TICK_STATS_HANDLER_MAX; handler++) {
+        print_entry("handler", tick_stats_handler_name(handler), tick_stats_get_handler(handler), tick->total_us);
+    }
+    print_entry("figures", "figure_action_handle", tick_stats_get_figures(), tick->total_us);
+    for (figure_type type = FIGURE_NONE; type < FIGURE_TYPE_MAX; type++) {
+        snprintf(label, sizeof(label), "figure %d", type);
+        print_entry(label, 0, tick_stats_get_figure_type(type), tick->total_us);
+    }
+    print_entry("tick", "game_tick_run", tick, tick->total_us);
+}
+
+int main(int argc, char **argv)
+{
+    headless_args args;
+    if (!parse_arguments(argc, argv, &args)) {
+        print_usage();
+        return 1;
+    }
+    if (SDL_Init(0) != 0) {
+        SDL_Log("Could not initialize SDL: %s", SDL_GetError());
+        return 1;
+    }
+    if (args.data_directory && !platform_file_manager_set_base_path(args.data_directory)) {
+        SDL_Log("%s: directory not found", args.data_directory);
+        exit_with_status(1);
+    }
+    if (args.xml_runs && !run_xml_benchmark(args.xml_runs)) {
+        exit_with_status(5);
+    }
+    if (args.num_smk_files && !run_smk_benchmark(args.smk_files, args.num_smk_files)) {
+        exit_with_status(5);
+    }
+    if (!args.saved_game) {
+        log_repeated_messages();
+        SDL_Quit();
+        return 0;
+    }
+    init_null_renderer();
+    screen_set_resolution(HEADLESS_SCREEN_WIDTH, HEADLESS_SCREEN_HEIGHT);
+
+    if (!game_pre_init() || !game_init_headless()) {
+        SDL_Log("Exiting: game init failed");
+        exit_with_status(2);
+    }
+    if (game_file_load_saved_game(args.saved_game) != FILE_LOAD_SUCCESS) {
+        SDL_Log("Exiting: unable to load %s", args.saved_game);
+        exit_with_status(3);
+    }
+
+    if (args.asset_runs) {
+        run_asset_benchmark(args.asset_runs);
+    }
+    if (args.route_runs) {
+        run_route_benchmark(args.route_runs);
+    }
+    if (args.figure_runs) {
+        run_figure_benchmark(args.figure_runs);
+    }
+
+    tick_stats_reset();
+    tick_stats_set_enabled(1);
+    uint64_t start = system_get_microseconds();
+    for (int i = 0; i < args.ticks; i++) {
+        game_tick_run();
+    }
+    uint64_t elapsed = system_get_microseconds() - start;
+    tick_stats_set_enabled(0);
+
+    print_report(args.ticks, elapsed);
+    if (args.csv_file && !tick_stats_write_csv(args.csv_file)) {
+        exit_with_status(4);
+    }
+    game_file_io_finish_pending_save();
+    log_repeated_messages();
+    SDL_Quit();
+    return 0;
+}
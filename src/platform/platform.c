@@ -136,6 +136,29 @@ int platform_sdl_version_at_least(int major, int minor, int patch)
     return SDL_VERSIONNUM(version.major, version.minor, version.patch) >= SDL_VERSIONNUM(major, minor, patch);
 }
 
+uint64_t system_get_ticks(void)
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (platform_sdl_version_at_least(2, 0, 18)) {
+        return SDL_GetTicks64();
+    } else {
+        return SDL_GetTicks();
+    }
+#else
+    return SDL_GetTicks();
+#endif
+}
+
+uint64_t system_get_microseconds(void)
+{
+    static uint64_t frequency;
+    if (!frequency) {
+        frequency = SDL_GetPerformanceFrequency();
+    }
+    uint64_t counter = SDL_GetPerformanceCounter();
+    return (counter / frequency) * 1000000 + (counter % frequency) * 1000000 / frequency;
+}
+
 char *platform_get_logging_path(void)
 {
     if (!SDL_strcasecmp(system_OS(), "Android")) {
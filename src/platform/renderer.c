@@ -35,8 +35,21 @@
 #define HAS_TEXTURE_SCALE_MODE 0
 #endif
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define USE_RENDER_GEOMETRY
+#define HAS_RENDER_GEOMETRY (platform_sdl_version_at_least(2, 0, 18))
+#endif
+
+#ifdef DRAW_FPS
+#define RECORD_DRAW_CALL() data.stats.current.draw_calls++
+#else
+#define RECORD_DRAW_CALL()
+#endif
+
 #define MAX_UNPACKED_IMAGES 20
 
+#define MAX_BATCHED_SPRITES 2048
+
 #define MAX_PACKED_IMAGE_SIZE 64000
 
 #if (defined(__ANDROID__) || defined(__EMSCRIPTEN__)) && !SDL_VERSION_ATLEAST(2, 24, 0)
@@ -91,6 +104,7 @@ static struct {
         int height;
         int opacity;
     } tooltip;
+    SDL_Texture *offscreen_texture;
     SDL_Texture **texture_lists[ATLAS_MAX];
     image_atlas_data atlas_data[ATLAS_MAX];
     struct {
@@ -118,13 +132,82 @@ static struct {
     float city_scale;
     int should_correct_texture_offset;
     int disable_linear_filter;
+#ifdef USE_RENDER_GEOMETRY
+    struct {
+        int enabled;
+        SDL_Texture *texture;
+        SDL_ScaleMode scale_mode;
+        float texture_width;
+        float texture_height;
+        int sprites;
+        SDL_Vertex vertices[MAX_BATCHED_SPRITES * 4];
+        int indices[MAX_BATCHED_SPRITES * 6];
+    } batch;
+#endif
+#ifdef DRAW_FPS
+    struct {
+        platform_renderer_frame_stats current;
+        platform_renderer_frame_stats last_frame;
+    } stats;
+#endif
 } data;
 
+static void flush_sprite_batch(void)
+{
+#ifdef USE_RENDER_GEOMETRY
+    if (!data.batch.sprites) {
+        return;
+    }
+    // The color of each sprite is stored in its vertices, so the texture itself should not tint anything
+    SDL_SetTextureColorMod(data.batch.texture, 0xff, 0xff, 0xff);
+    SDL_SetTextureAlphaMod(data.batch.texture, 0xff);
+    SDL_ScaleMode current_scale_mode;
+    SDL_GetTextureScaleMode(data.batch.texture, &current_scale_mode);
+    if (current_scale_mode != data.batch.scale_mode) {
+        SDL_SetTextureScaleMode(data.batch.texture, data.batch.scale_mode);
+    }
+    SDL_RenderGeometry(data.renderer, data.batch.texture, data.batch.vertices, data.batch.sprites * 4,
+        data.batch.indices, data.batch.sprites * 6);
+    RECORD_DRAW_CALL();
+    data.batch.sprites = 0;
+#endif
+}
+
+static void reset_sprite_batch(void)
+{
+    flush_sprite_batch();
+#ifdef USE_RENDER_GEOMETRY
+    // Textures are about to be destroyed, and a new texture could end up with the same address
+    data.batch.texture = 0;
+#endif
+}
+
+static void init_sprite_batch(void)
+{
+#ifdef USE_RENDER_GEOMETRY
+    data.batch.texture = 0;
+    data.batch.sprites = 0;
+    // The software renderer draws geometry one triangle at a time, which is slower than copying rectangles
+    data.batch.enabled = HAS_RENDER_GEOMETRY && !data.is_software_renderer;
+    for (int i = 0; i < MAX_BATCHED_SPRITES; i++) {
+        int *indices = &data.batch.indices[i * 6];
+        int first_vertex = i * 4;
+        indices[0] = first_vertex;
+        indices[1] = first_vertex + 1;
+        indices[2] = first_vertex + 2;
+        indices[3] = first_vertex + 2;
+        indices[4] = first_vertex + 3;
+        indices[5] = first_vertex;
+    }
+#endif
+}
+
 static int save_screen_buffer(color_t *pixels, int x, int y, int width, int height, int row_width)
 {
     if (data.paused) {
         return 0;
     }
+    flush_sprite_batch();
     SDL_Rect rect = { x, y, width, height };
     return SDL_RenderReadPixels(data.renderer, &rect, SDL_PIXELFORMAT_ARGB8888, pixels,
         row_width * sizeof(color_t)) == 0;
@@ -135,11 +218,13 @@ static void draw_line(int x_start, int x_end, int y_start, int y_end, color_t co
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetRenderDrawColor(data.renderer,
         (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
         (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
         (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE,
         (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA);
+    RECORD_DRAW_CALL();
     SDL_RenderDrawLine(data.renderer, x_start, y_start, x_end, y_end);
 }
 
@@ -148,12 +233,14 @@ static void draw_rect(int x_start, int x_end, int y_start, int y_end, color_t co
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetRenderDrawColor(data.renderer,
         (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
         (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
         (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE,
         (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA);
     SDL_Rect rect = { x_start, y_start, x_end, y_end };
+    RECORD_DRAW_CALL();
     SDL_RenderDrawRect(data.renderer, &rect);
 }
 
@@ -162,12 +249,14 @@ static void fill_rect(int x_start, int x_end, int y_start, int y_end, color_t co
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetRenderDrawColor(data.renderer,
         (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
         (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
         (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE,
         (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA);
     SDL_Rect rect = { x_start, y_start, x_end, y_end };
+    RECORD_DRAW_CALL();
     SDL_RenderFillRect(data.renderer, &rect);
 }
 
@@ -176,6 +265,7 @@ static void set_clip_rectangle(int x, int y, int width, int height)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_Rect clip = { x, y, width, height };
     SDL_RenderSetClipRect(data.renderer, &clip);
 }
@@ -185,6 +275,7 @@ static void reset_clip_rectangle(void)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_RenderSetClipRect(data.renderer, NULL);
 }
 
@@ -193,6 +284,7 @@ static void set_viewport(int x, int y, int width, int height)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_Rect viewport = { x, y, width, height };
     SDL_RenderSetViewport(data.renderer, &viewport);
 }
@@ -202,6 +294,7 @@ static void reset_viewport(void)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_RenderSetViewport(data.renderer, NULL);
     SDL_RenderSetClipRect(data.renderer, NULL);
 }
@@ -211,6 +304,7 @@ static void clear_screen(void)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetRenderDrawColor(data.renderer, 0, 0, 0, 255);
     SDL_RenderClear(data.renderer);
 }
@@ -223,6 +317,7 @@ static void get_max_image_size(int *width, int *height)
 
 static void free_silhouettes(void)
 {
+    reset_sprite_batch();
     silhouette_texture *silhouette = data.silhouettes;
     while (silhouette) {
         silhouette_texture *current = silhouette;
@@ -235,6 +330,7 @@ static void free_silhouettes(void)
 
 static void free_unpacked_assets(void)
 {
+    reset_sprite_batch();
     for (int i = 0; i < MAX_UNPACKED_IMAGES; i++) {
         if (data.unpacked_images[i].texture) {
             SDL_DestroyTexture(data.unpacked_images[i].texture);
@@ -245,6 +341,7 @@ static void free_unpacked_assets(void)
 
 static void free_texture_atlas(atlas_type type)
 {
+    reset_sprite_batch();
     if (!data.texture_lists[type]) {
         return;
     }
@@ -416,6 +513,7 @@ static const image_atlas_data *get_texture_atlas(atlas_type type)
 
 static void free_all_textures(void)
 {
+    reset_sprite_batch();
     for (atlas_type i = ATLAS_FIRST; i < ATLAS_MAX - 1; i++) {
         free_texture_atlas_and_data(i);
     }
@@ -472,6 +570,18 @@ static SDL_Texture *get_texture(int texture_id)
     return data.texture_lists[type][texture_id & IMAGE_ATLAS_BIT_MASK];
 }
 
+#ifdef USE_TEXTURE_SCALE_MODE
+static SDL_ScaleMode get_desired_scale_mode(float scale)
+{
+    if (data.disable_linear_filter) {
+        return SDL_ScaleModeNearest;
+    }
+    SDL_ScaleMode city_scale_mode = SDL_ScaleModeNearest;
+    SDL_ScaleMode texture_scale_mode = scale != 1.0f ? SDL_ScaleModeLinear : SDL_ScaleModeNearest;
+    return data.city_scale == scale ? city_scale_mode : texture_scale_mode;
+}
+#endif
+
 static void set_texture_color_and_scale_mode(SDL_Texture *texture, color_t color, float scale)
 {
     if (!color) {
@@ -491,18 +601,68 @@ static void set_texture_color_and_scale_mode(SDL_Texture *texture, color_t color
     SDL_ScaleMode current_scale_mode;
     SDL_GetTextureScaleMode(texture, &current_scale_mode);
 
-    SDL_ScaleMode city_scale_mode = SDL_ScaleModeNearest;
-    SDL_ScaleMode texture_scale_mode = scale != 1.0f ? SDL_ScaleModeLinear : SDL_ScaleModeNearest;
-    SDL_ScaleMode desired_scale_mode = data.city_scale == scale ? city_scale_mode : texture_scale_mode;
-    if (data.disable_linear_filter) {
-        desired_scale_mode = SDL_ScaleModeNearest;
-    }
+    SDL_ScaleMode desired_scale_mode = get_desired_scale_mode(scale);
     if (current_scale_mode != desired_scale_mode) {
         SDL_SetTextureScaleMode(texture, desired_scale_mode);
     }
 #endif
 }
 
+#ifdef USE_RENDER_GEOMETRY
+static void add_sprite_to_batch(SDL_Texture *texture, const SDL_Rect *src, const SDL_FRect *dst,
+    color_t color, float scale)
+{
+    SDL_ScaleMode scale_mode = get_desired_scale_mode(scale);
+    if (texture != data.batch.texture || scale_mode != data.batch.scale_mode ||
+        data.batch.sprites == MAX_BATCHED_SPRITES) {
+        flush_sprite_batch();
+        if (texture != data.batch.texture) {
+            int width, height;
+            SDL_QueryTexture(texture, NULL, NULL, &width, &height);
+            data.batch.texture = texture;
+            data.batch.texture_width = (float) width;
+            data.batch.texture_height = (float) height;
+        }
+        data.batch.scale_mode = scale_mode;
+    }
+    if (!color) {
+        color = COLOR_MASK_NONE;
+    }
+    SDL_Color vertex_color = {
+        (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
+        (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
+        (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE,
+        (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA
+    };
+    float u_start = src->x / data.batch.texture_width;
+    float u_end = (src->x + src->w) / data.batch.texture_width;
+    float v_start = src->y / data.batch.texture_height;
+    float v_end = (src->y + src->h) / data.batch.texture_height;
+
+    SDL_Vertex *vertices = &data.batch.vertices[data.batch.sprites * 4];
+    vertices[0].position.x = dst->x;
+    vertices[0].position.y = dst->y;
+    vertices[0].tex_coord.x = u_start;
+    vertices[0].tex_coord.y = v_start;
+    vertices[1].position.x = dst->x + dst->w;
+    vertices[1].position.y = dst->y;
+    vertices[1].tex_coord.x = u_end;
+    vertices[1].tex_coord.y = v_start;
+    vertices[2].position.x = dst->x + dst->w;
+    vertices[2].position.y = dst->y + dst->h;
+    vertices[2].tex_coord.x = u_end;
+    vertices[2].tex_coord.y = v_end;
+    vertices[3].position.x = dst->x;
+    vertices[3].position.y = dst->y + dst->h;
+    vertices[3].tex_coord.x = u_start;
+    vertices[3].tex_coord.y = v_end;
+    for (int i = 0; i < 4; i++) {
+        vertices[i].color = vertex_color;
+    }
+    data.batch.sprites++;
+}
+#endif
+
 static void draw_texture_advanced(const image *img, float x, float y, color_t color,
     float scale_x, float scale_y, double angle, int disable_coord_scaling)
 {
@@ -518,7 +678,9 @@ static void draw_texture_advanced(const image *img, float x, float y, color_t co
 
     float scale = scale_x == scale_y ? scale_x : 0.0f;
 
-    set_texture_color_and_scale_mode(texture, color, scale);
+#ifdef DRAW_FPS
+    data.stats.current.sprites++;
+#endif
 
     x += img->x_offset;
     y += img->y_offset;
@@ -536,6 +698,24 @@ static void draw_texture_advanced(const image *img, float x, float y, color_t co
     float coord_scale_x = disable_coord_scaling ? 1.0f : scale_x;
     float coord_scale_y = disable_coord_scaling ? 1.0f : scale_y;
 
+#ifdef USE_RENDER_GEOMETRY
+    // Rotated sprites are rare, so they are still drawn one by one
+    if (data.batch.enabled && angle == 0.0) {
+        SDL_FRect dst_coords = {
+            (x + grid_correction) / coord_scale_x,
+            (y + grid_correction) / coord_scale_y,
+            (img->width - grid_correction) / scale_x,
+            (img->height - grid_correction) / scale_y
+        };
+        add_sprite_to_batch(texture, &src_coords, &dst_coords, color, scale);
+        return;
+    }
+#endif
+
+    flush_sprite_batch();
+    set_texture_color_and_scale_mode(texture, color, scale);
+    RECORD_DRAW_CALL();
+
 #ifdef USE_RENDERCOPYF
     if (HAS_RENDERCOPYF) {
         SDL_FRect dst_coords = {
@@ -568,6 +748,7 @@ static void create_custom_texture(custom_image_type type, int width, int height,
     if (data.paused) {
         return;
     }
+    reset_sprite_batch();
     if (data.custom_textures[type].texture) {
         SDL_DestroyTexture(data.custom_textures[type].texture);
         data.custom_textures[type].texture = 0;
@@ -633,6 +814,7 @@ static void update_custom_texture(custom_image_type type)
     if (data.paused || !data.custom_textures[type].texture || !data.custom_textures[type].buffer) {
         return;
     }
+    flush_sprite_batch();
     int width;
     SDL_QueryTexture(data.custom_textures[type].texture, NULL, NULL, &width, NULL);
     SDL_UpdateTexture(data.custom_textures[type].texture, NULL,
@@ -646,6 +828,7 @@ static void update_custom_texture_from(custom_image_type type, const color_t *bu
     if (data.paused || !data.custom_textures[type].texture) {
         return;
     }
+    flush_sprite_batch();
     int texture_width, texture_height;
     SDL_QueryTexture(data.custom_textures[type].texture, NULL, NULL, &texture_width, &texture_height);
     if (x_offset + width > texture_width || y_offset + height > texture_height) {
@@ -674,6 +857,7 @@ static void update_custom_texture_yuv(custom_image_type type, const uint8_t *y_d
     if (data.paused || !data.supports_yuv_textures || !data.custom_textures[type].texture) {
         return;
     }
+    flush_sprite_batch();
     int width, height;
     Uint32 format;
     SDL_QueryTexture(data.custom_textures[type].texture, &format, NULL, &width, &height);
@@ -691,6 +875,7 @@ static int start_tooltip_creation(int width, int height)
     if (data.paused) {
         return 0;
     }
+    flush_sprite_batch();
     if (data.tooltip.texture) {
         if (data.tooltip.texture_width < width || data.tooltip.texture_height < height) {
             SDL_DestroyTexture(data.tooltip.texture);
@@ -728,10 +913,41 @@ static void finish_tooltip_creation(void)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
     SDL_SetRenderTarget(data.renderer, data.render_texture);
 }
 
+static int start_offscreen_render(int width, int height)
+{
+    if (data.paused || data.offscreen_texture) {
+        return 0;
+    }
+    flush_sprite_batch();
+    data.offscreen_texture = SDL_CreateTexture(data.renderer, SDL_PIXELFORMAT_ARGB8888,
+        SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!data.offscreen_texture) {
+        return 0;
+    }
+    if (SDL_SetRenderTarget(data.renderer, data.offscreen_texture) != 0) {
+        SDL_DestroyTexture(data.offscreen_texture);
+        data.offscreen_texture = 0;
+        return 0;
+    }
+    return 1;
+}
+
+static void finish_offscreen_render(void)
+{
+    if (!data.offscreen_texture) {
+        return;
+    }
+    flush_sprite_batch();
+    SDL_SetRenderTarget(data.renderer, data.render_texture);
+    SDL_DestroyTexture(data.offscreen_texture);
+    data.offscreen_texture = 0;
+}
+
 static int has_tooltip(void)
 {
     return data.tooltip.texture != 0;
@@ -766,6 +982,7 @@ static int save_to_texture(int texture_id, int x, int y, int width, int height)
     if (data.paused) {
         return 0;
     }
+    flush_sprite_batch();
     SDL_Texture *former_target = SDL_GetRenderTarget(data.renderer);
     if (!former_target) {
         return 0;
@@ -775,7 +992,7 @@ static int save_to_texture(int texture_id, int x, int y, int width, int height)
     SDL_Texture *texture = 0;
 
     if (!texture_info || (texture_info && (texture_info->tex_width < width || texture_info->tex_height < height))) {
-        if (texture_info) {
+        if (texture_info && texture_info->texture) {
             SDL_DestroyTexture(texture_info->texture);
             texture_info->texture = 0;
             texture_info->tex_width = 0;
@@ -836,22 +1053,26 @@ static int save_to_texture(int texture_id, int x, int y, int width, int height)
     return texture_info->id;
 }
 
-static void draw_saved_texture(int texture_id, int x, int y)
+static int draw_saved_texture(int texture_id, int x, int y)
 {
     if (data.paused) {
-        return;
+        return 0;
     }
+    flush_sprite_batch();
     buffer_texture *texture_info = get_saved_texture_info(texture_id);
-    if (!texture_info) {
-        return;
+    if (!texture_info || !texture_info->texture) {
+        return 0;
     }
     SDL_Rect src_coords = { 0, 0, texture_info->width, texture_info->height };
     SDL_Rect dst_coords = { x, y, texture_info->width, texture_info->height };
+    RECORD_DRAW_CALL();
     SDL_RenderCopy(data.renderer, texture_info->texture, &src_coords, &dst_coords);
+    return 1;
 }
 
 static void create_blend_texture(custom_image_type type)
 {
+    flush_sprite_batch();
     SDL_Texture *texture = SDL_CreateTexture(data.renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_TARGET, 58, 30);
     if (!texture) {
         return;
@@ -990,12 +1211,14 @@ static SDL_Texture *get_silhouette_texture(const image *img)
 
 static void draw_silhouetted_texture(const image *img, int x, int y, color_t color, float scale)
 {
+    flush_sprite_batch();
     SDL_Texture *texture = get_silhouette_texture(img);
     if (!texture) {
         return;
     }
 
     set_texture_color_and_scale_mode(texture, color, scale);
+    RECORD_DRAW_CALL();
 
     x += img->x_offset;
     y += img->y_offset;
@@ -1047,6 +1270,7 @@ static void load_unpacked_image(const image *img, const color_t *pixels)
     if (data.paused) {
         return;
     }
+    reset_sprite_batch();
     int first_empty = -1;
     int oldest_texture_index = 0;
     int unpacked_image_id = img->atlas.id & IMAGE_ATLAS_BIT_MASK;
@@ -1107,6 +1331,7 @@ static void load_unpacked_image(const image *img, const color_t *pixels)
 
 static void free_unpacked_image(const image *img)
 {
+    reset_sprite_batch();
     int unpacked_image_id = img->atlas.id & IMAGE_ATLAS_BIT_MASK;
     int found_id = -1;
     for (int i = 0; i < MAX_UNPACKED_IMAGES; i++) {
@@ -1169,6 +1394,8 @@ static void create_renderer_interface(void)
     data.renderer_interface.set_tooltip_position = set_tooltip_position;
     data.renderer_interface.set_tooltip_opacity = set_tooltip_opacity;
     data.renderer_interface.has_tooltip = has_tooltip;
+    data.renderer_interface.start_offscreen_render = start_offscreen_render;
+    data.renderer_interface.finish_offscreen_render = finish_offscreen_render;
     data.renderer_interface.save_image_from_screen = save_to_texture;
     data.renderer_interface.draw_image_to_screen = draw_saved_texture;
     data.renderer_interface.save_screen_buffer = save_screen_buffer;
@@ -1225,6 +1452,7 @@ int platform_renderer_init(SDL_Window *window)
         data.max_texture_size.height = info.max_texture_height;
     }
     data.paused = 0;
+    init_sprite_batch();
    
 #ifdef MAX_TEXTURE_SIZE
 #ifdef __EMSCRIPTEN__
@@ -1266,6 +1494,7 @@ int platform_renderer_create_render_texture(int width, int height)
     if (data.paused) {
         return 1;
     }
+    flush_sprite_batch();
     destroy_render_texture();
 
 #ifdef USE_TEXTURE_SCALE_MODE
@@ -1323,6 +1552,7 @@ int platform_renderer_lost_render_texture(void)
 
 void platform_renderer_invalidate_target_textures(void)
 {
+    reset_sprite_batch();
     if (data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture) {
         SDL_DestroyTexture(data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture);
         data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture = 0;
@@ -1337,6 +1567,15 @@ void platform_renderer_invalidate_target_textures(void)
         SDL_DestroyTexture(data.tooltip.texture);
         data.tooltip.texture = 0;
     }
+    // The contents of saved images are lost as well, so they have to be saved again
+    for (buffer_texture *texture_info = data.texture_buffers.first; texture_info; texture_info = texture_info->next) {
+        if (texture_info->texture) {
+            SDL_DestroyTexture(texture_info->texture);
+            texture_info->texture = 0;
+        }
+        texture_info->tex_width = 0;
+        texture_info->tex_height = 0;
+    }
 }
 
 void platform_renderer_clear(void)
@@ -1364,6 +1603,7 @@ static void draw_tooltip(void)
     dst.w = data.tooltip.width;
     dst.h = data.tooltip.height;
     SDL_SetTextureAlphaMod(data.tooltip.texture, data.tooltip.opacity);
+    RECORD_DRAW_CALL();
     SDL_RenderCopy(data.renderer, data.tooltip.texture, &src, &dst);
 }
 
@@ -1384,6 +1624,7 @@ static void draw_software_mouse_cursor(void)
     dst.y = m->y - data.cursors[current].hotspot.y;
     dst.w = size;
     dst.h = size;
+    RECORD_DRAW_CALL();
     SDL_RenderCopy(data.renderer, data.cursors[current].texture, NULL, &dst);
 }
 
@@ -1392,7 +1633,9 @@ void platform_renderer_render(void)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetRenderTarget(data.renderer, NULL);
+    RECORD_DRAW_CALL();
     SDL_RenderCopy(data.renderer, data.render_texture, NULL, NULL);
     draw_tooltip();
     if (platform_cursor_is_software()) {
@@ -1400,7 +1643,18 @@ void platform_renderer_render(void)
     }
     SDL_RenderPresent(data.renderer);
     SDL_SetRenderTarget(data.renderer, data.render_texture);
+#ifdef DRAW_FPS
+    data.stats.last_frame = data.stats.current;
+    memset(&data.stats.current, 0, sizeof(data.stats.current));
+#endif
+}
+
+#ifdef DRAW_FPS
+const platform_renderer_frame_stats *platform_renderer_get_frame_stats(void)
+{
+    return &data.stats.last_frame;
 }
+#endif
 
 void platform_renderer_generate_mouse_cursor_texture(int cursor_id, int size, const color_t *pixels,
     int hotspot_x, int hotspot_y)
@@ -1427,6 +1681,7 @@ void platform_renderer_generate_mouse_cursor_texture(int cursor_id, int size, co
 
 void platform_renderer_pause(void)
 {
+    reset_sprite_batch();
     SDL_SetRenderTarget(data.renderer, NULL);
     data.paused = 1;
 }
@@ -1440,6 +1695,7 @@ void platform_renderer_resume(void)
 
 void platform_renderer_destroy(void)
 {
+    reset_sprite_batch();
     destroy_render_texture();
     if (data.renderer) {
         SDL_DestroyRenderer(data.renderer);
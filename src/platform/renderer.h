@@ -5,6 +5,13 @@
 
 #include "SDL.h"
 
+#ifdef DRAW_FPS
+typedef struct {
+    int draw_calls;
+    int sprites;
+} platform_renderer_frame_stats;
+#endif
+
 int platform_renderer_init(SDL_Window *window);
 
 int platform_renderer_create_render_texture(int width, int height);
@@ -20,6 +27,10 @@ void platform_renderer_clear(void);
 
 void platform_renderer_render(void);
 
+#ifdef DRAW_FPS
+const platform_renderer_frame_stats *platform_renderer_get_frame_stats(void);
+#endif
+
 void platform_renderer_pause(void);
 
 void platform_renderer_resume(void);
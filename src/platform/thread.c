@@ -0,0 +1,94 @@
+#include "thread.h"
+
+#include "SDL.h"
+
+#include <stdlib.h>
+
+struct platform_thread {
+    SDL_Thread *thread;
+    SDL_atomic_t finished;
+    int (*function)(void *);
+    void *data;
+};
+
+#ifndef __EMSCRIPTEN__
+static int run_thread(void *data)
+{
+    platform_thread *thread = data;
+    int status = thread->function(thread->data);
+    SDL_AtomicSet(&thread->finished, 1);
+    return status;
+}
+#endif
+
+platform_thread *platform_thread_create(int (*function)(void *), const char *name, void *data)
+{
+#ifdef __EMSCRIPTEN__
+    // The browser build runs without pthreads, and file writes must sync the filesystem from the main thread
+    return 0;
+#else
+    platform_thread *thread = malloc(sizeof(platform_thread));
+    if (!thread) {
+        return 0;
+    }
+    SDL_AtomicSet(&thread->finished, 0);
+    thread->function = function;
+    thread->data = data;
+    thread->thread = SDL_CreateThread(run_thread, name, thread);
+    if (!thread->thread) {
+        SDL_Log("Unable to create thread %s: %s", name, SDL_GetError());
+        free(thread);
+        return 0;
+    }
+    return thread;
+#endif
+}
+
+int platform_thread_wait(platform_thread *thread)
+{
+    int status = 0;
+    SDL_WaitThread(thread->thread, &status);
+    free(thread);
+    return status;
+}
+
+int platform_thread_is_finished(platform_thread *thread)
+{
+    return SDL_AtomicGet(&thread->finished);
+}
+
+platform_mutex *platform_mutex_create(void)
+{
+    return (platform_mutex *) SDL_CreateMutex();
+}
+
+void platform_mutex_lock(platform_mutex *mutex)
+{
+    SDL_LockMutex((SDL_mutex *) mutex);
+}
+
+void platform_mutex_unlock(platform_mutex *mutex)
+{
+    SDL_UnlockMutex((SDL_mutex *) mutex);
+}
+
+platform_condition *platform_condition_create(void)
+{
+    return (platform_condition *) SDL_CreateCond();
+}
+
+void platform_condition_wait(platform_condition *condition, platform_mutex *mutex)
+{
+    SDL_CondWait((SDL_cond *) condition, (SDL_mutex *) mutex);
+}
+
+void platform_condition_broadcast(platform_condition *condition)
+{
+    SDL_CondBroadcast((SDL_cond *) condition);
+}
+
+int platform_thread_cpu_count(void)
+{
+    int count = SDL_GetCPUCount();
+    return count > 0 ? count : 1;
+}
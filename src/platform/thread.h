@@ -0,0 +1,67 @@
+#ifndef PLATFORM_THREAD_H
+#define PLATFORM_THREAD_H
+
+typedef struct platform_thread platform_thread;
+typedef struct platform_mutex platform_mutex;
+typedef struct platform_condition platform_condition;
+
+/**
+ * Starts a function on a new thread
+ * @param function Function to run
+ * @param name Thread name, for debugging
+ * @param data Argument to pass to the function
+ * @return The thread, or 0 if threads are not supported or the thread could not be created,
+ *         in which case the caller should run the function itself
+ */
+platform_thread *platform_thread_create(int (*function)(void *), const char *name, void *data);
+
+/**
+ * Waits for a thread to finish and releases it
+ * @param thread Thread to wait for
+ * @return The value returned by the thread function
+ */
+int platform_thread_wait(platform_thread *thread);
+
+/**
+ * Checks whether a thread has returned from its function, without waiting for it
+ * @param thread Thread to check
+ * @return 1 if the thread has finished and platform_thread_wait will not block, 0 otherwise
+ */
+int platform_thread_is_finished(platform_thread *thread);
+
+/**
+ * Creates a mutex
+ * @return The mutex, or 0 if it could not be created
+ */
+platform_mutex *platform_mutex_create(void);
+
+void platform_mutex_lock(platform_mutex *mutex);
+
+void platform_mutex_unlock(platform_mutex *mutex);
+
+/**
+ * Creates a condition variable
+ * @return The condition variable, or 0 if it could not be created
+ */
+platform_condition *platform_condition_create(void);
+
+/**
+ * Releases the locked mutex and waits until the condition is signalled, then locks the mutex again
+ * @param condition Condition to wait for
+ * @param mutex Mutex that is locked by the caller
+ */
+void platform_condition_wait(platform_condition *condition, platform_mutex *mutex);
+
+/**
+ * Wakes up every thread waiting for the condition
+ * @param condition Condition to signal
+ */
+void platform_condition_broadcast(platform_condition *condition);
+
+/**
+ * Gets the number of logical CPU cores
+ * @return Number of cores, at least 1
+ */
+int platform_thread_cpu_count(void);
+
+#endif // PLATFORM_THREAD_H
@@ -19,13 +19,15 @@
 static const struct {
     int width;
     int height;
-} MAP_SIZES[] = {
+} MAP_SIZES[NUM_MAP_SIZES] = {
     {40, 40},
     {60, 60},
     {80, 80},
     {100, 100},
     {120, 120},
-    {160, 160}
+    {160, 160},
+    {324, 324},
+    {512, 512}
 };
 
 static int is_saved;
@@ -57,6 +59,8 @@ void scenario_editor_create(int map_size)
 
     scenario.map.width = MAP_SIZES[map_size].width;
     scenario.map.height = MAP_SIZES[map_size].height;
+    // Keeps the current grid when allocating fails, the map offsets below follow whichever grid is in use
+    map_grid_allocate(map_grid_size_for_map(scenario.map.width, scenario.map.height));
     scenario.map.grid_border_size = GRID_SIZE - scenario.map.width;
     scenario.map.grid_start = (GRID_SIZE - scenario.map.height) / 2 * GRID_SIZE + (GRID_SIZE - scenario.map.width) / 2;
 
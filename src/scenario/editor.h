@@ -3,6 +3,14 @@
 
 #include <stdint.h>
 
+/**
+ * The six original map sizes, followed by the sizes that need a larger grid
+ */
+enum {
+    NUM_ORIGINAL_MAP_SIZES = 6,
+    NUM_MAP_SIZES = 8
+};
+
 void scenario_editor_create(int map_size);
 
 int scenario_editor_is_saved(void);
@@ -200,12 +200,12 @@ void sound_city_decay_views(void)
     }
 }
 
-void sound_city_progress_ambient(void)
+void sound_city_progress_ambient(int views)
 {
     for (sound_ambient_type sound = SOUND_AMBIENT_FIRST; sound < SOUND_AMBIENT_MAX; sound++) {
         data.ambient_sounds[sound].available = 1;
-        ++data.ambient_sounds[sound].total_views;
-        ++data.ambient_sounds[sound].direction_views[SOUND_DIRECTION_CENTER];
+        data.ambient_sounds[sound].total_views += views;
+        data.ambient_sounds[sound].direction_views[SOUND_DIRECTION_CENTER] += views;
     }
 }
 
@@ -1469,6 +1469,11 @@ static translation_string all_strings[] = {
     {TR_CHEAT_CLIMATE_CHANGE, "Climate change in effect" },
     {TR_CHEAT_EDITOR_WARNING_TITLE, "Warning"},
     {TR_CHEAT_EDITOR_WARNING_TEXT, "Running the map editor from city mode can corrupt the save or cause the game to crash.\n\nProceed at your own risk and make sure you have a backup of the current save."},
+    {TR_CHEAT_TICK_STATS_ENABLED, "Tick statistics enabled"},
+    {TR_CHEAT_TICK_STATS_DISABLED, "Tick statistics disabled"},
+    {TR_CHEAT_TICK_STATS_RESET, "Tick statistics cleared"},
+    {TR_CHEAT_TICK_STATS_SAVED, "Tick statistics saved to tick_stats.csv"},
+    {TR_CHEAT_TICK_STATS_SAVE_FAILED, "Unable to save tick statistics"},
     {TR_MAIN_MENU_SELECT_CAMPAIGN, "Start new campaign"},
     {TR_WINDOW_SELECT_CAMPAIGN, "Select a campaign"},
     {TR_WINDOW_CAMPAIGN_AUTHOR, "Author:"},
@@ -1627,6 +1632,9 @@ static translation_string all_strings[] = {
     {TR_BUILDING_NATIVE_WATCHTOWER_DESC, "Using these structures, the natives observe every movement in your city, ever ready to exploit signs of weakness. Unless the locals are taught the benefits of Roman civilization, the guards watching from the tower will prevent expansion into this area."},
     {TR_BUILDING_INFO_CARAVANSERAI_MONTHLY_CONSUMPTION, "Monthly food consumption:"},
     {TR_CONFIG_CARAVANS_MOVE_OFF_ROAD, "Trade caravans do not prioritize road networks"},
+    {TR_WARNING_SCREENSHOT_FAILED, "Unable to save screenshot: "},
+    {TR_EDITOR_MAP_SIZE_324, "324 x 324"},
+    {TR_EDITOR_MAP_SIZE_512, "512 x 512"},
 
 };
 
@@ -1030,6 +1030,11 @@ typedef enum {
     TR_CHEAT_CLIMATE_CHANGE,
     TR_CHEAT_EDITOR_WARNING_TITLE,
     TR_CHEAT_EDITOR_WARNING_TEXT,
+    TR_CHEAT_TICK_STATS_ENABLED,
+    TR_CHEAT_TICK_STATS_DISABLED,
+    TR_CHEAT_TICK_STATS_RESET,
+    TR_CHEAT_TICK_STATS_SAVED,
+    TR_CHEAT_TICK_STATS_SAVE_FAILED,
     TR_CITY_MESSAGE_TITLE_ROAD_TO_ROME_WARNING,
     TR_CITY_MESSAGE_TEXT_ROAD_TO_ROME_WARNING,
     TR_CITY_MESSAGE_TITLE_TRADE_ROUTE_PRICE_CHANGE,
@@ -1621,6 +1626,9 @@ typedef enum {
     TR_BUILDING_NATIVE_WATCHTOWER_DESC,
     TR_BUILDING_INFO_CARAVANSERAI_MONTHLY_CONSUMPTION,
     TR_CONFIG_CARAVANS_MOVE_OFF_ROAD,
+    TR_WARNING_SCREENSHOT_FAILED,
+    TR_EDITOR_MAP_SIZE_324,
+    TR_EDITOR_MAP_SIZE_512,
     TRANSLATION_MAX_KEY
 } translation_key;
 
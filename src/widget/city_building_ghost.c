@@ -74,17 +74,17 @@ static enum {
     TILE_DISCOURAGED = -1
 };
 
-static const int FORT_GROUND_GRID_OFFSETS[4][4] = {
-    { GRID_OFFSET(3, -1),  GRID_OFFSET(4, -1), GRID_OFFSET(4, 0),  GRID_OFFSET(3, 0)   },
-    { GRID_OFFSET(-1, -4), GRID_OFFSET(0, -4), GRID_OFFSET(0, -3), GRID_OFFSET(-1, -3) },
-    { GRID_OFFSET(-4, 0),  GRID_OFFSET(-3, 0), GRID_OFFSET(-3, 1), GRID_OFFSET(-4, 1)  },
-    { GRID_OFFSET(0, 3),   GRID_OFFSET(1, 3),  GRID_OFFSET(1, 4),  GRID_OFFSET(0, 4)   }
+static const tile_xy_offsets FORT_GROUND_GRID_OFFSETS[4][4] = {
+    { {3, -1},  {4, -1}, {4, 0},  {3, 0}   },
+    { {-1, -4}, {0, -4}, {0, -3}, {-1, -3} },
+    { {-4, 0},  {-3, 0}, {-3, 1}, {-4, 1}  },
+    { {0, 3},   {1, 3},  {1, 4},  {0, 4}   }
 };
 static const int FORT_GROUND_X_VIEW_OFFSETS[4] = { 120, 90, -120, -90 };
 static const int FORT_GROUND_Y_VIEW_OFFSETS[4] = { 30, -75, -60, 45 };
 
-static const int RESERVOIR_GRID_OFFSETS[4] = {
-    GRID_OFFSET(-1, -1), GRID_OFFSET(1, -1), GRID_OFFSET(1, 1), GRID_OFFSET(-1, 1)
+static const tile_xy_offsets RESERVOIR_GRID_OFFSETS[4] = {
+    {-1, -1}, {1, -1}, {1, 1}, {-1, 1}
 };
 
 static const int HIPPODROME_X_VIEW_OFFSETS[4] = { 150, 150, -150, -150 };
@@ -147,6 +147,17 @@ static inline int tile_grid_offset(int orientation, int index)
     return GRID_OFFSET(data.offsets[orientation][index].x, data.offsets[orientation][index].y);
 }
 
+static inline int reservoir_grid_offset(int orientation_index)
+{
+    return GRID_OFFSET(RESERVOIR_GRID_OFFSETS[orientation_index].x, RESERVOIR_GRID_OFFSETS[orientation_index].y);
+}
+
+static inline int fort_ground_grid_offset(int orientation_index)
+{
+    const tile_xy_offsets *offset = &FORT_GROUND_GRID_OFFSETS[building_rotation_get_rotation()][orientation_index];
+    return GRID_OFFSET(offset->x, offset->y);
+}
+
 static int is_blocked_for_building(int grid_offset, int building_size, int *blocked_tiles)
 {
     int orientation_index = city_view_orientation() / 2;
@@ -677,9 +688,9 @@ static void draw_draggable_reservoir(const map_tile *tile, int x, int y)
             }
             if (!draw_later) {
                 if (config_get(CONFIG_UI_SHOW_WATER_STRUCTURE_RANGE)) {
-                    city_view_foreach_tile_in_range(offset + RESERVOIR_GRID_OFFSETS[orientation_index], 3,
+                    city_view_foreach_tile_in_range(offset + reservoir_grid_offset(orientation_index), 3,
                         map_water_supply_reservoir_radius(), draw_first_reservoir_range);
-                    city_view_foreach_tile_in_range(tile->grid_offset + RESERVOIR_GRID_OFFSETS[orientation_index], 3,
+                    city_view_foreach_tile_in_range(tile->grid_offset + reservoir_grid_offset(orientation_index), 3,
                         map_water_supply_reservoir_radius(), draw_second_reservoir_range);
                 }
                 draw_single_reservoir(0, x_start, y_start, color, has_water, 1);
@@ -689,7 +700,7 @@ static void draw_draggable_reservoir(const map_tile *tile, int x, int y)
     if (!drawing_two_reservoirs) {
         data.reservoir_range.last_grid_offset = -1;
         data.reservoir_range.total = 0;
-        int grid_offset = tile->grid_offset + RESERVOIR_GRID_OFFSETS[orientation_index];
+        int grid_offset = tile->grid_offset + reservoir_grid_offset(orientation_index);
         for (int i = 0; i < 9; i++) {
             int tile_offset = grid_offset + tile_grid_offset(orientation_index, i);
             int terrain = map_terrain_get(tile_offset);
@@ -722,10 +733,10 @@ static void draw_draggable_reservoir(const map_tile *tile, int x, int y)
     y -= 30;
     if (config_get(CONFIG_UI_SHOW_WATER_STRUCTURE_RANGE) && (!building_construction_in_progress() || draw_later)) {
         if (draw_later) {
-            city_view_foreach_tile_in_range(offset + RESERVOIR_GRID_OFFSETS[orientation_index], 3,
+            city_view_foreach_tile_in_range(offset + reservoir_grid_offset(orientation_index), 3,
                 map_water_supply_reservoir_radius(), draw_first_reservoir_range);
         }
-        city_view_foreach_tile_in_range(tile->grid_offset + RESERVOIR_GRID_OFFSETS[orientation_index], 3,
+        city_view_foreach_tile_in_range(tile->grid_offset + reservoir_grid_offset(orientation_index), 3,
             map_water_supply_reservoir_radius(), draw_second_reservoir_range);
     }
     draw_single_reservoir(tile->grid_offset, x, y, color, has_water, drawing_two_reservoirs);
@@ -1008,8 +1019,7 @@ static void draw_fort(const map_tile *tile, int x, int y)
     int num_tiles_ground = building_size_ground * building_size_ground;
 
     int grid_offset_fort = tile->grid_offset;
-    int grid_offset_ground = grid_offset_fort +
-        FORT_GROUND_GRID_OFFSETS[building_rotation_get_rotation()][city_view_orientation() / 2];
+    int grid_offset_ground = grid_offset_fort + fort_ground_grid_offset(city_view_orientation() / 2);
     int blocked_tiles_fort[9];
     int blocked_tiles_ground[16];
 
@@ -1420,12 +1430,12 @@ static void draw_partial_grid(int grid_offset, int x, int y, building_type type)
     if (building_is_farm(type) || type == BUILDING_DRAGGABLE_RESERVOIR || type == BUILDING_WAREHOUSE) {
         size = 3;
         if (type == BUILDING_DRAGGABLE_RESERVOIR) {
-            grid_offset += RESERVOIR_GRID_OFFSETS[orientation_index];
+            grid_offset += reservoir_grid_offset(orientation_index);
         }
     }
     draw_grid_around_building(grid_offset, size, orientation_index, x, y);
     if (building_is_fort(type)) {
-        grid_offset += FORT_GROUND_GRID_OFFSETS[building_rotation_get_rotation()][orientation_index];
+        grid_offset += fort_ground_grid_offset(orientation_index);
         int ground_index = building_rotation_get_building_orientation(building_rotation_get_rotation()) / 2;
         int x_ground = x + FORT_GROUND_X_VIEW_OFFSETS[ground_index];
         int y_ground = y + FORT_GROUND_Y_VIEW_OFFSETS[ground_index];
@@ -3,6 +3,7 @@
 #include "assets/assets.h"
 #include "building/building.h"
 #include "city/view.h"
+#include "core/direction.h"
 #include "graphics/image.h"
 #include "map/aqueduct.h"
 #include "map/building.h"
@@ -11,12 +12,17 @@
 #include "map/terrain.h"
 #include "map/tiles.h"
 
-static int highway_barrier_direction_offsets[4] = { 1, -GRID_SIZE, -1, GRID_SIZE };
+static const int HIGHWAY_BARRIER_DIRECTIONS[4] = { DIR_2_RIGHT, DIR_0_TOP, DIR_6_LEFT, DIR_4_BOTTOM };
+
+static inline int highway_barrier_direction_offset(int direction_index)
+{
+    return map_grid_direction_delta(HIGHWAY_BARRIER_DIRECTIONS[direction_index]);
+}
 
 static int has_adjacent_road(int adjacent_grid_offset, int direction_index)
 {
-    int right_direction = highway_barrier_direction_offsets[(direction_index + 3) % 4];
-    int left_direction = highway_barrier_direction_offsets[(direction_index + 1) % 4];
+    int right_direction = highway_barrier_direction_offset((direction_index + 3) % 4);
+    int left_direction = highway_barrier_direction_offset((direction_index + 1) % 4);
     int left_has_road = map_terrain_is(adjacent_grid_offset + left_direction, TERRAIN_ROAD);
     int right_has_road = map_terrain_is(adjacent_grid_offset + right_direction, TERRAIN_ROAD);
     if (left_has_road && right_has_road) {
@@ -51,7 +57,7 @@ static int is_highway_access(int grid_offset, int direction_index)
 
 static void draw_barrier_image(int grid_offset, int direction_index, int x, int y, float scale)
 {
-    int direction = highway_barrier_direction_offsets[direction_index];
+    int direction = highway_barrier_direction_offset(direction_index);
 
     int direction_offset = grid_offset + direction;
     if (is_highway_access(direction_offset, direction_index)) {
@@ -59,7 +65,7 @@ static void draw_barrier_image(int grid_offset, int direction_index, int x, int
     }
 
     int last_direction_index = (direction_index + 3) % 4;
-    int last_direction_offset = grid_offset + highway_barrier_direction_offsets[last_direction_index];
+    int last_direction_offset = grid_offset + highway_barrier_direction_offset(last_direction_index);
     // last barrier was a corner and will handle the rendering
     if (!is_highway_access(last_direction_offset, last_direction_index)) {
         return;
@@ -67,7 +73,7 @@ static void draw_barrier_image(int grid_offset, int direction_index, int x, int
 
     int barrier_offset = (direction_index + city_view_orientation() / 2) % 4;
     int next_direction_index = (direction_index + 1) % 4;
-    int next_direction_offset = grid_offset + highway_barrier_direction_offsets[next_direction_index];
+    int next_direction_offset = grid_offset + highway_barrier_direction_offset(next_direction_index);
     // is this a corner?
     if (!is_highway_access(next_direction_offset, next_direction_index)) {
         // increment by 4 to get the corner image
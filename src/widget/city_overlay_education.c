@@ -1,5 +1,6 @@
 #include "city_overlay_education.h"
 
+#include "building/house_service.h"
 #include "game/state.h"
 
 static int show_building_education(const building *b)
@@ -49,17 +50,20 @@ static int get_column_height_education(const building *b)
 
 static int get_column_height_school(const building *b)
 {
-    return b->house_size && b->data.house.school ? b->data.house.school / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_SCHOOL);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_column_height_library(const building *b)
 {
-    return b->house_size && b->data.house.library ? b->data.house.library / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_LIBRARY);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_column_height_academy(const building *b)
 {
-    return b->house_size && b->data.house.academy ? b->data.house.academy / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_ACADEMY);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_tooltip_education(tooltip_context *c, const building *b)
@@ -75,11 +79,11 @@ static int get_tooltip_education(tooltip_context *c, const building *b)
 
 static int get_tooltip_school(tooltip_context *c, const building *b)
 {
-    if (b->data.house.school <= 0) {
+    if (house_service_get(b, HOUSE_SERVICE_SCHOOL) <= 0) {
         return 19;
-    } else if (b->data.house.school >= 80) {
+    } else if (house_service_get(b, HOUSE_SERVICE_SCHOOL) >= 80) {
         return 20;
-    } else if (b->data.house.school >= 20) {
+    } else if (house_service_get(b, HOUSE_SERVICE_SCHOOL) >= 20) {
         return 21;
     } else {
         return 22;
@@ -88,11 +92,11 @@ static int get_tooltip_school(tooltip_context *c, const building *b)
 
 static int get_tooltip_library(tooltip_context *c, const building *b)
 {
-    if (b->data.house.library <= 0) {
+    if (house_service_get(b, HOUSE_SERVICE_LIBRARY) <= 0) {
         return 23;
-    } else if (b->data.house.library >= 80) {
+    } else if (house_service_get(b, HOUSE_SERVICE_LIBRARY) >= 80) {
         return 24;
-    } else if (b->data.house.library >= 20) {
+    } else if (house_service_get(b, HOUSE_SERVICE_LIBRARY) >= 20) {
         return 25;
     } else {
         return 26;
@@ -101,11 +105,11 @@ static int get_tooltip_library(tooltip_context *c, const building *b)
 
 static int get_tooltip_academy(tooltip_context *c, const building *b)
 {
-    if (b->data.house.academy <= 0) {
+    if (house_service_get(b, HOUSE_SERVICE_ACADEMY) <= 0) {
         return 27;
-    } else if (b->data.house.academy >= 80) {
+    } else if (house_service_get(b, HOUSE_SERVICE_ACADEMY) >= 80) {
         return 28;
-    } else if (b->data.house.academy >= 20) {
+    } else if (house_service_get(b, HOUSE_SERVICE_ACADEMY) >= 20) {
         return 29;
     } else {
         return 30;
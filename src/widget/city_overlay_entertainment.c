@@ -1,5 +1,6 @@
 #include "city_overlay_entertainment.h"
 
+#include "building/house_service.h"
 #include "game/state.h"
 #include "translation/translation.h"
 
@@ -110,35 +111,41 @@ static int get_column_height_entertainment(const building *b)
 
 static int get_column_height_theater(const building *b)
 {
-    return b->house_size && b->data.house.theater ? b->data.house.theater / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_THEATER);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_column_height_amphitheater(const building *b)
 {
-    return b->house_size && b->data.house.amphitheater_actor ? b->data.house.amphitheater_actor / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_AMPHITHEATER_ACTOR);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_column_height_arena(const building *b)
 {
-    return b->house_size && b->house_arena_gladiator ? b->house_arena_gladiator / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_ARENA_GLADIATOR);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_column_height_colosseum(const building *b)
 {
-    return b->house_size && b->data.house.colosseum_gladiator ? b->data.house.colosseum_gladiator / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_COLOSSEUM_GLADIATOR);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_column_height_hippodrome(const building *b)
 {
-    return b->house_size && b->data.house.hippodrome ? b->data.house.hippodrome / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_HIPPODROME);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_column_height_tavern(const building *b)
 {
-    if (!b->house_size || !b->house_tavern_wine_access) {
+    if (!b->house_size || !house_service_get(b, HOUSE_SERVICE_TAVERN_WINE)) {
         return NO_COLUMN;
     }
-    return (((b->house_tavern_wine_access / 10) * 2) + (b->house_tavern_food_access / 10)) / 3;
+    return (((house_service_get(b, HOUSE_SERVICE_TAVERN_WINE) / 10) * 2) +
+        (house_service_get(b, HOUSE_SERVICE_TAVERN_FOOD) / 10)) / 3;
 }
 
 static int get_tooltip_entertainment(tooltip_context *c, const building *b)
@@ -170,11 +177,11 @@ static int get_tooltip_entertainment(tooltip_context *c, const building *b)
 
 static int get_tooltip_theater(tooltip_context *c, const building *b)
 {
-    if (b->data.house.theater <= 0) {
+    if (house_service_get(b, HOUSE_SERVICE_THEATER) <= 0) {
         return 75;
-    } else if (b->data.house.theater >= 80) {
+    } else if (house_service_get(b, HOUSE_SERVICE_THEATER) >= 80) {
         return 76;
-    } else if (b->data.house.theater >= 20) {
+    } else if (house_service_get(b, HOUSE_SERVICE_THEATER) >= 20) {
         return 77;
     } else {
         return 78;
@@ -183,11 +190,11 @@ static int get_tooltip_theater(tooltip_context *c, const building *b)
 
 static int get_tooltip_amphitheater(tooltip_context *c, const building *b)
 {
-    if (b->data.house.amphitheater_actor <= 0) {
+    if (house_service_get(b, HOUSE_SERVICE_AMPHITHEATER_ACTOR) <= 0) {
         return 79;
-    } else if (b->data.house.amphitheater_actor >= 80) {
+    } else if (house_service_get(b, HOUSE_SERVICE_AMPHITHEATER_ACTOR) >= 80) {
         return 80;
-    } else if (b->data.house.amphitheater_actor >= 20) {
+    } else if (house_service_get(b, HOUSE_SERVICE_AMPHITHEATER_ACTOR) >= 20) {
         return 81;
     } else {
         return 82;
@@ -196,13 +203,13 @@ static int get_tooltip_amphitheater(tooltip_context *c, const building *b)
 
 static int get_tooltip_colosseum(tooltip_context *c, const building *b)
 {
-    if (b->data.house.colosseum_gladiator && b->data.house.colosseum_lion) {
+    if (house_service_get(b, HOUSE_SERVICE_COLOSSEUM_GLADIATOR) && house_service_get(b, HOUSE_SERVICE_COLOSSEUM_LION)) {
         c->translation_key = TR_TOOLTIP_OVERLAY_ARENA_COL_5;
-    } else if (b->data.house.colosseum_gladiator) {
+    } else if (house_service_get(b, HOUSE_SERVICE_COLOSSEUM_GLADIATOR)) {
         c->translation_key = TR_TOOLTIP_OVERLAY_ARENA_COL_4;
-    } else if (b->house_arena_gladiator && b->house_arena_lion) {
+    } else if (house_service_get(b, HOUSE_SERVICE_ARENA_GLADIATOR) && house_service_get(b, HOUSE_SERVICE_ARENA_LION)) {
         c->translation_key = TR_TOOLTIP_OVERLAY_ARENA_COL_3;
-    } else if (b->house_arena_gladiator) {
+    } else if (house_service_get(b, HOUSE_SERVICE_ARENA_GLADIATOR)) {
         c->translation_key = TR_TOOLTIP_OVERLAY_ARENA_COL_2;
     } else {
         c->translation_key = TR_TOOLTIP_OVERLAY_ARENA_COL_1;
@@ -212,11 +219,11 @@ static int get_tooltip_colosseum(tooltip_context *c, const building *b)
 
 static int get_tooltip_hippodrome(tooltip_context *c, const building *b)
 {
-    if (b->data.house.hippodrome <= 0) {
+    if (house_service_get(b, HOUSE_SERVICE_HIPPODROME) <= 0) {
         return 87;
-    } else if (b->data.house.hippodrome >= 80) {
+    } else if (house_service_get(b, HOUSE_SERVICE_HIPPODROME) >= 80) {
         return 88;
-    } else if (b->data.house.hippodrome >= 20) {
+    } else if (house_service_get(b, HOUSE_SERVICE_HIPPODROME) >= 20) {
         return 89;
     } else {
         return 90;
@@ -225,18 +232,18 @@ static int get_tooltip_hippodrome(tooltip_context *c, const building *b)
 
 static int get_tooltip_tavern(tooltip_context *c, const building *b)
 {
-    if (b->house_tavern_wine_access <= 0) {
+    if (house_service_get(b, HOUSE_SERVICE_TAVERN_WINE) <= 0) {
         c->translation_key = TR_TOOLTIP_OVERLAY_TAVERN_1;
-    } else if (b->house_tavern_wine_access <= 20) {
+    } else if (house_service_get(b, HOUSE_SERVICE_TAVERN_WINE) <= 20) {
         c->translation_key = TR_TOOLTIP_OVERLAY_TAVERN_2;
-    } else if (b->data.house.hippodrome <= 80) {
-        if (!b->house_tavern_food_access) {
+    } else if (house_service_get(b, HOUSE_SERVICE_HIPPODROME) <= 80) {
+        if (!house_service_get(b, HOUSE_SERVICE_TAVERN_FOOD)) {
             c->translation_key = TR_TOOLTIP_OVERLAY_TAVERN_3;
         } else {
             c->translation_key = TR_TOOLTIP_OVERLAY_TAVERN_4;
         }
     } else {
-        if (!b->house_tavern_food_access) {
+        if (!house_service_get(b, HOUSE_SERVICE_TAVERN_FOOD)) {
             c->translation_key = TR_TOOLTIP_OVERLAY_TAVERN_5;
         } else {
             c->translation_key = TR_TOOLTIP_OVERLAY_TAVERN_6;
@@ -1,5 +1,6 @@
 #include "city_overlay_health.h"
 
+#include "building/house_service.h"
 #include "city/health.h"
 #include "game/state.h"
 #include "translation/translation.h"
@@ -98,22 +99,26 @@ static int get_column_height_health(const building *b)
 
 static int get_column_height_barber(const building *b)
 {
-    return b->house_size && b->data.house.barber ? b->data.house.barber / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_BARBER);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_column_height_bathhouse(const building *b)
 {
-    return b->house_size && b->data.house.bathhouse ? b->data.house.bathhouse / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_BATHHOUSE);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_column_height_clinic(const building *b)
 {
-    return b->house_size && b->data.house.clinic ? b->data.house.clinic / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_CLINIC);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_column_height_hospital(const building *b)
 {
-    return b->house_size && b->data.house.hospital ? b->data.house.hospital / 10 : NO_COLUMN;
+    int coverage = house_service_get(b, HOUSE_SERVICE_HOSPITAL);
+    return b->house_size && coverage ? coverage / 10 : NO_COLUMN;
 }
 
 static int get_column_height_sickness(const building *b)
@@ -165,11 +170,11 @@ static int get_tooltip_health(tooltip_context *c, const building *b)
 
 static int get_tooltip_barber(tooltip_context *c, const building *b)
 {
-    if (b->data.house.barber <= 0) {
+    if (house_service_get(b, HOUSE_SERVICE_BARBER) <= 0) {
         return 31;
-    } else if (b->data.house.barber >= 80) {
+    } else if (house_service_get(b, HOUSE_SERVICE_BARBER) >= 80) {
         return 32;
-    } else if (b->data.house.barber < 20) {
+    } else if (house_service_get(b, HOUSE_SERVICE_BARBER) < 20) {
         return 33;
     } else {
         return 34;
@@ -178,11 +183,11 @@ static int get_tooltip_barber(tooltip_context *c, const building *b)
 
 static int get_tooltip_bathhouse(tooltip_context *c, const building *b)
 {
-    if (b->data.house.bathhouse <= 0) {
+    if (house_service_get(b, HOUSE_SERVICE_BATHHOUSE) <= 0) {
         return 8;
-    } else if (b->data.house.bathhouse >= 80) {
+    } else if (house_service_get(b, HOUSE_SERVICE_BATHHOUSE) >= 80) {
         return 9;
-    } else if (b->data.house.bathhouse >= 20) {
+    } else if (house_service_get(b, HOUSE_SERVICE_BATHHOUSE) >= 20) {
         return 10;
     } else {
         return 11;
@@ -191,11 +196,11 @@ static int get_tooltip_bathhouse(tooltip_context *c, const building *b)
 
 static int get_tooltip_clinic(tooltip_context *c, const building *b)
 {
-    if (b->data.house.clinic <= 0) {
+    if (house_service_get(b, HOUSE_SERVICE_CLINIC) <= 0) {
         return 35;
-    } else if (b->data.house.clinic >= 80) {
+    } else if (house_service_get(b, HOUSE_SERVICE_CLINIC) >= 80) {
         return 36;
-    } else if (b->data.house.clinic >= 20) {
+    } else if (house_service_get(b, HOUSE_SERVICE_CLINIC) >= 20) {
         return 37;
     } else {
         return 38;
@@ -204,11 +209,11 @@ static int get_tooltip_clinic(tooltip_context *c, const building *b)
 
 static int get_tooltip_hospital(tooltip_context *c, const building *b)
 {
-    if (b->data.house.hospital <= 0) {
+    if (house_service_get(b, HOUSE_SERVICE_HOSPITAL) <= 0) {
         return 39;
-    } else if (b->data.house.hospital >= 80) {
+    } else if (house_service_get(b, HOUSE_SERVICE_HOSPITAL) >= 80) {
         return 40;
-    } else if (b->data.house.hospital >= 20) {
+    } else if (house_service_get(b, HOUSE_SERVICE_HOSPITAL) >= 20) {
         return 41;
     } else {
         return 42;
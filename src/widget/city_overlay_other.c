@@ -3,6 +3,7 @@
 #include "assets/assets.h"
 #include "building/animation.h"
 #include "building/building.h"
+#include "building/house_service.h"
 #include "building/industry.h"
 #include "building/model.h"
 #include "building/monument.h"
@@ -260,25 +261,25 @@ static void add_god(tooltip_context *c, int god_id)
 
 static int get_tooltip_religion(tooltip_context *c, const building *b)
 {
-    if (b->house_pantheon_access) {
+    if (house_service_get(b, HOUSE_SERVICE_PANTHEON)) {
         c->translation_key = TR_TOOLTIP_OVERLAY_PANTHEON_ACCESS;
         return 0;
     }
 
     if (b->data.house.num_gods < 5) {
-        if (b->data.house.temple_ceres) {
+        if (house_service_get(b, HOUSE_SERVICE_TEMPLE_CERES)) {
             add_god(c, GOD_CERES);
         }
-        if (b->data.house.temple_neptune) {
+        if (house_service_get(b, HOUSE_SERVICE_TEMPLE_NEPTUNE)) {
             add_god(c, GOD_NEPTUNE);
         }
-        if (b->data.house.temple_mercury) {
+        if (house_service_get(b, HOUSE_SERVICE_TEMPLE_MERCURY)) {
             add_god(c, GOD_MERCURY);
         }
-        if (b->data.house.temple_mars) {
+        if (house_service_get(b, HOUSE_SERVICE_TEMPLE_MARS)) {
             add_god(c, GOD_MARS);
         }
-        if (b->data.house.temple_venus) {
+        if (house_service_get(b, HOUSE_SERVICE_TEMPLE_VENUS)) {
             add_god(c, GOD_VENUS);
         }
     }
@@ -355,7 +356,7 @@ static int get_tooltip_tax_income(tooltip_context *c, const building *b)
         c->has_numeric_prefix = 1;
         c->numeric_prefix = denarii;
         return 45;
-    } else if (b->house_tax_coverage > 0) {
+    } else if (house_service_get(b, HOUSE_SERVICE_TAX_COLLECTOR) > 0) {
         return 44;
     } else {
         return 43;
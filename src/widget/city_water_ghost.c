@@ -7,32 +7,44 @@
 #include "map/water_supply.h"
 #include "widget/city_building_ghost.h"
 
-#include <string.h>
-
 enum {
     WATER_ACCESS_NONE = 0x0,
     WATER_ACCESS_WELL = 0x1,
     WATER_ACCESS_FOUNTAIN = 0x2
 };
 
-static uint8_t has_water_access[GRID_SIZE * GRID_SIZE];
+static grid_u8 has_water_access;
 static building_type last_building_type = BUILDING_NONE;
 static int last_well_count = 0;
 static int last_fountain_count = 0;
 
+void city_water_ghost_init_grids(void)
+{
+    map_grid_register_u8(&has_water_access);
+}
+
+static int is_inside_map(int grid_offset)
+{
+    return map_grid_is_inside(map_grid_offset_to_x(grid_offset), map_grid_offset_to_y(grid_offset), 1);
+}
+
 static void set_well_access(int x, int y, int grid_offset)
 {
-    has_water_access[grid_offset] |= WATER_ACCESS_WELL;
+    if (is_inside_map(grid_offset)) {
+        has_water_access.items[grid_offset] |= WATER_ACCESS_WELL;
+    }
 }
 
 static void set_fountain_access(int x, int y, int grid_offset)
 {
-    has_water_access[grid_offset] |= WATER_ACCESS_FOUNTAIN;
+    if (is_inside_map(grid_offset)) {
+        has_water_access.items[grid_offset] |= WATER_ACCESS_FOUNTAIN;
+    }
 }
 
 static void update_water_access(void)
 {
-    memset(has_water_access, 0, sizeof(uint8_t) * GRID_SIZE * GRID_SIZE);
+    map_grid_clear_map_area_u8(has_water_access.items);
     for (building *b = building_first_of_type(BUILDING_WELL); b; b = b->next_of_type) {
         city_view_foreach_tile_in_range(b->grid_offset, 1, map_water_supply_well_radius(), set_well_access);
     }
@@ -43,7 +55,7 @@ static void update_water_access(void)
 
 static void draw_water_access(int x, int y, int grid_offset)
 {
-    uint8_t water_access = has_water_access[grid_offset];
+    uint8_t water_access = has_water_access.items[grid_offset];
     if (water_access & WATER_ACCESS_FOUNTAIN) {
         city_building_ghost_draw_fountain_range(x, y, grid_offset);
     } else if (water_access & WATER_ACCESS_WELL) {
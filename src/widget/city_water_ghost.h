@@ -1,6 +1,8 @@
 #ifndef WIDGET_CITY_WATER_GHOST_H
 #define WIDGET_CITY_WATER_GHOST_H
 
+void city_water_ghost_init_grids(void);
+
 void city_water_ghost_draw_water_structure_ranges(void);
 
 #endif // WIDGET_CITY_WATER_GHOST_H
@@ -23,6 +23,7 @@
 #include "map/grid.h"
 #include "map/image.h"
 #include "map/image_context.h"
+#include "map/point.h"
 #include "map/property.h"
 #include "map/random.h"
 #include "map/tiles.h"
@@ -46,18 +47,18 @@ static unsigned int city_roamer_preview_selected_building_id = ((unsigned int) -
 #define SELECTED_BUILDING_COLOR_MASK COLOR_MASK_SKY_BLUE
 #define OFFSET(x,y) (x + GRID_SIZE * y)
 
-static const int ADJACENT_OFFSETS[2][4][7] = {
+static const map_point ADJACENT_OFFSETS[2][4][7] = {
     {
-        {OFFSET(-1, 0), OFFSET(-1, -1), OFFSET(-1, -2), OFFSET(0, -2), OFFSET(1, -2)},
-        {OFFSET(0, -1), OFFSET(1, -1), OFFSET(2, -1), OFFSET(2, 0), OFFSET(2, 1)},
-        {OFFSET(1, 0), OFFSET(1, 1), OFFSET(1, 2), OFFSET(0, 2), OFFSET(-1, 2)},
-        {OFFSET(0, 1), OFFSET(-1, 1), OFFSET(-2, 1), OFFSET(-2, 0), OFFSET(-2, -1)}
+        {{-1, 0}, {-1, -1}, {-1, -2}, {0, -2}, {1, -2}},
+        {{0, -1}, {1, -1}, {2, -1}, {2, 0}, {2, 1}},
+        {{1, 0}, {1, 1}, {1, 2}, {0, 2}, {-1, 2}},
+        {{0, 1}, {-1, 1}, {-2, 1}, {-2, 0}, {-2, -1}}
     },
     {
-        {OFFSET(-1, 0), OFFSET(-1, -1), OFFSET(-1, -2), OFFSET(-1, -3), OFFSET(0, -3),  OFFSET(1, -3), OFFSET(2, -3)},
-        {OFFSET(0, -1), OFFSET(1, -1), OFFSET(2, -1), OFFSET(3, -1), OFFSET(3, 0),  OFFSET(3, 1), OFFSET(3, 2)},
-        {OFFSET(1, 0), OFFSET(1, 1), OFFSET(1, 2), OFFSET(1, 3), OFFSET(0, 3),  OFFSET(-1, 3), OFFSET(-2, 3)},
-        {OFFSET(0, 1), OFFSET(-1, 1), OFFSET(-2, 1), OFFSET(-3, 1), OFFSET(-3, 0),  OFFSET(-3, -1), OFFSET(-3, -2)}
+        {{-1, 0}, {-1, -1}, {-1, -2}, {-1, -3}, {0, -3},  {1, -3}, {2, -3}},
+        {{0, -1}, {1, -1}, {2, -1}, {3, -1}, {3, 0},  {3, 1}, {3, 2}},
+        {{1, 0}, {1, 1}, {1, 2}, {1, 3}, {0, 3},  {-1, 3}, {-2, 3}},
+        {{0, 1}, {-1, 1}, {-2, 1}, {-3, 1}, {-3, 0},  {-3, -1}, {-3, -2}}
     }
 };
 
@@ -246,10 +247,11 @@ static int has_adjacent_deletion(int grid_offset)
 {
     int size = map_property_multi_tile_size(grid_offset);
     int total_adjacent_offsets = size * 2 + 1;
-    const int *adjacent_offset = ADJACENT_OFFSETS[size - 2][city_view_orientation() / 2];
+    const map_point *adjacent_offset = ADJACENT_OFFSETS[size - 2][city_view_orientation() / 2];
     for (int i = 0; i < total_adjacent_offsets; ++i) {
-        if (map_property_is_deleted(grid_offset + adjacent_offset[i]) ||
-            draw_building_as_deleted(building_get(map_building_at(grid_offset + adjacent_offset[i])))) {
+        int adjacent_grid_offset = grid_offset + OFFSET(adjacent_offset[i].x, adjacent_offset[i].y);
+        if (map_property_is_deleted(adjacent_grid_offset) ||
+            draw_building_as_deleted(building_get(map_building_at(adjacent_grid_offset)))) {
             return 1;
         }
     }
@@ -781,21 +783,22 @@ static void draw_animation(int x, int y, int grid_offset)
 
 static void draw_figures(int x, int y, int grid_offset)
 {
-    int figure_id = map_figure_at(grid_offset);
-    while (figure_id) {
-        figure *f = figure_get(figure_id);
+    const uint16_t *figure_ids;
+    unsigned int total_figures = map_figure_get_all_at(grid_offset, &figure_ids);
+    for (unsigned int i = 0; i < total_figures; i++) {
+        figure *f = figure_get(figure_ids[i]);
         if (!f->is_ghost && overlay->show_figure(f)) {
             city_draw_figure(f, x, y, scale, 0);
         }
-        figure_id = f->next_figure_id_on_same_tile;
     }
 }
 
 static void draw_elevated_figures(int x, int y, int grid_offset)
 {
-    int figure_id = map_figure_at(grid_offset);
-    while (figure_id > 0) {
-        figure *f = figure_get(figure_id);
+    const uint16_t *figure_ids;
+    unsigned int total_figures = map_figure_get_all_at(grid_offset, &figure_ids);
+    for (unsigned int i = 0; i < total_figures; i++) {
+        figure *f = figure_get(figure_ids[i]);
         if (((f->use_cross_country && !f->is_ghost && !f->dont_draw_elevated) || f->height_adjusted_ticks) && overlay->show_figure(f)) {
             city_draw_figure(f, x, y, scale, 0);
         } else if (f->building_id == city_roamer_preview_selected_building_id) { //figure from selected building
@@ -808,7 +811,6 @@ static void draw_elevated_figures(int x, int y, int grid_offset)
             }
 
         }
-        figure_id = f->next_figure_id_on_same_tile;
     }
 }
 
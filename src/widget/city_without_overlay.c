@@ -38,6 +38,7 @@
 #include "map/figure.h"
 #include "map/grid.h"
 #include "map/image.h"
+#include "map/point.h"
 #include "map/property.h"
 #include "map/sprite.h"
 #include "map/terrain.h"
@@ -48,23 +49,25 @@
 #include "widget/city_figure.h"
 #include "widget/city_draw_highway.h"
 
+#include <stdlib.h>
+
 #define OFFSET(x,y) (x + GRID_SIZE * y)
 
 #define WAREHOUSE_FLAG_FRAMES 9
 #define SELECTED_BUILDING_COLOR_MASK COLOR_MASK_SKY_BLUE
 
-static const int ADJACENT_OFFSETS[2][4][7] = {
+static const map_point ADJACENT_OFFSETS[2][4][7] = {
     {
-        {OFFSET(-1, 0), OFFSET(-1, -1),  OFFSET(-1, -2), OFFSET(0, -2), OFFSET(1, -2)},
-        {OFFSET(0, -1), OFFSET(1, -1),  OFFSET(2, -1), OFFSET(2, 0), OFFSET(2, 1)},
-        {OFFSET(1, 0), OFFSET(1, 1),  OFFSET(1, 2), OFFSET(0, 2), OFFSET(-1, 2)},
-        {OFFSET(0, 1), OFFSET(-1, 1),  OFFSET(-2, 1), OFFSET(-2, 0), OFFSET(-2, -1)}
+        {{-1, 0}, {-1, -1},  {-1, -2}, {0, -2}, {1, -2}},
+        {{0, -1}, {1, -1},  {2, -1}, {2, 0}, {2, 1}},
+        {{1, 0}, {1, 1},  {1, 2}, {0, 2}, {-1, 2}},
+        {{0, 1}, {-1, 1},  {-2, 1}, {-2, 0}, {-2, -1}}
     },
     {
-        {OFFSET(-1, 0), OFFSET(-1, -1),  OFFSET(-1, -2), OFFSET(-1, -3), OFFSET(0, -3),  OFFSET(1, -3), OFFSET(2, -3)},
-        {OFFSET(0, -1), OFFSET(1, -1),  OFFSET(2, -1), OFFSET(3, -1), OFFSET(3, 0),  OFFSET(3, 1), OFFSET(3, 2)},
-        {OFFSET(1, 0), OFFSET(1, 1),  OFFSET(1, 2), OFFSET(1, 3), OFFSET(0, 3),  OFFSET(-1, 3), OFFSET(-2, 3)},
-        {OFFSET(0, 1), OFFSET(-1, 1),  OFFSET(-2, 1), OFFSET(-3, 1), OFFSET(-3, 0),  OFFSET(-3, -1), OFFSET(-3, -2)}
+        {{-1, 0}, {-1, -1},  {-1, -2}, {-1, -3}, {0, -3},  {1, -3}, {2, -3}},
+        {{0, -1}, {1, -1},  {2, -1}, {3, -1}, {3, 0},  {3, 1}, {3, 2}},
+        {{1, 0}, {1, 1},  {1, 2}, {1, 3}, {0, 3},  {-1, 3}, {-2, 3}},
+        {{0, 1}, {-1, 1},  {-2, 1}, {-3, 1}, {-3, 0},  {-3, -1}, {-3, -2}}
     }
 };
 
@@ -82,6 +85,37 @@ static struct {
     float scale;
 } draw_context;
 
+typedef struct {
+    int x;
+    int grid_offset;
+} ground_tile;
+
+// The footprints of all tiles, as drawn on the screen for the current camera and map state
+static struct {
+    int image_id;
+    int is_valid;
+    int x;
+    int y;
+    int width;
+    int height;
+    int camera_x;
+    int camera_y;
+    int scale;
+    int orientation;
+    int show_grid;
+    int highlight_selected_building;
+    unsigned int selected_building_id;
+    int construction_start_offset;
+    unsigned int map_image_version;
+    unsigned int marking_version;
+    unsigned int roamer_preview_version;
+    // Frames that use the cache only visit the tiles that make sounds or have animated water
+    int total_views;
+    ground_tile *tiles;
+    int total_tiles;
+    int tiles_capacity;
+} ground_cache;
+
 static void init_draw_context(int selected_figure_id, pixel_coordinate *figure_coord, int highlighted_formation)
 {
     draw_context.advance_water_animation = 0;
@@ -115,10 +149,11 @@ static int has_adjacent_deletion(int grid_offset)
 {
     int size = map_property_multi_tile_size(grid_offset);
     int total_adjacent_offsets = size * 2 + 1;
-    const int *adjacent_offset = ADJACENT_OFFSETS[size - 2][city_view_orientation() / 2];
+    const map_point *adjacent_offset = ADJACENT_OFFSETS[size - 2][city_view_orientation() / 2];
     for (int i = 0; i < total_adjacent_offsets; ++i) {
-        if (map_property_is_deleted(grid_offset + adjacent_offset[i]) ||
-            draw_building_as_deleted(building_get(map_building_at(grid_offset + adjacent_offset[i])))) {
+        int adjacent_grid_offset = grid_offset + OFFSET(adjacent_offset[i].x, adjacent_offset[i].y);
+        if (map_property_is_deleted(adjacent_grid_offset) ||
+            draw_building_as_deleted(building_get(map_building_at(adjacent_grid_offset)))) {
             return 1;
         }
     }
@@ -181,23 +216,51 @@ static int is_building_selected(const building *b)
 
 }
 
-static void draw_footprint(int x, int y, int grid_offset)
+static color_t get_footprint_color_mask(int building_id)
 {
-    sound_city_progress_ambient();
-    building_construction_record_view_position(x, y, grid_offset);
-    if (grid_offset < 0 || !map_property_is_draw_tile(grid_offset)) {
+    if (!building_id) {
+        return 0;
+    }
+    building *b = building_get(building_id);
+    if (draw_building_as_deleted(b)) {
+        return COLOR_MASK_RED;
+    } else if (is_building_selected(b)) {
+        return get_building_color_mask(b);
+    }
+    return 0;
+}
+
+static int is_animated_water(int image_id)
+{
+    return image_id >= draw_context.image_id_water_first && image_id <= draw_context.image_id_water_last;
+}
+
+static void add_ground_tile(int x, int grid_offset)
+{
+    if (ground_cache.total_tiles < 0) {
         return;
     }
-    // Valid grid_offset and leftmost tile -> draw
+    if (ground_cache.total_tiles == ground_cache.tiles_capacity) {
+        int capacity = ground_cache.tiles_capacity ? ground_cache.tiles_capacity * 2 : 256;
+        ground_tile *tiles = realloc(ground_cache.tiles, capacity * sizeof(ground_tile));
+        if (!tiles) {
+            // The cache is not used without the full list of tiles
+            ground_cache.total_tiles = -1;
+            return;
+        }
+        ground_cache.tiles = tiles;
+        ground_cache.tiles_capacity = capacity;
+    }
+    ground_cache.tiles[ground_cache.total_tiles].x = x;
+    ground_cache.tiles[ground_cache.total_tiles].grid_offset = grid_offset;
+    ground_cache.total_tiles++;
+}
+
+static void mark_sound_view(int x, int grid_offset)
+{
     int building_id = map_building_at(grid_offset);
-    color_t color_mask = 0;
     if (building_id) {
         building *b = building_get(building_id);
-        if (draw_building_as_deleted(b)) {
-            color_mask = COLOR_MASK_RED;
-        } else if (is_building_selected(b)) {
-            color_mask = get_building_color_mask(b);
-        }
         int view_x, view_y, view_width, view_height;
         city_view_get_viewport(&view_x, &view_y, &view_width, &view_height);
 
@@ -220,20 +283,51 @@ static void draw_footprint(int x, int y, int grid_offset)
     if (map_terrain_is(grid_offset, TERRAIN_GARDEN)) {
         sound_city_mark_building_view(BUILDING_GARDENS, 0, SOUND_DIRECTION_CENTER);
     }
+}
+
+static int animate_water(int grid_offset)
+{
+    int image_id = map_image_at(grid_offset);
+    if (!draw_context.advance_water_animation || map_property_is_constructing(grid_offset) ||
+        !is_animated_water(image_id)) {
+        return 0;
+    }
+    image_id++;
+    if (image_id > draw_context.image_id_water_last) {
+        image_id = draw_context.image_id_water_first;
+    }
+    map_image_set_animation_frame(grid_offset, image_id);
+    return 1;
+}
+
+static void prepare_footprint(int x, int y, int grid_offset)
+{
+    ground_cache.total_views++;
+    building_construction_record_view_position(x, y, grid_offset);
+    if (grid_offset < 0 || !map_property_is_draw_tile(grid_offset)) {
+        return;
+    }
+    if (map_building_at(grid_offset) || map_terrain_is(grid_offset, TERRAIN_GARDEN) ||
+        is_animated_water(map_image_at(grid_offset))) {
+        add_ground_tile(x, grid_offset);
+    }
+    mark_sound_view(x, grid_offset);
+    animate_water(grid_offset);
+}
+
+static void draw_footprint(int x, int y, int grid_offset)
+{
+    if (grid_offset < 0 || !map_property_is_draw_tile(grid_offset)) {
+        return;
+    }
+    // Valid grid_offset and leftmost tile -> draw
+    int building_id = map_building_at(grid_offset);
+    color_t color_mask = get_footprint_color_mask(building_id);
     int image_id = map_image_at(grid_offset);
     if (map_property_is_constructing(grid_offset)) { //&&
         //  !building_is_connectable(building_construction_type())) {
         image_id = image_group(GROUP_TERRAIN_OVERLAY);
     }
-    if (draw_context.advance_water_animation &&
-        image_id >= draw_context.image_id_water_first &&
-        image_id <= draw_context.image_id_water_last) {
-        image_id++;
-        if (image_id > draw_context.image_id_water_last) {
-            image_id = draw_context.image_id_water_first;
-        }
-        map_image_set(grid_offset, image_id);
-    }
     if (map_terrain_is(grid_offset, TERRAIN_HIGHWAY) && !map_terrain_is(grid_offset, TERRAIN_GATEHOUSE)) {
         city_draw_highway_footprint(x, y, draw_context.scale, grid_offset);
     } else {
@@ -250,6 +344,88 @@ static void draw_footprint(int x, int y, int grid_offset)
     draw_roamer_frequency(x, y, grid_offset);
 }
 
+static void prepare_and_draw_footprint(int x, int y, int grid_offset)
+{
+    prepare_footprint(x, y, grid_offset);
+    draw_footprint(x, y, grid_offset);
+}
+
+static int ground_cache_matches_view(int x, int y, int width, int height)
+{
+    int camera_x, camera_y;
+    city_view_get_camera_in_pixels(&camera_x, &camera_y);
+    return ground_cache.is_valid &&
+        ground_cache.x == x && ground_cache.y == y &&
+        ground_cache.width == width && ground_cache.height == height &&
+        ground_cache.camera_x == camera_x && ground_cache.camera_y == camera_y &&
+        ground_cache.scale == city_view_get_scale() &&
+        ground_cache.orientation == city_view_orientation() &&
+        ground_cache.show_grid == config_get(CONFIG_UI_SHOW_GRID) &&
+        ground_cache.highlight_selected_building == config_get(CONFIG_UI_HIGHLIGHT_SELECTED_BUILDING) &&
+        ground_cache.selected_building_id == draw_context.selected_building_id &&
+        ground_cache.construction_start_offset == building_construction_get_start_grid_offset() &&
+        ground_cache.map_image_version == map_image_get_version() &&
+        ground_cache.marking_version == map_property_get_marking_version() &&
+        ground_cache.roamer_preview_version == figure_roamer_preview_get_version();
+}
+
+static void save_ground_cache(int x, int y, int width, int height)
+{
+    ground_cache.image_id = graphics_save_to_image(ground_cache.image_id, x, y, width, height);
+    ground_cache.is_valid = ground_cache.image_id != 0 && ground_cache.total_tiles >= 0;
+    ground_cache.x = x;
+    ground_cache.y = y;
+    ground_cache.width = width;
+    ground_cache.height = height;
+    city_view_get_camera_in_pixels(&ground_cache.camera_x, &ground_cache.camera_y);
+    ground_cache.scale = city_view_get_scale();
+    ground_cache.orientation = city_view_orientation();
+    ground_cache.show_grid = config_get(CONFIG_UI_SHOW_GRID);
+    ground_cache.highlight_selected_building = config_get(CONFIG_UI_HIGHLIGHT_SELECTED_BUILDING);
+    ground_cache.selected_building_id = draw_context.selected_building_id;
+    ground_cache.construction_start_offset = building_construction_get_start_grid_offset();
+    ground_cache.map_image_version = map_image_get_version();
+    ground_cache.marking_version = map_property_get_marking_version();
+    ground_cache.roamer_preview_version = figure_roamer_preview_get_version();
+}
+
+static int prepare_cached_footprints(void)
+{
+    int has_moving_water = 0;
+    sound_city_progress_ambient(ground_cache.total_views);
+    for (int i = 0; i < ground_cache.total_tiles; i++) {
+        const ground_tile *tile = &ground_cache.tiles[i];
+        mark_sound_view(tile->x, tile->grid_offset);
+        has_moving_water |= animate_water(tile->grid_offset);
+    }
+    return has_moving_water;
+}
+
+static void draw_ground(int x, int y, int width, int height, int can_use_cache)
+{
+    if (can_use_cache && ground_cache_matches_view(x, y, width, height)) {
+        // Moving water is drawn together with the other footprints to keep the original drawing order.
+        // The saved image is also gone when the render targets were reset.
+        if (!prepare_cached_footprints() && graphics_draw_from_image(ground_cache.image_id, x, y)) {
+            return;
+        }
+        city_view_foreach_valid_map_tile(draw_footprint);
+    } else {
+        ground_cache.total_views = 0;
+        ground_cache.total_tiles = 0;
+        city_view_foreach_valid_map_tile(prepare_and_draw_footprint);
+        sound_city_progress_ambient(ground_cache.total_views);
+        if (!can_use_cache) {
+            // Water may have moved without the saved image
+            ground_cache.is_valid = 0;
+            return;
+        }
+    }
+    save_ground_cache(x, y, width, height);
+    // Saving switches render targets, which may reset the clip rectangle
+    graphics_set_clip_rectangle(x, y, width, height);
+}
+
 static void draw_hippodrome_spectators(const building *b, int x, int y, color_t color_mask)
 {
     // get which part of the hippodrome is getting checked
@@ -429,10 +605,11 @@ static void draw_top(int x, int y, int grid_offset)
 
 static void draw_figures(int x, int y, int grid_offset)
 {
-    int figure_id = map_figure_at(grid_offset);
-    while (figure_id) {
-        figure *f = figure_get(figure_id);
-        if (figure_id == draw_context.selected_figure_id) {
+    const uint16_t *figure_ids;
+    unsigned int total_figures = map_figure_get_all_at(grid_offset, &figure_ids);
+    for (unsigned int i = 0; i < total_figures; i++) {
+        figure *f = figure_get(figure_ids[i]);
+        if (f->id == draw_context.selected_figure_id) {
             if (!f->is_ghost || f->height_adjusted_ticks) {
                 city_draw_selected_figure(f, x, y, draw_context.scale, draw_context.selected_figure_coord);
             }
@@ -440,7 +617,6 @@ static void draw_figures(int x, int y, int grid_offset)
             int highlight = f->formation_id > 0 && f->formation_id == draw_context.highlighted_formation;
             city_draw_figure(f, x, y, draw_context.scale, highlight);
         }
-        figure_id = f->next_figure_id_on_same_tile;
     }
 }
 
@@ -816,12 +992,10 @@ static void draw_animation(int x, int y, int grid_offset)
 
 static void draw_elevated_figures(int x, int y, int grid_offset)
 {
-    int figure_id = map_figure_at(grid_offset);
-
-
-    while (figure_id > 0) {
-        figure *f = figure_get(figure_id);
-
+    const uint16_t *figure_ids;
+    unsigned int total_figures = map_figure_get_all_at(grid_offset, &figure_ids);
+    for (unsigned int i = 0; i < total_figures; i++) {
+        figure *f = figure_get(figure_ids[i]);
         if ((f->use_cross_country && !f->is_ghost && !f->dont_draw_elevated) || f->height_adjusted_ticks) {
             int highlight = f->formation_id > 0 && f->formation_id == draw_context.highlighted_formation;
             city_draw_figure(f, x, y, draw_context.scale, highlight);
@@ -835,7 +1009,6 @@ static void draw_elevated_figures(int x, int y, int grid_offset)
             }
 
         }
-        figure_id = f->next_figure_id_on_same_tile;
     }
 }
 
@@ -954,8 +1127,8 @@ static void update_clouds(void)
  {
      int tx = map_grid_offset_to_x(grid_offset);
      int ty = map_grid_offset_to_y(grid_offset);
-     map_routing_distance_grid *distance = map_routing_get_distance_grid();
-     int16_t dist = distance->determined.items[grid_offset];
+     const map_routing_distance_grid *distance = map_routing_get_distance_grid();
+     int dist = map_routing_distance(grid_offset);
      if (!dist) {
          return;
      }
@@ -1025,7 +1198,9 @@ void city_without_overlay_draw(int selected_figure_id, pixel_coordinate *figure_
     city_view_get_viewport(&x, &y, &width, &height);
     graphics_fill_rect(x, y, width, height, COLOR_BLACK);
     int should_mark_deleting = city_building_ghost_mark_deleting(tile);
-    city_view_foreach_valid_map_tile(draw_footprint);
+    // Offscreen views are drawn into their own render target, which the ground cache would replace
+    int is_offscreen = city_view_is_offscreen();
+    draw_ground(x, y, width, height, !should_mark_deleting && !selected_figure_id && !is_offscreen);
     if (!should_mark_deleting) {
         city_view_foreach_valid_map_tile_row(
             draw_top,
@@ -1048,6 +1223,8 @@ void city_without_overlay_draw(int selected_figure_id, pixel_coordinate *figure_
         city_view_foreach_valid_map_tile(deletion_draw_figures_animations);
         city_view_foreach_valid_map_tile(deletion_draw_remaining);
     }
-    update_clouds();
-    update_weather();
+    if (!is_offscreen) {
+        update_clouds();
+        update_weather();
+    }
 }
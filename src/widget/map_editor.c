@@ -73,7 +73,7 @@ static void draw_footprint(int x, int y, int grid_offset)
         if (image_id > draw_context.image_id_water_last) {
             image_id = draw_context.image_id_water_first;
         }
-        map_image_set(grid_offset, image_id);
+        map_image_set_animation_frame(grid_offset, image_id);
     }
     image_draw_isometric_footprint_from_draw_tile(image_id, x, y, color_mask, draw_context.scale);
     if (config_get(CONFIG_UI_SHOW_GRID) && draw_context.scale <= 2.0f) {
@@ -98,13 +98,13 @@ static void draw_top(int x, int y, int grid_offset)
 
 static void draw_flags(int x, int y, int grid_offset)
 {
-    int figure_id = map_figure_at(grid_offset);
-    while (figure_id) {
-        figure *f = figure_get(figure_id);
+    const uint16_t *figure_ids;
+    unsigned int total_figures = map_figure_get_all_at(grid_offset, &figure_ids);
+    for (unsigned int i = 0; i < total_figures; i++) {
+        figure *f = figure_get(figure_ids[i]);
         if (!f->is_ghost) {
             city_draw_figure(f, x, y, draw_context.scale, 0);
         }
-        figure_id = f->next_figure_id_on_same_tile;
     }
 }
 
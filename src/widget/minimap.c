@@ -508,11 +508,14 @@ static void prepare_minimap_cache(void)
         !graphics_renderer()->has_custom_image(CUSTOM_IMAGE_MINIMAP)) {
         data.minimap.width = data.functions->map.width();
         data.minimap.height = data.functions->map.height() * 2;
-        data.minimap.x = (VIEW_X_MAX - data.minimap.width) / 2;
-        data.minimap.y = (VIEW_Y_MAX - data.minimap.height) / 2;
 
         graphics_renderer()->create_custom_image(CUSTOM_IMAGE_MINIMAP, data.minimap.width * 2, data.minimap.height, 0);
     }
+    // The lookup size changes with the grid size, which differs between the city and previewed files
+    int view_x_max, view_y_max;
+    city_view_get_lookup_size(&view_x_max, &view_y_max);
+    data.minimap.x = (view_x_max - data.minimap.width) / 2;
+    data.minimap.y = (view_y_max - data.minimap.height) / 2;
     data.cache.buffer = graphics_renderer()->get_custom_image_buffer(CUSTOM_IMAGE_MINIMAP, &data.cache.stride);
 }
 
@@ -1,5 +1,6 @@
 #include "top_menu_editor.h"
 
+#include "core/lang.h"
 #include "empire/empire.h"
 #include "empire/object.h"
 #include "game/file_editor.h"
@@ -174,7 +175,7 @@ int widget_top_menu_editor_handle_input(const mouse *m, const hotkeys *h)
 static void map_size_selected(int size)
 {
     clear_state();
-    if (size >= 0 && size <= 5) {
+    if (size >= 0 && size < NUM_MAP_SIZES) {
         game_file_editor_create_scenario(size);
         window_editor_map_show();
     } else {
@@ -190,7 +191,15 @@ void menu_file_new_map(int centered)
         x += 325;
         y += 200;
     }
-    window_select_list_show(x, y, 0, 33, 7, map_size_selected);
+    // The original sizes, the large grid sizes and the original cancel item
+    static const uint8_t *items[NUM_MAP_SIZES + 1];
+    for (int i = 0; i < NUM_ORIGINAL_MAP_SIZES; i++) {
+        items[i] = lang_get_string(33, i);
+    }
+    items[NUM_ORIGINAL_MAP_SIZES] = translation_for(TR_EDITOR_MAP_SIZE_324);
+    items[NUM_ORIGINAL_MAP_SIZES + 1] = translation_for(TR_EDITOR_MAP_SIZE_512);
+    items[NUM_MAP_SIZES] = lang_get_string(33, NUM_ORIGINAL_MAP_SIZES);
+    window_select_list_show_text(x, y, 0, items, NUM_MAP_SIZES + 1, map_size_selected);
 }
 
 static void menu_file_load_map(int param)
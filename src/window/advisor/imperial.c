@@ -318,7 +318,6 @@ static void get_tooltip_text(advisor_tooltip_result *r)
 
 const advisor_window_type *window_advisor_imperial(void)
 {
-    city_resource_calculate_warehouse_stocks();
     city_resource_calculate_food_stocks_and_supply_wheat();
     static const advisor_window_type window = {
         draw_background,
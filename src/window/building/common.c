@@ -2,6 +2,7 @@
 
 #include "assets/assets.h"
 #include "building/building.h"
+#include "building/house_service.h"
 #include "building/model.h"
 #include "building/monument.h"
 #include "city/labor.h"
@@ -72,16 +73,16 @@ static int get_employment_info_text(const building *b, int consider_house_coveri
         text_id = 16; // no people in city
     } else if (!consider_house_covering) {
         text_id = 19;
-    } else if (b->houses_covered <= 0) {
+    } else if (house_service_houses_covered(b) <= 0) {
         text_id = 17; // no employees nearby
-    } else if (b->houses_covered < 40) {
+    } else if (house_service_houses_covered(b) < 40) {
         text_id = 20; // poor access to employees
     } else if (city_labor_category(b->labor_category)->workers_allocated <= 0) {
         text_id = 18; // no people allocated
     } else {
         text_id = 19; // too few people allocated
     }
-    if (!text_id && consider_house_covering && b->houses_covered < 40) {
+    if (!text_id && consider_house_covering && house_service_houses_covered(b) < 40) {
         text_id = 20; // poor access to employees
     }
     return text_id;
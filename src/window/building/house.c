@@ -1,6 +1,7 @@
 #include "house.h"
 
 #include "building/building.h"
+#include "building/house_service.h"
 #include "building/model.h"
 #include "city/constants.h"
 #include "city/finance.h"
@@ -66,7 +67,7 @@ static void draw_population_info(building_info_context *c, int y_offset)
 static void draw_tax_info(building_info_context *c, int y_offset)
 {
     building *b = building_get(c->building_id);
-    if (b->house_tax_coverage) {
+    if (house_service_get(b, HOUSE_SERVICE_TAX_COLLECTOR)) {
         int pct = calc_adjust_with_percentage(b->tax_income_or_storage / 2, city_finance_tax_percentage());
         int width = lang_text_draw(127, 24, c->x_offset + 36, y_offset, FONT_NORMAL_BROWN);
         width += lang_text_draw_amount(8, 0, pct, c->x_offset + 36 + width, y_offset, FONT_NORMAL_BROWN);
@@ -34,6 +34,7 @@
 #include "map/figure.h"
 #include "map/grid.h"
 #include "map/image.h"
+#include "map/point.h"
 #include "map/property.h"
 #include "map/sprite.h"
 #include "map/terrain.h"
@@ -421,12 +422,12 @@ static void init(int grid_offset)
     for (int i = 0; i < 7; i++) {
         context.figure.figure_ids[i] = 0;
     }
-    static const int FIGURE_OFFSETS[] = {
-        OFFSET(0,0), OFFSET(0,-1), OFFSET(0,1), OFFSET(1,0), OFFSET(-1,0),
-        OFFSET(-1,-1), OFFSET(1,-1), OFFSET(-1,1), OFFSET(1,1)
+    static const map_point FIGURE_OFFSETS[] = {
+        {0, 0}, {0, -1}, {0, 1}, {1, 0}, {-1, 0},
+        {-1, -1}, {1, -1}, {-1, 1}, {1, 1}
     };
     for (int i = 0; i < 9 && context.figure.count < 7; i++) {
-        int figure_id = map_figure_at(grid_offset + FIGURE_OFFSETS[i]);
+        int figure_id = map_figure_at(grid_offset + OFFSET(FIGURE_OFFSETS[i].x, FIGURE_OFFSETS[i].y));
         while (figure_id > 0 && context.figure.count < 7) {
             figure *f = figure_get(figure_id);
             if (f->state != FIGURE_STATE_DEAD &&